@@ -20,6 +20,10 @@
 #include "absl/types/span.h"
 
 namespace Envoy {
+namespace Stats {
+class Scope;
+} // namespace Stats
+
 namespace Buffer {
 
 /**
@@ -76,6 +80,47 @@ using SliceDataPtr = std::unique_ptr<SliceData>;
 class Reservation;
 class ReservationSingleSlice;
 
+/**
+ * An account that buffer memory is charged to, so that memory can be attributed to the stream
+ * that owns it. An account is shared by all of the buffers of a stream and is only used from the
+ * thread that created it.
+ */
+class BufferMemoryAccount {
+public:
+  virtual ~BufferMemoryAccount() = default;
+
+  /**
+   * @return uint64_t the number of bytes currently charged to the account.
+   */
+  virtual uint64_t balance() const PURE;
+
+  /**
+   * Charges the account for bytes added to one of its buffers.
+   * @param amount supplies the number of bytes to charge.
+   */
+  virtual void charge(uint64_t amount) PURE;
+
+  /**
+   * Credits the account for bytes removed from one of its buffers.
+   * @param amount supplies the number of bytes to credit. Must not exceed the balance.
+   */
+  virtual void credit(uint64_t amount) PURE;
+
+  /**
+   * Resets the stream that owns the account to release its memory. This is a no-op if the stream
+   * has already been reset or has completed.
+   */
+  virtual void resetDownstream() PURE;
+
+  /**
+   * Called by the owning stream when it is destroyed. Buffers may outlive the stream, but the
+   * account must no longer attempt to reset it.
+   */
+  virtual void clearDownstream() PURE;
+};
+
+using BufferMemoryAccountSharedPtr = std::shared_ptr<BufferMemoryAccount>;
+
 // Base class for an object to manage the ownership for slices in a `Reservation` or
 // `ReservationSingleSlice`.
 class ReservationSlicesOwner {
@@ -101,6 +146,14 @@ public:
    */
   virtual void addDrainTracker(std::function<void()> drain_tracker) PURE;
 
+  /**
+   * Binds the buffer to a memory account. The bytes currently held by the buffer and all bytes
+   * added later are charged to the account until they are drained or the buffer is destroyed.
+   * Buffers that do not support accounting ignore the account.
+   * @param account supplies the account to charge, or nullptr to stop charging any account.
+   */
+  virtual void bindAccount(BufferMemoryAccountSharedPtr account) PURE;
+
   /**
    * Copy data into the buffer (deprecated, use absl::string_view variant
    * instead).
@@ -459,6 +512,30 @@ public:
   virtual InstancePtr create(std::function<void()> below_low_watermark,
                              std::function<void()> above_high_watermark,
                              std::function<void()> above_overflow_watermark) PURE;
+
+  /**
+   * Enables memory accounting. Until this is called createAccount() returns nullptr, so streams
+   * are not charged for their buffers. Must be called before the factory is used to create any
+   * account.
+   * @param scope supplies the scope in which the account tracking stats are created.
+   */
+  virtual void enableAccountTracking(Stats::Scope& scope) PURE;
+
+  /**
+   * Creates a memory account that is tracked by this factory.
+   * @param reset_stream supplies a function that resets the stream owning the account. It is
+   *   called at most once, and never after BufferMemoryAccount::clearDownstream().
+   * @return a new account, or nullptr if this factory does not track memory.
+   */
+  virtual BufferMemoryAccountSharedPtr createAccount(std::function<void()> reset_stream) PURE;
+
+  /**
+   * Resets the streams whose accounts hold the most memory. Higher pressure resets streams from
+   * more buckets of tracked accounts, starting with the largest.
+   * @param pressure supplies the memory pressure in [0, 1]. Nothing is reset at 0.
+   * @return uint64_t the number of streams that were reset.
+   */
+  virtual uint64_t resetAccountsGivenPressure(float pressure) PURE;
 };
 
 using WatermarkFactoryPtr = std::unique_ptr<WatermarkFactory>;
@@ -34,15 +34,21 @@ namespace Event {
 /**
  * All dispatcher stats. @see stats_macros.h
  */
-#define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+#define ALL_DISPATCHER_STATS(COUNTER, HISTOGRAM)                                                   \
+  COUNTER(slow_callbacks)                                                                          \
+  HISTOGRAM(deferred_delete_us, Microseconds)                                                      \
+  HISTOGRAM(file_event_us, Microseconds)                                                           \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
-  HISTOGRAM(poll_delay_us, Microseconds)
+  HISTOGRAM(poll_delay_us, Microseconds)                                                           \
+  HISTOGRAM(post_callback_us, Microseconds)                                                        \
+  HISTOGRAM(schedulable_callback_us, Microseconds)                                                 \
+  HISTOGRAM(timer_us, Microseconds)
 
 /**
  * Struct definition for all dispatcher stats. @see stats_macros.h
  */
 struct DispatcherStats {
-  ALL_DISPATCHER_STATS(GENERATE_HISTOGRAM_STRUCT)
+  ALL_DISPATCHER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 using DispatcherStatsPtr = std::unique_ptr<DispatcherStats>;
@@ -94,6 +100,17 @@ public:
    */
   virtual Event::TimerPtr createScaledTimer(Event::ScaledTimerMinimum minimum, TimerCb cb) PURE;
 
+  /**
+   * Allocates a coarse timer. @see Timer for docs on how to use the timer. Coarse timers with the
+   * same granularity share a single underlying timer, which makes enabling and disabling them much
+   * cheaper than for timers returned by createTimer(). In exchange, a coarse timer may fire up to
+   * one granularity after its timeout expired.
+   * @param granularity the resolution of the timer. Must be at least 1ms.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  virtual Event::TimerPtr createCoarseTimer(std::chrono::milliseconds granularity,
+                                            TimerCb cb) PURE;
+
   /**
    * Allocates a schedulable callback. @see SchedulableCallback for docs on how to use the wrapped
    * callback.
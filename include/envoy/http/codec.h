@@ -380,6 +380,14 @@ public:
    * small window updates as satisfying the idle timeout as this is a potential DoS vector.
    */
   virtual void setFlushTimeout(std::chrono::milliseconds timeout) PURE;
+
+  /**
+   * Binds the buffers owned by the stream to a memory account, so that the memory they hold is
+   * attributed to the proxied request. Codecs whose buffers are shared by the whole connection
+   * ignore the account.
+   * @param account supplies the account to charge.
+   */
+  virtual void setAccount(Buffer::BufferMemoryAccountSharedPtr account) PURE;
 };
 
 /**
@@ -502,6 +510,12 @@ public:
    */
   virtual bool wantsToWrite() PURE;
 
+  /**
+   * Write any output the codec holds back in order to coalesce writes to the connection. Called
+   * before the connection is closed, so that the output is not lost.
+   */
+  virtual void flushPendingWrites() PURE;
+
   /**
    * Called when the underlying Network::Connection goes over its high watermark.
    */
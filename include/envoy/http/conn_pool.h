@@ -78,6 +78,17 @@ public:
   virtual Cancellable* newStream(Http::ResponseDecoder& response_decoder,
                                  Callbacks& callbacks) PURE;
 
+  /**
+   * Like newStream(), but the request may be sent as early (0-RTT) data on a connection that is
+   * still completing the handshake of a resumed session. Early data may be replayed, so this must
+   * only be used for requests that are safe to replay. Pools that can't send early data create a
+   * regular stream.
+   */
+  virtual Cancellable* newEarlyDataStream(Http::ResponseDecoder& response_decoder,
+                                          Callbacks& callbacks) {
+    return newStream(response_decoder, callbacks);
+  }
+
   /**
    * Returns a user-friendly protocol description for logging.
    * @return absl::string_view a protocol description for logging.
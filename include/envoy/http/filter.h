@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -559,6 +560,13 @@ public:
    */
   virtual Network::Socket::OptionsSharedPtr getUpstreamSocketOptions() const PURE;
 
+  /**
+   * @return the memory account of the stream, which buffers created on behalf of the stream
+   *         (for example by the router for the upstream request) should be bound to. May be
+   *         nullptr if the stream's memory is not accounted for.
+   */
+  virtual Buffer::BufferMemoryAccountSharedPtr account() const PURE;
+
   /**
    * Schedules a request for a RouteConfiguration update from the management server.
    * @param route_config_updated_cb callback to be called when the configuration update has been
@@ -945,6 +953,38 @@ public:
   virtual ResponseTrailerMapOptConstRef responseTrailers() const PURE;
 };
 
+/**
+ * Records the time spent in the callbacks of a filter, as measured by the filter manager.
+ */
+class FilterLatencyRecorder {
+public:
+  virtual ~FilterLatencyRecorder() = default;
+
+  /**
+   * @return whether the thread CPU time used by the callbacks should be measured as well as the
+   *         time they take.
+   */
+  virtual bool recordsCpuTime() const PURE;
+
+  /**
+   * Records a decoder callback of the filter.
+   * @param duration the time the callback took.
+   * @param cpu_time the thread CPU time used by the callback, if recordsCpuTime().
+   */
+  virtual void recordDecode(std::chrono::microseconds duration,
+                            std::chrono::microseconds cpu_time) PURE;
+
+  /**
+   * Records an encoder callback of the filter.
+   * @param duration the time the callback took.
+   * @param cpu_time the thread CPU time used by the callback, if recordsCpuTime().
+   */
+  virtual void recordEncode(std::chrono::microseconds duration,
+                            std::chrono::microseconds cpu_time) PURE;
+};
+
+using FilterLatencyRecorderPtr = std::unique_ptr<FilterLatencyRecorder>;
+
 /**
  * These callbacks are provided by the connection manager to the factory so that the factory can
  * build the filter chain in an application specific way.
@@ -1002,6 +1042,14 @@ public:
    * @param handler supplies the handler to add.
    */
   virtual void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) PURE;
+
+  /**
+   * Times the callbacks of the filters added after this call, until the next call. Filters aren't
+   * timed by default.
+   * @param recorder supplies the recorder of the latency of the filters, or nullptr to not time
+   *        them. It must outlive the stream.
+   */
+  virtual void setFilterLatencyRecorder(FilterLatencyRecorder* recorder) PURE;
 };
 
 /**
@@ -29,6 +29,9 @@ enum class ConnectionEvent {
   RemoteClose,
   LocalClose,
   Connected,
+  // Raised by connections that can send early (0-RTT) data while their handshake is still in
+  // progress. Connected follows once the handshake completes.
+  ConnectedZeroRtt,
 };
 
 /**
@@ -1238,6 +1238,11 @@ public:
    * @return return the connection for the downstream stream.
    */
   virtual const Network::Connection& connection() const PURE;
+  /**
+   * @return the memory account of the downstream stream, which the upstream stream's buffers
+   *         should be charged to. May be nullptr.
+   */
+  virtual Buffer::BufferMemoryAccountSharedPtr account() const PURE;
 };
 
 /**
@@ -34,6 +34,13 @@ public:
 
   // Overload action to reduce some subset of configured timeouts.
   const std::string ReduceTimeouts = "envoy.overload_actions.reduce_timeouts";
+
+  // Overload action to scale down per-stream buffer limits.
+  const std::string ReduceBufferLimits = "envoy.overload_actions.reduce_buffer_limits";
+
+  // Overload action to reset the streams holding the most buffer memory.
+  const std::string ResetStreamsUsingExcessiveMemory =
+      "envoy.overload_actions.reset_high_memory_stream";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
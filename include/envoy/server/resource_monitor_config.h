@@ -7,6 +7,7 @@
 #include "envoy/protobuf/message_validator.h"
 #include "envoy/server/options.h"
 #include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/protobuf/protobuf.h"
 
@@ -39,6 +40,13 @@ public:
    *         messages.
    */
   virtual ProtobufMessage::ValidationVisitor& messageValidationVisitor() PURE;
+
+  /**
+   * @return ThreadLocal::SlotAllocator& the thread local storage allocator. Slots may be allocated
+   *         when the monitor is created, but worker threads are not registered until later, so
+   *         slot data should not be set before the first call to updateResourceUsage().
+   */
+  virtual ThreadLocal::SlotAllocator& threadLocal() PURE;
 };
 
 /**
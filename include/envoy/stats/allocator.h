@@ -37,6 +37,18 @@ public:
   virtual CounterSharedPtr makeCounter(StatName name, StatName tag_extracted_name,
                                        const StatNameTagVector& stat_name_tags) PURE;
 
+  /**
+   * Like makeCounter, but creates a counter sharded across threads, so that threads incrementing
+   * it concurrently don't contend, at the cost of a cache line per shard. If a counter of the same
+   * name already exists, it is returned whether or not it is sharded.
+   * @param name the full name of the stat.
+   * @param tag_extracted_name the name of the stat with tag-values stripped out.
+   * @param tags the tag values.
+   * @return CounterSharedPtr a counter.
+   */
+  virtual CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                              const StatNameTagVector& stat_name_tags) PURE;
+
   /**
    * @param name the full name of the stat.
    * @param tag_extracted_name the name of the stat with tag-values stripped out.
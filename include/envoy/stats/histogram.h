@@ -8,6 +8,8 @@
 #include "envoy/stats/refcount_ptr.h"
 #include "envoy/stats/stats.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Stats {
 
@@ -24,6 +26,12 @@ public:
    * @return The buckets for the histogram. Each value is an upper bound of a bucket.
    */
   virtual ConstSupportedBuckets& buckets(absl::string_view stat_name) const PURE;
+
+  /**
+   * @return the relative error of the log-linear histograms recording the values of histograms,
+   *         or nullopt if the values are recorded in circllhist histograms.
+   */
+  virtual absl::optional<double> relativeError() const PURE;
 };
 
 using HistogramSettingsConstPtr = std::unique_ptr<const HistogramSettings>;
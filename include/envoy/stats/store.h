@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "envoy/common/matchers.h"
 #include "envoy/common/pure.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
@@ -85,6 +86,13 @@ public:
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Attach matchers selecting the counters to shard across threads. Counters created after this
+   * call whose names match any of the matchers are sharded.
+   * @param matchers the matchers, which may be empty to shard no counters.
+   */
+  virtual void setShardedCounterMatchers(std::vector<Matchers::StringMatcherPtr>&& matchers) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -557,6 +557,7 @@ public:
   COUNTER(upstream_flow_control_resumed_reading_total)                                             \
   COUNTER(upstream_internal_redirect_failed_total)                                                 \
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
+  COUNTER(upstream_rq_0rtt)                                                                        \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
@@ -565,6 +566,8 @@ public:
   COUNTER(upstream_rq_pending_overflow)                                                            \
   COUNTER(upstream_rq_pending_total)                                                               \
   COUNTER(upstream_rq_per_try_timeout)                                                             \
+  COUNTER(upstream_rq_prewarm_hit)                                                                 \
+  COUNTER(upstream_rq_prewarm_miss)                                                                \
   COUNTER(upstream_rq_retry)                                                                       \
   COUNTER(upstream_rq_retry_backoff_exponential)                                                   \
   COUNTER(upstream_rq_retry_backoff_ratelimited)                                                   \
@@ -741,6 +744,25 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the minimum number of connections with spare stream capacity that each connection
+   *         pool keeps established or connecting to its host.
+   */
+  virtual uint32_t minReadyConnections() const PURE;
+
+  /**
+   * @return the window for which connection pools anticipate streams based on the recent stream
+   *         arrival rate, or zero if predictive connection establishment is disabled.
+   */
+  virtual std::chrono::milliseconds arrivalRateLookahead() const PURE;
+
+  /**
+   * @return the policy which determines the connection of a connection pool new streams are
+   *         assigned to.
+   */
+  virtual envoy::config::cluster::v3::Cluster::ConnectionSelectionPolicy
+  connectionSelectionPolicy() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
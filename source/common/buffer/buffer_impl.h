@@ -679,6 +679,8 @@ public:
   void setWatermarks(uint32_t) override { ASSERT(false, "watermarks not implemented."); }
   uint32_t highWatermark() const override { return 0; }
   bool highWatermarkTriggered() const override { return false; }
+  // Does not implement memory accounting, which is done by WatermarkBuffer.
+  void bindAccount(BufferMemoryAccountSharedPtr) override {}
 
   /**
    * Describe the in-memory representation of the slices in the buffer. For use
@@ -1,11 +1,20 @@
 #include "common/buffer/watermark_buffer.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "common/common/assert.h"
 #include "common/runtime/runtime_features.h"
 
 namespace Envoy {
 namespace Buffer {
 
+WatermarkBuffer::~WatermarkBuffer() {
+  if (account_ != nullptr) {
+    account_->credit(account_charge_);
+  }
+}
+
 void WatermarkBuffer::add(const void* data, uint64_t size) {
   OwnedImpl::add(data, size);
   checkHighAndOverflowWatermarks();
@@ -108,7 +117,30 @@ void WatermarkBuffer::setWatermarks(uint32_t low_watermark, uint32_t high_waterm
   checkLowWatermark();
 }
 
+void WatermarkBuffer::bindAccount(BufferMemoryAccountSharedPtr account) {
+  if (account_ != nullptr) {
+    account_->credit(account_charge_);
+    account_charge_ = 0;
+  }
+  account_ = std::move(account);
+  updateAccountBalance();
+}
+
+void WatermarkBuffer::updateAccountBalance() {
+  if (account_ == nullptr) {
+    return;
+  }
+  const uint64_t current_length = OwnedImpl::length();
+  if (current_length > account_charge_) {
+    account_->charge(current_length - account_charge_);
+  } else if (current_length < account_charge_) {
+    account_->credit(account_charge_ - current_length);
+  }
+  account_charge_ = current_length;
+}
+
 void WatermarkBuffer::checkLowWatermark() {
+  updateAccountBalance();
   if (!above_high_watermark_called_ ||
       (high_watermark_ != 0 && OwnedImpl::length() > low_watermark_)) {
     return;
@@ -119,6 +151,7 @@ void WatermarkBuffer::checkLowWatermark() {
 }
 
 void WatermarkBuffer::checkHighAndOverflowWatermarks() {
+  updateAccountBalance();
   if (high_watermark_ == 0 || OwnedImpl::length() <= high_watermark_) {
     return;
   }
@@ -137,5 +170,136 @@ void WatermarkBuffer::checkHighAndOverflowWatermarks() {
   }
 }
 
+BufferMemoryAccountImpl::~BufferMemoryAccountImpl() {
+  // Every buffer charging the account holds a reference to it, so all charges have been credited.
+  ASSERT(balance_ == 0);
+  ASSERT(!bucket_.has_value());
+}
+
+void BufferMemoryAccountImpl::charge(uint64_t amount) {
+  const uint64_t old_balance = balance_;
+  balance_ += amount;
+  factory_.onAccountBalanceChanged(*this, old_balance);
+}
+
+void BufferMemoryAccountImpl::credit(uint64_t amount) {
+  ASSERT(amount <= balance_);
+  const uint64_t old_balance = balance_;
+  balance_ -= amount;
+  factory_.onAccountBalanceChanged(*this, old_balance);
+}
+
+void BufferMemoryAccountImpl::resetDownstream() {
+  if (reset_stream_ == nullptr) {
+    return;
+  }
+  // Clear the callback first, as resetting the stream may credit the account or clear it.
+  std::function<void()> reset_stream = std::move(reset_stream_);
+  reset_stream_ = nullptr;
+  reset_stream();
+}
+
+WatermarkBufferFactory::~WatermarkBufferFactory() {
+  for (const auto& bucket : buckets_) {
+    ASSERT(bucket.empty());
+  }
+}
+
+void WatermarkBufferFactory::enableAccountTracking(Stats::Scope& scope) {
+  ASSERT(stats_ == nullptr);
+  // Every worker's factory shares the same stats. The bucket gauges are only ever adjusted by the
+  // change in balance, so they hold the sum across workers.
+  stats_ = std::make_unique<BufferMemoryAccountStats>(BufferMemoryAccountStats{
+      ALL_BUFFER_MEMORY_ACCOUNT_STATS(POOL_COUNTER_PREFIX(scope, "buffer_memory_account."),
+                                      POOL_GAUGE_PREFIX(scope, "buffer_memory_account."))});
+  bucket_bytes_ = {&stats_->bucket_0_bytes_, &stats_->bucket_1_bytes_, &stats_->bucket_2_bytes_,
+                   &stats_->bucket_3_bytes_, &stats_->bucket_4_bytes_, &stats_->bucket_5_bytes_,
+                   &stats_->bucket_6_bytes_, &stats_->bucket_7_bytes_};
+}
+
+BufferMemoryAccountSharedPtr
+WatermarkBufferFactory::createAccount(std::function<void()> reset_stream) {
+  if (stats_ == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<BufferMemoryAccountImpl>(*this, std::move(reset_stream));
+}
+
+absl::optional<uint32_t> WatermarkBufferFactory::bucketForBalance(uint64_t balance) {
+  uint64_t shifted = balance >> MinimumTrackedAccountBalanceLog2;
+  if (shifted == 0) {
+    return absl::nullopt;
+  }
+  uint32_t bucket = 0;
+  while (shifted > 1 && bucket < NumAccountBuckets - 1) {
+    shifted >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void WatermarkBufferFactory::onAccountBalanceChanged(BufferMemoryAccountImpl& account,
+                                                     uint64_t old_balance) {
+  const absl::optional<uint32_t> new_bucket = bucketForBalance(account.balance_);
+  if (!account.bucket_.has_value() && !new_bucket.has_value()) {
+    // Most accounts are never large enough to be tracked.
+    return;
+  }
+
+  if (account.bucket_.has_value()) {
+    bucket_bytes_[*account.bucket_]->sub(old_balance);
+    if (account.bucket_ != new_bucket) {
+      buckets_[*account.bucket_].erase(&account);
+    }
+  }
+  if (new_bucket.has_value()) {
+    bucket_bytes_[*new_bucket]->add(account.balance_);
+    if (account.bucket_ != new_bucket) {
+      buckets_[*new_bucket].insert(&account);
+    }
+  }
+  account.bucket_ = new_bucket;
+}
+
+uint64_t WatermarkBufferFactory::resetAccountsGivenPressure(float pressure) {
+  ASSERT(pressure >= 0.0 && pressure <= 1.0);
+  if (pressure == 0 || stats_ == nullptr) {
+    return 0;
+  }
+
+  // Only the largest bucket is reset at low pressure, and every tracked account at saturation.
+  const uint32_t buckets_to_reset = std::min<uint32_t>(
+      static_cast<uint32_t>(pressure * NumAccountBuckets) + 1, NumAccountBuckets);
+
+  // Collect the accounts up front since resetting a stream may move accounts between buckets.
+  // Holding references keeps the accounts alive until all resets have been issued.
+  std::vector<std::shared_ptr<BufferMemoryAccountImpl>> to_reset;
+  for (uint32_t bucket = NumAccountBuckets; bucket-- > NumAccountBuckets - buckets_to_reset;) {
+    for (BufferMemoryAccountImpl* account : buckets_[bucket]) {
+      if (to_reset.size() == MaxStreamsResetPerInvocation) {
+        break;
+      }
+      // Streams that were already reset stay tracked until their buffers are released.
+      if (account->reset_stream_ != nullptr) {
+        to_reset.push_back(account->shared_from_this());
+      }
+    }
+  }
+
+  for (const auto& account : to_reset) {
+    account->resetDownstream();
+  }
+  stats_->streams_reset_.add(to_reset.size());
+  return to_reset.size();
+}
+
+uint32_t scaleBufferLimit(uint32_t limit, UnitFloat reduction) {
+  if (limit == 0 || reduction == UnitFloat::min()) {
+    return limit;
+  }
+  const uint32_t scaled = static_cast<uint32_t>(limit * reduction.invert().value());
+  return std::max(scaled, std::min(limit, MinimumScaledBufferLimit));
+}
+
 } // namespace Buffer
 } // namespace Envoy
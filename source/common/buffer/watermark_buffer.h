@@ -1,9 +1,18 @@
 #pragma once
 
+#include <array>
 #include <functional>
+#include <memory>
 #include <string>
 
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
 #include "common/buffer/buffer_impl.h"
+#include "common/common/interval_value.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Buffer {
@@ -15,6 +24,8 @@ namespace Buffer {
 // is drained below the low watermark, at which point the below_low_watermark function is called.
 // If the buffer size is above the overflow watermark, above_overflow_watermark is called.
 // It is only called on the first time the buffer overflows.
+// If the buffer is bound to a memory account, the account is charged for the buffer length each
+// time the watermarks are checked.
 class WatermarkBuffer : public OwnedImpl {
 public:
   WatermarkBuffer(std::function<void()> below_low_watermark,
@@ -22,6 +33,7 @@ public:
                   std::function<void()> above_overflow_watermark)
       : below_low_watermark_(below_low_watermark), above_high_watermark_(above_high_watermark),
         above_overflow_watermark_(above_overflow_watermark) {}
+  ~WatermarkBuffer() override;
 
   // Override all functions from Instance which can result in changing the size
   // of the underlying buffer.
@@ -45,6 +57,7 @@ public:
   // Returns true if the high watermark callbacks have been called more recently
   // than the low watermark callbacks.
   bool highWatermarkTriggered() const override { return above_high_watermark_called_; }
+  void bindAccount(BufferMemoryAccountSharedPtr account) override;
 
 protected:
   virtual void checkHighAndOverflowWatermarks();
@@ -53,6 +66,8 @@ protected:
 private:
   void commit(uint64_t length, absl::Span<RawSlice> slices,
               ReservationSlicesOwnerPtr slices_owner) override;
+  // Charges or credits the bound account with the change in length since the last update.
+  void updateAccountBalance();
 
   std::function<void()> below_low_watermark_;
   std::function<void()> above_high_watermark_;
@@ -69,12 +84,72 @@ private:
   bool above_high_watermark_called_{false};
   // Set to true when above_overflow_watermark_ is called (and isn't cleared).
   bool above_overflow_watermark_called_{false};
+  BufferMemoryAccountSharedPtr account_;
+  // The number of bytes currently charged to account_.
+  uint64_t account_charge_{0};
 };
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
 
+// Accounts are tracked by their factory once their balance reaches 2^18 bytes (256KiB). Tracked
+// accounts are grouped in power of two buckets: bucket 0 holds balances in [256KiB, 512KiB),
+// bucket 1 holds [512KiB, 1MiB), and so on. The last bucket holds all balances of 32MiB or more.
+constexpr uint32_t MinimumTrackedAccountBalanceLog2 = 18;
+constexpr uint32_t NumAccountBuckets = 8;
+// Bounds the work done by a single call to resetAccountsGivenPressure().
+constexpr uint32_t MaxStreamsResetPerInvocation = 50;
+
+/**
+ * All stats for buffer memory accounts. @see stats_macros.h
+ */
+#define ALL_BUFFER_MEMORY_ACCOUNT_STATS(COUNTER, GAUGE)                                            \
+  COUNTER(streams_reset)                                                                           \
+  GAUGE(bucket_0_bytes, NeverImport)                                                               \
+  GAUGE(bucket_1_bytes, NeverImport)                                                               \
+  GAUGE(bucket_2_bytes, NeverImport)                                                               \
+  GAUGE(bucket_3_bytes, NeverImport)                                                               \
+  GAUGE(bucket_4_bytes, NeverImport)                                                               \
+  GAUGE(bucket_5_bytes, NeverImport)                                                               \
+  GAUGE(bucket_6_bytes, NeverImport)                                                               \
+  GAUGE(bucket_7_bytes, NeverImport)
+
+/**
+ * Struct definition for all buffer memory account stats. @see stats_macros.h
+ */
+struct BufferMemoryAccountStats {
+  ALL_BUFFER_MEMORY_ACCOUNT_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class WatermarkBufferFactory;
+
+class BufferMemoryAccountImpl : public BufferMemoryAccount,
+                                public std::enable_shared_from_this<BufferMemoryAccountImpl> {
+public:
+  BufferMemoryAccountImpl(WatermarkBufferFactory& factory, std::function<void()> reset_stream)
+      : factory_(factory), reset_stream_(std::move(reset_stream)) {}
+  ~BufferMemoryAccountImpl() override;
+
+  // Buffer::BufferMemoryAccount
+  uint64_t balance() const override { return balance_; }
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  void resetDownstream() override;
+  void clearDownstream() override { reset_stream_ = nullptr; }
+
+private:
+  friend class WatermarkBufferFactory;
+
+  WatermarkBufferFactory& factory_;
+  std::function<void()> reset_stream_;
+  uint64_t balance_{0};
+  // The bucket the account is tracked in, if its balance is large enough to be tracked.
+  absl::optional<uint32_t> bucket_;
+};
+
 class WatermarkBufferFactory : public WatermarkFactory {
 public:
+  ~WatermarkBufferFactory() override;
+
   // Buffer::WatermarkFactory
   InstancePtr create(std::function<void()> below_low_watermark,
                      std::function<void()> above_high_watermark,
@@ -82,7 +157,42 @@ public:
     return std::make_unique<WatermarkBuffer>(below_low_watermark, above_high_watermark,
                                              above_overflow_watermark);
   }
+  void enableAccountTracking(Stats::Scope& scope) override;
+  BufferMemoryAccountSharedPtr createAccount(std::function<void()> reset_stream) override;
+  uint64_t resetAccountsGivenPressure(float pressure) override;
+
+  /**
+   * @return the accounts currently tracked in the given bucket. Exposed for testing.
+   */
+  const absl::flat_hash_set<BufferMemoryAccountImpl*>& accountsInBucketForTest(uint32_t bucket) {
+    return buckets_[bucket];
+  }
+
+private:
+  friend class BufferMemoryAccountImpl;
+
+  static absl::optional<uint32_t> bucketForBalance(uint64_t balance);
+  // Moves the account to the bucket matching its new balance and updates the bucket stats.
+  void onAccountBalanceChanged(BufferMemoryAccountImpl& account, uint64_t old_balance);
+
+  // Only set once account tracking is enabled.
+  std::unique_ptr<BufferMemoryAccountStats> stats_;
+  std::array<Stats::Gauge*, NumAccountBuckets> bucket_bytes_{};
+  std::array<absl::flat_hash_set<BufferMemoryAccountImpl*>, NumAccountBuckets> buckets_;
 };
 
+// scaleBufferLimit() never reduces a limit below this value, so that a stream can still make
+// progress with a full HTTP/2 DATA frame of the default maximum size.
+constexpr uint32_t MinimumScaledBufferLimit = 16 * 1024;
+
+/**
+ * Scales a buffer limit down in response to resource pressure.
+ * @param limit the configured limit. A limit of 0 (unlimited) is returned unchanged.
+ * @param reduction the fraction by which to reduce the limit, typically the state of the
+ *        envoy.overload_actions.reduce_buffer_limits overload action.
+ * @return the reduced limit, which is never less than min(limit, MinimumScaledBufferLimit).
+ */
+uint32_t scaleBufferLimit(uint32_t limit, UnitFloat reduction);
+
 } // namespace Buffer
 } // namespace Envoy
@@ -12,6 +12,7 @@
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
 #include "common/common/hex.h"
+#include "common/common/matchers.h"
 #include "common/common/utility.h"
 #include "common/config/api_type_oracle.h"
 #include "common/config/version_converter.h"
@@ -236,6 +237,15 @@ Utility::createHistogramSettings(const envoy::config::bootstrap::v3::Bootstrap&
   return std::make_unique<Stats::HistogramSettingsImpl>(bootstrap.stats_config());
 }
 
+std::vector<Matchers::StringMatcherPtr>
+Utility::createShardedCounterMatchers(const envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+  std::vector<Matchers::StringMatcherPtr> matchers;
+  for (const auto& matcher : bootstrap.stats_config().sharded_counters()) {
+    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
+  }
+  return matchers;
+}
+
 Grpc::AsyncClientFactoryPtr Utility::factoryForGrpcApiConfigSource(
     Grpc::AsyncClientManager& async_client_manager,
     const envoy::config::core::v3::ApiConfigSource& api_config_source, Stats::Scope& scope,
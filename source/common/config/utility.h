@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/api/api.h"
+#include "envoy/common/matchers.h"
 #include "envoy/common/random_generator.h"
 #include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -415,6 +416,12 @@ public:
   static Stats::HistogramSettingsConstPtr
   createHistogramSettings(const envoy::config::bootstrap::v3::Bootstrap& bootstrap);
 
+  /**
+   * Create the matchers selecting the counters to shard across threads.
+   */
+  static std::vector<Matchers::StringMatcherPtr>
+  createShardedCounterMatchers(const envoy::config::bootstrap::v3::Bootstrap& bootstrap);
+
   /**
    * Obtain gRPC async client factory from a envoy::config::core::v3::ApiConfigSource.
    * @param async_client_manager gRPC async client manager.
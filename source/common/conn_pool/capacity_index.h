@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <list>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+
+/**
+ * Indexes elements, e.g. the clients of a connection pool, by their remaining capacity, so that the
+ * elements with the least and the most capacity are found in O(1). Elements of equal capacity share
+ * a bucket, and the buckets are kept in a list sorted by capacity. The capacity of a connection
+ * changes by one stream at a time, in which case the element is moved to an adjacent bucket, so
+ * updates are O(1) as well. Larger changes take time linear in the number of buckets skipped.
+ *
+ * The index does not own its elements. Each element has an Entry, which tracks its position in the
+ * index and must outlive its membership.
+ */
+template <class T> class CapacityIndex {
+  struct Bucket {
+    Bucket(int64_t capacity) : capacity_(capacity) {}
+
+    const int64_t capacity_;
+    std::list<T*> elements_;
+  };
+  using BucketList = std::list<Bucket>;
+
+public:
+  class Entry {
+  public:
+    bool indexed() const { return indexed_; }
+
+  private:
+    friend class CapacityIndex;
+
+    typename BucketList::iterator bucket_;
+    typename std::list<T*>::iterator element_;
+    bool indexed_{false};
+  };
+
+  ~CapacityIndex() { ASSERT(size_ == 0); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  /**
+   * Adds an element to the index.
+   * @param element supplies the element to add.
+   * @param entry supplies the element's entry, which must not be indexed.
+   * @param capacity supplies the element's remaining capacity.
+   */
+  void insert(T& element, Entry& entry, int64_t capacity) {
+    ASSERT(!entry.indexed_);
+    // Search from the end of the list closest to the capacity, as elements are usually added with
+    // either all or very little of their capacity remaining.
+    typename BucketList::iterator bucket;
+    if (buckets_.empty() ||
+        capacity - buckets_.front().capacity_ < buckets_.back().capacity_ - capacity) {
+      bucket = buckets_.begin();
+      while (bucket != buckets_.end() && bucket->capacity_ < capacity) {
+        ++bucket;
+      }
+    } else {
+      bucket = buckets_.end();
+      while (bucket != buckets_.begin() && std::prev(bucket)->capacity_ >= capacity) {
+        --bucket;
+      }
+    }
+    bucket = bucketAt(bucket, capacity);
+    bucket->elements_.push_front(&element);
+    entry.bucket_ = bucket;
+    entry.element_ = bucket->elements_.begin();
+    entry.indexed_ = true;
+    ++size_;
+  }
+
+  /**
+   * Updates the remaining capacity of an indexed element.
+   */
+  void update(Entry& entry, int64_t capacity) {
+    ASSERT(entry.indexed_);
+    const typename BucketList::iterator old_bucket = entry.bucket_;
+    if (old_bucket->capacity_ == capacity) {
+      return;
+    }
+
+    // Find the first bucket with at least the new capacity, starting from the current one.
+    typename BucketList::iterator bucket = old_bucket;
+    if (capacity < old_bucket->capacity_) {
+      while (bucket != buckets_.begin() && std::prev(bucket)->capacity_ >= capacity) {
+        --bucket;
+      }
+    } else {
+      ++bucket;
+      while (bucket != buckets_.end() && bucket->capacity_ < capacity) {
+        ++bucket;
+      }
+    }
+    bucket = bucketAt(bucket, capacity);
+    // Splicing keeps the element's iterator valid and doesn't allocate.
+    bucket->elements_.splice(bucket->elements_.begin(), old_bucket->elements_, entry.element_);
+    entry.bucket_ = bucket;
+    if (old_bucket->elements_.empty()) {
+      buckets_.erase(old_bucket);
+    }
+  }
+
+  /**
+   * Removes an indexed element from the index.
+   */
+  void remove(Entry& entry) {
+    ASSERT(entry.indexed_);
+    entry.bucket_->elements_.erase(entry.element_);
+    if (entry.bucket_->elements_.empty()) {
+      buckets_.erase(entry.bucket_);
+    }
+    entry.indexed_ = false;
+    --size_;
+  }
+
+  /**
+   * @return the element with the least remaining capacity of at least min_capacity, or nullptr if
+   *         there is none. Of several such elements, the most recently moved one is returned.
+   */
+  T* leastCapacity(int64_t min_capacity) const {
+    for (const Bucket& bucket : buckets_) {
+      if (bucket.capacity_ >= min_capacity) {
+        return bucket.elements_.front();
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @return the element with the most remaining capacity, or nullptr if the index is empty. Of
+   *         several such elements, the most recently moved one is returned.
+   */
+  T* mostCapacity() const { return buckets_.empty() ? nullptr : buckets_.back().elements_.front(); }
+
+private:
+  // Returns the bucket for the capacity, given the first bucket with at least that capacity.
+  typename BucketList::iterator bucketAt(typename BucketList::iterator bucket, int64_t capacity) {
+    if (bucket != buckets_.end() && bucket->capacity_ == capacity) {
+      return bucket;
+    }
+    return buckets_.emplace(bucket, capacity);
+  }
+
+  BucketList buckets_;
+  size_t size_{0};
+};
+
+} // namespace ConnectionPool
+} // namespace Envoy
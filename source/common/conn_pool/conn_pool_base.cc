@@ -1,5 +1,8 @@
 #include "common/conn_pool/conn_pool_base.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "common/common/assert.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/runtime/runtime_features.h"
@@ -25,16 +28,21 @@ ConnPoolImplBase::ConnPoolImplBase(
     Upstream::ClusterConnectivityState& state)
     : state_(state), host_(host), priority_(priority), dispatcher_(dispatcher),
       socket_options_(options), transport_socket_options_(transport_socket_options),
+      connection_selection_policy_(host_->cluster().connectionSelectionPolicy()),
       upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {}
 
 ConnPoolImplBase::~ConnPoolImplBase() {
   ASSERT(ready_clients_.empty());
   ASSERT(busy_clients_.empty());
   ASSERT(connecting_clients_.empty());
+  ASSERT(early_data_clients_.empty());
 }
 
 void ConnPoolImplBase::destructAllConnections() {
-  for (auto* list : {&ready_clients_, &busy_clients_, &connecting_clients_}) {
+  // Closing the connections must not prewarm new ones.
+  is_draining_for_deletion_ = true;
+  for (auto* list :
+       {&ready_clients_, &busy_clients_, &connecting_clients_, &early_data_clients_}) {
     while (!list->empty()) {
       list->front()->close();
     }
@@ -72,7 +80,7 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
   // If an Envoy user wants preconnecting for degraded upstreams this could be
   // added later via extending the preconnect config.
   if (host_->health() != Upstream::Host::Health::Healthy) {
-    return pending_streams_.size() > connecting_stream_capacity_;
+    return pending_streams_.size() > connectingStreamCapacity();
   }
 
   // Determine if we are trying to prefetch for global preconnect or local preconnect.
@@ -83,7 +91,7 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // prefetching for the next upcoming stream, which will likely be assigned to this pool.
     // We may eventually want to track preconnect_attempts to allow more preconnecting for
     // heavily weighted upstreams or sticky picks.
-    return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
+    return shouldConnect(pending_streams_.size(), num_active_streams_, connectingStreamCapacity(),
                          global_preconnect_ratio, true);
   } else {
     // Ensure this local pool has adequate connections for the given load.
@@ -91,8 +99,17 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // Local preconnect does not need to anticipate a stream. It is called as
     // new streams are established or torn down and simply attempts to maintain
     // the correct ratio of streams and anticipated capacity.
-    return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
-                         perUpstreamPreconnectRatio());
+    //
+    // If prewarming is configured, a minimum number of connections is kept ready regardless of
+    // load, and the streams expected from the recent arrival rate are provisioned for as if they
+    // were pending.
+    const size_t ready_connections =
+        ready_clients_.size() + connecting_clients_.size() + early_data_clients_.size();
+    if (!prewarm_paused_ && ready_connections < host_->cluster().minReadyConnections()) {
+      return true;
+    }
+    return shouldConnect(pending_streams_.size() + anticipatedStreams(), num_active_streams_,
+                         connectingStreamCapacity(), perUpstreamPreconnectRatio());
   }
 }
 
@@ -104,6 +121,43 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   }
 }
 
+bool ConnPoolImplBase::prewarmEnabled() const {
+  return host_->cluster().minReadyConnections() > 0 ||
+         host_->cluster().arrivalRateLookahead() > std::chrono::milliseconds::zero();
+}
+
+double ConnPoolImplBase::decayedStreamArrivalAverage(MonotonicTime now) const {
+  const std::chrono::duration<double> elapsed = now - last_stream_arrival_;
+  const std::chrono::duration<double> lookahead = host_->cluster().arrivalRateLookahead();
+  return stream_arrival_average_ * std::exp(-elapsed / lookahead);
+}
+
+void ConnPoolImplBase::recordStreamArrival() {
+  if (host_->cluster().arrivalRateLookahead() == std::chrono::milliseconds::zero()) {
+    return;
+  }
+  const MonotonicTime now = dispatcher_.approximateMonotonicTime();
+  stream_arrival_average_ = decayedStreamArrivalAverage(now) + 1;
+  last_stream_arrival_ = now;
+}
+
+uint32_t ConnPoolImplBase::anticipatedStreams() const {
+  if (prewarm_paused_ || stream_arrival_average_ == 0 ||
+      host_->cluster().arrivalRateLookahead() == std::chrono::milliseconds::zero()) {
+    return 0;
+  }
+  // With a steady arrival rate the average converges to the number of streams arriving within the
+  // lookahead, plus about half a stream.
+  return static_cast<uint32_t>(
+      decayedStreamArrivalAverage(dispatcher_.approximateMonotonicTime()));
+}
+
+void ConnPoolImplBase::maybePrewarm() {
+  if (prewarmEnabled() && !is_draining_for_deletion_) {
+    tryCreateNewConnections();
+  }
+}
+
 ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   ConnPoolImplBase::ConnectionResult result;
   // Somewhat arbitrarily cap the number of connections preconnected due to new
@@ -137,8 +191,8 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
   // If we are at the connection circuit-breaker limit due to other upstreams having
   // too many open connections, and this upstream has no connections, always create one, to
   // prevent pending streams being queued to this upstream with no way to be processed.
-  if (can_create_connection ||
-      (ready_clients_.empty() && busy_clients_.empty() && connecting_clients_.empty())) {
+  if (can_create_connection || (ready_clients_.empty() && busy_clients_.empty() &&
+                                connecting_clients_.empty() && early_data_clients_.empty())) {
     ENVOY_LOG(debug, "creating a new connection");
     ActiveClientPtr client = instantiateActiveClient();
     ASSERT(client->state_ == ActiveClient::State::CONNECTING);
@@ -159,7 +213,8 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
 
 void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient& client,
                                             AttachContext& context) {
-  ASSERT(client.state_ == Envoy::ConnectionPool::ActiveClient::State::READY);
+  ASSERT(client.state_ == Envoy::ConnectionPool::ActiveClient::State::READY ||
+         client.state_ == Envoy::ConnectionPool::ActiveClient::State::READY_FOR_EARLY_DATA);
 
   if (!host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max streams overflow");
@@ -168,6 +223,9 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
     host_->cluster().stats().upstream_rq_pending_overflow_.inc();
   } else {
     ENVOY_CONN_LOG(debug, "creating stream", client);
+    if (!client.connected_) {
+      host_->cluster().stats().upstream_rq_0rtt_.inc();
+    }
 
     client.remaining_streams_--;
     if (client.remaining_streams_ == 0) {
@@ -177,6 +235,13 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
     } else if (client.numActiveStreams() + 1 >= client.concurrent_stream_limit_) {
       // As soon as the new stream is created, the client will be maxed out.
       transitionActiveClientState(client, Envoy::ConnectionPool::ActiveClient::State::BUSY);
+    } else if (client.capacity_entry_.indexed()) {
+      // The stream is only counted by the client once it has been created, so account for it here.
+      const int64_t concurrent_capacity =
+          static_cast<int64_t>(client.concurrent_stream_limit_) - client.numActiveStreams() - 1;
+      ready_clients_by_capacity_.update(
+          client.capacity_entry_,
+          std::min<int64_t>(client.remaining_streams_, concurrent_capacity));
     }
 
     // Decrement the capacity, as there's one less stream available for serving.
@@ -215,19 +280,35 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
   if (client.state_ == ActiveClient::State::DRAINING && client.numActiveStreams() == 0) {
     // Close out the draining client if we no longer have active streams.
     client.close();
-  } else if (client.state_ == ActiveClient::State::BUSY) {
+  } else if (client.state_ == ActiveClient::State::BUSY && client.connected_) {
     transitionActiveClientState(client, ActiveClient::State::READY);
     if (!delay_attaching_stream) {
       onUpstreamReady();
     }
+  } else if (client.state_ == ActiveClient::State::BUSY) {
+    transitionActiveClientState(client, ActiveClient::State::READY_FOR_EARLY_DATA);
+    if (!delay_attaching_stream) {
+      onUpstreamReadyForEarlyData(client);
+    }
+  } else if (client.capacity_entry_.indexed()) {
+    ready_clients_by_capacity_.update(client.capacity_entry_, client.currentUnusedCapacity());
   }
 }
 
-ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context) {
+ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context,
+                                                         bool can_send_early_data) {
   ASSERT(static_cast<ssize_t>(connecting_stream_capacity_) ==
          connectingCapacity(connecting_clients_)); // O(n) debug check.
-  if (!ready_clients_.empty()) {
-    ActiveClient& client = *ready_clients_.front();
+  const bool prewarm_enabled = prewarmEnabled();
+  if (prewarm_enabled) {
+    recordStreamArrival();
+  }
+  if (!ready_clients_.empty() || (can_send_early_data && !early_data_clients_.empty())) {
+    if (prewarm_enabled) {
+      host_->cluster().stats().upstream_rq_prewarm_hit_.inc();
+    }
+    ActiveClient& client =
+        !ready_clients_.empty() ? selectReadyClient() : *early_data_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing connection", client);
     attachStreamToClient(client, context);
     // Even if there's a ready client, we may want to preconnect to handle the next incoming stream.
@@ -235,19 +316,22 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
     return nullptr;
   }
 
+  if (prewarm_enabled) {
+    host_->cluster().stats().upstream_rq_prewarm_miss_.inc();
+  }
   if (host_->cluster().resourceManager(priority_).pendingRequests().canCreate()) {
-    ConnectionPool::Cancellable* pending = newPendingStream(context);
+    ConnectionPool::Cancellable* pending = newPendingStream(context, can_send_early_data);
     ENVOY_LOG(debug, "trying to create new connection");
     ENVOY_LOG(trace, fmt::format("{}", *this));
 
-    auto old_capacity = connecting_stream_capacity_;
+    auto old_capacity = connectingStreamCapacity();
     // This must come after newPendingStream() because this function uses the
     // length of pending_streams_ to determine if a new connection is needed.
     const ConnectionResult result = tryCreateNewConnections();
     // If there is not enough connecting capacity, the only reason to not
     // increase capacity is if the connection limits are exceeded.
-    ENVOY_BUG(pending_streams_.size() <= connecting_stream_capacity_ ||
-                  connecting_stream_capacity_ > old_capacity ||
+    ENVOY_BUG(pending_streams_.size() <= connectingStreamCapacity() ||
+                  connectingStreamCapacity() > old_capacity ||
                   result == ConnectionResult::NoConnectionRateLimited,
               fmt::format("Failed to create expected connection: {}", *this));
     return pending;
@@ -270,19 +354,58 @@ void ConnPoolImplBase::scheduleOnUpstreamReady() {
 
 void ConnPoolImplBase::onUpstreamReady() {
   while (!pending_streams_.empty() && !ready_clients_.empty()) {
-    ActiveClientPtr& client = ready_clients_.front();
-    ENVOY_CONN_LOG(debug, "attaching to next stream", *client);
+    ActiveClient& client = selectReadyClient();
+    ENVOY_CONN_LOG(debug, "attaching to next stream", client);
     // Pending streams are pushed onto the front, so pull from the back.
-    attachStreamToClient(*client, pending_streams_.back()->context());
+    attachStreamToClient(client, pending_streams_.back()->context());
     state_.decrPendingStreams(1);
     pending_streams_.pop_back();
   }
 }
 
+void ConnPoolImplBase::onUpstreamReadyForEarlyData(ActiveClient& client) {
+  while (client.state_ == ActiveClient::State::READY_FOR_EARLY_DATA) {
+    // Pending streams are pushed onto the front, so search from the back.
+    auto it = std::find_if(
+        pending_streams_.rbegin(), pending_streams_.rend(),
+        [](const PendingStreamPtr& stream) { return stream->can_send_early_data_; });
+    if (it == pending_streams_.rend()) {
+      return;
+    }
+    ENVOY_CONN_LOG(debug, "attaching to next early data stream", client);
+    PendingStreamPtr stream = (*it)->removeFromList(pending_streams_);
+    state_.decrPendingStreams(1);
+    attachStreamToClient(client, stream->context());
+  }
+}
+
+uint32_t ConnPoolImplBase::connectingStreamCapacity() const {
+  uint32_t capacity = connecting_stream_capacity_;
+  for (const auto& client : early_data_clients_) {
+    capacity += std::max<int64_t>(client->currentUnusedCapacity(), 0);
+  }
+  return capacity;
+}
+
+ActiveClient& ConnPoolImplBase::selectReadyClient() {
+  ASSERT(!ready_clients_.empty());
+  ActiveClient* client = nullptr;
+  if (connection_selection_policy_ == envoy::config::cluster::v3::Cluster::PACK) {
+    client = ready_clients_by_capacity_.leastCapacity(1);
+  } else if (connection_selection_policy_ == envoy::config::cluster::v3::Cluster::SPREAD) {
+    client = ready_clients_by_capacity_.mostCapacity();
+  }
+  // Clients may be ready without unused capacity if the peer lowered its concurrent stream limit.
+  // Fall back to the most recently ready client as the pool does without an index.
+  return client != nullptr ? *client : *ready_clients_.front();
+}
+
 std::list<ActiveClientPtr>& ConnPoolImplBase::owningList(ActiveClient::State state) {
   switch (state) {
   case ActiveClient::State::CONNECTING:
     return connecting_clients_;
+  case ActiveClient::State::READY_FOR_EARLY_DATA:
+    return early_data_clients_;
   case ActiveClient::State::READY:
     return ready_clients_;
   case ActiveClient::State::BUSY:
@@ -299,6 +422,13 @@ void ConnPoolImplBase::transitionActiveClientState(ActiveClient& client,
                                                    ActiveClient::State new_state) {
   auto& old_list = owningList(client.state_);
   auto& new_list = owningList(new_state);
+  if (client.capacity_entry_.indexed()) {
+    ready_clients_by_capacity_.remove(client.capacity_entry_);
+  }
+  if (new_state == ActiveClient::State::READY && indexReadyClients()) {
+    ready_clients_by_capacity_.insert(client, client.capacity_entry_,
+                                      client.currentUnusedCapacity());
+  }
   client.state_ = new_state;
 
   // old_list and new_list can be equal when transitioning from BUSY to DRAINING.
@@ -311,7 +441,21 @@ void ConnPoolImplBase::transitionActiveClientState(ActiveClient& client,
   }
 }
 
+ActiveClientPtr ConnPoolImplBase::removeClient(ActiveClient& client) {
+  if (client.capacity_entry_.indexed()) {
+    ready_clients_by_capacity_.remove(client.capacity_entry_);
+  }
+  return client.removeFromList(owningList(client.state_));
+}
+
+void ConnPoolImplBase::onClientCapacityChanged(ActiveClient& client) {
+  if (client.capacity_entry_.indexed()) {
+    ready_clients_by_capacity_.update(client.capacity_entry_, client.currentUnusedCapacity());
+  }
+}
+
 void ConnPoolImplBase::addDrainedCallbackImpl(Instance::DrainedCb cb) {
+  is_draining_for_deletion_ = true;
   drained_callbacks_.push_back(cb);
   checkForDrained();
 }
@@ -330,6 +474,11 @@ void ConnPoolImplBase::closeIdleConnectionsForDrainingPool() {
     for (auto& client : connecting_clients_) {
       to_close.push_back(client.get());
     }
+    for (auto& client : early_data_clients_) {
+      if (client->numActiveStreams() == 0) {
+        to_close.push_back(client.get());
+      }
+    }
   }
 
   for (auto& entry : to_close) {
@@ -347,6 +496,15 @@ void ConnPoolImplBase::drainConnectionsImpl() {
     transitionActiveClientState(*ready_clients_.front(), ActiveClient::State::DRAINING);
   }
 
+  // Clients sending early data without streams are kept for the pending streams, so only drain
+  // the ones serving streams.
+  for (auto it = early_data_clients_.begin(); it != early_data_clients_.end();) {
+    ActiveClient& client = **it++;
+    if (client.numActiveStreams() > 0) {
+      transitionActiveClientState(client, ActiveClient::State::DRAINING);
+    }
+  }
+
   // Changing busy_clients_ to DRAINING does not move them between lists,
   // so use a for-loop since the list is not mutated.
   ASSERT(&owningList(ActiveClient::State::DRAINING) == &busy_clients_);
@@ -363,7 +521,7 @@ void ConnPoolImplBase::checkForDrained() {
   closeIdleConnectionsForDrainingPool();
 
   if (pending_streams_.empty() && ready_clients_.empty() && busy_clients_.empty() &&
-      connecting_clients_.empty()) {
+      connecting_clients_.empty() && early_data_clients_.empty()) {
     ENVOY_LOG(debug, "invoking drained callbacks");
     for (const Instance::DrainedCb& cb : drained_callbacks_) {
       cb();
@@ -378,6 +536,17 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     connecting_stream_capacity_ -= client.effectiveConcurrentStreamLimit();
   }
 
+  if (event == Network::ConnectionEvent::ConnectedZeroRtt) {
+    // The handshake is still in progress, so the connect timer keeps running. The unused capacity
+    // of the client still counts towards the connecting stream capacity until it is connected.
+    ENVOY_CONN_LOG(debug, "ready for early data", client);
+    ASSERT(client.state_ == ActiveClient::State::CONNECTING);
+    transitionActiveClientState(client, ActiveClient::State::READY_FOR_EARLY_DATA);
+    onUpstreamReadyForEarlyData(client);
+    checkForDrained();
+    return;
+  }
+
   if (client.connect_timer_) {
     client.connect_timer_->disableTimer();
     client.connect_timer_.reset();
@@ -397,9 +566,13 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
     }
 
-    if (client.state_ == ActiveClient::State::CONNECTING) {
+    // Excess connecting clients are drained before they are closed, so don't count clients that
+    // were drained before they connected as failures.
+    if (!client.connected_ && client.state_ != ActiveClient::State::DRAINING) {
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
+      // Don't keep reconnecting to a host that fails connections for streams that may never come.
+      prewarm_paused_ = true;
 
       ConnectionPool::PoolFailureReason reason;
       if (client.timed_out_) {
@@ -427,7 +600,7 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     // this forces part of its cleanup to happen now.
     client.releaseResources();
 
-    dispatcher_.deferredDelete(client.removeFromList(owningList(client.state_)));
+    dispatcher_.deferredDelete(removeClient(client));
     if (incomplete_stream) {
       checkForDrained();
     }
@@ -437,22 +610,34 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     // If we have pending streams and we just lost a connection we should make a new one.
     if (!pending_streams_.empty()) {
       tryCreateNewConnections();
+    } else {
+      // Replace the connection if it was needed to keep connections ready ahead of demand.
+      maybePrewarm();
     }
   } else if (event == Network::ConnectionEvent::Connected) {
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
-    ASSERT(client.state_ == ActiveClient::State::CONNECTING);
-    transitionActiveClientState(client, ActiveClient::State::READY);
+    client.connected_ = true;
+    // Clients which were sent early data may already be BUSY or DRAINING.
+    ASSERT(client.state_ != ActiveClient::State::READY);
+    if (client.state_ == ActiveClient::State::CONNECTING ||
+        client.state_ == ActiveClient::State::READY_FOR_EARLY_DATA) {
+      transitionActiveClientState(client, ActiveClient::State::READY);
+    }
+    prewarm_paused_ = false;
 
     // At this point, for the mixed ALPN pool, the client may be deleted. Do not
     // refer to client after this point.
     onConnected(client);
     onUpstreamReady();
+    // Attaching pending streams may have left fewer ready connections than configured.
+    maybePrewarm();
     checkForDrained();
   }
 }
 
-PendingStream::PendingStream(ConnPoolImplBase& parent) : parent_(parent) {
+PendingStream::PendingStream(ConnPoolImplBase& parent, bool can_send_early_data)
+    : parent_(parent), can_send_early_data_(can_send_early_data) {
   parent_.host()->cluster().stats().upstream_rq_pending_total_.inc();
   parent_.host()->cluster().stats().upstream_rq_pending_active_.inc();
   parent_.host()->cluster().resourceManager(parent_.priority()).pendingRequests().inc();
@@ -485,6 +670,11 @@ void ConnPoolImplBase::purgePendingStreams(
 bool ConnPoolImplBase::connectingConnectionIsExcess() const {
   ASSERT(connecting_stream_capacity_ >=
          connecting_clients_.front()->effectiveConcurrentStreamLimit());
+  // Connections kept ready ahead of demand are never excess.
+  if (ready_clients_.size() + connecting_clients_.size() + early_data_clients_.size() <=
+      host_->cluster().minReadyConnections()) {
+    return false;
+  }
   // If perUpstreamPreconnectRatio is one, this simplifies to checking if there would still be
   // sufficient connecting stream capacity to serve all pending streams if the most recent client
   // were removed from the picture.
@@ -492,8 +682,9 @@ bool ConnPoolImplBase::connectingConnectionIsExcess() const {
   // If preconnect ratio is set, it also factors in the anticipated load based on both queued
   // streams and active streams, and makes sure the connecting capacity would still be sufficient to
   // serve that even with the most recent client removed.
-  return (pending_streams_.size() + num_active_streams_) * perUpstreamPreconnectRatio() <=
-         (connecting_stream_capacity_ -
+  return (pending_streams_.size() + anticipatedStreams() + num_active_streams_) *
+             perUpstreamPreconnectRatio() <=
+         (connectingStreamCapacity() -
           connecting_clients_.front()->effectiveConcurrentStreamLimit() + num_active_streams_);
 }
 
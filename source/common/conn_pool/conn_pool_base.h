@@ -8,6 +8,7 @@
 
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
+#include "common/conn_pool/capacity_index.h"
 
 #include "absl/strings/string_view.h"
 
@@ -77,6 +78,9 @@ public:
 
   enum class State {
     CONNECTING, // Connection is not yet established.
+    // Connection is not yet established, but streams that may be sent as early data may be
+    // immediately dispatched to this connection.
+    READY_FOR_EARLY_DATA,
     READY,      // Additional streams may be immediately dispatched to this connection.
     BUSY,       // Connection is at its concurrent stream limit.
     DRAINING,   // No more streams can be dispatched to this connection, and it will be closed
@@ -92,15 +96,20 @@ public:
   Stats::TimespanPtr conn_connect_ms_;
   Stats::TimespanPtr conn_length_;
   Event::TimerPtr connect_timer_;
+  // The position of the client in the pool's index of ready clients, if the pool maintains one.
+  CapacityIndex<ActiveClient>::Entry capacity_entry_;
   bool resources_released_{false};
   bool timed_out_{false};
+  // Set once the connection is established. Streams may be attached before that to connections
+  // which can send early data.
+  bool connected_{false};
 };
 
 // PendingStream is the base class tracking streams for which a connection has been created but not
 // yet established.
 class PendingStream : public LinkedObject<PendingStream>, public ConnectionPool::Cancellable {
 public:
-  PendingStream(ConnPoolImplBase& parent);
+  PendingStream(ConnPoolImplBase& parent, bool can_send_early_data);
   ~PendingStream() override;
 
   // ConnectionPool::Cancellable
@@ -111,6 +120,8 @@ public:
   virtual AttachContext& context() PURE;
 
   ConnPoolImplBase& parent_;
+  // True if the stream may be sent as early data, i.e. it is safe to replay.
+  const bool can_send_early_data_;
 };
 
 using PendingStreamPtr = std::unique_ptr<PendingStream>;
@@ -158,6 +169,9 @@ public:
   // Gets a pointer to the list that currently owns this client.
   std::list<ActiveClientPtr>& owningList(ActiveClient::State state);
 
+  // Removes the client from the list that currently owns it, and from the index of ready clients.
+  ActiveClientPtr removeClient(ActiveClient& client);
+
   // Removes the PendingStream from the list of streams. Called when the PendingStream is
   // cancelled, e.g. when the stream is reset before a connection has been established.
   void onPendingStreamCancel(PendingStream& stream, Envoy::ConnectionPool::CancelPolicy policy);
@@ -173,16 +187,23 @@ public:
   // Changes the state_ of an ActiveClient and moves to the appropriate list.
   void transitionActiveClientState(ActiveClient& client, ActiveClient::State new_state);
 
+  // Called when the unused capacity of a client changed other than by a stream being attached to
+  // or closed on it, e.g. when the peer lowered its concurrent stream limit.
+  void onClientCapacityChanged(ActiveClient& client);
+
   void onConnectionEvent(ActiveClient& client, absl::string_view failure_reason,
                          Network::ConnectionEvent event);
   // See if the drain process has started and/or completed.
   void checkForDrained();
   void scheduleOnUpstreamReady();
-  ConnectionPool::Cancellable* newStream(AttachContext& context);
+  // If can_send_early_data is true, the stream may be attached to a connection that is still
+  // completing its handshake and sent as early data.
+  ConnectionPool::Cancellable* newStream(AttachContext& context, bool can_send_early_data = false);
   // Called if this pool is likely to be picked soon, to determine if it's worth preconnecting.
   bool maybePreconnect(float global_preconnect_ratio);
 
-  virtual ConnectionPool::Cancellable* newPendingStream(AttachContext& context) PURE;
+  virtual ConnectionPool::Cancellable* newPendingStream(AttachContext& context,
+                                                        bool can_send_early_data) PURE;
 
   virtual void attachStreamToClient(Envoy::ConnectionPool::ActiveClient& client,
                                     AttachContext& context);
@@ -212,7 +233,7 @@ public:
     os << spaces << "ConnPoolImplBase " << this << DUMP_MEMBER(ready_clients_.size())
        << DUMP_MEMBER(busy_clients_.size()) << DUMP_MEMBER(connecting_clients_.size())
        << DUMP_MEMBER(connecting_stream_capacity_) << DUMP_MEMBER(num_active_streams_)
-       << DUMP_MEMBER(pending_streams_.size())
+       << DUMP_MEMBER(pending_streams_.size()) << DUMP_MEMBER(early_data_clients_.size())
        << " per upstream preconnect ratio: " << perUpstreamPreconnectRatio();
   }
 
@@ -251,6 +272,20 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // Returns true if connections are established ahead of demand, either to keep a minimum number
+  // of ready connections or for the streams anticipated from the recent stream arrival rate.
+  bool prewarmEnabled() const;
+
+  // Records a new stream in the moving average of the stream arrival rate.
+  void recordStreamArrival();
+
+  // Returns the number of streams expected to arrive within the cluster's arrival rate lookahead.
+  uint32_t anticipatedStreams() const;
+
+  // Creates connections if the pool has fewer ready connections than configured, or fewer than
+  // needed for the anticipated streams, unless the pool is being drained for deletion.
+  void maybePrewarm();
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -295,16 +330,52 @@ protected:
   // Clients that are not ready to handle additional streams because they are CONNECTING.
   std::list<ActiveClientPtr> connecting_clients_;
 
+  // Clients that are not yet connected, but can serve streams that may be sent as early data.
+  // All entries are in state READY_FOR_EARLY_DATA.
+  std::list<ActiveClientPtr> early_data_clients_;
+
   // The number of streams that can be immediately dispatched
   // if all CONNECTING connections become connected.
   uint32_t connecting_stream_capacity_{0};
 
 private:
+  // Returns the ready client that the next stream is attached to, according to the cluster's
+  // connection selection policy.
+  ActiveClient& selectReadyClient();
+  // Returns the number of streams that can be dispatched once the connections which are not yet
+  // established become connected, including the unused capacity of those sending early data.
+  uint32_t connectingStreamCapacity() const;
+  // Attaches the pending streams which may be sent as early data to the client.
+  void onUpstreamReadyForEarlyData(ActiveClient& client);
+  // Returns true if the ready clients are indexed by their unused capacity.
+  bool indexReadyClients() const {
+    return connection_selection_policy_ !=
+           envoy::config::cluster::v3::Cluster::MOST_RECENTLY_READY;
+  }
+
+  const envoy::config::cluster::v3::Cluster::ConnectionSelectionPolicy connection_selection_policy_;
+  // The ready clients indexed by their unused capacity, unless streams are attached to the most
+  // recently ready client, which is simply the front of ready_clients_.
+  CapacityIndex<ActiveClient> ready_clients_by_capacity_;
+
   std::list<PendingStreamPtr> pending_streams_;
 
   // The number of streams currently attached to clients.
   uint32_t num_active_streams_{0};
 
+  // The moving average of the number of streams arriving within the cluster's arrival rate
+  // lookahead, as of last_stream_arrival_. It decays exponentially with the lookahead as the time
+  // constant, and each new stream adds one to it.
+  double stream_arrival_average_{0};
+  MonotonicTime last_stream_arrival_;
+
+  // Set once the pool is being drained for deletion, after which no connections are prewarmed.
+  bool is_draining_for_deletion_{false};
+  // Set when a connection attempt fails, and cleared once a connection is established. Connections
+  // are only created for pending and active streams in the meantime.
+  bool prewarm_paused_{false};
+
+  double decayedStreamArrivalAverage(MonotonicTime now) const;
   void onUpstreamReady();
   Event::SchedulableCallbackPtr upstream_ready_cb_;
 };
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -40,6 +41,10 @@
 namespace Envoy {
 namespace Event {
 
+namespace {
+const char SlowCallbackThresholdKey[] = "envoy.dispatcher.slow_callback_threshold_ms";
+} // namespace
+
 DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
                                Event::TimeSystem& time_system)
     : DispatcherImpl(name, api, time_system, {}) {}
@@ -72,8 +77,10 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
   ASSERT(!name_.empty());
   FatalErrorHandler::registerFatalErrorHandler(*this);
   updateApproximateMonotonicTimeInternal();
-  base_scheduler_.registerOnPrepareCallback(
-      std::bind(&DispatcherImpl::updateApproximateMonotonicTime, this));
+  base_scheduler_.registerOnPrepareCallback([this]() {
+    updateApproximateMonotonicTime();
+    updateSlowCallbackThreshold();
+  });
 }
 
 DispatcherImpl::~DispatcherImpl() {
@@ -97,7 +104,9 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
   post([this, &scope, effective_prefix] {
     stats_prefix_ = effective_prefix + "dispatcher";
     stats_ = std::make_unique<DispatcherStats>(
-        DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
+        DispatcherStats{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
+    updateSlowCallbackThreshold();
     base_scheduler_.initializeStats(stats_.get());
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
@@ -129,7 +138,7 @@ void DispatcherImpl::clearDeferredDeleteList() {
   // destroy in FIFO order so just do it manually. This required 2 passes over the vector which is
   // not optimal but can be cleaned up later if needed.
   for (size_t i = 0; i < num_to_delete; i++) {
-    (*to_delete)[i].reset();
+    runCallback(CallbackType::DeferredDelete, [to_delete, i]() { (*to_delete)[i].reset(); });
   }
 
   to_delete->clear();
@@ -187,7 +196,7 @@ FileEventPtr DispatcherImpl::createFileEvent(os_fd_t fd, FileReadyCb cb, FileTri
       *this, fd,
       [this, cb](uint32_t events) {
         touchWatchdog();
-        cb(events);
+        runCallback(CallbackType::FileEvent, [&cb, events]() { cb(events); });
       },
       trigger, events)};
 }
@@ -229,11 +238,20 @@ TimerPtr DispatcherImpl::createScaledTimer(ScaledTimerMinimum minimum, TimerCb c
   return scaled_timer_manager_->createTimer(minimum, std::move(cb));
 }
 
+TimerPtr DispatcherImpl::createCoarseTimer(std::chrono::milliseconds granularity, TimerCb cb) {
+  ASSERT(isThreadSafe());
+  TimerWheelPtr& wheel = timer_wheels_[granularity.count()];
+  if (wheel == nullptr) {
+    wheel = std::make_unique<TimerWheel>(*this, granularity);
+  }
+  return wheel->createTimer(std::move(cb));
+}
+
 Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::function<void()> cb) {
   ASSERT(isThreadSafe());
   return base_scheduler_.createSchedulableCallback([this, cb]() {
     touchWatchdog();
-    cb();
+    runCallback(CallbackType::SchedulableCallback, cb);
   });
 }
 
@@ -241,7 +259,7 @@ TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
   return scheduler_->createTimer(
       [this, cb]() {
         touchWatchdog();
-        cb();
+        runCallback(CallbackType::Timer, cb);
       },
       *this);
 }
@@ -339,6 +357,15 @@ void DispatcherImpl::updateApproximateMonotonicTimeInternal() {
   approximate_monotonic_time_ = api_.timeSource().monotonicTime();
 }
 
+void DispatcherImpl::updateSlowCallbackThreshold() {
+  // Callbacks are only timed once stats are initialized. Reading the threshold once per event loop
+  // iteration picks up runtime changes without a runtime lookup per callback.
+  if (stats_ != nullptr && Runtime::LoaderSingleton::getExisting() != nullptr) {
+    slow_callback_threshold_ =
+        std::chrono::milliseconds(Runtime::getInteger(SlowCallbackThresholdKey, 0));
+  }
+}
+
 void DispatcherImpl::runThreadLocalDelete() {
   std::list<DispatcherThreadDeletableConstPtr> to_be_delete;
   {
@@ -377,20 +404,57 @@ void DispatcherImpl::runPostCallbacks() {
     // executing a long list of callbacks.
     touchWatchdog();
     // Run the callback.
-    callbacks.front()();
+    runCallback(CallbackType::PostCallback, callbacks.front());
     // Pop the front so that the destructor of the callback that just executed runs before the next
     // callback executes.
     callbacks.pop_front();
   }
 }
 
+void DispatcherImpl::finishCallback(CallbackType type) {
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      api_.timeSource().monotonicTime() - *callback_start_);
+  callback_start_.reset();
+  callbackHistogram(type).recordValue(duration.count());
+  if (slow_callback_threshold_.count() > 0 && duration >= slow_callback_threshold_) {
+    stats_->slow_callbacks_.inc();
+    static constexpr const char* type_names[] = {"deferred delete", "file event", "post callback",
+                                                 "schedulable callback", "timer"};
+    ENVOY_LOG_PERIODIC(warn, std::chrono::seconds(1), "{}: slow {} took {}us{}{}", stats_prefix_,
+                       type_names[static_cast<int>(type)], duration.count(),
+                       slow_callback_state_.empty() ? "" : ", while processing:\n",
+                       slow_callback_state_);
+  }
+  slow_callback_state_.clear();
+}
+
+Stats::Histogram& DispatcherImpl::callbackHistogram(CallbackType type) {
+  switch (type) {
+  case CallbackType::DeferredDelete:
+    return stats_->deferred_delete_us_;
+  case CallbackType::FileEvent:
+    return stats_->file_event_us_;
+  case CallbackType::PostCallback:
+    return stats_->post_callback_us_;
+  case CallbackType::SchedulableCallback:
+    return stats_->schedulable_callback_us_;
+  case CallbackType::Timer:
+    return stats_->timer_us_;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void DispatcherImpl::dumpTrackedObjects(std::ostream& os) const {
+  for (auto iter = tracked_object_stack_.rbegin(); iter != tracked_object_stack_.rend(); ++iter) {
+    (*iter)->dumpState(os);
+  }
+}
+
 void DispatcherImpl::onFatalError(std::ostream& os) const {
   // Dump the state of the tracked objects in the dispatcher if thread safe. This generally
   // results in dumping the active state only for the thread which caused the fatal error.
   if (isThreadSafe()) {
-    for (auto iter = tracked_object_stack_.rbegin(); iter != tracked_object_stack_.rend(); ++iter) {
-      (*iter)->dumpState(os);
-    }
+    dumpTrackedObjects(os);
   }
 }
 
@@ -425,6 +489,17 @@ void DispatcherImpl::popTrackedObject(const ScopeTrackedObject* expected_object)
   ASSERT(expected_object != nullptr);
   RELEASE_ASSERT(!tracked_object_stack_.empty(), "Tracked Object Stack is empty, nothing to pop!");
 
+  // A callback's duration is only known once it returns, after it has popped its tracked objects,
+  // so they are dumped here if the callback has already run for longer than the slow callback
+  // threshold.
+  if (slow_callback_threshold_.count() > 0 && callback_start_.has_value() &&
+      slow_callback_state_.empty() &&
+      api_.timeSource().monotonicTime() - *callback_start_ >= slow_callback_threshold_) {
+    std::ostringstream state;
+    dumpTrackedObjects(state);
+    slow_callback_state_ = state.str();
+  }
+
   const ScopeTrackedObject* top = tracked_object_stack_.back();
   tracked_object_stack_.pop_back();
   ASSERT(top == expected_object,
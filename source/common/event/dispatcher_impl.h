@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -18,9 +19,12 @@
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
+#include "common/event/timer_wheel.h"
 #include "common/signal/fatal_error_handler.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Event {
@@ -81,6 +85,7 @@ public:
   TimerPtr createTimer(TimerCb cb) override;
   TimerPtr createScaledTimer(ScaledTimerType timer_type, TimerCb cb) override;
   TimerPtr createScaledTimer(ScaledTimerMinimum minimum, TimerCb cb) override;
+  TimerPtr createCoarseTimer(std::chrono::milliseconds granularity, TimerCb cb) override;
 
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
@@ -127,10 +132,30 @@ private:
   };
   using WatchdogRegistrationPtr = std::unique_ptr<WatchdogRegistration>;
 
+  // The kinds of callbacks whose durations are recorded separately once stats are initialized.
+  enum class CallbackType { DeferredDelete, FileEvent, PostCallback, SchedulableCallback, Timer };
+
+  // Runs a callback, recording its duration in the stats for its type if stats are initialized.
+  // Callbacks run from within another callback, e.g. deferred deletes run by a destructor that
+  // clears the deferred delete list, are part of the duration of the outermost callback only.
+  template <class Callback> void runCallback(CallbackType type, const Callback& callback) {
+    if (stats_ == nullptr || callback_start_.has_value()) {
+      callback();
+      return;
+    }
+    callback_start_ = api_.timeSource().monotonicTime();
+    callback();
+    finishCallback(type);
+  }
+  void finishCallback(CallbackType type);
+  Stats::Histogram& callbackHistogram(CallbackType type);
+  void dumpTrackedObjects(std::ostream& os) const;
+
   TimerPtr createTimerInternal(TimerCb cb);
   void updateApproximateMonotonicTimeInternal();
   void runPostCallbacks();
   void runThreadLocalDelete();
+  void updateSlowCallbackThreshold();
 
   // Helper used to touch the watchdog after most schedulable, fd, and timer callbacks.
   void touchWatchdog();
@@ -146,6 +171,13 @@ private:
   Api::Api& api_;
   std::string stats_prefix_;
   DispatcherStatsPtr stats_;
+  // Callbacks running for at least this long are logged, unless it is zero. It is read from runtime
+  // at the start of each event loop iteration once stats are initialized.
+  std::chrono::milliseconds slow_callback_threshold_{};
+  // The start of the running outermost callback, only set once stats are initialized.
+  absl::optional<MonotonicTime> callback_start_;
+  // The tracked objects being processed when the running callback reached the threshold.
+  std::string slow_callback_state_;
   Thread::ThreadId run_tid_;
   Buffer::WatermarkFactorySharedPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
@@ -173,6 +205,9 @@ private:
   bool deferred_deleting_{};
   MonotonicTime approximate_monotonic_time_;
   WatchdogRegistrationPtr watchdog_registration_;
+  // Timing wheels backing the coarse timers, keyed by granularity in milliseconds. These are
+  // declared before scaled_timer_manager_ since scaled timers may be backed by coarse timers.
+  absl::flat_hash_map<std::chrono::milliseconds::rep, TimerWheelPtr> timer_wheels_;
   const ScaledRangeTimerManagerPtr scaled_timer_manager_;
 };
 
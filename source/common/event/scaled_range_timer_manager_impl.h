@@ -20,12 +20,18 @@ namespace Event {
  * expectation is that the number of (max - min) values used to enable timers is small, so the
  * number of queues is tightly bounded. The queue-based implementation depends on that expectation
  * for efficient operation.
+ *
+ * Every enabled timer that has a min duration also arms a timer of its own for that duration. If a
+ * non-zero min timer granularity is given, these are coarse timers backed by a timing wheel of
+ * that granularity, at the cost of reaching the min duration up to one granularity late.
  */
 class ScaledRangeTimerManagerImpl : public ScaledRangeTimerManager {
 public:
-  // Takes a Dispatcher and a map from timer type to scaled minimum value.
-  ScaledRangeTimerManagerImpl(Dispatcher& dispatcher,
-                              const ScaledTimerTypeMapConstSharedPtr& timer_minimums = nullptr);
+  // Takes a Dispatcher, a map from timer type to scaled minimum value and the granularity of the
+  // min duration timers, or zero to use precise timers.
+  ScaledRangeTimerManagerImpl(
+      Dispatcher& dispatcher, const ScaledTimerTypeMapConstSharedPtr& timer_minimums = nullptr,
+      std::chrono::milliseconds min_timer_granularity = std::chrono::milliseconds::zero());
   ~ScaledRangeTimerManagerImpl() override;
 
   // ScaledRangeTimerManager impl
@@ -114,6 +120,8 @@ private:
                                           std::chrono::milliseconds duration,
                                           UnitFloat scale_factor);
 
+  TimerPtr createMinDurationTimer(TimerCb callback);
+
   ScalingTimerHandle activateTimer(std::chrono::milliseconds duration, RangeTimerImpl& timer);
 
   void removeTimer(ScalingTimerHandle handle);
@@ -124,6 +132,7 @@ private:
 
   Dispatcher& dispatcher_;
   const ScaledTimerTypeMapConstSharedPtr timer_minimums_;
+  const std::chrono::milliseconds min_timer_granularity_;
   UnitFloat scale_factor_;
   absl::flat_hash_set<std::unique_ptr<Queue>, Hash, Eq> queues_;
 };
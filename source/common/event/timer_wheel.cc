@@ -0,0 +1,223 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/scope_tracker.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerWheel::WheelTimerImpl final : public Timer {
+public:
+  WheelTimerImpl(TimerWheel& wheel, TimerCb cb) : wheel_(wheel), cb_(std::move(cb)) {
+    ASSERT(cb_);
+  }
+  ~WheelTimerImpl() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override { wheel_.disable(*this); }
+  void enableTimer(std::chrono::milliseconds ms, const ScopeTrackedObject* object) override {
+    wheel_.enable(*this, ms, object);
+  }
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* object) override {
+    wheel_.enable(*this, us, object);
+  }
+  bool enabled() override { return enabled_; }
+
+private:
+  friend class TimerWheel;
+
+  TimerWheel& wheel_;
+  const TimerCb cb_;
+  const ScopeTrackedObject* object_{};
+  // The tick at which the timer expires.
+  uint64_t expiry_tick_{0};
+  // The slot the timer is linked into while it is enabled.
+  WheelTimerImpl* prev_{};
+  WheelTimerImpl* next_{};
+  uint32_t level_{0};
+  uint32_t slot_{0};
+  bool enabled_{false};
+};
+
+TimerWheel::TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds granularity)
+    : dispatcher_(dispatcher), granularity_(granularity),
+      start_time_(dispatcher.timeSource().monotonicTime()),
+      tick_timer_(dispatcher.createTimer([this]() { onTick(); })) {
+  ASSERT(granularity_ > std::chrono::milliseconds::zero());
+}
+
+TimerWheel::~TimerWheel() { ASSERT(enabled_timers_ == 0); }
+
+TimerPtr TimerWheel::createTimer(TimerCb cb) {
+  return std::make_unique<WheelTimerImpl>(*this, std::move(cb));
+}
+
+uint64_t TimerWheel::ticksAt(MonotonicTime time, bool round_up) const {
+  const auto elapsed = std::max(time - start_time_, MonotonicTime::duration::zero());
+  const auto granularity = std::chrono::duration_cast<MonotonicTime::duration>(granularity_);
+  uint64_t ticks = elapsed / granularity;
+  if (round_up && elapsed % granularity != MonotonicTime::duration::zero()) {
+    ++ticks;
+  }
+  return ticks;
+}
+
+void TimerWheel::enable(WheelTimerImpl& timer, std::chrono::microseconds duration,
+                        const ScopeTrackedObject* object) {
+  ASSERT(dispatcher_.isThreadSafe());
+  ASSERT(duration >= std::chrono::microseconds::zero());
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (timer.enabled_) {
+    unlink(timer);
+  } else {
+    if (enabled_timers_ == 0 && !processing_) {
+      // The wheel stops ticking while it is empty, so catch up with the current time.
+      current_tick_ = std::max(current_tick_, ticksAt(now, false));
+    }
+    ++enabled_timers_;
+  }
+
+  timer.enabled_ = true;
+  timer.object_ = object;
+  timer.expiry_tick_ = std::max(ticksAt(now + duration, true), current_tick_ + 1);
+  insert(timer);
+
+  if (!processing_ && (!tick_timer_->enabled() || timer.expiry_tick_ < scheduled_tick_)) {
+    scheduleAt(timer.expiry_tick_);
+  }
+}
+
+void TimerWheel::disable(WheelTimerImpl& timer) {
+  ASSERT(dispatcher_.isThreadSafe());
+  if (!timer.enabled_) {
+    return;
+  }
+  unlink(timer);
+  timer.enabled_ = false;
+  timer.object_ = nullptr;
+  --enabled_timers_;
+  // The underlying timer is left armed; if the wheel is empty by then it is disabled on the next
+  // tick, which is cheaper than re-arming it on every disable.
+}
+
+void TimerWheel::insert(WheelTimerImpl& timer) {
+  uint32_t level = 0;
+  uint32_t slot;
+  if (((timer.expiry_tick_ ^ current_tick_) >> (SlotBits * Levels)) != 0) {
+    // Beyond the range of the wheel. Park the timer in the first slot of the top level, which is
+    // cascaded the next time the top level wraps around, and re-insert it from there.
+    level = Levels - 1;
+    slot = 0;
+  } else {
+    // Use the lowest level below which the expiry tick and the current tick share all digits, so
+    // the slot is reached, and cascaded to lower levels, before the timer expires.
+    while (level < Levels - 1 &&
+           ((timer.expiry_tick_ ^ current_tick_) >> (SlotBits * (level + 1))) != 0) {
+      ++level;
+    }
+    slot = static_cast<uint32_t>(timer.expiry_tick_ >> (SlotBits * level)) & SlotMask;
+  }
+
+  WheelTimerImpl*& head = slots_[level][slot];
+  timer.level_ = level;
+  timer.slot_ = slot;
+  timer.prev_ = nullptr;
+  timer.next_ = head;
+  if (head != nullptr) {
+    head->prev_ = &timer;
+  }
+  head = &timer;
+}
+
+void TimerWheel::unlink(WheelTimerImpl& timer) {
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    slots_[timer.level_][timer.slot_] = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  }
+  timer.prev_ = nullptr;
+  timer.next_ = nullptr;
+}
+
+void TimerWheel::onTick() {
+  ASSERT(!processing_);
+  processing_ = true;
+  const uint64_t now_tick = ticksAt(dispatcher_.timeSource().monotonicTime(), false);
+  while (current_tick_ < now_tick) {
+    if (enabled_timers_ == 0) {
+      current_tick_ = now_tick;
+      break;
+    }
+    ++current_tick_;
+    processTick();
+  }
+  processing_ = false;
+  scheduleNextTick();
+}
+
+void TimerWheel::processTick() {
+  // Cascade the timers of every level that wrapped around on this tick, starting with the top
+  // level so that timers can move down more than one level in a single tick.
+  for (uint32_t level = Levels - 1; level > 0; --level) {
+    const uint32_t shift = SlotBits * level;
+    if ((current_tick_ & ((uint64_t(1) << shift) - 1)) != 0) {
+      continue;
+    }
+    WheelTimerImpl*& head = slots_[level][(current_tick_ >> shift) & SlotMask];
+    WheelTimerImpl* timer = head;
+    head = nullptr;
+    while (timer != nullptr) {
+      WheelTimerImpl* next = timer->next_;
+      insert(*timer);
+      timer = next;
+    }
+  }
+
+  // Timers are unlinked one at a time since the callbacks may disable or destroy other timers
+  // expiring on the same tick. Timers enabled by the callbacks always land in later slots.
+  WheelTimerImpl*& head = slots_[0][current_tick_ & SlotMask];
+  while (head != nullptr) {
+    WheelTimerImpl& timer = *head;
+    ASSERT(timer.expiry_tick_ == current_tick_);
+    unlink(timer);
+    timer.enabled_ = false;
+    --enabled_timers_;
+    if (timer.object_ == nullptr) {
+      timer.cb_();
+    } else {
+      ScopeTrackerScopeState scope(timer.object_, dispatcher_);
+      timer.object_ = nullptr;
+      timer.cb_();
+    }
+  }
+}
+
+void TimerWheel::scheduleNextTick() {
+  if (enabled_timers_ == 0) {
+    tick_timer_->disableTimer();
+    return;
+  }
+  for (uint64_t tick = current_tick_ + 1;; ++tick) {
+    if ((tick & SlotMask) == 0 || slots_[0][tick & SlotMask] != nullptr) {
+      scheduleAt(tick);
+      return;
+    }
+  }
+}
+
+void TimerWheel::scheduleAt(uint64_t tick) {
+  scheduled_tick_ = tick;
+  const MonotonicTime deadline = start_time_ + granularity_ * static_cast<int64_t>(tick);
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  tick_timer_->enableHRTimer(
+      deadline > now ? std::chrono::ceil<std::chrono::microseconds>(deadline - now)
+                     : std::chrono::microseconds::zero());
+}
+
+} // namespace Event
+} // namespace Envoy
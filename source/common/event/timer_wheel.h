@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A hierarchical timing wheel that multiplexes any number of coarse timers onto a single Timer
+ * from the dispatcher. Time is divided into ticks of the configured granularity, and each timer is
+ * placed into a slot of the wheel level that covers its remaining number of ticks. Enabling or
+ * disabling a timer only links or unlinks it from an intrusive list, so the cost is O(1) no matter
+ * how many timers are armed, in contrast with the O(log n) heap operations of libevent timers.
+ *
+ * Timers never fire early: the expiration time is rounded up to the next tick, so a timer may fire
+ * up to one granularity later than requested. This makes the wheel suitable for timeouts that are
+ * usually cancelled before they expire, e.g. per-stream idle and request timeouts, but not for
+ * timers that need precise scheduling.
+ *
+ * The wheel is not thread safe and all timers must be used from the dispatcher's thread. All timers
+ * created by the wheel must be destroyed before the wheel.
+ */
+class TimerWheel {
+public:
+  TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds granularity);
+  ~TimerWheel();
+
+  /**
+   * Allocates a timer on this wheel. @see Timer for docs on how to use the timer.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  TimerPtr createTimer(TimerCb cb);
+
+  std::chrono::milliseconds granularity() const { return granularity_; }
+
+  /**
+   * @return the number of timers currently enabled on the wheel.
+   */
+  uint64_t enabledTimers() const { return enabled_timers_; }
+
+private:
+  class WheelTimerImpl;
+
+  // Each level has 2^SlotBits slots, and a slot of level N spans 2^(N * SlotBits) ticks. With 4
+  // levels of 64 slots the wheel covers 2^24 ticks, i.e. about 4.6 hours at a 1ms granularity.
+  // Timers further in the future are parked in the top level and re-inserted once it wraps around.
+  static constexpr uint32_t SlotBits = 6;
+  static constexpr uint32_t SlotsPerLevel = 1 << SlotBits;
+  static constexpr uint32_t SlotMask = SlotsPerLevel - 1;
+  static constexpr uint32_t Levels = 4;
+
+  uint64_t ticksAt(MonotonicTime time, bool round_up) const;
+  void enable(WheelTimerImpl& timer, std::chrono::microseconds duration,
+              const ScopeTrackedObject* object);
+  void disable(WheelTimerImpl& timer);
+  // Links the timer into the slot matching its expiration tick relative to current_tick_.
+  void insert(WheelTimerImpl& timer);
+  void unlink(WheelTimerImpl& timer);
+  // Runs the cascades and expirations of every tick up to the current time.
+  void onTick();
+  void processTick();
+  // Arms the underlying timer for the earlier of the next non-empty slot of the first level and
+  // the next cascade of the second level.
+  void scheduleNextTick();
+  void scheduleAt(uint64_t tick);
+
+  Dispatcher& dispatcher_;
+  const std::chrono::milliseconds granularity_;
+  // All ticks are counted from the creation of the wheel.
+  const MonotonicTime start_time_;
+  const TimerPtr tick_timer_;
+  // The last tick that has been processed.
+  uint64_t current_tick_{0};
+  // The tick the underlying timer is armed for, if it is enabled.
+  uint64_t scheduled_tick_{0};
+  uint64_t enabled_timers_{0};
+  // Set while expired timers are processed, when scheduling is deferred to the end of the tick.
+  bool processing_{false};
+  std::array<std::array<WheelTimerImpl*, SlotsPerLevel>, Levels> slots_{};
+};
+
+using TimerWheelPtr = std::unique_ptr<TimerWheel>;
+
+} // namespace Event
+} // namespace Envoy
@@ -429,6 +429,7 @@ private:
   const ScopeTrackedObject& scope() override { return *this; }
   void addUpstreamSocketOptions(const Network::Socket::OptionsSharedPtr&) override {}
   Network::Socket::OptionsSharedPtr getUpstreamSocketOptions() const override { return {}; }
+  Buffer::BufferMemoryAccountSharedPtr account() const override { return nullptr; }
 
   // ScopeTrackedObject
   void dumpState(std::ostream& os, int indent_level) const override {
@@ -319,6 +319,12 @@ public:
    */
   virtual absl::optional<std::chrono::milliseconds> maxStreamDuration() const PURE;
 
+  /**
+   * @return granularity of the coarse timers used for the request, request headers and max stream
+   *         duration timeouts of each stream. Zero indicates that precise timers are used.
+   */
+  virtual std::chrono::milliseconds streamTimerGranularity() const PURE;
+
   /**
    * @return Router::RouteConfigProvider* the configuration provider used to acquire a route
    *         config for each request flow. Pointer ownership is _not_ transferred to the caller of
@@ -23,6 +23,7 @@
 #include "envoy/type/v3/percent.pb.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/buffer/watermark_buffer.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/enum_to_int.h"
@@ -101,6 +102,8 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_state_.getState(Server::OverloadActionNames::get().StopAcceptingRequests)),
       overload_disable_keepalive_ref_(
           overload_state_.getState(Server::OverloadActionNames::get().DisableHttpKeepAlive)),
+      overload_reduce_buffer_limits_ref_(
+          overload_state_.getState(Server::OverloadActionNames::get().ReduceBufferLimits)),
       time_source_(time_source) {}
 
 const ResponseHeaderMap& ConnectionManagerImpl::continueHeader() {
@@ -164,7 +167,13 @@ ConnectionManagerImpl::~ConnectionManagerImpl() {
 }
 
 void ConnectionManagerImpl::checkForDeferredClose() {
-  if (drain_state_ == DrainState::Closing && streams_.empty() && !codec_->wantsToWrite()) {
+  if (drain_state_ != DrainState::Closing || !streams_.empty()) {
+    return;
+  }
+  // Send the frames the codec holds back to coalesce writes, e.g. those ending the last stream,
+  // so that the codec no longer wants to write unless it is flow controlled.
+  codec_->flushPendingWrites();
+  if (!codec_->wantsToWrite()) {
     doConnectionClose(Network::ConnectionCloseType::FlushWriteAndDelay, absl::nullopt,
                       StreamInfo::ResponseCodeDetails::get().DownstreamLocalDisconnect);
   }
@@ -223,6 +232,10 @@ void ConnectionManagerImpl::doEndStream(ActiveStream& stream) {
 }
 
 void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
+  // Buffers charging the account may outlive the stream, which can no longer be reset.
+  if (stream.filter_manager_.account() != nullptr) {
+    stream.filter_manager_.account()->clearDownstream();
+  }
   if (stream.max_stream_duration_timer_) {
     stream.max_stream_duration_timer_->disableTimer();
     stream.max_stream_duration_timer_ = nullptr;
@@ -257,9 +270,15 @@ RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encod
   }
 
   ENVOY_CONN_LOG(debug, "new stream", read_callbacks_->connection());
-  ActiveStreamPtr new_stream(new ActiveStream(*this, response_encoder.getStream().bufferLimit()));
+  // Streams created while the process is under memory pressure get a reduced buffer limit.
+  const uint32_t buffer_limit = Buffer::scaleBufferLimit(
+      response_encoder.getStream().bufferLimit(), overload_reduce_buffer_limits_ref_.value());
+  ActiveStreamPtr new_stream(new ActiveStream(*this, buffer_limit));
   new_stream->state_.is_internally_created_ = is_internally_created;
   new_stream->response_encoder_ = &response_encoder;
+  if (new_stream->filter_manager_.account() != nullptr) {
+    new_stream->response_encoder_->getStream().setAccount(new_stream->filter_manager_.account());
+  }
   new_stream->response_encoder_->getStream().addCallbacks(*new_stream);
   new_stream->response_encoder_->getStream().setFlushTimeout(new_stream->idle_timeout_ms_);
   // If the network connection is backed up, the stream should be made aware of it on creation.
@@ -454,6 +473,9 @@ void ConnectionManagerImpl::doConnectionClose(
   }
 
   if (close_type.has_value()) {
+    if (codec_ && close_type.value() != Network::ConnectionCloseType::NoFlush) {
+      codec_->flushPendingWrites();
+    }
     read_callbacks_->connection().close(close_type.value());
   }
 }
@@ -579,7 +601,11 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
                       connection_manager_.config_.localReply(),
                       connection_manager_.codec_->protocol(), connection_manager_.timeSource(),
                       connection_manager_.read_callbacks_->connection().streamInfo().filterState(),
-                      StreamInfo::FilterState::LifeSpan::Connection),
+                      StreamInfo::FilterState::LifeSpan::Connection,
+                      connection_manager_.read_callbacks_->connection()
+                          .dispatcher()
+                          .getWatermarkFactory()
+                          .createAccount([this]() { onResetDueToMemoryPressure(); })),
       request_response_timespan_(new Stats::HistogramCompletableTimespanImpl(
           connection_manager_.stats_.named_.downstream_rq_time_,
           connection_manager_.timeSource())) {
@@ -638,25 +664,21 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.requestTimeout().count()) {
     std::chrono::milliseconds request_timeout = connection_manager_.config_.requestTimeout();
-    request_timer_ = connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onRequestTimeout(); });
+    request_timer_ = createStreamTimer([this]() -> void { onRequestTimeout(); });
     request_timer_->enableTimer(request_timeout, this);
   }
 
   if (connection_manager_.config_.requestHeadersTimeout().count()) {
     std::chrono::milliseconds request_headers_timeout =
         connection_manager_.config_.requestHeadersTimeout();
-    request_header_timer_ =
-        connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-            [this]() -> void { onRequestHeaderTimeout(); });
+    request_header_timer_ = createStreamTimer([this]() -> void { onRequestHeaderTimeout(); });
     request_header_timer_->enableTimer(request_headers_timeout, this);
   }
 
   const auto max_stream_duration = connection_manager_.config_.maxStreamDuration();
   if (max_stream_duration.has_value() && max_stream_duration.value().count()) {
     max_stream_duration_timer_ =
-        connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-            [this]() -> void { onStreamMaxDurationReached(); });
+        createStreamTimer([this]() -> void { onStreamMaxDurationReached(); });
     max_stream_duration_timer_->enableTimer(connection_manager_.config_.maxStreamDuration().value(),
                                             this);
   }
@@ -751,6 +773,22 @@ void ConnectionManagerImpl::ActiveStream::onRequestHeaderTimeout() {
                  StreamInfo::ResponseCodeDetails::get().RequestHeaderTimeout);
 }
 
+Event::TimerPtr ConnectionManagerImpl::ActiveStream::createStreamTimer(Event::TimerCb cb) {
+  Event::Dispatcher& dispatcher = connection_manager_.read_callbacks_->connection().dispatcher();
+  const auto granularity = connection_manager_.config_.streamTimerGranularity();
+  if (granularity.count()) {
+    return dispatcher.createCoarseTimer(granularity, std::move(cb));
+  }
+  return dispatcher.createTimer(std::move(cb));
+}
+
+void ConnectionManagerImpl::ActiveStream::onResetDueToMemoryPressure() {
+  ENVOY_STREAM_LOG(debug, "resetting stream due to buffer memory pressure", *this);
+  filter_manager_.streamInfo().setResponseCodeDetails(
+      StreamInfo::ResponseCodeDetails::get().Overload);
+  resetStream();
+}
+
 void ConnectionManagerImpl::ActiveStream::onStreamMaxDurationReached() {
   ENVOY_STREAM_LOG(debug, "Stream max duration time reached", *this);
   connection_manager_.stats_.named_.downstream_rq_max_duration_reached_.inc();
@@ -1244,8 +1282,7 @@ void ConnectionManagerImpl::ActiveStream::refreshDurationTimeout() {
   // Finally create (if necessary) and enable the timer.
   if (!max_stream_duration_timer_) {
     max_stream_duration_timer_ =
-        connection_manager_.read_callbacks_->connection().dispatcher().createTimer(
-            [this]() -> void { onStreamMaxDurationReached(); });
+        createStreamTimer([this]() -> void { onStreamMaxDurationReached(); });
   }
   max_stream_duration_timer_->enableTimer(timeout);
 }
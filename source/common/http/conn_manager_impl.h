@@ -312,6 +312,8 @@ private:
       bool decorated_propagate_ : 1;
     };
 
+    // Creates a per-stream timeout timer, which is a coarse timer if the config asks for one.
+    Event::TimerPtr createStreamTimer(Event::TimerCb cb);
     // Per-stream idle timeout callback.
     void onIdleTimeout();
     // Per-stream request timeout callback.
@@ -320,6 +322,9 @@ private:
     void onRequestHeaderTimeout();
     // Per-stream alive duration reached.
     void onStreamMaxDurationReached();
+    // Called by the stream's memory account when the stream is among the largest consumers of
+    // buffer memory while the process is under memory pressure.
+    void onResetDueToMemoryPressure();
     bool hasCachedRoute() { return cached_route_.has_value() && cached_route_.value(); }
 
     // Return local port of the connection.
@@ -443,6 +448,7 @@ private:
   // map lookup in the hot path of processing each request.
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
+  const Server::OverloadActionState& overload_reduce_buffer_limits_ref_;
   TimeSource& time_source_;
   bool remote_close_{};
 };
@@ -63,17 +63,25 @@ HttpConnPoolImplBase::newStream(Http::ResponseDecoder& response_decoder,
   return Envoy::ConnectionPool::ConnPoolImplBase::newStream(context);
 }
 
+ConnectionPool::Cancellable*
+HttpConnPoolImplBase::newEarlyDataStream(Http::ResponseDecoder& response_decoder,
+                                         Http::ConnectionPool::Callbacks& callbacks) {
+  HttpAttachContext context({&response_decoder, &callbacks});
+  return Envoy::ConnectionPool::ConnPoolImplBase::newStream(context, true);
+}
+
 bool HttpConnPoolImplBase::hasActiveConnections() const {
   return (hasPendingStreams() || (hasActiveStreams()));
 }
 
 ConnectionPool::Cancellable*
-HttpConnPoolImplBase::newPendingStream(Envoy::ConnectionPool::AttachContext& context) {
+HttpConnPoolImplBase::newPendingStream(Envoy::ConnectionPool::AttachContext& context,
+                                       bool can_send_early_data) {
   Http::ResponseDecoder& decoder = *typedContext<HttpAttachContext>(context).decoder_;
   Http::ConnectionPool::Callbacks& callbacks = *typedContext<HttpAttachContext>(context).callbacks_;
   ENVOY_LOG(debug, "queueing stream due to no available connections");
   Envoy::ConnectionPool::PendingStreamPtr pending_stream(
-      new HttpPendingStream(*this, decoder, callbacks));
+      new HttpPendingStream(*this, decoder, callbacks, can_send_early_data));
   return addPendingStream(std::move(pending_stream));
 }
 
@@ -126,6 +134,7 @@ void MultiplexedActiveClientBase::onSettings(ReceivedSettings& settings) {
     parent_.decrClusterStreamCapacity(delta);
     ENVOY_CONN_LOG(trace, "Decreasing stream capacity by {}", *codec_client_, delta);
     negative_capacity_ += delta;
+    parent_.onClientCapacityChanged(*this);
   }
   // As we don't increase stream limits when maxConcurrentStreams goes up, treat
   // a stream limit of 0 as a GOAWAY.
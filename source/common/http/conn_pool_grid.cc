@@ -25,8 +25,10 @@ absl::string_view describePool(const ConnectionPool::Instance& pool) {
 ConnectivityGrid::WrapperCallbacks::WrapperCallbacks(ConnectivityGrid& grid,
                                                      Http::ResponseDecoder& decoder,
                                                      PoolIterator pool_it,
-                                                     ConnectionPool::Callbacks& callbacks)
+                                                     ConnectionPool::Callbacks& callbacks,
+                                                     bool can_send_early_data)
     : grid_(grid), decoder_(decoder), inner_callbacks_(callbacks),
+      can_send_early_data_(can_send_early_data),
       next_attempt_timer_(
           grid_.dispatcher_.createTimer([this]() -> void { tryAnotherConnection(); })),
       current_(pool_it) {
@@ -36,7 +38,9 @@ ConnectivityGrid::WrapperCallbacks::WrapperCallbacks(ConnectivityGrid& grid,
 // TODO(#15649) add trace logging.
 ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::ConnectionAttemptCallbacks(
     WrapperCallbacks& parent, PoolIterator it)
-    : parent_(parent), pool_it_(it), cancellable_(pool().newStream(parent_.decoder_, *this)) {}
+    : parent_(parent), pool_it_(it),
+      cancellable_(parent_.can_send_early_data_ ? pool().newEarlyDataStream(parent_.decoder_, *this)
+                                                : pool().newStream(parent_.decoder_, *this)) {}
 
 void ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::onPoolFailure(
     ConnectionPool::PoolFailureReason reason, absl::string_view transport_failure_reason,
@@ -166,6 +170,18 @@ bool ConnectivityGrid::hasActiveConnections() const {
 
 ConnectionPool::Cancellable* ConnectivityGrid::newStream(Http::ResponseDecoder& decoder,
                                                          ConnectionPool::Callbacks& callbacks) {
+  return newStreamImpl(decoder, callbacks, false);
+}
+
+ConnectionPool::Cancellable*
+ConnectivityGrid::newEarlyDataStream(Http::ResponseDecoder& decoder,
+                                     ConnectionPool::Callbacks& callbacks) {
+  return newStreamImpl(decoder, callbacks, true);
+}
+
+ConnectionPool::Cancellable* ConnectivityGrid::newStreamImpl(Http::ResponseDecoder& decoder,
+                                                             ConnectionPool::Callbacks& callbacks,
+                                                             bool can_send_early_data) {
   if (pools_.empty()) {
     createNextPool();
   }
@@ -173,7 +189,8 @@ ConnectionPool::Cancellable* ConnectivityGrid::newStream(Http::ResponseDecoder&
   // TODO(#15649) track pools with successful connections: don't always start at
   // the front of the list.
   auto wrapped_callback =
-      std::make_unique<WrapperCallbacks>(*this, decoder, pools_.begin(), callbacks);
+      std::make_unique<WrapperCallbacks>(*this, decoder, pools_.begin(), callbacks,
+                                         can_send_early_data);
   ConnectionPool::Cancellable* ret = wrapped_callback.get();
   LinkedList::moveIntoList(std::move(wrapped_callback), wrapped_callbacks_);
   return ret;
@@ -30,7 +30,7 @@ public:
                            public LinkedObject<WrapperCallbacks> {
   public:
     WrapperCallbacks(ConnectivityGrid& grid, Http::ResponseDecoder& decoder, PoolIterator pool_it,
-                     ConnectionPool::Callbacks& callbacks);
+                     ConnectionPool::Callbacks& callbacks, bool can_send_early_data);
 
     // This holds state for a single connection attempt to a specific pool.
     class ConnectionAttemptCallbacks : public ConnectionPool::Callbacks,
@@ -83,6 +83,8 @@ public:
     // The callbacks from the original caller, which must get onPoolFailure or
     // onPoolReady unless there is call to cancel().
     ConnectionPool::Callbacks& inner_callbacks_;
+    // True if the original newStream may be sent as early data.
+    const bool can_send_early_data_;
     // The timer which tracks when new connections should be attempted.
     Event::TimerPtr next_attempt_timer_;
     // The iterator to the last pool which had a connection attempt.
@@ -102,6 +104,8 @@ public:
   bool hasActiveConnections() const override;
   ConnectionPool::Cancellable* newStream(Http::ResponseDecoder& response_decoder,
                                          ConnectionPool::Callbacks& callbacks) override;
+  ConnectionPool::Cancellable* newEarlyDataStream(Http::ResponseDecoder& response_decoder,
+                                                  ConnectionPool::Callbacks& callbacks) override;
   void addDrainedCallback(DrainedCb cb) override;
   void drainConnections() override;
   Upstream::HostDescriptionConstSharedPtr host() const override;
@@ -114,6 +118,10 @@ public:
 private:
   friend class ConnectivityGridForTest;
 
+  ConnectionPool::Cancellable* newStreamImpl(Http::ResponseDecoder& response_decoder,
+                                             ConnectionPool::Callbacks& callbacks,
+                                             bool can_send_early_data);
+
   // Called by each pool as it drains. The grid is responsible for calling
   // drained_callbacks_ once all pools have drained.
   void onDrainReceived();
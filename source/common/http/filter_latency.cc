@@ -0,0 +1,102 @@
+#include "common/http/filter_latency.h"
+
+#include <ctime>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+FilterLatencyRecorderImpl::FilterLatencyRecorderImpl(const std::string& prefix,
+                                                     Stats::Scope& scope, bool record_cpu_time)
+    : stats_{ALL_FILTER_LATENCY_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))} {
+  if (record_cpu_time) {
+    cpu_time_stats_.emplace(
+        FilterCpuTimeStats{ALL_FILTER_CPU_TIME_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))});
+  }
+}
+
+void FilterLatencyRecorderImpl::recordDecode(std::chrono::microseconds duration,
+                                             std::chrono::microseconds cpu_time) {
+  stats_.decode_time_.recordValue(duration.count());
+  if (cpu_time_stats_.has_value()) {
+    cpu_time_stats_->decode_cpu_time_.recordValue(cpu_time.count());
+  }
+}
+
+void FilterLatencyRecorderImpl::recordEncode(std::chrono::microseconds duration,
+                                             std::chrono::microseconds cpu_time) {
+  stats_.encode_time_.recordValue(duration.count());
+  if (cpu_time_stats_.has_value()) {
+    cpu_time_stats_->encode_cpu_time_.recordValue(cpu_time.count());
+  }
+}
+
+std::chrono::nanoseconds FilterLatencyTimer::threadCpuTime() {
+#ifdef WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+    return std::chrono::nanoseconds(0);
+  }
+  // The times are in units of 100ns.
+  const uint64_t kernel = (uint64_t(kernel_time.dwHighDateTime) << 32) | kernel_time.dwLowDateTime;
+  const uint64_t user = (uint64_t(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+  return std::chrono::nanoseconds((kernel + user) * 100);
+#else
+  timespec now;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+#endif
+}
+
+thread_local FilterLatencyTimer* FilterLatencyTimer::current_ = nullptr;
+
+void FilterLatencyTimer::start(TimeSource& time_source, bool encode) {
+  time_source_ = &time_source;
+  encode_ = encode;
+  outer_ = current_;
+  if (outer_ != nullptr) {
+    outer_->pause();
+  }
+  current_ = this;
+  resume();
+}
+
+void FilterLatencyTimer::stop() {
+  pause();
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(elapsed_);
+  const auto cpu_time = std::chrono::duration_cast<std::chrono::microseconds>(elapsed_cpu_time_);
+  if (encode_) {
+    recorder_->recordEncode(duration, cpu_time);
+  } else {
+    recorder_->recordDecode(duration, cpu_time);
+  }
+  ASSERT(current_ == this);
+  current_ = outer_;
+  if (outer_ != nullptr) {
+    outer_->resume();
+  }
+}
+
+void FilterLatencyTimer::pause() {
+  elapsed_ += time_source_->monotonicTime() - start_time_;
+  if (recorder_->recordsCpuTime()) {
+    elapsed_cpu_time_ += threadCpuTime() - start_cpu_time_;
+  }
+}
+
+void FilterLatencyTimer::resume() {
+  if (recorder_->recordsCpuTime()) {
+    start_cpu_time_ = threadCpuTime();
+  }
+  start_time_ = time_source_->monotonicTime();
+}
+
+} // namespace Http
+} // namespace Envoy
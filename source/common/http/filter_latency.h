@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/http/filter.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * All stats of the latency of an HTTP filter. @see stats_macros.h
+ */
+#define ALL_FILTER_LATENCY_STATS(HISTOGRAM)                                                        \
+  HISTOGRAM(decode_time, Microseconds)                                                             \
+  HISTOGRAM(encode_time, Microseconds)
+
+/**
+ * All stats of the CPU time of an HTTP filter, which are only created when it's recorded.
+ * @see stats_macros.h
+ */
+#define ALL_FILTER_CPU_TIME_STATS(HISTOGRAM)                                                       \
+  HISTOGRAM(decode_cpu_time, Microseconds)                                                         \
+  HISTOGRAM(encode_cpu_time, Microseconds)
+
+/**
+ * Struct definition for the latency stats of an HTTP filter. @see stats_macros.h
+ */
+struct FilterLatencyStats {
+  ALL_FILTER_LATENCY_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Struct definition for the CPU time stats of an HTTP filter. @see stats_macros.h
+ */
+struct FilterCpuTimeStats {
+  ALL_FILTER_CPU_TIME_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Records the latency of the callbacks of a filter in the filter's latency stats.
+ */
+class FilterLatencyRecorderImpl : public FilterLatencyRecorder {
+public:
+  /**
+   * @param prefix supplies the prefix of the stats, which ends with the filter's name and a '.'.
+   */
+  FilterLatencyRecorderImpl(const std::string& prefix, Stats::Scope& scope, bool record_cpu_time);
+
+  // Http::FilterLatencyRecorder
+  bool recordsCpuTime() const override { return cpu_time_stats_.has_value(); }
+  void recordDecode(std::chrono::microseconds duration,
+                    std::chrono::microseconds cpu_time) override;
+  void recordEncode(std::chrono::microseconds duration,
+                    std::chrono::microseconds cpu_time) override;
+
+private:
+  FilterLatencyStats stats_;
+  absl::optional<FilterCpuTimeStats> cpu_time_stats_;
+};
+
+/**
+ * Times a filter callback from its construction to its destruction, if the filter's latency is
+ * recorded. Otherwise, it does nothing beyond checking the recorder.
+ *
+ * Callbacks can nest, e.g. when sendLocalReply() in decodeHeaders() runs the encoder filters. The
+ * timers of a thread form a stack, and a nested timer pauses the one it interrupts, so that each
+ * callback is only charged for its own time.
+ */
+class FilterLatencyTimer {
+public:
+  FilterLatencyTimer(FilterLatencyRecorder* recorder, TimeSource& time_source, bool encode)
+      : recorder_(recorder) {
+    if (recorder_ != nullptr) {
+      start(time_source, encode);
+    }
+  }
+  ~FilterLatencyTimer() {
+    if (recorder_ != nullptr) {
+      stop();
+    }
+  }
+
+  /**
+   * @return the CPU time used by the calling thread so far, or 0 if it can't be measured.
+   */
+  static std::chrono::nanoseconds threadCpuTime();
+
+private:
+  void start(TimeSource& time_source, bool encode);
+  void stop();
+  void pause();
+  void resume();
+
+  // The innermost running timer of the thread.
+  static thread_local FilterLatencyTimer* current_;
+
+  FilterLatencyRecorder* const recorder_;
+  FilterLatencyTimer* outer_{};
+  TimeSource* time_source_{};
+  bool encode_{};
+  MonotonicTime start_time_;
+  std::chrono::nanoseconds start_cpu_time_{};
+  // The time and CPU time used by the callback before it was last resumed.
+  std::chrono::nanoseconds elapsed_{};
+  std::chrono::nanoseconds elapsed_cpu_time_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -6,6 +6,7 @@
 #include "common/common/enum_to_int.h"
 #include "common/common/scope_tracker.h"
 #include "common/http/codes.h"
+#include "common/http/filter_latency.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/header_utility.h"
 #include "common/http/utility.h"
@@ -281,6 +282,7 @@ Buffer::InstancePtr ActiveStreamDecoderFilter::createBuffer() {
       [this]() -> void { this->requestDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->bindAccount(parent_.account_);
   return buffer;
 }
 
@@ -426,6 +428,7 @@ void FilterManager::addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr fi
                                                  bool dual_filter) {
   ActiveStreamDecoderFilterPtr wrapper(
       new ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter));
+  wrapper->latency_recorder_ = filter_latency_recorder_;
 
   // If we're a dual handling filter, have the encoding wrapper be the only thing registering itself
   // as the handling filter.
@@ -450,6 +453,7 @@ void FilterManager::addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr fi
                                                  bool dual_filter) {
   ActiveStreamEncoderFilterPtr wrapper(
       new ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter));
+  wrapper->latency_recorder_ = filter_latency_recorder_;
 
   if (match_state) {
     match_state->filter_ = filter.get();
@@ -502,7 +506,11 @@ void FilterManager::decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHead
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeHeaders));
     state_.filter_call_state_ |= FilterCallState::DecodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == decoder_filters_.end());
-    FilterHeadersStatus status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    FilterHeadersStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ false);
+      status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    }
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndDontEndStream && !(*entry)->end_stream_),
            "Filters should not return FilterHeadersStatus::ContinueAndDontEndStream from "
@@ -631,7 +639,11 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
 
     state_.filter_call_state_ |= FilterCallState::DecodeData;
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.requestTrailers();
-    FilterDataStatus status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
+    FilterDataStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ false);
+      status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
+    }
     if ((*entry)->end_stream_) {
       (*entry)->handle_->decodeComplete();
     }
@@ -725,7 +737,11 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeTrailers));
     state_.filter_call_state_ |= FilterCallState::DecodeTrailers;
-    FilterTrailersStatus status = (*entry)->handle_->decodeTrailers(trailers);
+    FilterTrailersStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ false);
+      status = (*entry)->handle_->decodeTrailers(trailers);
+    }
     (*entry)->handle_->decodeComplete();
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::DecodeTrailers;
@@ -760,7 +776,11 @@ void FilterManager::decodeMetadata(ActiveStreamDecoderFilter* filter, MetadataMa
       return;
     }
 
-    FilterMetadataStatus status = (*entry)->handle_->decodeMetadata(metadata_map);
+    FilterMetadataStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ false);
+      status = (*entry)->handle_->decodeMetadata(metadata_map);
+    }
     ENVOY_STREAM_LOG(trace, "decode metadata called: filter={} status={}, metadata: {}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status),
                      metadata_map);
@@ -983,7 +1003,11 @@ void FilterManager::encode100ContinueHeaders(ActiveStreamEncoderFilter* filter,
 
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
     state_.filter_call_state_ |= FilterCallState::Encode100ContinueHeaders;
-    FilterHeadersStatus status = (*entry)->handle_->encode100ContinueHeaders(headers);
+    FilterHeadersStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ true);
+      status = (*entry)->handle_->encode100ContinueHeaders(headers);
+    }
     state_.filter_call_state_ &= ~FilterCallState::Encode100ContinueHeaders;
     ENVOY_STREAM_LOG(trace, "encode 100 continue headers called: filter={} status={}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status));
@@ -1031,7 +1055,11 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
     state_.filter_call_state_ |= FilterCallState::EncodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == encoder_filters_.end());
-    FilterHeadersStatus status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
+    FilterHeadersStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ true);
+      status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
+    }
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndDontEndStream && !(*entry)->end_stream_),
            "Filters should not return FilterHeadersStatus::ContinueAndDontEndStream from "
@@ -1094,7 +1122,11 @@ void FilterManager::encodeMetadata(ActiveStreamEncoderFilter* filter,
       return;
     }
 
-    FilterMetadataStatus status = (*entry)->handle_->encodeMetadata(*metadata_map_ptr);
+    FilterMetadataStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ true);
+      status = (*entry)->handle_->encodeMetadata(*metadata_map_ptr);
+    }
     ENVOY_STREAM_LOG(trace, "encode metadata called: filter={} status={}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status));
   }
@@ -1178,7 +1210,11 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
     recordLatestDataFilter(entry, state_.latest_data_encoding_filter_, encoder_filters_);
 
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.responseTrailers();
-    FilterDataStatus status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
+    FilterDataStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ true);
+      status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
+    }
     if ((*entry)->end_stream_) {
       (*entry)->handle_->encodeComplete();
     }
@@ -1231,7 +1267,11 @@ void FilterManager::encodeTrailers(ActiveStreamEncoderFilter* filter,
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
-    FilterTrailersStatus status = (*entry)->handle_->encodeTrailers(trailers);
+    FilterTrailersStatus status;
+    {
+      FilterLatencyTimer timer((*entry)->latency_recorder_, time_source_, /* encode = */ true);
+      status = (*entry)->handle_->encodeTrailers(trailers);
+    }
     (*entry)->handle_->encodeComplete();
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::EncodeTrailers;
@@ -1408,6 +1448,10 @@ Network::Socket::OptionsSharedPtr ActiveStreamDecoderFilter::getUpstreamSocketOp
   return parent_.upstream_options_;
 }
 
+Buffer::BufferMemoryAccountSharedPtr ActiveStreamDecoderFilter::account() const {
+  return parent_.account();
+}
+
 void ActiveStreamDecoderFilter::requestRouteConfigUpdate(
     Http::RouteConfigUpdatedCallbackSharedPtr route_config_updated_cb) {
   parent_.filter_manager_callbacks_.requestRouteConfigUpdate(std::move(route_config_updated_cb));
@@ -1423,6 +1467,7 @@ Buffer::InstancePtr ActiveStreamEncoderFilter::createBuffer() {
       [this]() -> void { this->responseDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->bindAccount(parent_.account_);
   return buffer;
 }
 Buffer::InstancePtr& ActiveStreamEncoderFilter::bufferedData() {
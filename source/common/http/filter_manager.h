@@ -189,6 +189,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   IterationState iteration_state_;
 
   FilterMatchStateSharedPtr filter_match_state_;
+  // Records the latency of the filter's callbacks, if the stream is sampled for filter latency.
+  FilterLatencyRecorder* latency_recorder_{};
   // If the filter resumes iteration from a StopAllBuffer/Watermark state, the current filter
   // hasn't parsed data and trailers. As a result, the filter iteration should start with the
   // current filter instead of the next one. If true, filter iteration starts with the current
@@ -274,6 +276,7 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
   void addUpstreamSocketOptions(const Network::Socket::OptionsSharedPtr& options) override;
 
   Network::Socket::OptionsSharedPtr getUpstreamSocketOptions() const override;
+  Buffer::BufferMemoryAccountSharedPtr account() const override;
 
   // Each decoder filter instance checks if the request passed to the filter is gRPC
   // so that we can issue gRPC local responses to gRPC requests. Filter's decodeHeaders()
@@ -631,11 +634,13 @@ public:
                 uint32_t buffer_limit, FilterChainFactory& filter_chain_factory,
                 const LocalReply::LocalReply& local_reply, Http::Protocol protocol,
                 TimeSource& time_source, StreamInfo::FilterStateSharedPtr parent_filter_state,
-                StreamInfo::FilterState::LifeSpan filter_state_life_span)
+                StreamInfo::FilterState::LifeSpan filter_state_life_span,
+                Buffer::BufferMemoryAccountSharedPtr account)
       : filter_manager_callbacks_(filter_manager_callbacks), dispatcher_(dispatcher),
-        connection_(connection), stream_id_(stream_id), proxy_100_continue_(proxy_100_continue),
-        buffer_limit_(buffer_limit), filter_chain_factory_(filter_chain_factory),
-        local_reply_(local_reply),
+        time_source_(time_source), connection_(connection), stream_id_(stream_id),
+        account_(std::move(account)), proxy_100_continue_(proxy_100_continue),
+        buffer_limit_(buffer_limit),
+        filter_chain_factory_(filter_chain_factory), local_reply_(local_reply),
         stream_info_(protocol, time_source, connection.addressProviderSharedPtr(),
                      parent_filter_state, filter_state_life_span) {}
   ~FilterManager() override {
@@ -714,6 +719,9 @@ public:
     addStreamEncoderFilterWorker(filter, nullptr, true);
   }
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override;
+  void setFilterLatencyRecorder(FilterLatencyRecorder* recorder) override {
+    filter_latency_recorder_ = recorder;
+  }
 
   void log() {
     RequestHeaderMap* request_headers = nullptr;
@@ -848,6 +856,11 @@ public:
    */
   bool aboveHighWatermark() { return high_watermark_count_ != 0; }
 
+  /**
+   * @return the memory account that the stream's buffers are charged to, if any.
+   */
+  const Buffer::BufferMemoryAccountSharedPtr& account() const { return account_; }
+
   // Pass on watermark callbacks to watermark subscribers. This boils down to passing watermark
   // events for this stream and the downstream connection to the router filter.
   void callHighWatermarkCallbacks();
@@ -963,14 +976,19 @@ private:
 
   FilterManagerCallbacks& filter_manager_callbacks_;
   Event::Dispatcher& dispatcher_;
+  TimeSource& time_source_;
   const Network::Connection& connection_;
   const uint64_t stream_id_;
+  // Declared before the buffers charging it, so that they are released first.
+  const Buffer::BufferMemoryAccountSharedPtr account_;
   const bool proxy_100_continue_;
 
   std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
   std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
   std::list<StreamFilterBase*> filters_;
   std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+  // Set while the filter chain is created, for the filters being added.
+  FilterLatencyRecorder* filter_latency_recorder_{};
 
   // Stores metadata added in the decoding filter that is being processed. Will be cleared before
   // processing the next filter. The storage is created on demand. We need to store metadata
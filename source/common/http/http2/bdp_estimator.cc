@@ -0,0 +1,38 @@
+#include "common/http/http2/bdp_estimator.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+void BdpEstimator::onPingSent(MonotonicTime now) {
+  ASSERT(!ping_outstanding_);
+  ping_outstanding_ = true;
+  ping_sent_ = now;
+  // Only the bytes sent by the peer after it could have seen the PING belong to this round trip.
+  accumulated_bytes_ = 0;
+}
+
+absl::optional<uint64_t> BdpEstimator::onPingAck(MonotonicTime now) {
+  ASSERT(ping_outstanding_);
+  ping_outstanding_ = false;
+  const uint64_t bytes = accumulated_bytes_;
+  accumulated_bytes_ = 0;
+
+  const double round_trip_seconds = std::chrono::duration<double>(now - ping_sent_).count();
+  const double bandwidth = round_trip_seconds > 0 ? bytes / round_trip_seconds : 0;
+  if (3 * bytes <= 2 * estimate_ || bandwidth <= max_bandwidth_) {
+    return absl::nullopt;
+  }
+  max_bandwidth_ = bandwidth;
+  estimate_ = std::max(bytes, 2 * estimate_);
+  return estimate_;
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
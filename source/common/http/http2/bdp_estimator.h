@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/common/time.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+// Estimates the bandwidth-delay product (BDP) of a connection by counting the bytes received
+// during the round trip of a PING frame. The estimate only grows: it doubles whenever the bytes
+// received during a round trip come close to the current estimate while the bandwidth keeps
+// increasing, which indicates that the flow-control windows sized after the estimate limit the
+// throughput of the connection.
+class BdpEstimator {
+public:
+  explicit BdpEstimator(uint64_t initial_estimate) : estimate_(initial_estimate) {}
+
+  // Accounts for received DATA payload.
+  // @return true if a PING should be sent to measure the round trip, in which case onPingSent() is
+  //         expected to be called.
+  bool onDataReceived(uint64_t bytes) {
+    accumulated_bytes_ += bytes;
+    return !ping_outstanding_;
+  }
+
+  void onPingSent(MonotonicTime now);
+
+  // Completes the measurement started by the last PING.
+  // @return the new estimate if it has grown.
+  absl::optional<uint64_t> onPingAck(MonotonicTime now);
+
+  bool pingOutstanding() const { return ping_outstanding_; }
+  uint64_t estimate() const { return estimate_; }
+
+private:
+  uint64_t estimate_;
+  uint64_t accumulated_bytes_{};
+  // The highest bandwidth, in bytes per second, that grew the estimate.
+  double max_bandwidth_{};
+  MonotonicTime ping_sent_;
+  bool ping_outstanding_{};
+};
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -148,6 +148,20 @@ void ConnectionImpl::StreamImpl::destroy() {
   parent_.stats_.pending_send_bytes_.sub(pending_send_data_.length());
 }
 
+// Names and values of the HPACK static table, e.g. ":method: GET" or "accept-encoding", are backed
+// by buffers that live as long as the nghttp2 library, so they are referenced rather than copied.
+// Referenced header strings are also passed back to nghttp2 without copying when re-encoded.
+static HeaderString toHeaderString(nghttp2_rcbuf* rcbuf) {
+  const nghttp2_vec buf = nghttp2_rcbuf_get_buf(rcbuf);
+  const absl::string_view view(reinterpret_cast<const char*>(buf.base), buf.len);
+  if (nghttp2_rcbuf_is_static(rcbuf)) {
+    return HeaderString(view);
+  }
+  HeaderString header_string;
+  header_string.setCopy(view);
+  return header_string;
+}
+
 static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
   uint8_t flags = 0;
   if (header.key().isReference()) {
@@ -447,7 +461,7 @@ void ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t
 
   parent_.stats_.pending_send_bytes_.sub(length);
   output.move(pending_send_data_, length);
-  parent_.connection_.write(output, false);
+  parent_.writeOutboundFrames(output);
 }
 
 void ConnectionImpl::ClientStreamImpl::submitHeaders(const std::vector<nghttp2_nv>& final_headers,
@@ -599,15 +613,37 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
     // This call schedules the initial interval, with jitter.
     onKeepaliveResponse();
   }
+
+  if (http2_options.has_window_auto_tuning()) {
+    const auto& window_auto_tuning = http2_options.window_auto_tuning();
+    max_connection_window_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        window_auto_tuning, max_connection_window_size,
+        ::Envoy::Http2::Utility::OptionsLimits::DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE);
+    max_stream_window_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        window_auto_tuning, max_stream_window_size,
+        ::Envoy::Http2::Utility::OptionsLimits::DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE);
+    connection_window_size_ = http2_options.initial_connection_window_size().value();
+    bdp_estimator_ = std::make_unique<BdpEstimator>(per_stream_buffer_limit_);
+  }
+
+  if (http2_options.coalesce_frame_writes()) {
+    deferred_send_callback_ =
+        connection.dispatcher().createSchedulableCallback([this]() { onDeferredSend(); });
+  }
 }
 
 ConnectionImpl::~ConnectionImpl() {
   for (const auto& stream : active_streams_) {
     stream->destroy();
   }
+  stats_.window_auto_tuning_bytes_.sub(auto_tuned_window_bytes_);
   nghttp2_session_del(session_);
 }
 
+// Distinguishes the PINGs measuring round trips for window auto-tuning from keepalive PINGs, whose
+// payload is the time they were sent at.
+static constexpr uint64_t BdpPingPayload = 0x6264702d70696e67;
+
 void ConnectionImpl::sendKeepalive() {
   // Include the current time as the payload to help with debugging.
   SystemTime now = connection_.dispatcher().timeSource().systemTime();
@@ -646,6 +682,64 @@ void ConnectionImpl::onKeepaliveResponseTimeout() {
   connection_.close(Network::ConnectionCloseType::NoFlush);
 }
 
+void ConnectionImpl::sendBdpPing() {
+  uint64_t payload = BdpPingPayload;
+  // The last parameter is an opaque 8-byte buffer, so this cast is safe.
+  int rc = nghttp2_submit_ping(session_, 0 /*flags*/, reinterpret_cast<uint8_t*>(&payload));
+  ASSERT(rc == 0);
+  bdp_estimator_->onPingSent(connection_.dispatcher().timeSource().monotonicTime());
+}
+
+void ConnectionImpl::onBdpPingAck() {
+  if (!bdp_estimator_->pingOutstanding()) {
+    // An unsolicited PING ACK with the same payload.
+    return;
+  }
+  const absl::optional<uint64_t> estimate =
+      bdp_estimator_->onPingAck(connection_.dispatcher().timeSource().monotonicTime());
+  if (estimate.has_value()) {
+    // Twice the bandwidth-delay product leaves room for the estimate to keep growing.
+    growWindows(2 * estimate.value());
+  }
+}
+
+void ConnectionImpl::growWindows(uint64_t target_window_size) {
+  bool grown = false;
+  const uint32_t connection_window_size =
+      std::min<uint64_t>(max_connection_window_size_, target_window_size);
+  if (connection_window_size > connection_window_size_) {
+    // This sends a WINDOW_UPDATE for the difference.
+    int rc = nghttp2_session_set_local_window_size(session_, NGHTTP2_FLAG_NONE, 0,
+                                                   connection_window_size);
+    ASSERT(rc == 0);
+    auto_tuned_window_bytes_ += connection_window_size - connection_window_size_;
+    stats_.window_auto_tuning_bytes_.add(connection_window_size - connection_window_size_);
+    connection_window_size_ = connection_window_size;
+    grown = true;
+  }
+
+  const uint32_t stream_window_size =
+      std::min<uint64_t>(max_stream_window_size_, target_window_size);
+  if (stream_window_size > per_stream_buffer_limit_) {
+    // nghttp2 grows the windows of open streams when the peer acknowledges the new setting. New
+    // streams buffer up to their window, like streams created with the initial window size.
+    nghttp2_settings_entry setting{NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, stream_window_size};
+    int rc = nghttp2_submit_settings(session_, NGHTTP2_FLAG_NONE, &setting, 1);
+    ASSERT(rc == 0);
+    per_stream_buffer_limit_ = stream_window_size;
+    for (auto& stream : active_streams_) {
+      stream->setWriteBufferWatermarks(stream_window_size / 2, stream_window_size);
+    }
+    grown = true;
+  }
+
+  if (grown) {
+    ENVOY_CONN_LOG(debug, "auto-tuned flow-control windows: connection={} stream={}", connection_,
+                   connection_window_size_, per_stream_buffer_limit_);
+    stats_.window_auto_tuning_increases_.inc();
+  }
+}
+
 Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
   ScopeTrackerScopeState scope(this, connection_.dispatcher());
   ENVOY_CONN_LOG(trace, "dispatching {} bytes", connection_, data.length());
@@ -686,7 +780,7 @@ Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
   data.drain(data.length());
 
   // Decoding incoming frames can generate outbound frames so flush pending.
-  return sendPendingFrames();
+  return sendPendingFramesNow();
 }
 
 const ConnectionImpl::StreamImpl* ConnectionImpl::getStream(int32_t stream_id) const {
@@ -698,6 +792,14 @@ ConnectionImpl::StreamImpl* ConnectionImpl::getStream(int32_t stream_id) {
 }
 
 int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
+  // Measure the round trip while DATA flows, unless the windows can't grow any further. The PING is
+  // sent once the received data has been dispatched.
+  if (bdp_estimator_ != nullptr && bdp_estimator_->onDataReceived(len) &&
+      (connection_window_size_ < max_connection_window_size_ ||
+       per_stream_buffer_limit_ < max_stream_window_size_)) {
+    sendBdpPing();
+  }
+
   StreamImpl* stream = getStream(stream_id);
   // If this results in buffering too much data, the watermark buffer will call
   // pendingRecvBufferHighWatermark, resulting in ++read_disable_count_
@@ -718,9 +820,9 @@ void ConnectionImpl::goAway() {
                                  NGHTTP2_NO_ERROR, nullptr, 0);
   ASSERT(rc == 0);
 
-  if (sendPendingFramesAndHandleError()) {
-    // Intended to check through coverage that this error case is tested
-    return;
+  // The connection is usually closed soon after GOAWAY, so don't defer sending it.
+  if (!sendPendingFramesNow().ok()) {
+    scheduleProtocolConstraintViolationCallback();
   }
 }
 
@@ -728,9 +830,8 @@ void ConnectionImpl::shutdownNotice() {
   int rc = nghttp2_submit_shutdown_notice(session_);
   ASSERT(rc == 0);
 
-  if (sendPendingFramesAndHandleError()) {
-    // Intended to check through coverage that this error case is tested
-    return;
+  if (!sendPendingFramesNow().ok()) {
+    scheduleProtocolConstraintViolationCallback();
   }
 }
 
@@ -740,7 +841,7 @@ Status ConnectionImpl::protocolErrorForTest() {
                                  NGHTTP2_PROTOCOL_ERROR, nullptr, 0);
   ASSERT(rc == 0);
 
-  return sendPendingFrames();
+  return sendPendingFramesNow();
 }
 
 Status ConnectionImpl::onBeforeFrameReceived(const nghttp2_frame_hd* hd) {
@@ -785,6 +886,10 @@ Status ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
     safeMemcpy(&data, &(frame->ping.opaque_data));
     ENVOY_CONN_LOG(trace, "recv PING ACK {}", connection_, data);
 
+    if (bdp_estimator_ != nullptr && data == BdpPingPayload) {
+      onBdpPingAck();
+      return okStatus();
+    }
     onKeepaliveResponse();
     return okStatus();
   }
@@ -981,10 +1086,20 @@ ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   // deleted before the codec object is deleted. This is presently guaranteed by the
   // destruction order of the Network::ConnectionImpl object where write_buffer_ is
   // destroyed before the filter_manager_ which owns the codec through Http::ConnectionManagerImpl.
-  connection_.write(buffer, false);
+  writeOutboundFrames(buffer);
   return length;
 }
 
+void ConnectionImpl::writeOutboundFrames(Buffer::OwnedImpl& output) {
+  if (deferred_send_callback_ != nullptr) {
+    // Small frames are copied into the last slice along with their drain trackers, so the frames
+    // of a send are written to the connection as a few large slices.
+    coalesced_frames_.move(output);
+  } else {
+    connection_.write(output, false);
+  }
+}
+
 int ConnectionImpl::onStreamClose(int32_t stream_id, uint32_t error_code) {
   StreamImpl* stream = getStream(stream_id);
   if (stream) {
@@ -1112,7 +1227,26 @@ Status ConnectionImpl::sendPendingFrames() {
     return okStatus();
   }
 
+  if (deferred_send_callback_ != nullptr) {
+    // Frames queued by further operations in this event loop iteration are sent together.
+    deferred_send_callback_->scheduleCallbackCurrentIteration();
+    return okStatus();
+  }
+  return sendPendingFramesNow();
+}
+
+Status ConnectionImpl::sendPendingFramesNow() {
+  if (dispatching_ || connection_.state() == Network::Connection::State::Closed) {
+    return okStatus();
+  }
+
+  if (deferred_send_callback_ != nullptr) {
+    deferred_send_callback_->cancel();
+  }
   const int rc = nghttp2_session_send(session_);
+  if (coalesced_frames_.length() > 0) {
+    connection_.write(coalesced_frames_, false);
+  }
   if (rc != 0) {
     ASSERT(rc == NGHTTP2_ERR_CALLBACK_FAILURE);
     return codecProtocolError(nghttp2_strerror(rc));
@@ -1137,7 +1271,7 @@ Status ConnectionImpl::sendPendingFrames() {
         stream->resetStreamWorker(stream->deferred_reset_.value());
       }
     }
-    RETURN_IF_ERROR(sendPendingFrames());
+    RETURN_IF_ERROR(sendPendingFramesNow());
   }
 
   // After all pending frames have been written into the outbound buffer check if any of
@@ -1158,6 +1292,18 @@ bool ConnectionImpl::sendPendingFramesAndHandleError() {
   return false;
 }
 
+void ConnectionImpl::onDeferredSend() {
+  if (!sendPendingFramesNow().ok()) {
+    scheduleProtocolConstraintViolationCallback();
+  }
+}
+
+void ConnectionImpl::flushPendingWrites() {
+  if (deferred_send_callback_ != nullptr && deferred_send_callback_->enabled()) {
+    onDeferredSend();
+  }
+}
+
 void ConnectionImpl::sendSettings(
     const envoy::config::core::v3::Http2ProtocolOptions& http2_options, bool disable_push) {
   absl::InlinedVector<nghttp2_settings_entry, 10> settings;
@@ -1266,17 +1412,12 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
             std::move(status));
       });
 
-  nghttp2_session_callbacks_set_on_header_callback(
+  nghttp2_session_callbacks_set_on_header_callback2(
       callbacks_,
-      [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
-         const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
-        // TODO PERF: Can reference count here to avoid copies.
-        HeaderString name;
-        name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
-        HeaderString value;
-        value.setCopy(reinterpret_cast<const char*>(raw_value), value_length);
-        return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, std::move(name),
-                                                                 std::move(value));
+      [](nghttp2_session*, const nghttp2_frame* frame, nghttp2_rcbuf* name, nghttp2_rcbuf* value,
+         uint8_t, void* user_data) -> int {
+        return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, toHeaderString(name),
+                                                                 toHeaderString(value));
       });
 
   nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
@@ -23,6 +23,7 @@
 #include "common/common/thread.h"
 #include "common/http/codec_helper.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http2/bdp_estimator.h"
 #include "common/http/http2/codec_stats.h"
 #include "common/http/http2/metadata_decoder.h"
 #include "common/http/http2/metadata_encoder.h"
@@ -124,6 +125,7 @@ public:
   void shutdownNotice() override;
   Status protocolErrorForTest(); // Used in tests to simulate errors.
   bool wantsToWrite() override { return nghttp2_session_want_write(session_); }
+  void flushPendingWrites() override;
   // Propagate network connection watermark events to each stream on the connection.
   void onUnderlyingConnectionAboveWriteBufferHighWatermark() override {
     for (auto& stream : active_streams_) {
@@ -237,6 +239,10 @@ protected:
     void setFlushTimeout(std::chrono::milliseconds timeout) override {
       stream_idle_timeout_ = timeout;
     }
+    void setAccount(Buffer::BufferMemoryAccountSharedPtr account) override {
+      pending_recv_data_.bindAccount(account);
+      pending_send_data_.bindAccount(std::move(account));
+    }
 
     // ScopeTrackedObject
     void dumpState(std::ostream& os, int indent_level) const override;
@@ -450,9 +456,20 @@ protected:
    *    frame accounting.
    *
    * TODO(yanavlasov): harmonize behavior for cases 2, 3.
+   *
+   * When frame writes are coalesced, sending outside of the dispatching context is deferred to the
+   * end of the current event loop iteration and `sendPendingFrames()` always returns success. The
+   * deferred send runs early if the frames are needed sooner, i.e. on GOAWAY, shutdown notice and
+   * before the connection is closed through `flushPendingWrites()`.
    */
   Status sendPendingFrames();
 
+  /**
+   * Like sendPendingFrames(), but sends immediately even when frame writes are coalesced. Used
+   * before the connection may be closed, e.g. after submitting GOAWAY.
+   */
+  Status sendPendingFramesNow();
+
   /**
    * Call the sendPendingFrames() method and schedule disconnect callback when
    * sendPendingFrames() returns an error.
@@ -553,12 +570,21 @@ private:
 
   // Adds buffer fragment for a new outbound frame to the supplied Buffer::OwnedImpl.
   void addOutboundFrameFragment(Buffer::OwnedImpl& output, const uint8_t* data, size_t length);
+  // Writes outbound frames to the connection, or holds them in coalesced_frames_ until the end of
+  // sendPendingFramesNow() when frame writes are coalesced.
+  void writeOutboundFrames(Buffer::OwnedImpl& output);
+  void onDeferredSend();
   virtual ProtocolConstraints::ReleasorProc
   trackOutboundFrames(bool is_outbound_flood_monitored_control_frame) PURE;
   virtual Status trackInboundFrames(const nghttp2_frame_hd* hd, uint32_t padding_length) PURE;
   void sendKeepalive();
   void onKeepaliveResponse();
   void onKeepaliveResponseTimeout();
+  void sendBdpPing();
+  void onBdpPingAck();
+  // Grows the connection and stream flow-control windows to the target, bounded by the window
+  // auto-tuning maximums.
+  void growWindows(uint64_t target_window_size);
   virtual StreamResetReason getMessagingErrorResetReason() const PURE;
 
   // Tracks the current slice we're processing in the dispatch loop.
@@ -567,12 +593,25 @@ private:
   bool raised_goaway_ : 1;
   bool pending_deferred_reset_ : 1;
   Event::SchedulableCallbackPtr protocol_constraint_violation_callback_;
+  // Only set when frame writes are coalesced.
+  Event::SchedulableCallbackPtr deferred_send_callback_;
+  // Frames written by nghttp2 during the current sendPendingFramesNow() call. Only used when frame
+  // writes are coalesced.
+  Buffer::OwnedImpl coalesced_frames_;
   Random::RandomGenerator& random_;
   Event::TimerPtr keepalive_send_timer_;
   Event::TimerPtr keepalive_timeout_timer_;
   std::chrono::milliseconds keepalive_interval_;
   std::chrono::milliseconds keepalive_timeout_;
   uint32_t keepalive_interval_jitter_percent_;
+  // Only set when flow-control windows are auto-tuned. The stream window is tracked by
+  // per_stream_buffer_limit_.
+  std::unique_ptr<BdpEstimator> bdp_estimator_;
+  uint32_t max_connection_window_size_{};
+  uint32_t max_stream_window_size_{};
+  uint32_t connection_window_size_{};
+  // Bytes by which the connection window has grown beyond its initial size.
+  uint64_t auto_tuned_window_bytes_{};
 };
 
 /**
@@ -28,8 +28,10 @@ namespace Http2 {
   COUNTER(tx_flush_timeout)                                                                        \
   COUNTER(tx_reset)                                                                                \
   COUNTER(keepalive_timeout)                                                                       \
+  COUNTER(window_auto_tuning_increases)                                                            \
   GAUGE(streams_active, Accumulate)                                                                \
-  GAUGE(pending_send_bytes, Accumulate)
+  GAUGE(pending_send_bytes, Accumulate)                                                            \
+  GAUGE(window_auto_tuning_bytes, Accumulate)
 
 /**
  * Wrapper struct for the HTTP/2 codec stats. @see stats_macros.h
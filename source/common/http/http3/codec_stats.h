@@ -21,6 +21,8 @@ namespace Http3 {
   COUNTER(rx_reset)                                                                                \
   COUNTER(trailers)                                                                                \
   COUNTER(tx_reset)                                                                                \
+  COUNTER(zero_rtt_accepted)                                                                       \
+  COUNTER(zero_rtt_rejected)                                                                       \
   GAUGE(streams_active, Accumulate)
 
 /**
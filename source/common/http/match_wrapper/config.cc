@@ -77,6 +77,9 @@ struct DelegatingFactoryCallbacks : public Envoy::Http::FilterChainFactoryCallba
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
     delegated_callbacks_.addAccessLogHandler(std::move(handler));
   }
+  void setFilterLatencyRecorder(Envoy::Http::FilterLatencyRecorder* recorder) override {
+    delegated_callbacks_.setFilterLatencyRecorder(recorder);
+  }
 
   Envoy::Http::FilterChainFactoryCallbacks& delegated_callbacks_;
   Matcher::MatchTreeSharedPtr<Envoy::Http::HttpMatchingData> match_tree_;
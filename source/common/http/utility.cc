@@ -175,6 +175,27 @@ initializeAndValidateOptions(const envoy::config::core::v3::Http2ProtocolOptions
              OptionsLimits::MIN_INITIAL_CONNECTION_WINDOW_SIZE &&
          options_clone.initial_connection_window_size().value() <=
              OptionsLimits::MAX_INITIAL_CONNECTION_WINDOW_SIZE);
+  if (options_clone.has_window_auto_tuning()) {
+    // Windows are only ever grown, so auto-tuning would have no effect on windows that start above
+    // their maximum, as the default initial windows do.
+    const auto& window_auto_tuning = options_clone.window_auto_tuning();
+    const uint32_t max_stream_window_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        window_auto_tuning, max_stream_window_size,
+        OptionsLimits::DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE);
+    const uint32_t max_connection_window_size = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        window_auto_tuning, max_connection_window_size,
+        OptionsLimits::DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE);
+    if (options_clone.initial_stream_window_size().value() > max_stream_window_size ||
+        options_clone.initial_connection_window_size().value() > max_connection_window_size) {
+      throw EnvoyException(fmt::format(
+          "window_auto_tuning requires initial_stream_window_size ({}) and "
+          "initial_connection_window_size ({}) to not exceed max_stream_window_size ({}) and "
+          "max_connection_window_size ({})",
+          options_clone.initial_stream_window_size().value(),
+          options_clone.initial_connection_window_size().value(), max_stream_window_size,
+          max_connection_window_size));
+    }
+  }
   if (!options_clone.has_max_outbound_frames()) {
     options_clone.mutable_max_outbound_frames()->set_value(
         OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES);
@@ -476,6 +497,14 @@ bool Utility::isWebSocketUpgradeRequest(const RequestHeaderMap& headers) {
                                  Http::Headers::get().UpgradeValues.WebSocket));
 }
 
+bool Utility::isIdempotentRequest(const RequestHeaderMap& headers) {
+  const absl::string_view method = headers.getMethodValue();
+  const auto& method_values = Http::Headers::get().MethodValues;
+  return method == method_values.Get || method == method_values.Head ||
+         method == method_values.Options || method == method_values.Trace ||
+         method == method_values.Put || method == method_values.Delete;
+}
+
 void Utility::sendLocalReply(const bool& is_reset, StreamDecoderFilterCallbacks& callbacks,
                              const LocalReplyData& local_reply_data) {
   absl::string_view details;
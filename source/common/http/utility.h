@@ -89,6 +89,8 @@ struct OptionsLimits {
   // our default connection-level window also equals to our stream-level
   static const uint32_t DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE = 256 * 1024 * 1024;
   static const uint32_t MAX_INITIAL_CONNECTION_WINDOW_SIZE = (1U << 31) - 1;
+  // Default bound of connection and stream windows grown by window auto-tuning.
+  static const uint32_t DEFAULT_MAX_AUTO_TUNED_WINDOW_SIZE = 16 * 1024 * 1024;
 
   // Default limit on the number of outbound frames of all types.
   static const uint32_t DEFAULT_MAX_OUTBOUND_FRAMES = 10000;
@@ -289,6 +291,12 @@ bool isH2UpgradeRequest(const RequestHeaderMap& headers);
  */
 bool isWebSocketUpgradeRequest(const RequestHeaderMap& headers);
 
+/**
+ * @return true if the request method is idempotent as defined by RFC 7231, so that the request is
+ *         safe to replay, false otherwise.
+ */
+bool isIdempotentRequest(const RequestHeaderMap& headers);
+
 struct EncodeFunctions {
   // Function to modify locally generated response headers.
   std::function<void(ResponseHeaderMap& headers)> modify_headers_;
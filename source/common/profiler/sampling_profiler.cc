@@ -0,0 +1,225 @@
+#include "common/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <map>
+#include <thread>
+
+#ifndef WIN32
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#endif
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+
+namespace Envoy {
+namespace Profiler {
+
+void SampledStacks::add(absl::Span<void* const> frames) {
+  ++counts_[std::vector<void*>(frames.begin(), frames.end())];
+  ++num_samples_;
+}
+
+std::string SampledStacks::collapsed() const {
+  // Many stacks share frames, so each program counter is only symbolized once.
+  absl::flat_hash_map<void*, std::string> symbols;
+  auto symbolize = [&symbols](void* pc) -> const std::string& {
+    auto iter = symbols.find(pc);
+    if (iter == symbols.end()) {
+      char name[1024];
+      std::string symbol =
+          absl::Symbolize(pc, name, sizeof(name)) ? std::string(name) : fmt::format("{}", pc);
+      // Frames are separated by ';', so it can't appear in a frame.
+      absl::StrReplaceAll({{";", ":"}}, &symbol);
+      iter = symbols.emplace(pc, std::move(symbol)).first;
+    }
+    return iter->second;
+  };
+
+  // Different program counters in a function all collapse into the function's frame.
+  std::map<std::string, uint64_t> collapsed_counts;
+  std::vector<absl::string_view> frames;
+  for (const auto& [stack, count] : counts_) {
+    frames.clear();
+    for (size_t i = stack.size(); i-- > 0;) {
+      // All frames but the innermost hold return addresses, which may be the start of the next
+      // function after the call, so they are symbolized one byte earlier, inside the call.
+      void* pc = i == 0 ? stack[i] : static_cast<char*>(stack[i]) - 1;
+      frames.push_back(symbolize(pc));
+    }
+    collapsed_counts[absl::StrJoin(frames, ";")] += count;
+  }
+
+  std::string output;
+  for (const auto& [stack, count] : collapsed_counts) {
+    absl::StrAppend(&output, stack, " ", count, "\n");
+  }
+  if (num_dropped_ > 0) {
+    absl::StrAppend(&output, "[dropped] ", num_dropped_, "\n");
+  }
+  return output;
+}
+
+uint32_t SamplingProfiler::maxSamples(std::chrono::microseconds interval,
+                                      std::chrono::microseconds duration) {
+  ASSERT(interval.count() > 0);
+  // Process CPU time, and so samples, accrue at most as fast as all CPUs together run.
+  const uint64_t cpus = std::max(1U, std::thread::hardware_concurrency());
+  const uint64_t samples = (duration.count() / interval.count() + 1) * cpus;
+  return static_cast<uint32_t>(std::min<uint64_t>(samples, MaxSamples));
+}
+
+#ifndef WIN32
+
+namespace {
+
+struct Sample {
+  int depth_;
+  void* frames_[SamplingProfiler::MaxStackDepth];
+};
+
+// The state shared with the signal handler, which may only use lock-free atomics, and the sample
+// it claims from samples.
+std::atomic<bool> profiler_running{false};
+std::atomic<bool> sampling{false};
+std::atomic<uint32_t> active_handlers{0};
+std::atomic<uint32_t> next_sample{0};
+Sample* samples = nullptr;
+uint32_t max_samples = 0;
+bool handler_installed = false;
+
+// The program counter the signal interrupted, which the unwinder doesn't report: it starts from
+// the interrupted function's return address.
+void* interruptedPc(void* context) {
+#if defined(__linux__) && defined(__x86_64__)
+  return reinterpret_cast<void*>(static_cast<ucontext_t*>(context)->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__linux__) && defined(__aarch64__)
+  return reinterpret_cast<void*>(static_cast<ucontext_t*>(context)->uc_mcontext.pc);
+#else
+  UNREFERENCED_PARAMETER(context);
+  return nullptr;
+#endif
+}
+
+void onSigProf(int, siginfo_t*, void* context) {
+  const int saved_errno = errno;
+  ++active_handlers;
+  // stop() clears sampling before waiting for the active handlers, so a handler that sees it set
+  // can safely write to samples.
+  if (sampling) {
+    const uint32_t index = next_sample++;
+    if (index < max_samples) {
+      Sample& sample = samples[index];
+      int depth = 0;
+      void* pc = interruptedPc(context);
+      if (pc != nullptr) {
+        sample.frames_[depth++] = pc;
+      }
+      sample.depth_ = depth + absl::GetStackTraceWithContext(
+                                  sample.frames_ + depth, SamplingProfiler::MaxStackDepth - depth,
+                                  /* skip_count = */ 1, context,
+                                  /* min_dropped_frames = */ nullptr);
+    }
+  }
+  --active_handlers;
+  errno = saved_errno;
+}
+
+bool setTimer(std::chrono::microseconds interval) {
+  itimerval timer{};
+  timer.it_interval.tv_sec = interval.count() / 1000000;
+  timer.it_interval.tv_usec = interval.count() % 1000000;
+  timer.it_value = timer.it_interval;
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+} // namespace
+
+bool SamplingProfiler::start(std::chrono::microseconds interval,
+                             std::chrono::microseconds duration) {
+  ASSERT(interval.count() > 0);
+  bool expected = false;
+  if (!profiler_running.compare_exchange_strong(expected, true)) {
+    return false;
+  }
+
+  if (!handler_installed) {
+    // Unwind once outside the handler, so the unwinder's lazy initialization doesn't run in it.
+    void* frame;
+    absl::GetStackTrace(&frame, 1, 0);
+
+    struct sigaction action {};
+    action.sa_sigaction = onSigProf;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      profiler_running = false;
+      return false;
+    }
+    // A SIGPROF may still be pending when the profiler stops, and its default action is to
+    // terminate the process, so the handler stays installed.
+    handler_installed = true;
+  }
+
+  max_samples = maxSamples(interval, duration);
+  samples = new Sample[max_samples];
+  next_sample = 0;
+  sampling = true;
+  if (!setTimer(interval)) {
+    sampling = false;
+    delete[] samples;
+    samples = nullptr;
+    profiler_running = false;
+    return false;
+  }
+  return true;
+}
+
+bool SamplingProfiler::running() { return profiler_running; }
+
+SampledStacks SamplingProfiler::stop() {
+  SampledStacks stacks;
+  if (!profiler_running) {
+    return stacks;
+  }
+
+  setTimer(std::chrono::microseconds(0));
+  sampling = false;
+  while (active_handlers != 0) {
+    std::this_thread::yield();
+  }
+
+  const uint32_t num_taken = next_sample;
+  const uint32_t num_kept = std::min(num_taken, max_samples);
+  for (uint32_t i = 0; i < num_kept; ++i) {
+    stacks.add(absl::MakeConstSpan(samples[i].frames_, samples[i].depth_));
+  }
+  stacks.setNumDropped(num_taken - num_kept);
+  delete[] samples;
+  samples = nullptr;
+  profiler_running = false;
+  return stacks;
+}
+
+#else
+
+bool SamplingProfiler::start(std::chrono::microseconds, std::chrono::microseconds) {
+  return false;
+}
+bool SamplingProfiler::running() { return false; }
+SampledStacks SamplingProfiler::stop() { return {}; }
+
+#endif
+
+} // namespace Profiler
+} // namespace Envoy
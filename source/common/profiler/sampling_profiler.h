@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * The stacks sampled by a SamplingProfiler, counted by stack.
+ */
+class SampledStacks {
+public:
+  /**
+   * Counts a sample.
+   * @param frames the program counters of the sampled stack, innermost first.
+   */
+  void add(absl::Span<void* const> frames);
+
+  /**
+   * @return the number of samples taken.
+   */
+  uint64_t numSamples() const { return num_samples_; }
+
+  /**
+   * @return the number of samples dropped because the profiler's buffer was full.
+   */
+  uint64_t numDropped() const { return num_dropped_; }
+  void setNumDropped(uint64_t num_dropped) { num_dropped_ = num_dropped; }
+
+  /**
+   * Symbolizes the stacks, and renders them in the collapsed format read by flamegraph tools:
+   * one line per distinct stack, holding its frames from the outermost, separated by ';',
+   * followed by a space and the number of samples of that stack. Lines are sorted by stack. If
+   * samples were dropped, a last line counts them under a single "[dropped]" frame.
+   */
+  std::string collapsed() const;
+
+private:
+  absl::flat_hash_map<std::vector<void*>, uint64_t> counts_;
+  uint64_t num_samples_{0};
+  uint64_t num_dropped_{0};
+};
+
+/**
+ * A process-wide sampling CPU profiler, which unlike Profiler::Cpu needs no special build. While
+ * it runs, a SIGPROF interval timer interrupts whichever thread is consuming CPU each time the
+ * process has used another interval of CPU time, and the signal handler copies the interrupted
+ * thread's stack into a buffer allocated up front. The samples are only symbolized and aggregated
+ * when the profiler is stopped. The buffer is sized for the samples of the expected duration with
+ * all CPUs busy, up to MaxSamples samples, which bounds the memory used; later samples are
+ * dropped. Only the part of the buffer holding samples is touched.
+ *
+ * SIGPROF and ITIMER_PROF are also used by the gperftools CPU profiler, so the two must not run at
+ * once. Only one SamplingProfiler may run at a time.
+ */
+class SamplingProfiler {
+public:
+  static constexpr int MaxStackDepth = 64;
+  static constexpr uint32_t MaxSamples = 1 << 18;
+
+  /**
+   * Starts sampling.
+   * @param interval the process CPU time between samples.
+   * @param duration how long the profiler is expected to run, which sizes the sample buffer.
+   * @return false if the profiler is already running, or can't run on this platform.
+   */
+  static bool start(std::chrono::microseconds interval, std::chrono::microseconds duration);
+
+  /**
+   * @return the number of samples the buffer holds for a profile of the given duration, i.e. the
+   *         samples taken if all CPUs are busy throughout, up to MaxSamples.
+   */
+  static uint32_t maxSamples(std::chrono::microseconds interval,
+                             std::chrono::microseconds duration);
+
+  /**
+   * @return whether the profiler is running.
+   */
+  static bool running();
+
+  /**
+   * Stops sampling, returning the samples taken since start().
+   */
+  static SampledStacks stop();
+};
+
+} // namespace Profiler
+} // namespace Envoy
@@ -25,16 +25,16 @@ ActiveQuicListener::ActiveQuicListener(
     uint32_t worker_index, uint32_t concurrency, Event::Dispatcher& dispatcher,
     Network::UdpConnectionHandler& parent, Network::ListenerConfig& listener_config,
     const quic::QuicConfig& quic_config, Network::Socket::OptionsSharedPtr options,
-    bool kernel_worker_routing, const envoy::config::core::v3::RuntimeFeatureFlag& enabled)
+    const envoy::config::core::v3::RuntimeFeatureFlag& enabled)
     : ActiveQuicListener(worker_index, concurrency, dispatcher, parent,
                          listener_config.listenSocketFactory().getListenSocket(), listener_config,
-                         quic_config, std::move(options), kernel_worker_routing, enabled) {}
+                         quic_config, std::move(options), enabled) {}
 
 ActiveQuicListener::ActiveQuicListener(
     uint32_t worker_index, uint32_t concurrency, Event::Dispatcher& dispatcher,
     Network::UdpConnectionHandler& parent, Network::SocketSharedPtr listen_socket,
     Network::ListenerConfig& listener_config, const quic::QuicConfig& quic_config,
-    Network::Socket::OptionsSharedPtr options, bool kernel_worker_routing,
+    Network::Socket::OptionsSharedPtr options,
     const envoy::config::core::v3::RuntimeFeatureFlag& enabled)
     : Server::ActiveUdpListenerBase(
           worker_index, concurrency, parent, *listen_socket,
@@ -42,8 +42,7 @@ ActiveQuicListener::ActiveQuicListener(
               listen_socket, *this,
               listener_config.udpListenerConfig()->config().downstream_socket_config()),
           &listener_config),
-      dispatcher_(dispatcher), version_manager_(quic::CurrentSupportedVersions()),
-      kernel_worker_routing_(kernel_worker_routing) {
+      dispatcher_(dispatcher), version_manager_(quic::CurrentSupportedVersions()) {
   // This flag fix a QUICHE issue which may crash Envoy during connection close.
   SetQuicReloadableFlag(quic_single_ack_in_packet2, true);
 
@@ -78,7 +77,7 @@ ActiveQuicListener::ActiveQuicListener(
   quic_dispatcher_ = std::make_unique<EnvoyQuicDispatcher>(
       crypto_config_.get(), quic_config, &version_manager_, std::move(connection_helper),
       std::move(alarm_factory), quic::kQuicDefaultConnectionIdLength, parent, *config_, stats_,
-      per_worker_stats_, dispatcher, listen_socket_);
+      per_worker_stats_, dispatcher, listen_socket_, worker_index, concurrency);
 
   // Create udp_packet_writer
   Network::UdpPacketWriterPtr udp_packet_writer =
@@ -169,17 +168,12 @@ void ActiveQuicListener::shutdownListener() {
 }
 
 uint32_t ActiveQuicListener::destination(const Network::UdpRecvData& data) const {
-  if (kernel_worker_routing_) {
-    // The kernel has already routed the packet correctly. Make it stay on the current worker.
-    return worker_index_;
-  }
-
-  // This implementation is not as performant as it could be. It will result in most packets being
-  // delivered by the kernel to the wrong worker, and then redirected to the correct worker.
-  //
-  // This could possibly be improved by keeping a global table of connection IDs, so that a new
-  // connection will add its connection ID to the table on the current worker, and so packets should
-  // be delivered to the correct worker by the kernel unless the client changes address.
+  // When the BPF program installed by ``ActiveQuicListenerFactory::createActiveUdpListener`` steers
+  // packets, the kernel has already routed almost all of them to the correct worker, and this only
+  // catches the ones it couldn't route. Otherwise the kernel routes packets by their addresses, and
+  // most of them are delivered to the wrong worker and then redirected to the correct worker.
+  // Connection IDs replaced by the server keep routing the connection to the worker that received
+  // its first packet, see ``EnvoyQuicDispatcher::GenerateNewServerConnectionId``.
 
   // This is a re-implementation of the same algorithm written in BPF in
   // ``ActiveQuicListenerFactory::createActiveUdpListener``
@@ -234,7 +228,6 @@ ActiveQuicListenerFactory::ActiveQuicListenerFactory(
 Network::ConnectionHandler::ActiveUdpListenerPtr ActiveQuicListenerFactory::createActiveUdpListener(
     uint32_t worker_index, Network::UdpConnectionHandler& parent, Event::Dispatcher& disptacher,
     Network::ListenerConfig& config) {
-  bool kernel_worker_routing = false;
   std::unique_ptr<Network::Socket::Options> options = std::make_unique<Network::Socket::Options>();
 
 #if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
@@ -282,8 +275,6 @@ Network::ConnectionHandler::ActiveUdpListenerPtr ActiveQuicListenerFactory::crea
             absl::string_view(reinterpret_cast<char*>(&prog), sizeof(prog))));
       }
     });
-
-    kernel_worker_routing = true;
   };
 
 #else
@@ -294,8 +285,7 @@ Network::ConnectionHandler::ActiveUdpListenerPtr ActiveQuicListenerFactory::crea
 #endif
 
   return std::make_unique<ActiveQuicListener>(worker_index, concurrency_, disptacher, parent,
-                                              config, quic_config_, std::move(options),
-                                              kernel_worker_routing, enabled_);
+                                              config, quic_config_, std::move(options), enabled_);
 } // namespace Quic
 
 } // namespace Quic
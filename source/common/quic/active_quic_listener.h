@@ -27,13 +27,13 @@ public:
   ActiveQuicListener(uint32_t worker_index, uint32_t concurrency, Event::Dispatcher& dispatcher,
                      Network::UdpConnectionHandler& parent,
                      Network::ListenerConfig& listener_config, const quic::QuicConfig& quic_config,
-                     Network::Socket::OptionsSharedPtr options, bool kernel_worker_routing,
+                     Network::Socket::OptionsSharedPtr options,
                      const envoy::config::core::v3::RuntimeFeatureFlag& enabled);
 
   ActiveQuicListener(uint32_t worker_index, uint32_t concurrency, Event::Dispatcher& dispatcher,
                      Network::UdpConnectionHandler& parent, Network::SocketSharedPtr listen_socket,
                      Network::ListenerConfig& listener_config, const quic::QuicConfig& quic_config,
-                     Network::Socket::OptionsSharedPtr options, bool kernel_worker_routing,
+                     Network::Socket::OptionsSharedPtr options,
                      const envoy::config::core::v3::RuntimeFeatureFlag& enabled);
 
   ~ActiveQuicListener() override;
@@ -66,7 +66,6 @@ private:
   Event::Dispatcher& dispatcher_;
   quic::QuicVersionManager version_manager_;
   std::unique_ptr<EnvoyQuicDispatcher> quic_dispatcher_;
-  const bool kernel_worker_routing_;
   absl::optional<Runtime::FeatureFlag> enabled_{};
   Network::UdpPacketWriter* udp_packet_writer_;
 
@@ -9,6 +9,7 @@
 
 #include "extensions/transport_sockets/tls/ssl_socket.h"
 
+#include "quiche/quic/core/crypto/quic_client_session_cache.h"
 #include "quiche/quic/core/http/quic_client_push_promise_index.h"
 #include "quiche/quic/core/quic_utils.h"
 
@@ -28,6 +29,8 @@ struct PersistentQuicInfoImpl : public Http::PersistentQuicInfo {
   // given connection pool.
   quic::QuicServerId server_id_;
   quic::ParsedQuicVersionVector supported_versions_{quic::CurrentSupportedVersions()};
+  // Caches the TLS sessions and transport parameters of previous connections to server_id_, which
+  // lets new connections resume them and send early (0-RTT) data.
   std::unique_ptr<quic::QuicCryptoClientConfig> crypto_config_;
 };
 
@@ -30,6 +30,8 @@ public:
   // Returns true if the session has data to send but queued in connection or
   // stream send buffer.
   bool wantsToWrite() override;
+  // The QUIC session bundles its writes itself.
+  void flushPendingWrites() override {}
 
 protected:
   QuicFilterManagerConnectionImpl& quic_session_;
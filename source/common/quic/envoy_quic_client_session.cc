@@ -14,7 +14,12 @@ EnvoyQuicClientSession::EnvoyQuicClientSession(
     : QuicFilterManagerConnectionImpl(*connection, dispatcher, send_buffer_limit),
       quic::QuicSpdyClientSession(config, supported_versions, connection.release(), server_id,
                                   crypto_config, push_promise_index),
-      host_name_(server_id.host()) {
+      host_name_(server_id.host()), early_data_cb_(dispatcher.createSchedulableCallback([this]() {
+        // The handshake may have completed or failed in the meantime.
+        if (connection()->connected() && !OneRttKeysAvailable()) {
+          raiseConnectionEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+        }
+      })) {
   // HTTP/3 header limits should be configurable, but for now hard-code to Envoy defaults.
   set_max_inbound_header_list_size(Http::DEFAULT_MAX_REQUEST_HEADERS_KB * 1000);
 }
@@ -106,9 +111,35 @@ EnvoyQuicClientSession::CreateIncomingStream(quic::PendingStream* /*pending*/) {
 bool EnvoyQuicClientSession::hasDataToWrite() { return HasDataToWrite(); }
 
 void EnvoyQuicClientSession::OnTlsHandshakeComplete() {
+  if (codec_stats_.has_value()) {
+    switch (GetCryptoStream()->EarlyDataReason()) {
+    case ssl_early_data_accepted:
+      codec_stats_->get().zero_rtt_accepted_.inc();
+      break;
+    case ssl_early_data_unknown:
+    case ssl_early_data_disabled:
+    case ssl_early_data_no_session_offered:
+    case ssl_early_data_unsupported_for_session:
+      // No early data was offered.
+      break;
+    default:
+      // QUICHE resends the rejected early data once the handshake completes.
+      codec_stats_->get().zero_rtt_rejected_.inc();
+      break;
+    }
+  }
   raiseConnectionEvent(Network::ConnectionEvent::Connected);
 }
 
+void EnvoyQuicClientSession::OnNewEncryptionKeyAvailable(
+    quic::EncryptionLevel level, std::unique_ptr<quic::QuicEncrypter> encrypter) {
+  quic::QuicSpdyClientSession::OnNewEncryptionKeyAvailable(level, std::move(encrypter));
+  if (level == quic::ENCRYPTION_ZERO_RTT) {
+    ENVOY_CONN_LOG(trace, "able to send early data", *this);
+    early_data_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
 size_t EnvoyQuicClientSession::WriteHeadersOnHeadersStream(
     quic::QuicStreamId id, spdy::SpdyHeaderBlock headers, bool fin,
     const spdy::SpdyStreamPrecedence& precedence,
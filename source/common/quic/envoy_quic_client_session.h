@@ -59,6 +59,8 @@ public:
   void OnGoAway(const quic::QuicGoAwayFrame& frame) override;
   void OnHttp3GoAway(uint64_t stream_id) override;
   void OnTlsHandshakeComplete() override;
+  void OnNewEncryptionKeyAvailable(quic::EncryptionLevel level,
+                                   std::unique_ptr<quic::QuicEncrypter> encrypter) override;
   size_t WriteHeadersOnHeadersStream(
       quic::QuicStreamId id, spdy::SpdyHeaderBlock headers, bool fin,
       const spdy::SpdyStreamPrecedence& precedence,
@@ -83,6 +85,9 @@ private:
   // them.
   Http::ConnectionCallbacks* http_connection_callbacks_{nullptr};
   const absl::string_view host_name_;
+  // Raises ConnectedZeroRtt once early data can be sent. The 0-RTT keys are installed by
+  // connect(), before the owner of the connection has added its connection callbacks.
+  Event::SchedulableCallbackPtr early_data_cb_;
 };
 
 } // namespace Quic
@@ -3,6 +3,7 @@
 #include "common/http/utility.h"
 #include "common/quic/envoy_quic_server_connection.h"
 #include "common/quic/envoy_quic_server_session.h"
+#include "common/quic/envoy_quic_utils.h"
 
 namespace Envoy {
 namespace Quic {
@@ -15,13 +16,13 @@ EnvoyQuicDispatcher::EnvoyQuicDispatcher(
     uint8_t expected_server_connection_id_length, Network::ConnectionHandler& connection_handler,
     Network::ListenerConfig& listener_config, Server::ListenerStats& listener_stats,
     Server::PerHandlerListenerStats& per_worker_stats, Event::Dispatcher& dispatcher,
-    Network::Socket& listen_socket)
+    Network::Socket& listen_socket, uint32_t worker_index, uint32_t concurrency)
     : quic::QuicDispatcher(&quic_config, crypto_config, version_manager, std::move(helper),
                            std::make_unique<EnvoyQuicCryptoServerStreamHelper>(),
                            std::move(alarm_factory), expected_server_connection_id_length),
       connection_handler_(connection_handler), listener_config_(listener_config),
       listener_stats_(listener_stats), per_worker_stats_(per_worker_stats), dispatcher_(dispatcher),
-      listen_socket_(listen_socket) {
+      listen_socket_(listen_socket), worker_index_(worker_index), concurrency_(concurrency) {
   // Set send buffer twice of max flow control window to ensure that stream send
   // buffer always takes all the data.
   // The max amount of data buffered is the per-stream high watermark + the max
@@ -46,6 +47,17 @@ void EnvoyQuicDispatcher::OnConnectionClosed(quic::QuicConnectionId connection_i
   connection_handler_.decNumConnections();
 }
 
+quic::QuicConnectionId
+EnvoyQuicDispatcher::GenerateNewServerConnectionId(quic::ParsedQuicVersion version,
+                                                   quic::QuicConnectionId connection_id) const {
+  quic::QuicConnectionId new_connection_id =
+      quic::QuicDispatcher::GenerateNewServerConnectionId(version, connection_id);
+  if (concurrency_ > 1 && new_connection_id.length() >= sizeof(uint32_t)) {
+    encodeWorkerIndexInConnectionId(new_connection_id, worker_index_, concurrency_);
+  }
+  return new_connection_id;
+}
+
 std::unique_ptr<quic::QuicSession> EnvoyQuicDispatcher::CreateQuicSession(
     quic::QuicConnectionId server_connection_id, const quic::QuicSocketAddress& self_address,
     const quic::QuicSocketAddress& peer_address, absl::string_view /*alpn*/,
@@ -52,12 +52,19 @@ public:
                       Network::ListenerConfig& listener_config,
                       Server::ListenerStats& listener_stats,
                       Server::PerHandlerListenerStats& per_worker_stats,
-                      Event::Dispatcher& dispatcher, Network::Socket& listen_socket);
+                      Event::Dispatcher& dispatcher, Network::Socket& listen_socket,
+                      uint32_t worker_index, uint32_t concurrency);
 
   void OnConnectionClosed(quic::QuicConnectionId connection_id, quic::QuicErrorCode error,
                           const std::string& error_details,
                           quic::ConnectionCloseSource source) override;
 
+  // Encodes the index of this worker in the replacements of client chosen connection IDs, so that
+  // the packets of the connection keep being routed to this worker.
+  quic::QuicConnectionId
+  GenerateNewServerConnectionId(quic::ParsedQuicVersion version,
+                                quic::QuicConnectionId connection_id) const override;
+
 protected:
   std::unique_ptr<quic::QuicSession>
   CreateQuicSession(quic::QuicConnectionId server_connection_id,
@@ -72,6 +79,8 @@ private:
   Server::PerHandlerListenerStats& per_worker_stats_;
   Event::Dispatcher& dispatcher_;
   Network::Socket& listen_socket_;
+  const uint32_t worker_index_;
+  const uint32_t concurrency_;
 };
 
 } // namespace Quic
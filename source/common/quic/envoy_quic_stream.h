@@ -108,6 +108,9 @@ public:
   const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
     return connection()->addressProvider().localAddress();
   }
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {
+    // Stream data is buffered by QUICHE, which is not yet accounted for.
+  }
 
   // SendBufferMonitor
   void updateBytesBuffered(size_t old_buffered_bytes, size_t new_buffered_bytes) override {
@@ -1,5 +1,8 @@
 #include "common/quic/envoy_quic_utils.h"
 
+#include <cstring>
+#include <limits>
+
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
 
@@ -223,5 +226,29 @@ int deduceSignatureAlgorithmFromPublicKey(const EVP_PKEY* public_key, std::strin
   return sign_alg;
 }
 
+uint32_t connectionIdWorkerIndex(const quic::QuicConnectionId& connection_id,
+                                 uint32_t concurrency) {
+  ASSERT(connection_id.length() >= sizeof(uint32_t));
+  uint32_t connection_id_snippet;
+  memcpy(&connection_id_snippet, connection_id.data(), sizeof(connection_id_snippet));
+  return ntohl(connection_id_snippet) % concurrency;
+}
+
+void encodeWorkerIndexInConnectionId(quic::QuicConnectionId& connection_id, uint32_t worker_index,
+                                     uint32_t concurrency) {
+  ASSERT(connection_id.length() >= sizeof(uint32_t));
+  ASSERT(worker_index < concurrency);
+  uint32_t connection_id_snippet;
+  memcpy(&connection_id_snippet, connection_id.data(), sizeof(connection_id_snippet));
+  const uint64_t snippet = ntohl(connection_id_snippet);
+  // Replace the remainder of the division by the number of workers with the worker index.
+  uint64_t adjusted_snippet = snippet - snippet % concurrency + worker_index;
+  if (adjusted_snippet > std::numeric_limits<uint32_t>::max()) {
+    adjusted_snippet -= concurrency;
+  }
+  connection_id_snippet = htonl(static_cast<uint32_t>(adjusted_snippet));
+  memcpy(connection_id.mutable_data(), &connection_id_snippet, sizeof(connection_id_snippet));
+}
+
 } // namespace Quic
 } // namespace Envoy
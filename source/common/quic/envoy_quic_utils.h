@@ -14,6 +14,7 @@
 #pragma GCC diagnostic ignored "-Winvalid-offsetof"
 #endif
 
+#include "quiche/quic/core/quic_connection_id.h"
 #include "quiche/quic/core/quic_types.h"
 
 #if defined(__GNUC__)
@@ -125,5 +126,15 @@ bssl::UniquePtr<X509> parseDERCertificate(const std::string& der_bytes, std::str
 // not supported, return 0 with error_details populated correspondingly.
 int deduceSignatureAlgorithmFromPublicKey(const EVP_PKEY* public_key, std::string* error_details);
 
+// Returns the index of the worker that packets carrying the given connection ID are routed to by
+// ActiveQuicListener::destination() and the BPF program installed by ActiveQuicListenerFactory:
+// the first 4 bytes of the connection ID in network byte order, modulo the number of workers.
+uint32_t connectionIdWorkerIndex(const quic::QuicConnectionId& connection_id, uint32_t concurrency);
+
+// Rewrites the first 4 bytes of a connection ID, which must be at least 4 bytes long, so that
+// packets carrying it are routed to the given worker. The other bits of these bytes are preserved.
+void encodeWorkerIndexInConnectionId(quic::QuicConnectionId& connection_id, uint32_t worker_index,
+                                     uint32_t concurrency);
+
 } // namespace Quic
 } // namespace Envoy
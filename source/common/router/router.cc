@@ -283,6 +283,14 @@ FilterUtility::StrictHeaderChecker::checkHeader(Http::RequestHeaderMap& headers,
   NOT_REACHED_GCOVR_EXCL_LINE;
 }
 
+const Server::OverloadActionState& FilterConfig::bufferLimitReduction() {
+  if (overload_manager_ == nullptr) {
+    return inactive_overload_state_;
+  }
+  return overload_manager_->getThreadLocalOverloadState().getState(
+      Server::OverloadActionNames::get().ReduceBufferLimits);
+}
+
 Stats::StatName Filter::upstreamZone(Upstream::HostDescriptionConstSharedPtr upstream_host) {
   return upstream_host ? upstream_host->localityZoneStatName() : config_.empty_stat_name_;
 }
@@ -414,9 +422,14 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
   // A route entry matches for the request.
   route_entry_ = route_->routeEntry();
   // If there's a route specific limit and it's smaller than general downstream
-  // limits, apply the new cap.
-  retry_shadow_buffer_limit_ =
-      std::min(retry_shadow_buffer_limit_, route_entry_->retryShadowBufferLimit());
+  // limits, apply the new cap. The downstream limit was already scaled down by the HCM if the
+  // process is under memory pressure, so only the route limit is scaled here.
+  if (route_entry_->retryShadowBufferLimit() < retry_shadow_buffer_limit_) {
+    retry_shadow_buffer_limit_ =
+        std::min(retry_shadow_buffer_limit_,
+                 Buffer::scaleBufferLimit(route_entry_->retryShadowBufferLimit(),
+                                          config_.bufferLimitReduction().value()));
+  }
   callbacks_->streamInfo().setRouteName(route_entry_->routeName());
   if (debug_config && debug_config->append_cluster_) {
     // The cluster name will be appended to any local or upstream responses from this point.
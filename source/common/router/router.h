@@ -15,6 +15,7 @@
 #include "envoy/router/shadow_writer.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/server/overload/overload_manager.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
@@ -199,6 +200,7 @@ public:
     for (const auto& upstream_log : config.upstream_log()) {
       upstream_logs_.push_back(AccessLog::AccessLogFactory::fromProto(upstream_log, context));
     }
+    overload_manager_ = &context.overloadManager();
   }
   using HeaderVector = std::vector<Http::LowerCaseString>;
   using HeaderVectorPtr = std::unique_ptr<HeaderVector>;
@@ -206,6 +208,11 @@ public:
   ShadowWriter& shadowWriter() { return *shadow_writer_; }
   TimeSource& timeSource() { return time_source_; }
 
+  /**
+   * @return the calling worker's state of the reduce buffer limits overload action.
+   */
+  const Server::OverloadActionState& bufferLimitReduction();
+
   Stats::Scope& scope_;
   const LocalInfo::LocalInfo& local_info_;
   Upstream::ClusterManager& cm_;
@@ -226,6 +233,10 @@ public:
 private:
   ShadowWriterPtr shadow_writer_;
   TimeSource& time_source_;
+  // Only set when the config is created from a factory context.
+  Server::OverloadManager* overload_manager_{};
+  const Server::OverloadActionState inactive_overload_state_{
+      Server::OverloadActionState::inactive()};
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
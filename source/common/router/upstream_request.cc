@@ -187,6 +187,10 @@ const Network::Connection& UpstreamRequest::connection() const {
   return *parent_.callbacks()->connection();
 }
 
+Buffer::BufferMemoryAccountSharedPtr UpstreamRequest::account() const {
+  return parent_.callbacks()->account();
+}
+
 void UpstreamRequest::decodeMetadata(Http::MetadataMapPtr&& metadata_map) {
   parent_.onUpstreamMetadata(std::move(metadata_map));
 }
@@ -224,6 +228,7 @@ void UpstreamRequest::encodeData(Buffer::Instance& data, bool end_stream) {
           [this]() -> void { this->disableDataFromDownstreamForFlowControl(); },
           []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
       buffered_request_body_->setWatermarks(parent_.callbacks()->decoderBufferLimit());
+      buffered_request_body_->bindAccount(account());
     }
 
     buffered_request_body_->move(data);
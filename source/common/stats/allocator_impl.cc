@@ -1,6 +1,7 @@
 #include "common/stats/allocator_impl.h"
 
 #include <cstdint>
+#include <memory>
 
 #include "envoy/stats/stats.h"
 #include "envoy/stats/symbol_table.h"
@@ -45,14 +46,20 @@ void AllocatorImpl::debugPrint() {
 // which we need in order to clean up the counter and gauge maps in that class
 // when they are destroyed.
 //
+// Nor do we store the alloc: stats are carved out of the alloc's slab pools,
+// which let us find it from the stat's address, saving 8 bytes per stat. They
+// must therefore be constructed with placement new on memory from the pool
+// for their type, and deleting them returns the memory there.
+//
 // We implement the RefcountInterface API, using 16 bits that would otherwise be
 // wasted in the alignment padding next to flags_.
 template <class BaseClass> class StatsSharedImpl : public MetricImpl<BaseClass> {
 public:
   StatsSharedImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
                   const StatNameTagVector& stat_name_tags)
-      : MetricImpl<BaseClass>(name, tag_extracted_name, stat_name_tags, alloc.symbolTable()),
-        alloc_(alloc) {}
+      : MetricImpl<BaseClass>(name, tag_extracted_name, stat_name_tags, alloc.symbolTable()) {
+    ASSERT(&this->alloc() == &alloc);
+  }
 
   ~StatsSharedImpl() override {
     // MetricImpl must be explicitly cleared() before destruction, otherwise it
@@ -62,8 +69,16 @@ public:
     this->clear(symbolTable());
   }
 
+  // Stats are only ever allocated from an AllocatorImpl's slab pools.
+  static void* operator new(size_t) = delete;
+  static void operator delete(void* object) {
+    AllocatorImpl& alloc = *static_cast<AllocatorImpl*>(StatSlabPool::owner(object));
+    Thread::LockGuard lock(alloc.mutex_);
+    StatSlabPool::free(object);
+  }
+
   // Metric
-  SymbolTable& symbolTable() final { return alloc_.symbolTable(); }
+  SymbolTable& symbolTable() final { return alloc().symbolTable(); }
   bool used() const override { return flags_ & Metric::Flags::Used; }
 
   // RefcountInterface
@@ -80,11 +95,12 @@ public:
     // destruct anything. But it seems preferable at to be conservative here,
     // as stats will only go out of scope when a scope is destructed (during
     // xDS) or during admin stats operations.
-    Thread::LockGuard lock(alloc_.mutex_);
+    AllocatorImpl& alloc = this->alloc();
+    Thread::LockGuard lock(alloc.mutex_);
     ASSERT(ref_count_ >= 1);
     if (--ref_count_ == 0) {
-      alloc_.sync().syncPoint(AllocatorImpl::DecrementToZeroSyncPoint);
-      removeFromSetLockHeld();
+      alloc.sync().syncPoint(AllocatorImpl::DecrementToZeroSyncPoint);
+      removeFromSetLockHeld(alloc);
       return true;
     }
     return false;
@@ -96,10 +112,11 @@ public:
    * our ref-count decrement hits zero. The counters and gauges are held in
    * distinct sets so we virtualize this removal helper.
    */
-  virtual void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) PURE;
+  virtual void removeFromSetLockHeld(AllocatorImpl& alloc)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc.mutex_) PURE;
 
 protected:
-  AllocatorImpl& alloc_;
+  AllocatorImpl& alloc() const { return *static_cast<AllocatorImpl*>(StatSlabPool::owner(this)); }
 
   // ref_count_ can be incremented as an atomic, without taking a new lock, as
   // the critical 0->1 transition occurs in makeCounter and makeGauge, which
@@ -107,9 +124,9 @@ protected:
   // but these are always in transition to ref-count 2 or higher, and thus
   // cannot race with a decrement to zero.
   //
-  // However, we must hold alloc_.mutex_ when decrementing ref_count_ so that
-  // when it hits zero we can atomically remove it from alloc_.counters_ or
-  // alloc_.gauges_. We leave it atomic to avoid taking the lock on increment.
+  // However, we must hold alloc().mutex_ when decrementing ref_count_ so that
+  // when it hits zero we can atomically remove it from alloc().counters_ or
+  // alloc().gauges_. We leave it atomic to avoid taking the lock on increment.
   std::atomic<uint32_t> ref_count_{0};
 
   std::atomic<uint16_t> flags_{0};
@@ -121,8 +138,9 @@ public:
               const StatNameTagVector& stat_name_tags)
       : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
 
-  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
-    const size_t count = alloc_.counters_.erase(statName());
+  void removeFromSetLockHeld(AllocatorImpl& alloc)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc.mutex_) override {
+    const size_t count = alloc.counters_.erase(statName());
     ASSERT(count == 1);
   }
 
@@ -144,6 +162,82 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// A counter for the few stats incremented on every request by every worker, such as
+// downstream_rq_total. CounterImpl::add() writes to two atomics shared by all threads, whose
+// cache line then bounces between the cores incrementing it. Here each thread instead adds to its
+// own shard, on its own cache line, and the shards are only summed when the counter is read or
+// latched on the main thread. The shards are allocated separately, as the slab pool doesn't align
+// objects to cache lines.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  // Threads are assigned shards round-robin, so with more threads than shards a few threads share
+  // each shard, which still divides the contention.
+  static constexpr uint32_t NumShards = 32;
+
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags),
+        shards_(new Shard[NumShards]) {}
+
+  void removeFromSetLockHeld(AllocatorImpl& alloc)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc.mutex_) override {
+    const size_t count = alloc.counters_.erase(statName());
+    ASSERT(count == 1);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    shards_[shardIndex()].value_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write flags_ the first time, so that it stays shared between the threads' caches.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    const uint64_t total = sum();
+    uint64_t latched = latched_value_;
+    do {
+      if (total <= latched) {
+        return 0;
+      }
+    } while (!latched_value_.compare_exchange_weak(latched, total));
+    return total - latched;
+  }
+  void reset() override {
+    // Rebase the latched value too, so that the next latch() only reports increments made after
+    // the reset. Both latch() and reset() run on the main thread.
+    const uint64_t total = sum();
+    reset_value_ = total;
+    latched_value_ = total;
+  }
+  uint64_t value() const override { return sum() - reset_value_; }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  static uint32_t shardIndex() {
+    static std::atomic<uint32_t> next_thread_index{0};
+    static thread_local const uint32_t thread_index = next_thread_index++ % NumShards;
+    return thread_index;
+  }
+
+  uint64_t sum() const {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < NumShards; ++i) {
+      total += shards_[i].value_.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  std::unique_ptr<Shard[]> shards_;
+  // The sum of the shards when the counter was last latched, and when it was last reset.
+  std::atomic<uint64_t> latched_value_{0};
+  std::atomic<uint64_t> reset_value_{0};
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -165,8 +259,9 @@ public:
     }
   }
 
-  void removeFromSetLockHeld() override ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) {
-    const size_t count = alloc_.gauges_.erase(statName());
+  void removeFromSetLockHeld(AllocatorImpl& alloc) override
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc.mutex_) {
+    const size_t count = alloc.gauges_.erase(statName());
     ASSERT(count == 1);
   }
 
@@ -237,8 +332,9 @@ public:
                   const StatNameTagVector& stat_name_tags)
       : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
 
-  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
-    const size_t count = alloc_.text_readouts_.erase(statName());
+  void removeFromSetLockHeld(AllocatorImpl& alloc)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc.mutex_) override {
+    const size_t count = alloc.text_readouts_.erase(statName());
     ASSERT(count == 1);
   }
 
@@ -258,6 +354,11 @@ private:
   std::string value_ ABSL_GUARDED_BY(mutex_);
 };
 
+AllocatorImpl::AllocatorImpl(SymbolTable& symbol_table)
+    : symbol_table_(symbol_table), counter_pool_(this, sizeof(CounterImpl)),
+      sharded_counter_pool_(this, sizeof(ShardedCounterImpl)), gauge_pool_(this, sizeof(GaugeImpl)),
+      text_readout_pool_(this, sizeof(TextReadoutImpl)) {}
+
 CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
   Thread::LockGuard lock(mutex_);
@@ -272,6 +373,21 @@ CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracte
   return counter;
 }
 
+CounterSharedPtr AllocatorImpl::makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                                   const StatNameTagVector& stat_name_tags) {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(gauges_.find(name) == gauges_.end());
+  ASSERT(text_readouts_.find(name) == text_readouts_.end());
+  auto iter = counters_.find(name);
+  if (iter != counters_.end()) {
+    return CounterSharedPtr(*iter);
+  }
+  auto counter = CounterSharedPtr(::new (sharded_counter_pool_.allocate()) ShardedCounterImpl(
+      name, *this, tag_extracted_name, stat_name_tags));
+  counters_.insert(counter.get());
+  return counter;
+}
+
 GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, StatName tag_extracted_name,
                                         const StatNameTagVector& stat_name_tags,
                                         Gauge::ImportMode import_mode) {
@@ -282,8 +398,9 @@ GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, StatName tag_extracted_na
   if (iter != gauges_.end()) {
     return GaugeSharedPtr(*iter);
   }
-  auto gauge =
-      GaugeSharedPtr(new GaugeImpl(name, *this, tag_extracted_name, stat_name_tags, import_mode));
+  auto gauge = GaugeSharedPtr(::new (gauge_pool_.allocate())
+                                  GaugeImpl(name, *this, tag_extracted_name, stat_name_tags,
+                                            import_mode));
   gauges_.insert(gauge.get());
   return gauge;
 }
@@ -297,8 +414,9 @@ TextReadoutSharedPtr AllocatorImpl::makeTextReadout(StatName name, StatName tag_
   if (iter != text_readouts_.end()) {
     return TextReadoutSharedPtr(*iter);
   }
-  auto text_readout =
-      TextReadoutSharedPtr(new TextReadoutImpl(name, *this, tag_extracted_name, stat_name_tags));
+  auto text_readout = TextReadoutSharedPtr(::new (text_readout_pool_.allocate())
+                                               TextReadoutImpl(name, *this, tag_extracted_name,
+                                                               stat_name_tags));
   text_readouts_.insert(text_readout.get());
   return text_readout;
 }
@@ -313,7 +431,8 @@ bool AllocatorImpl::isMutexLockedForTest() {
 
 Counter* AllocatorImpl::makeCounterInternal(StatName name, StatName tag_extracted_name,
                                             const StatNameTagVector& stat_name_tags) {
-  return new CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
+  return ::new (counter_pool_.allocate())
+      CounterImpl(name, *this, tag_extracted_name, stat_name_tags);
 }
 
 } // namespace Stats
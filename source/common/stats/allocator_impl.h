@@ -8,6 +8,7 @@
 
 #include "common/common/thread_synchronizer.h"
 #include "common/stats/metric_impl.h"
+#include "common/stats/stat_slab_pool.h"
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
@@ -19,12 +20,14 @@ class AllocatorImpl : public Allocator {
 public:
   static const char DecrementToZeroSyncPoint[];
 
-  AllocatorImpl(SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+  AllocatorImpl(SymbolTable& symbol_table);
   ~AllocatorImpl() override;
 
   // Allocator
   CounterSharedPtr makeCounter(StatName name, StatName tag_extracted_name,
                                const StatNameTagVector& stat_name_tags) override;
+  CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                      const StatNameTagVector& stat_name_tags) override;
   GaugeSharedPtr makeGauge(StatName name, StatName tag_extracted_name,
                            const StatNameTagVector& stat_name_tags,
                            Gauge::ImportMode import_mode) override;
@@ -48,12 +51,14 @@ public:
   bool isMutexLockedForTest();
 
 protected:
+  // Called with mutex_ held.
   virtual Counter* makeCounterInternal(StatName name, StatName tag_extracted_name,
                                        const StatNameTagVector& stat_name_tags);
 
 private:
   template <class BaseClass> friend class StatsSharedImpl;
   friend class CounterImpl;
+  friend class ShardedCounterImpl;
   friend class GaugeImpl;
   friend class TextReadoutImpl;
   friend class NotifyingAllocatorImpl;
@@ -74,6 +79,13 @@ private:
   // protected by locks.
   Thread::MutexBasicLockable mutex_;
 
+  // The storage for counters_, gauges_ and text_readouts_, which is allocated and freed with
+  // mutex_ held.
+  StatSlabPool counter_pool_;
+  StatSlabPool sharded_counter_pool_;
+  StatSlabPool gauge_pool_;
+  StatSlabPool text_readout_pool_;
+
   Thread::ThreadSynchronizer sync_;
 };
 
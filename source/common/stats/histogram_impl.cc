@@ -34,6 +34,13 @@ HistogramStatisticsImpl::HistogramStatisticsImpl(const histogram_t* histogram_pt
   }
 }
 
+HistogramStatisticsImpl::HistogramStatisticsImpl(const LogLinearHistogram& histogram,
+                                                 ConstSupportedBuckets& supported_buckets)
+    : supported_buckets_(supported_buckets),
+      computed_quantiles_(HistogramStatisticsImpl::supportedQuantiles().size(), 0.0) {
+  refresh(histogram);
+}
+
 const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
   CONSTRUCT_ON_FIRST_USE(std::vector<double>,
                          {0, 0.25, 0.5, 0.75, 0.90, 0.95, 0.99, 0.995, 0.999, 1});
@@ -81,6 +88,24 @@ void HistogramStatisticsImpl::refresh(const histogram_t* new_histogram_ptr) {
   }
 }
 
+void HistogramStatisticsImpl::refresh(const LogLinearHistogram& new_histogram) {
+  const std::vector<double>& supported_quantiles = supportedQuantiles();
+  ASSERT(supported_quantiles.size() == computed_quantiles_.size());
+  for (size_t i = 0; i < supported_quantiles.size(); ++i) {
+    computed_quantiles_[i] = new_histogram.quantile(supported_quantiles[i]);
+  }
+
+  sample_count_ = new_histogram.sampleCount();
+  sample_sum_ = new_histogram.sampleSum();
+
+  computed_buckets_.clear();
+  ConstSupportedBuckets& supported_buckets = supportedBuckets();
+  computed_buckets_.reserve(supported_buckets.size());
+  for (const auto bucket : supported_buckets) {
+    computed_buckets_.emplace_back(new_histogram.countBelow(bucket));
+  }
+}
+
 HistogramSettingsImpl::HistogramSettingsImpl(const envoy::config::metrics::v3::StatsConfig& config)
     : configs_([&config]() {
         std::vector<Config> configs;
@@ -91,7 +116,10 @@ HistogramSettingsImpl::HistogramSettingsImpl(const envoy::config::metrics::v3::S
         }
 
         return configs;
-      }()) {}
+      }()),
+      relative_error_(config.has_histogram_relative_error()
+                          ? absl::make_optional(config.histogram_relative_error().value())
+                          : absl::nullopt) {}
 
 const ConstSupportedBuckets& HistogramSettingsImpl::buckets(absl::string_view stat_name) const {
   for (const auto& config : configs_) {
@@ -0,0 +1,119 @@
+#include "common/stats/log_linear_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+// Keeps the bucket indexes of all 64 bit values within 32 bits.
+constexpr uint32_t MaxPrecisionBits = 16;
+} // namespace
+
+LogLinearHistogram::LogLinearHistogram(uint32_t precision_bits) : precision_bits_(precision_bits) {
+  ASSERT(precision_bits_ >= 1 && precision_bits_ <= MaxPrecisionBits);
+}
+
+uint32_t LogLinearHistogram::precisionBits(double relative_error) {
+  ASSERT(relative_error > 0);
+  return static_cast<uint32_t>(std::clamp(std::ceil(-std::log2(relative_error)), 1.0,
+                                          static_cast<double>(MaxPrecisionBits)));
+}
+
+uint32_t LogLinearHistogram::bucketIndex(uint64_t value) const {
+  if (value < (uint64_t(1) << precision_bits_)) {
+    return value;
+  }
+  // Keep the precision_bits_ + 1 most significant bits of the value, the highest of which is
+  // always set. The number of bits shifted out identifies the power of two.
+  const uint32_t shift = 63 - __builtin_clzll(value) - precision_bits_;
+  return (shift << precision_bits_) + (value >> shift);
+}
+
+double LogLinearHistogram::bucketLowerBound(uint32_t index) const {
+  if (index < (uint32_t(1) << precision_bits_)) {
+    return index;
+  }
+  const uint32_t shift = (index >> precision_bits_) - 1;
+  return std::ldexp(index - (shift << precision_bits_), shift);
+}
+
+void LogLinearHistogram::extend(uint32_t first, uint32_t last) {
+  if (counts_.empty()) {
+    first_index_ = first;
+    counts_.assign(last - first + 1, 0);
+    return;
+  }
+  const uint32_t new_first = std::min(first, first_index_);
+  const uint32_t new_last = std::max<uint32_t>(last, first_index_ + counts_.size() - 1);
+  counts_.insert(counts_.begin(), first_index_ - new_first, 0);
+  counts_.resize(new_last - new_first + 1, 0);
+  first_index_ = new_first;
+}
+
+void LogLinearHistogram::recordValue(uint64_t value) {
+  const uint32_t index = bucketIndex(value);
+  if (index < first_index_ || index - first_index_ >= counts_.size()) {
+    extend(index, index);
+  }
+  ++counts_[index - first_index_];
+  ++sample_count_;
+  sample_sum_ += value;
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+  ASSERT(precision_bits_ == other.precision_bits_);
+  if (other.counts_.empty()) {
+    return;
+  }
+  extend(other.first_index_, other.first_index_ + other.counts_.size() - 1);
+  uint64_t* counts = counts_.data() + (other.first_index_ - first_index_);
+  const uint64_t* other_counts = other.counts_.data();
+  const size_t size = other.counts_.size();
+  for (size_t i = 0; i < size; ++i) {
+    counts[i] += other_counts[i];
+  }
+  sample_count_ += other.sample_count_;
+  sample_sum_ += other.sample_sum_;
+}
+
+void LogLinearHistogram::clear() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  sample_count_ = 0;
+  sample_sum_ = 0;
+}
+
+double LogLinearHistogram::quantile(double q) const {
+  if (sample_count_ == 0) {
+    return 0;
+  }
+  const double rank = std::clamp(q, 0.0, 1.0) * sample_count_;
+  uint64_t below = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    const uint64_t count = counts_[i];
+    if (count == 0) {
+      continue;
+    }
+    if (below + count >= rank) {
+      const uint32_t index = first_index_ + i;
+      const double lower = bucketLowerBound(index);
+      return lower + (bucketUpperBound(index) - lower) * (rank - below) / count;
+    }
+    below += count;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+uint64_t LogLinearHistogram::countBelow(double bound) const {
+  uint64_t count = 0;
+  for (size_t i = 0; i < counts_.size() && bucketUpperBound(first_index_ + i) <= bound; ++i) {
+    count += counts_[i];
+  }
+  return count;
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Log-linear histogram of integer values, in the style of HDR histograms. Values below
+ * 2^precision_bits each get a bucket of their own, and larger values are split into
+ * 2^precision_bits buckets per power of two, so that each bucket is at most 2^-precision_bits
+ * times as wide as its lower bound.
+ *
+ * The counts are kept in a dense array covering the buckets recorded so far. The array is kept
+ * across clear(), so a histogram recording a steady distribution stops allocating after its first
+ * interval, and merging histograms adds their arrays element-wise, which compilers vectorize.
+ */
+class LogLinearHistogram {
+public:
+  explicit LogLinearHistogram(uint32_t precision_bits);
+
+  /**
+   * @param relative_error the largest acceptable width of a bucket relative to its lower bound.
+   * @return the smallest number of precision bits giving buckets within relative_error.
+   */
+  static uint32_t precisionBits(double relative_error);
+
+  void recordValue(uint64_t value);
+
+  /**
+   * Adds the values recorded in another histogram, which must have the same precision.
+   */
+  void merge(const LogLinearHistogram& other);
+
+  /**
+   * Forgets all recorded values, keeping the allocated buckets.
+   */
+  void clear();
+
+  /**
+   * @return the value below which the fraction q of the recorded values fall, interpolating
+   *         linearly within buckets, or 0 if no value was recorded.
+   */
+  double quantile(double q) const;
+
+  /**
+   * @return the number of recorded values in buckets whose exclusive upper bound is at most
+   *         bound, as circllhist counts them.
+   */
+  uint64_t countBelow(double bound) const;
+
+  uint32_t precisionBits() const { return precision_bits_; }
+  uint64_t sampleCount() const { return sample_count_; }
+  double sampleSum() const { return sample_sum_; }
+
+private:
+  uint32_t bucketIndex(uint64_t value) const;
+  double bucketLowerBound(uint32_t index) const;
+  double bucketUpperBound(uint32_t index) const { return bucketLowerBound(index + 1); }
+  // Grows counts_ to cover the buckets from first to last, inclusive.
+  void extend(uint32_t first, uint32_t last);
+
+  const uint32_t precision_bits_;
+  // The bucket index of counts_[0].
+  uint32_t first_index_{};
+  std::vector<uint64_t> counts_;
+  uint64_t sample_count_{};
+  double sample_sum_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
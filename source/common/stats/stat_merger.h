@@ -3,6 +3,7 @@
 #include "envoy/stats/store.h"
 
 #include "common/protobuf/protobuf.h"
+#include "common/stats/stat_snapshot.h"
 #include "common/stats/symbol_table_impl.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -33,6 +34,16 @@ public:
      */
     StatName makeDynamicStatName(const std::string& name, const DynamicsMap& map);
 
+    /**
+     * Generates a StatName with mixed dynamic/symbolic components based on
+     * the string and the spans of its dynamic tokens.
+     *
+     * @param name The string corresponding to the desired StatName.
+     * @param dynamic_spans the spans of tokens in the stat-name that are dynamic.
+     * @return the generated StatName, valid as long as the DynamicContext.
+     */
+    StatName makeDynamicStatName(absl::string_view name, const DynamicSpans& dynamic_spans);
+
   private:
     SymbolTable& symbol_table_;
     StatNamePool symbolic_pool_;
@@ -56,6 +67,14 @@ public:
                   const Protobuf::Map<std::string, uint64_t>& gauges,
                   const DynamicsMap& dynamics = DynamicsMap());
 
+  /**
+   * Merge the counter deltas and gauge values of a snapshot into stats_store,
+   * the same way as the protobuf maps above.
+   *
+   * @param snapshot the parent's stats, read in place from shared memory.
+   */
+  void mergeStats(const StatSnapshotReader& snapshot);
+
   /**
    * Indicates that a gauge's value from the hot-restart parent should be
    * retained, combining it with the child data. By default, data is transferred
@@ -76,6 +95,8 @@ private:
                      const DynamicsMap& dynamics_map);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                    const DynamicsMap& dynamics_map);
+  void mergeCounter(StatName stat_name, uint64_t delta);
+  void mergeGauge(StatName stat_name, uint64_t value);
 
   StatNameHashSet parent_gauges_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
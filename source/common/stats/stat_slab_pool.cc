@@ -0,0 +1,76 @@
+#include "common/stats/stat_slab_pool.h"
+
+#include <algorithm>
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Stats {
+
+StatSlabPool::StatSlabPool(void* owner, size_t object_size)
+    : owner_(owner), object_size_((std::max(object_size, sizeof(FreeObject)) + 7) & ~size_t(7)),
+      objects_per_slab_((SlabSize - headerSize()) / object_size_) {
+  RELEASE_ASSERT(objects_per_slab_ > 0, "stat objects must fit in a slab");
+}
+
+StatSlabPool::~StatSlabPool() {
+  // Every stat holds a reference to its owner, which must outlive it.
+  ASSERT(num_slabs_ == 0);
+}
+
+void* StatSlabPool::allocate() {
+  Slab* slab;
+  if (available_slabs_.empty()) {
+    slab = static_cast<Slab*>(::operator new(SlabSize, std::align_val_t(SlabSize)));
+    slab->pool_ = this;
+    slab->owner_ = owner_;
+    slab->free_list_ = nullptr;
+    slab->num_carved_ = 0;
+    slab->num_live_ = 0;
+    available_slabs_.insert(slab);
+    ++num_slabs_;
+  } else {
+    slab = *available_slabs_.begin();
+  }
+
+  void* object;
+  if (slab->free_list_ != nullptr) {
+    object = slab->free_list_;
+    slab->free_list_ = slab->free_list_->next_;
+  } else {
+    ASSERT(slab->num_carved_ < objects_per_slab_);
+    object = reinterpret_cast<uint8_t*>(slab) + headerSize() + slab->num_carved_ * object_size_;
+    ++slab->num_carved_;
+  }
+  if (++slab->num_live_ == objects_per_slab_) {
+    available_slabs_.erase(slab);
+  }
+  return object;
+}
+
+void StatSlabPool::free(void* object) {
+  Slab* slab = slabOf(object);
+  slab->pool_->freeObject(slab, object);
+}
+
+void StatSlabPool::freeObject(Slab* slab, void* object) {
+  ASSERT(slab->num_live_ > 0);
+  if (slab->num_live_-- == objects_per_slab_) {
+    available_slabs_.insert(slab);
+  }
+  if (slab->num_live_ == 0) {
+    available_slabs_.erase(slab);
+    --num_slabs_;
+    ::operator delete(slab, std::align_val_t(SlabSize));
+    return;
+  }
+  auto* free_object = static_cast<FreeObject*>(object);
+  free_object->next_ = slab->free_list_;
+  slab->free_list_ = free_object;
+}
+
+void* StatSlabPool::owner(const void* object) { return slabOf(object)->owner_; }
+
+} // namespace Stats
+} // namespace Envoy
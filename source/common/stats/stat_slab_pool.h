@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Allocates fixed-size stat objects from 4KB-aligned slabs. Each slab begins with a small header
+ * naming the pool and its owner, so an object can find its owner by masking its own address,
+ * rather than each of the (possibly millions of) stats storing a pointer to it. Carving objects
+ * out of slabs also saves the per-allocation bookkeeping malloc would otherwise add to each stat.
+ *
+ * Slabs are released when their last object is freed. The pool is not thread-safe: callers must
+ * serialize allocate() and free() themselves.
+ */
+class StatSlabPool {
+public:
+  static constexpr size_t SlabSize = 4096;
+
+  /**
+   * @param owner an opaque pointer, returned by owner() for every object allocated from the pool.
+   * @param object_size the size of the objects to allocate, which must be aligned to at most 8.
+   */
+  StatSlabPool(void* owner, size_t object_size);
+  ~StatSlabPool();
+
+  /**
+   * @return uninitialized memory for one object, 8-byte aligned.
+   */
+  void* allocate();
+
+  /**
+   * Returns an object's memory to the pool it was allocated from. The object must already have
+   * been destroyed.
+   */
+  static void free(void* object);
+
+  /**
+   * @return the owner of the pool an object was allocated from.
+   */
+  static void* owner(const void* object);
+
+  /**
+   * @return the number of slabs currently allocated, exposed for testing purposes.
+   */
+  size_t numSlabs() const { return num_slabs_; }
+
+  /**
+   * @return how many objects fit in a slab.
+   */
+  uint32_t objectsPerSlab() const { return objects_per_slab_; }
+
+private:
+  struct FreeObject {
+    FreeObject* next_;
+  };
+
+  struct Slab {
+    StatSlabPool* pool_;
+    void* owner_;
+    FreeObject* free_list_;
+    // Objects below this index have been handed out at least once; objects above it have never
+    // been touched, and are allocated in order without threading them onto free_list_.
+    uint32_t num_carved_;
+    uint32_t num_live_;
+  };
+
+  static Slab* slabOf(const void* object) {
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(object) & ~(SlabSize - 1));
+  }
+  static size_t headerSize() { return (sizeof(Slab) + 7) & ~size_t(7); }
+
+  void freeObject(Slab* slab, void* object);
+
+  void* const owner_;
+  const size_t object_size_;
+  const uint32_t objects_per_slab_;
+  size_t num_slabs_{0};
+  // Slabs with at least one object available. A full slab is dropped from this set, and added
+  // back when one of its objects is freed.
+  absl::flat_hash_set<Slab*> available_slabs_;
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#include "common/stats/stat_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+uint64_t align8(uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+// The offsets of the sections of a snapshot, relative to its start.
+struct Layout {
+  Layout(uint32_t num_stats, uint32_t num_spans, uint32_t names_size)
+      : values_(align8(sizeof(StatSnapshot::Header))),
+        name_ends_(values_ + uint64_t(num_stats) * sizeof(uint64_t)),
+        span_ends_(align8(name_ends_ + uint64_t(num_stats) * sizeof(uint32_t))),
+        spans_(align8(span_ends_ + uint64_t(num_stats) * sizeof(uint32_t))),
+        names_(align8(spans_ + uint64_t(num_spans) * 2 * sizeof(uint32_t))),
+        size_(align8(names_ + names_size)) {}
+
+  const uint64_t values_;
+  const uint64_t name_ends_;
+  const uint64_t span_ends_;
+  const uint64_t spans_;
+  const uint64_t names_;
+  const uint64_t size_;
+};
+
+} // namespace
+
+uint64_t StatSnapshot::size(uint32_t num_stats, uint32_t num_spans, uint32_t names_size) {
+  return Layout(num_stats, num_spans, names_size).size_;
+}
+
+void StatSnapshotWriter::Section::add(absl::string_view name, uint64_t value,
+                                      const DynamicSpans& spans) {
+  values_.push_back(value);
+  names_.append(name.data(), name.size());
+  name_ends_.push_back(names_.size());
+  for (const DynamicSpan& span : spans) {
+    spans_.push_back(span.first);
+    spans_.push_back(span.second);
+  }
+  span_ends_.push_back(spans_.size() / 2);
+}
+
+void StatSnapshotWriter::addCounter(absl::string_view name, uint64_t delta,
+                                    const DynamicSpans& spans) {
+  counters_.add(name, delta, spans);
+}
+
+void StatSnapshotWriter::addGauge(absl::string_view name, uint64_t value,
+                                  const DynamicSpans& spans) {
+  gauges_.add(name, value, spans);
+}
+
+uint64_t StatSnapshotWriter::size() const {
+  return StatSnapshot::size(counters_.values_.size() + gauges_.values_.size(),
+                            (counters_.spans_.size() + gauges_.spans_.size()) / 2,
+                            counters_.names_.size() + gauges_.names_.size());
+}
+
+void StatSnapshotWriter::write(uint8_t* buffer) const {
+  ASSERT(reinterpret_cast<uintptr_t>(buffer) % alignof(uint64_t) == 0);
+  const uint32_t num_counters = counters_.values_.size();
+  const uint32_t num_stats = num_counters + gauges_.values_.size();
+  const uint32_t num_counter_spans = counters_.spans_.size() / 2;
+  const uint32_t num_spans = num_counter_spans + gauges_.spans_.size() / 2;
+  const uint32_t counter_names_size = counters_.names_.size();
+  const uint32_t names_size = counter_names_size + gauges_.names_.size();
+  const Layout layout(num_stats, num_spans, names_size);
+  memset(buffer, 0, layout.size_);
+
+  auto* header = reinterpret_cast<StatSnapshot::Header*>(buffer);
+  header->magic_ = StatSnapshot::Magic;
+  header->num_counters_ = num_counters;
+  header->num_gauges_ = gauges_.values_.size();
+  header->num_spans_ = num_spans;
+  header->names_size_ = names_size;
+
+  auto* values = reinterpret_cast<uint64_t*>(buffer + layout.values_);
+  auto* name_ends = reinterpret_cast<uint32_t*>(buffer + layout.name_ends_);
+  auto* span_ends = reinterpret_cast<uint32_t*>(buffer + layout.span_ends_);
+  auto* spans = reinterpret_cast<uint32_t*>(buffer + layout.spans_);
+  char* names = reinterpret_cast<char*>(buffer + layout.names_);
+
+  std::copy(counters_.values_.begin(), counters_.values_.end(), values);
+  std::copy(gauges_.values_.begin(), gauges_.values_.end(), values + num_counters);
+  std::copy(counters_.name_ends_.begin(), counters_.name_ends_.end(), name_ends);
+  // The gauges' names and spans follow the counters', so their ends are shifted by the counters'.
+  for (size_t i = 0; i < gauges_.name_ends_.size(); ++i) {
+    name_ends[num_counters + i] = counter_names_size + gauges_.name_ends_[i];
+  }
+  std::copy(counters_.span_ends_.begin(), counters_.span_ends_.end(), span_ends);
+  for (size_t i = 0; i < gauges_.span_ends_.size(); ++i) {
+    span_ends[num_counters + i] = num_counter_spans + gauges_.span_ends_[i];
+  }
+  std::copy(counters_.spans_.begin(), counters_.spans_.end(), spans);
+  std::copy(gauges_.spans_.begin(), gauges_.spans_.end(), spans + 2 * num_counter_spans);
+  std::copy(counters_.names_.begin(), counters_.names_.end(), names);
+  std::copy(gauges_.names_.begin(), gauges_.names_.end(), names + counter_names_size);
+}
+
+bool StatSnapshotReader::parse(const uint8_t* data, uint64_t size) {
+  ASSERT(reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) == 0);
+  if (size < sizeof(StatSnapshot::Header)) {
+    return false;
+  }
+  const auto* header = reinterpret_cast<const StatSnapshot::Header*>(data);
+  if (header->magic_ != StatSnapshot::Magic) {
+    return false;
+  }
+  const uint64_t num_stats = uint64_t(header->num_counters_) + header->num_gauges_;
+  if (num_stats > UINT32_MAX) {
+    return false;
+  }
+  const Layout layout(num_stats, header->num_spans_, header->names_size_);
+  if (layout.size_ != size) {
+    return false;
+  }
+
+  const auto* name_ends = reinterpret_cast<const uint32_t*>(data + layout.name_ends_);
+  const auto* span_ends = reinterpret_cast<const uint32_t*>(data + layout.span_ends_);
+  uint32_t name_end = 0;
+  uint32_t span_end = 0;
+  for (uint64_t i = 0; i < num_stats; ++i) {
+    if (name_ends[i] < name_end || span_ends[i] < span_end) {
+      return false;
+    }
+    name_end = name_ends[i];
+    span_end = span_ends[i];
+  }
+  if (name_end > header->names_size_ || span_end > header->num_spans_) {
+    return false;
+  }
+
+  header_ = header;
+  values_ = reinterpret_cast<const uint64_t*>(data + layout.values_);
+  name_ends_ = name_ends;
+  span_ends_ = span_ends;
+  spans_ = reinterpret_cast<const uint32_t*>(data + layout.spans_);
+  names_ = reinterpret_cast<const char*>(data + layout.names_);
+  return true;
+}
+
+absl::string_view StatSnapshotReader::name(uint32_t index) const {
+  const uint32_t begin = index == 0 ? 0 : name_ends_[index - 1];
+  return {names_ + begin, name_ends_[index] - begin};
+}
+
+DynamicSpans StatSnapshotReader::dynamicSpans(uint32_t index) const {
+  DynamicSpans spans;
+  const uint32_t begin = index == 0 ? 0 : span_ends_[index - 1];
+  for (uint32_t i = begin; i < span_ends_[index]; ++i) {
+    spans.emplace_back(spans_[2 * i], spans_[2 * i + 1]);
+  }
+  return spans;
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/symbol_table.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A flat snapshot of counter deltas and gauge values, laid out so that a hot restart parent can
+ * write it straight into shared memory, and the child can read it in place without parsing or
+ * copying. Both processes run on the same host, so fields are in host byte order.
+ *
+ * The layout, in which every section starts 8-byte aligned, is:
+ *   Header
+ *   uint64_t values[num_stats]    the counter deltas, followed by the gauge values.
+ *   uint32_t name_ends[num_stats] the end of each stat's name in names.
+ *   uint32_t span_ends[num_stats] the end of each stat's dynamic spans in spans.
+ *   uint32_t spans[2 * num_spans] the first and last token of each dynamic span.
+ *   char names[names_size]        the concatenated stat names.
+ */
+class StatSnapshot {
+public:
+  struct Header {
+    uint64_t magic_;
+    uint32_t num_counters_;
+    uint32_t num_gauges_;
+    uint32_t num_spans_;
+    uint32_t names_size_;
+  };
+
+  static constexpr uint64_t Magic = 0x454e564f59535431; // "ENVOYST1"
+
+  /**
+   * @return the size in bytes of a snapshot with the given contents.
+   */
+  static uint64_t size(uint32_t num_stats, uint32_t num_spans, uint32_t names_size);
+};
+
+/**
+ * Accumulates the stats to put in a StatSnapshot. Counters and gauges may be added in any order.
+ */
+class StatSnapshotWriter {
+public:
+  void addCounter(absl::string_view name, uint64_t delta, const DynamicSpans& spans);
+  void addGauge(absl::string_view name, uint64_t value, const DynamicSpans& spans);
+
+  /**
+   * @return the size in bytes of the snapshot.
+   */
+  uint64_t size() const;
+
+  /**
+   * Writes the snapshot.
+   * @param buffer 8-byte aligned memory of at least size() bytes.
+   */
+  void write(uint8_t* buffer) const;
+
+private:
+  struct Section {
+    void add(absl::string_view name, uint64_t value, const DynamicSpans& spans);
+
+    std::vector<uint64_t> values_;
+    std::vector<uint32_t> name_ends_;
+    std::vector<uint32_t> span_ends_;
+    std::vector<uint32_t> spans_;
+    std::string names_;
+  };
+
+  Section counters_;
+  Section gauges_;
+};
+
+/**
+ * Reads a StatSnapshot in place. Stats are indexed from 0, counters first, then gauges.
+ */
+class StatSnapshotReader {
+public:
+  /**
+   * Checks that the supplied memory holds a well-formed snapshot, and points the reader at it.
+   * The memory must outlive the reader.
+   * @param data 8-byte aligned snapshot.
+   * @param size the size of the snapshot in bytes.
+   * @return false if the snapshot is malformed, in which case the reader must not be used.
+   */
+  bool parse(const uint8_t* data, uint64_t size);
+
+  uint32_t numCounters() const { return header_->num_counters_; }
+  uint32_t numGauges() const { return header_->num_gauges_; }
+  uint32_t numStats() const { return numCounters() + numGauges(); }
+
+  absl::string_view name(uint32_t index) const;
+  uint64_t value(uint32_t index) const { return values_[index]; }
+  DynamicSpans dynamicSpans(uint32_t index) const;
+
+private:
+  const StatSnapshot::Header* header_{};
+  const uint64_t* values_{};
+  const uint32_t* name_ends_{};
+  const uint32_t* span_ends_{};
+  const uint32_t* spans_{};
+  const char* names_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -157,11 +157,8 @@ void SymbolTableImpl::Encoding::decodeTokens(
 std::vector<absl::string_view> SymbolTableImpl::decodeStrings(const SymbolTable::Storage array,
                                                               size_t size) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
   Encoding::decodeTokens(
-      array, size,
-      [this, &strings](Symbol symbol)
-          ABSL_NO_THREAD_SAFETY_ANALYSIS { strings.push_back(fromSymbol(symbol)); },
+      array, size, [this, &strings](Symbol symbol) { strings.push_back(fromSymbol(symbol)); },
       [&strings](absl::string_view str) { strings.push_back(str); });
   return strings;
 }
@@ -202,24 +199,23 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
     return;
   }
 
-  // We want to hold the lock for the minimum amount of time, so we do the
-  // string-splitting and prepare a temp vector of Symbol first.
   const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
+  if (recent_lookup_capacity_.load(std::memory_order_relaxed) > 0) {
     Thread::LockGuard lock(lock_);
     recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
-      // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
-      // length below some threshold, say 4 bytes. It might be preferable not to
-      // reserve Symbols for every 3 digit number found (for example) in ipv4
-      // addresses.
-      symbols.push_back(toSymbol(token));
-    }
+  }
+
+  // Populate the Symbol objects, which involves bumping ref-counts in this. Each
+  // token only locks the shard it belongs to.
+  for (auto& token : tokens) {
+    // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
+    // length below some threshold, say 4 bytes. It might be preferable not to
+    // reserve Symbols for every 3 digit number found (for example) in ipv4
+    // addresses.
+    symbols.push_back(toSymbol(token));
   }
 
   // Now efficiently encode the array of 32-bit symbols into a uint8_t array.
@@ -227,9 +223,12 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
 }
 
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
-  ASSERT(encode_map_.size() == decode_map_.size());
-  return encode_map_.size();
+  uint64_t num_symbols = 0;
+  for (const EncodeShard& shard : encode_shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    num_symbols += shard.map_.size();
+  }
+  return num_symbols;
 }
 
 std::string SymbolTableImpl::toString(const StatName& stat_name) const {
@@ -237,50 +236,74 @@ std::string SymbolTableImpl::toString(const StatName& stat_name) const {
 }
 
 void SymbolTableImpl::incRefCount(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
+  // Before taking any lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-
-    ASSERT(decode_search != decode_map_.end(),
-           "Please see "
-           "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
-           "debugging-symbol-table-assertions");
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end(),
+    // The token stays valid as the caller holds a reference to the symbol.
+    const absl::string_view token = fromSymbol(symbol);
+    EncodeShard& shard = encodeShard(token);
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto encode_search = shard.map_.find(token);
+    ASSERT(encode_search != shard.map_.end(),
            "Please see "
            "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
            "debugging-symbol-table-assertions");
 
-    ++encode_search->second.ref_count_;
+    // The symbol can't be removed while the reader lock is held, as it's only removed under the
+    // writer lock, so adding a reference doesn't need the writer lock.
+    encode_search->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
 void SymbolTableImpl::free(const StatName& stat_name) {
-  // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
+  // Before taking any lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
-
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+    freeSymbol(symbol);
+  }
+}
+
+void SymbolTableImpl::freeSymbol(Symbol symbol) {
+  // The token stays valid as long as our reference to the symbol is held.
+  const absl::string_view token = fromSymbol(symbol);
+  EncodeShard& shard = encodeShard(token);
+
+  // Drop the reference under the reader lock unless it is the last one. The last reference is
+  // only dropped under the writer lock, so that concurrent lookups under the reader lock never
+  // find a symbol that is being removed.
+  {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto encode_search = shard.map_.find(token);
+    ASSERT(encode_search != shard.map_.end());
+    std::atomic<uint32_t>& ref_count = encode_search->second.ref_count_;
+    uint32_t count = ref_count.load(std::memory_order_relaxed);
+    while (count > 1) {
+      if (ref_count.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  absl::MutexLock lock(&shard.mutex_);
+  auto encode_search = shard.map_.find(token);
+  ASSERT(encode_search != shard.map_.end());
+
+  // If that was the last remaining client usage of the symbol, erase the
+  // current mappings and add the now-unused symbol to the reuse pool. Other
+  // threads may have added references since the reader lock was released.
+  if (encode_search->second.ref_count_.fetch_sub(1, std::memory_order_relaxed) == 1) {
+    // The encode map key references the string owned by the decode map, so it
+    // must be erased first.
+    shard.map_.erase(encode_search);
+    {
+      DecodeShard& decode_shard = decodeShard(symbol);
+      absl::MutexLock decode_lock(&decode_shard.mutex_);
+      decode_shard.map_.erase(symbol);
     }
+    Thread::LockGuard alloc_lock(lock_);
+    pool_.push(symbol);
   }
 }
 
@@ -343,6 +366,7 @@ DynamicSpans SymbolTableImpl::getDynamicSpans(StatName stat_name) const {
 void SymbolTableImpl::setRecentLookupCapacity(uint64_t capacity) {
   Thread::LockGuard lock(lock_);
   recent_lookups_.setCapacity(capacity);
+  recent_lookup_capacity_.store(capacity, std::memory_order_relaxed);
 }
 
 void SymbolTableImpl::clearRecentLookups() {
@@ -362,39 +386,58 @@ StatNameSetPtr SymbolTableImpl::makeSet(absl::string_view name) {
 }
 
 Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
-  Symbol result;
-  auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
-  } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+  EncodeShard& shard = encodeShard(sv);
+
+  // Most lookups are for existing string segments, which only need the reader
+  // lock to return the symbol and up the refcount at that location.
+  {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto encode_find = shard.map_.find(sv);
+    if (encode_find != shard.map_.end()) {
+      encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
+      return encode_find->second.symbol_;
+    }
+  }
+
+  absl::MutexLock lock(&shard.mutex_);
+  // Another thread may have added the string segment since the reader lock was released.
+  auto encode_find = shard.map_.find(sv);
+  if (encode_find != shard.map_.end()) {
+    encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
+    return encode_find->second.symbol_;
   }
-  return result;
-}
 
-absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
-  auto search = decode_map_.find(symbol);
-  RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
+  // We create the actual string, place it in the decode map, and then insert
+  // a string_view pointing to it in the encode map. This allows us to only
+  // store the string once. We use unique_ptr so copies are not made as
+  // flat_hash_map moves values around.
+  InlineStringPtr str = InlineString::create(sv);
+  const Symbol symbol = allocateSymbol();
+  auto encode_insert = shard.map_.insert({str->toStringView(), SharedSymbol(symbol)});
+  ASSERT(encode_insert.second);
+  DecodeShard& decode_shard = decodeShard(symbol);
+  absl::MutexLock decode_lock(&decode_shard.mutex_);
+  auto decode_insert = decode_shard.map_.insert({symbol, std::move(str)});
+  ASSERT(decode_insert.second);
+  return symbol;
+}
+
+absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const {
+  const DecodeShard& shard = decodeShard(symbol);
+  absl::ReaderMutexLock lock(&shard.mutex_);
+  auto search = shard.map_.find(symbol);
+  RELEASE_ASSERT(search != shard.map_.end(), "no such symbol");
   return search->second->toStringView();
 }
 
-void SymbolTableImpl::newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+Symbol SymbolTableImpl::allocateSymbol() {
+  Thread::LockGuard lock(lock_);
+  const Symbol symbol = next_symbol_;
+  newSymbol();
+  return symbol;
+}
+
+void SymbolTableImpl::newSymbol() {
   if (pool_.empty()) {
     next_symbol_ = ++monotonic_counter_;
   } else {
@@ -424,16 +467,20 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
   std::vector<Symbol> symbols;
-  for (const auto& p : decode_map_) {
-    symbols.push_back(p.first);
+  for (const DecodeShard& shard : decode_shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    for (const auto& p : shard.map_) {
+      symbols.push_back(p.first);
+    }
   }
   std::sort(symbols.begin(), symbols.end());
   for (Symbol symbol : symbols) {
-    const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    const absl::string_view token = fromSymbol(symbol);
+    const EncodeShard& shard = encodeShard(token);
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    const SharedSymbol& shared_symbol = shard.map_.find(token)->second;
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token, shared_symbol.ref_count_.load());
   }
 }
 #endif
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -23,6 +25,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -205,12 +208,47 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    // Only called while the map holding the symbol rehashes, under its writer lock.
+    SharedSymbol(SharedSymbol&& src) noexcept
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
 
     Symbol symbol_;
-    uint32_t ref_count_;
+    // References are added under the reader lock of the encode shard holding the symbol, so the
+    // count is atomic. It only drops to zero under the writer lock, when the symbol is removed.
+    std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
+  // Bitmap implementation.
+  // The encode map stores both the symbol and the ref count of that symbol.
+  // Using absl::string_view lets us only store the complete string once, in the decode map.
+  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
+  using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
+
+  // The maps are split into shards, each with its own reader-writer lock, so that encoding and
+  // decoding existing symbols only take reader locks and don't contend across threads. Writer locks
+  // are only taken to add and remove symbols. Tokens are sharded by hash and symbols by value.
+  // When both are needed, the encode shard lock is taken before the decode shard lock.
+  static constexpr uint32_t NumShards = 16;
+  struct EncodeShard {
+    mutable absl::Mutex mutex_;
+    EncodeMap map_ ABSL_GUARDED_BY(mutex_);
+  };
+  struct DecodeShard {
+    mutable absl::Mutex mutex_;
+    DecodeMap map_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  EncodeShard& encodeShard(absl::string_view token) {
+    return encode_shards_[HashUtil::xxHash64(token) % NumShards];
+  }
+  const EncodeShard& encodeShard(absl::string_view token) const {
+    return encode_shards_[HashUtil::xxHash64(token) % NumShards];
+  }
+  DecodeShard& decodeShard(Symbol symbol) { return decode_shards_[symbol % NumShards]; }
+  const DecodeShard& decodeShard(Symbol symbol) const { return decode_shards_[symbol % NumShards]; }
+
+  // Guards the allocation of symbols and the recent lookups. This is taken after the lock of an
+  // encode shard, and only when adding or removing a symbol.
   mutable Thread::MutexBasicLockable lock_;
 
   /**
@@ -234,7 +272,7 @@ private:
    * @param sv the individual string to be encoded as a symbol.
    * @return Symbol the encoded string.
    */
-  Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  Symbol toSymbol(absl::string_view sv);
 
   /**
    * Convenience function for decode(), decoding one symbol at a time.
@@ -242,12 +280,24 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const;
+
+  /**
+   * Drops a reference to a symbol, removing it from the table if that was the last one.
+   *
+   * @param symbol the symbol to be released.
+   */
+  void freeSymbol(Symbol symbol);
+
+  /**
+   * @return Symbol the symbol to use for a new token, taken from the free pool if possible.
+   */
+  Symbol allocateSymbol();
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
    */
-  void newSymbol();
+  void newSymbol() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   /**
    * Tokenizes name, finds or allocates symbols for each token, and adds them
@@ -270,19 +320,17 @@ private:
   // If the free pool is exhausted, we monotonically increase this counter.
   Symbol monotonic_counter_;
 
-  // Bitmap implementation.
-  // The encode map stores both the symbol and the ref count of that symbol.
-  // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
-  using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
-  EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
-  DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
+  std::array<EncodeShard, NumShards> encode_shards_;
+  std::array<DecodeShard, NumShards> decode_shards_;
 
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
   RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+  // Mirrors the capacity of recent_lookups_, so that encoding doesn't take lock_ when recent
+  // lookups aren't tracked, which is the default.
+  std::atomic<uint64_t> recent_lookup_capacity_{0};
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
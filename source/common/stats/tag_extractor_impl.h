@@ -133,6 +133,8 @@ public:
   bool extractTag(TagExtractionContext& context, std::vector<Tag>& tags,
                   IntervalSet<size_t>& remove_characters) const override;
 
+  const re2::RE2& regex() const { return regex_; }
+
 private:
   const re2::RE2 regex_;
 };
@@ -1,5 +1,6 @@
 #include "common/stats/tag_producer_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -41,6 +42,7 @@ TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v3::StatsConfig&
       default_tags_.emplace_back(Tag{name, tag_specifier.fixed_value()});
     }
   }
+  compileRegexSet();
 }
 
 int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
@@ -62,27 +64,63 @@ int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
 }
 
 void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
+  int regex_index = -1;
+  const auto* re2_extractor = dynamic_cast<const TagExtractorRe2Impl*>(extractor.get());
+  if (re2_extractor != nullptr) {
+    if (regex_set_ == nullptr) {
+      regex_set_ = std::make_unique<re2::RE2::Set>(re2::RE2::Options(), re2::RE2::UNANCHORED);
+    }
+    // The regex already compiled on its own, so this only fails if the set is out of memory, in
+    // which case the extractor is simply run on every stat name.
+    regex_index = regex_set_->Add(re2_extractor->regex().pattern(), nullptr);
+  }
+
   const absl::string_view prefix = extractor->prefixToken();
   if (prefix.empty()) {
-    tag_extractors_without_prefix_.emplace_back(std::move(extractor));
+    tag_extractors_without_prefix_.emplace_back(ExtractorEntry{std::move(extractor), regex_index});
   } else {
-    tag_extractor_prefix_map_[prefix].emplace_back(std::move(extractor));
+    tag_extractor_prefix_map_[prefix].emplace_back(
+        ExtractorEntry{std::move(extractor), regex_index});
+  }
+}
+
+void TagProducerImpl::compileRegexSet() {
+  if (regex_set_ != nullptr && !regex_set_->Compile()) {
+    regex_set_.reset();
   }
 }
 
 void TagProducerImpl::forEachExtractorMatching(
     absl::string_view stat_name, std::function<void(const TagExtractorPtr&)> f) const {
-  IntervalSetImpl<size_t> remove_characters;
-  for (const TagExtractorPtr& tag_extractor : tag_extractors_without_prefix_) {
-    f(tag_extractor);
+  // Find all the RE2 extractors matching stat_name with one pass of the set's DFA. If the DFA
+  // runs out of memory, fall back to running all the extractors.
+  std::vector<int> regex_matches;
+  bool filter_regexes = false;
+  if (regex_set_ != nullptr) {
+    re2::RE2::Set::ErrorInfo error_info;
+    regex_set_->Match(re2::StringPiece(stat_name.data(), stat_name.size()), &regex_matches,
+                      &error_info);
+    filter_regexes = error_info.kind == re2::RE2::Set::kNoError;
+  }
+  const auto call_if_matching = [&](const ExtractorEntry& entry) {
+    if (filter_regexes && entry.regex_index_ >= 0 &&
+        std::find(regex_matches.begin(), regex_matches.end(), entry.regex_index_) ==
+            regex_matches.end()) {
+      return;
+    }
+    f(entry.extractor_);
+  };
+
+  for (const ExtractorEntry& entry : tag_extractors_without_prefix_) {
+    call_if_matching(entry);
   }
   const absl::string_view::size_type dot = stat_name.find('.');
   if (dot != std::string::npos) {
     const absl::string_view token = absl::string_view(stat_name.data(), dot);
     const auto iter = tag_extractor_prefix_map_.find(token);
     if (iter != tag_extractor_prefix_map_.end()) {
-      for (const TagExtractorPtr& tag_extractor : iter->second) {
-        f(tag_extractor);
+      for (const ExtractorEntry& entry : iter->second) {
+        call_if_matching(entry);
       }
     }
   }
@@ -18,6 +18,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/string_view.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Stats {
@@ -58,6 +59,14 @@ private:
    */
   int addExtractorsMatching(absl::string_view name);
 
+  /**
+   * Compiles the regexes of the RE2 extractors added so far into a single RE2::Set, so that
+   * forEachExtractorMatching can find all the RE2 extractors matching a stat name in one pass
+   * over the name, rather than running each of their regexes in turn. Must be called once,
+   * after all the extractors have been added.
+   */
+  void compileRegexSet();
+
   /**
    * Roughly estimate the size of the vectors.
    * @param config const envoy::config::metrics::v2::StatsConfig& the config.
@@ -83,7 +92,7 @@ private:
    *   1. Finding the first '.' separated token in stat_name.
    *   2. Collecting the TagExtractors whose regexes have that same prefix "^prefix\\."
    *   3. Collecting also the TagExtractors whose regexes don't start with any prefix.
-   * In the future, we may also do substring searches in some cases.
+   *   4. Dropping the RE2 extractors whose regexes the RE2::Set did not match.
    * See DefaultTagRegexTester::produceTagsReverse in test/common/stats/stats_impl_test.cc.
    *
    * @param stat_name const std::string& the stat name.
@@ -92,12 +101,24 @@ private:
   void forEachExtractorMatching(absl::string_view stat_name,
                                 std::function<void(const TagExtractorPtr&)> f) const;
 
-  std::vector<TagExtractorPtr> tag_extractors_without_prefix_;
+  struct ExtractorEntry {
+    TagExtractorPtr extractor_;
+    // The index of the extractor's regex in regex_set_, or -1 if the extractor is not an RE2
+    // extractor and must be run on every stat name it may apply to.
+    int regex_index_;
+  };
+
+  std::vector<ExtractorEntry> tag_extractors_without_prefix_;
 
   // Maps a prefix word extracted out of a regex to a vector of TagExtractors. Note that
   // the storage for the prefix string is owned by the TagExtractor, which, depending on
   // implementation, may need make a copy of the prefix.
-  absl::flat_hash_map<absl::string_view, std::vector<TagExtractorPtr>> tag_extractor_prefix_map_;
+  absl::flat_hash_map<absl::string_view, std::vector<ExtractorEntry>> tag_extractor_prefix_map_;
+
+  // The regexes of all the RE2 extractors, matched against each stat name at once. Null if there
+  // are no RE2 extractors, or if the set could not be compiled, in which case every extractor
+  // that may apply to a stat name is run.
+  std::unique_ptr<re2::RE2::Set> regex_set_;
   TagVector default_tags_;
 };
 
@@ -1,5 +1,6 @@
 #include "common/stats/thread_local_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <list>
@@ -53,6 +54,22 @@ void ThreadLocalStoreImpl::setHistogramSettings(HistogramSettingsConstPtr&& hist
   histogram_settings_ = std::move(histogram_settings);
 }
 
+void ThreadLocalStoreImpl::setShardedCounterMatchers(
+    std::vector<Matchers::StringMatcherPtr>&& matchers) {
+  Thread::LockGuard lock(lock_);
+  sharded_counter_matchers_ = std::move(matchers);
+}
+
+bool ThreadLocalStoreImpl::shardsCounter(StatName name) const {
+  if (sharded_counter_matchers_.empty()) {
+    return false;
+  }
+  const std::string name_str = constSymbolTable().toString(name);
+  return std::any_of(
+      sharded_counter_matchers_.begin(), sharded_counter_matchers_.end(),
+      [&name_str](const Matchers::StringMatcherPtr& matcher) { return matcher->match(name_str); });
+}
+
 void ThreadLocalStoreImpl::setStatsMatcher(StatsMatcherPtr&& stats_matcher) {
   stats_matcher_ = std::move(stats_matcher);
   if (stats_matcher_->acceptsAll()) {
@@ -502,8 +519,12 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatNameWithTags(
   return safeMakeStat<Counter>(
       final_stat_name, joiner.tagExtractedName(), stat_name_tags, central_cache_->counters_,
       central_cache_->rejected_stats_,
-      [](Allocator& allocator, StatName name, StatName tag_extracted_name,
-         const StatNameTagVector& tags) -> CounterSharedPtr {
+      [this](Allocator& allocator, StatName name, StatName tag_extracted_name,
+             const StatNameTagVector& tags) -> CounterSharedPtr {
+        // safeMakeStat calls us with parent_.lock_ held.
+        if (parent_.shardsCounter(name)) {
+          return allocator.makeShardedCounter(name, tag_extracted_name, tags);
+        }
         return allocator.makeCounter(name, tag_extracted_name, tags);
       },
       tls_cache, tls_rejected_stats, parent_.null_counter_);
@@ -609,6 +630,11 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
 
     ConstSupportedBuckets* buckets = nullptr;
     buckets = &parent_.histogram_settings_->buckets(symbolTable().toString(final_stat_name));
+    absl::optional<uint32_t> log_linear_precision_bits;
+    const absl::optional<double> relative_error = parent_.histogram_settings_->relativeError();
+    if (relative_error.has_value()) {
+      log_linear_precision_bits = LogLinearHistogram::precisionBits(relative_error.value());
+    }
 
     RefcountPtr<ParentHistogramImpl> stat;
     {
@@ -619,7 +645,8 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
       } else {
         stat = new ParentHistogramImpl(final_stat_name, unit, parent_,
                                        tag_helper.tagExtractedName(), tag_helper.statNameTags(),
-                                       *buckets, parent_.next_histogram_id_++);
+                                       *buckets, log_linear_precision_bits,
+                                       parent_.next_histogram_id_++);
         if (!parent_.shutting_down_) {
           parent_.histogram_set_.insert(stat.get());
         }
@@ -715,7 +742,8 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 
   TlsHistogramSharedPtr hist_tls_ptr(
       new ThreadLocalHistogramImpl(parent.statName(), parent.unit(), tag_helper.tagExtractedName(),
-                                   tag_helper.statNameTags(), symbolTable()));
+                                   tag_helper.statNameTags(), symbolTable(),
+                                   parent.logLinearPrecisionBits()));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -726,26 +754,38 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
   return *hist_tls_ptr;
 }
 
-ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
-                                                   StatName tag_extracted_name,
-                                                   const StatNameTagVector& stat_name_tags,
-                                                   SymbolTable& symbol_table)
+ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(
+    StatName name, Histogram::Unit unit, StatName tag_extracted_name,
+    const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
+    absl::optional<uint32_t> log_linear_precision_bits)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
       current_active_(0), used_(false), created_thread_id_(std::this_thread::get_id()),
       symbol_table_(symbol_table) {
-  histograms_[0] = hist_alloc();
-  histograms_[1] = hist_alloc();
+  if (log_linear_precision_bits.has_value()) {
+    log_linear_histograms_.reserve(2);
+    log_linear_histograms_.emplace_back(log_linear_precision_bits.value());
+    log_linear_histograms_.emplace_back(log_linear_precision_bits.value());
+  } else {
+    histograms_[0] = hist_alloc();
+    histograms_[1] = hist_alloc();
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
   MetricImpl::clear(symbol_table_);
-  hist_free(histograms_[0]);
-  hist_free(histograms_[1]);
+  if (log_linear_histograms_.empty()) {
+    hist_free(histograms_[0]);
+    hist_free(histograms_[1]);
+  }
 }
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  if (log_linear_histograms_.empty()) {
+    hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  } else {
+    log_linear_histograms_[current_active_].recordValue(value);
+  }
   used_ = true;
 }
 
@@ -755,23 +795,55 @@ void ThreadLocalHistogramImpl::merge(histogram_t* target) {
   hist_clear(*other_histogram);
 }
 
+void ThreadLocalHistogramImpl::merge(LogLinearHistogram& target) {
+  LogLinearHistogram& other_histogram = log_linear_histograms_[otherHistogramIndex()];
+  target.merge(other_histogram);
+  other_histogram.clear();
+}
+
+namespace {
+
+// Computes the statistics of whichever of the histograms of a ParentHistogramImpl is in use.
+HistogramStatisticsImpl
+makeStatistics(const histogram_t* histogram,
+               const absl::optional<LogLinearHistogram>& log_linear_histogram,
+               ConstSupportedBuckets& supported_buckets) {
+  if (log_linear_histogram.has_value()) {
+    return HistogramStatisticsImpl(log_linear_histogram.value(), supported_buckets);
+  }
+  return HistogramStatisticsImpl(histogram, supported_buckets);
+}
+
+} // namespace
+
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ThreadLocalStoreImpl& thread_local_store,
                                          StatName tag_extracted_name,
                                          const StatNameTagVector& stat_name_tags,
-                                         ConstSupportedBuckets& supported_buckets, uint64_t id)
+                                         ConstSupportedBuckets& supported_buckets,
+                                         absl::optional<uint32_t> log_linear_precision_bits,
+                                         uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
-      unit_(unit), thread_local_store_(thread_local_store), interval_histogram_(hist_alloc()),
-      cumulative_histogram_(hist_alloc()),
-      interval_statistics_(interval_histogram_, supported_buckets),
-      cumulative_statistics_(cumulative_histogram_, supported_buckets), merged_(false), id_(id) {}
+      unit_(unit), thread_local_store_(thread_local_store),
+      log_linear_precision_bits_(log_linear_precision_bits),
+      interval_histogram_(log_linear_precision_bits.has_value() ? nullptr : hist_alloc()),
+      cumulative_histogram_(log_linear_precision_bits.has_value() ? nullptr : hist_alloc()),
+      interval_log_linear_histogram_(log_linear_precision_bits),
+      cumulative_log_linear_histogram_(log_linear_precision_bits),
+      interval_statistics_(makeStatistics(interval_histogram_, interval_log_linear_histogram_,
+                                          supported_buckets)),
+      cumulative_statistics_(makeStatistics(cumulative_histogram_,
+                                            cumulative_log_linear_histogram_, supported_buckets)),
+      merged_(false), id_(id) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   thread_local_store_.releaseHistogramCrossThread(id_);
   ASSERT(ref_count_ == 0);
   MetricImpl::clear(thread_local_store_.symbolTable());
-  hist_free(interval_histogram_);
-  hist_free(cumulative_histogram_);
+  if (!log_linear_precision_bits_.has_value()) {
+    hist_free(interval_histogram_);
+    hist_free(cumulative_histogram_);
+  }
 }
 
 void ParentHistogramImpl::incRefCount() { ++ref_count_; }
@@ -837,6 +909,19 @@ bool ParentHistogramImpl::used() const {
 void ParentHistogramImpl::merge() {
   Thread::ReleasableLockGuard lock(merge_lock_);
   if (merged_ || usedLockHeld()) {
+    if (log_linear_precision_bits_.has_value()) {
+      interval_log_linear_histogram_->clear();
+      for (const TlsHistogramSharedPtr& tls_histogram : tls_histograms_) {
+        tls_histogram->merge(*interval_log_linear_histogram_);
+      }
+      lock.release();
+      cumulative_log_linear_histogram_->merge(*interval_log_linear_histogram_);
+      cumulative_statistics_.refresh(*cumulative_log_linear_histogram_);
+      interval_statistics_.refresh(*interval_log_linear_histogram_);
+      merged_ = true;
+      return;
+    }
+
     hist_clear(interval_histogram_);
     // Here we could copy all the pointers to TLS histograms in the tls_histogram_ list,
     // then release the lock before we do the actual merge. However it is not a big deal
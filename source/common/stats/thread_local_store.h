@@ -14,6 +14,7 @@
 #include "common/common/thread_synchronizer.h"
 #include "common/stats/allocator_impl.h"
 #include "common/stats/histogram_impl.h"
+#include "common/stats/log_linear_histogram.h"
 #include "common/stats/null_counter.h"
 #include "common/stats/null_gauge.h"
 #include "common/stats/null_text_readout.h"
@@ -30,15 +31,18 @@ namespace Stats {
 /**
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
- * swap happens during the merge process.
+ * swap happens during the merge process. The histograms are circllhist histograms, or log-linear
+ * histograms if log_linear_precision_bits is set.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
-                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
+                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
+                           absl::optional<uint32_t> log_linear_precision_bits);
   ~ThreadLocalHistogramImpl() override;
 
   void merge(histogram_t* target);
+  void merge(LogLinearHistogram& target);
 
   /**
    * Called in the beginning of merge process. Swaps the histogram used for collection so that we do
@@ -66,7 +70,9 @@ private:
   Histogram::Unit unit_;
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
-  histogram_t* histograms_[2];
+  histogram_t* histograms_[2]{};
+  // Either empty, or the two log-linear histograms used instead of histograms_.
+  std::vector<LogLinearHistogram> log_linear_histograms_;
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -83,9 +89,12 @@ class ParentHistogramImpl : public MetricImpl<ParentHistogram> {
 public:
   ParentHistogramImpl(StatName name, Histogram::Unit unit, ThreadLocalStoreImpl& parent,
                       StatName tag_extracted_name, const StatNameTagVector& stat_name_tags,
-                      ConstSupportedBuckets& supported_buckets, uint64_t id);
+                      ConstSupportedBuckets& supported_buckets,
+                      absl::optional<uint32_t> log_linear_precision_bits, uint64_t id);
   ~ParentHistogramImpl() override;
 
+  absl::optional<uint32_t> logLinearPrecisionBits() const { return log_linear_precision_bits_; }
+
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
 
   // Stats::Histogram
@@ -125,8 +134,11 @@ private:
 
   Histogram::Unit unit_;
   ThreadLocalStoreImpl& thread_local_store_;
-  histogram_t* interval_histogram_;
-  histogram_t* cumulative_histogram_;
+  const absl::optional<uint32_t> log_linear_precision_bits_;
+  histogram_t* interval_histogram_{};
+  histogram_t* cumulative_histogram_{};
+  absl::optional<LogLinearHistogram> interval_log_linear_histogram_;
+  absl::optional<LogLinearHistogram> cumulative_log_linear_histogram_;
   HistogramStatisticsImpl interval_statistics_;
   HistogramStatisticsImpl cumulative_statistics_;
   mutable Thread::MutexBasicLockable merge_lock_;
@@ -251,6 +263,7 @@ public:
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setShardedCounterMatchers(std::vector<Matchers::StringMatcherPtr>&& matchers) override;
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -478,6 +491,7 @@ private:
   void mergeInternal(PostMergeCb merge_cb);
   bool rejects(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
+  bool shardsCounter(StatName name) const;
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
   bool checkAndRememberRejection(StatName name, StatNameStorageSet& central_rejected_stats,
@@ -495,6 +509,8 @@ private:
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
   HistogramSettingsConstPtr histogram_settings_;
+  // Written and read with lock_ held, the latter by safeMakeStat when creating a counter.
+  std::vector<Matchers::StringMatcherPtr> sharded_counter_matchers_;
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
@@ -28,8 +28,9 @@ struct TcpAttachContext : public Envoy::ConnectionPool::AttachContext {
 
 class TcpPendingStream : public Envoy::ConnectionPool::PendingStream {
 public:
-  TcpPendingStream(Envoy::ConnectionPool::ConnPoolImplBase& parent, TcpAttachContext& context)
-      : Envoy::ConnectionPool::PendingStream(parent), context_(context) {}
+  TcpPendingStream(Envoy::ConnectionPool::ConnPoolImplBase& parent, bool can_send_early_data,
+                   TcpAttachContext& context)
+      : Envoy::ConnectionPool::PendingStream(parent, can_send_early_data), context_(context) {}
   Envoy::ConnectionPool::AttachContext& context() override { return context_; }
 
   TcpAttachContext context_;
@@ -177,10 +178,10 @@ public:
     return Envoy::ConnectionPool::ConnPoolImplBase::maybePreconnect(preconnect_ratio);
   }
 
-  ConnectionPool::Cancellable*
-  newPendingStream(Envoy::ConnectionPool::AttachContext& context) override {
-    Envoy::ConnectionPool::PendingStreamPtr pending_stream =
-        std::make_unique<TcpPendingStream>(*this, typedContext<TcpAttachContext>(context));
+  ConnectionPool::Cancellable* newPendingStream(Envoy::ConnectionPool::AttachContext& context,
+                                                bool can_send_early_data) override {
+    Envoy::ConnectionPool::PendingStreamPtr pending_stream = std::make_unique<TcpPendingStream>(
+        *this, can_send_early_data, typedContext<TcpAttachContext>(context));
     return addPendingStream(std::move(pending_stream));
   }
 
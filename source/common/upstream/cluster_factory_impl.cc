@@ -66,6 +66,15 @@ std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr> ClusterFactoryImplBase::
         "Cannot use hostname for consistent hashing loadbalancing for cluster of type: '{}'",
         cluster_type));
   }
+
+  // Partitions beyond the number of workers would never be used, so their hosts would receive no
+  // traffic.
+  const uint32_t worker_host_partitions = cluster.common_lb_config().worker_host_partitions();
+  if (worker_host_partitions > 1 && worker_host_partitions > options.concurrency()) {
+    throw EnvoyException(fmt::format(
+        "cluster: worker_host_partitions ({}) of cluster '{}' must not exceed the concurrency ({})",
+        worker_host_partitions, cluster.name(), options.concurrency()));
+  }
   ClusterFactory* factory = Registry::FactoryRegistry<ClusterFactory>::getFactory(cluster_type);
 
   if (factory == nullptr) {
@@ -19,6 +19,7 @@
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/config/new_grpc_mux_impl.h"
 #include "common/config/utility.h"
@@ -44,6 +45,8 @@
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/subset_lb.h"
 
+#include "absl/container/flat_hash_set.h"
+
 #ifdef ENVOY_ENABLE_QUIC
 #include "common/http/http3/conn_pool.h"
 #endif
@@ -255,6 +258,12 @@ ClusterManagerImpl::ClusterManagerImpl(
     : factory_(factory), runtime_(runtime), stats_(stats), tls_(tls),
       random_(api.randomGenerator()),
       bind_config_(bootstrap.cluster_manager().upstream_bind_config()), local_info_(local_info),
+      deferred_cluster_creation_(bootstrap.cluster_manager().enable_deferred_cluster_creation()),
+      cluster_update_batch_window_(
+          bootstrap.cluster_manager().has_cluster_update_batch_window()
+              ? absl::make_optional(std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(
+                    bootstrap.cluster_manager(), cluster_update_batch_window)))
+              : absl::nullopt),
       cm_stats_(generateStats(stats)),
       init_helper_(*this, [this](ClusterManagerCluster& cluster) { onClusterInit(cluster); }),
       config_tracker_entry_(
@@ -271,6 +280,9 @@ ClusterManagerImpl::ClusterManagerImpl(
   async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
       *this, tls, time_source_, api, grpc_context.statNames());
   const auto& cm_config = bootstrap.cluster_manager();
+  if (cluster_update_batch_window_.has_value()) {
+    update_batch_timer_ = dispatcher_.createTimer([this]() -> void { flushThreadLocalUpdates(); });
+  }
   if (cm_config.has_outlier_detection()) {
     const std::string event_log_file_path = cm_config.outlier_detection().event_log_path();
     if (!event_log_file_path.empty()) {
@@ -439,7 +451,8 @@ void ClusterManagerImpl::initializeSecondaryClusters(
 ClusterManagerStats ClusterManagerImpl::generateStats(Stats::Scope& scope) {
   const std::string final_prefix = "cluster_manager.";
   return {ALL_CLUSTER_MANAGER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix),
-                                    POOL_GAUGE_PREFIX(scope, final_prefix))};
+                                    POOL_GAUGE_PREFIX(scope, final_prefix),
+                                    POOL_HISTOGRAM_PREFIX(scope, final_prefix))};
 }
 
 void ClusterManagerImpl::onClusterInit(ClusterManagerCluster& cm_cluster) {
@@ -701,13 +714,24 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
     removed = true;
     init_helper_.removeCluster(*existing_active_cluster->second);
     active_clusters_.erase(existing_active_cluster);
+    cluster_initialization_map_.erase(cluster_name);
 
     ENVOY_LOG(debug, "removing cluster {}", cluster_name);
+    flushThreadLocalUpdates();
     tls_.runOnAllThreads([cluster_name](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
-      ASSERT(cluster_manager->thread_local_clusters_.count(cluster_name) == 1);
+      cluster_manager->deferred_clusters_.erase(cluster_name);
+      if (cluster_manager->thread_local_clusters_.count(cluster_name) == 0) {
+        // The cluster was never created on this thread.
+        ASSERT(cluster_manager->parent_.deferred_cluster_creation_);
+        return;
+      }
       ENVOY_LOG(debug, "removing TLS cluster {}", cluster_name);
-      for (auto& cb : cluster_manager->update_callbacks_) {
-        cb->onClusterRemoval(cluster_name);
+      // The callbacks are not told about the removal of a deferred cluster whose creation they
+      // have not been told about yet.
+      if (cluster_manager->pending_created_clusters_.erase(cluster_name) == 0) {
+        for (auto& cb : cluster_manager->update_callbacks_) {
+          cb->onClusterRemoval(cluster_name);
+        }
       }
       cluster_manager->thread_local_clusters_.erase(cluster_name);
     });
@@ -854,6 +878,8 @@ ThreadLocalCluster* ClusterManagerImpl::getThreadLocalCluster(absl::string_view
   auto entry = cluster_manager.thread_local_clusters_.find(cluster);
   if (entry != cluster_manager.thread_local_clusters_.end()) {
     return entry->second.get();
+  } else if (deferred_cluster_creation_) {
+    return cluster_manager.initializeClusterInline(cluster);
   } else {
     return nullptr;
   }
@@ -930,8 +956,8 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
 
 void ClusterManagerImpl::postThreadLocalDrainConnections(const Cluster& cluster,
                                                          const HostVector& hosts_removed) {
-  tls_.runOnAllThreads([name = cluster.info()->name(),
-                        hosts_removed](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+  postThreadLocalUpdate([name = cluster.info()->name(),
+                         hosts_removed](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
     cluster_manager->removeHosts(name, hosts_removed);
   });
 }
@@ -957,9 +983,25 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
     per_priority.overprovisioning_factor_ = host_set->overprovisioningFactor();
   }
 
-  tls_.runOnAllThreads(
+  ClusterInitializationObjectConstSharedPtr cluster_initialization_object;
+  if (deferred_cluster_creation_) {
+    cluster_initialization_object = addOrUpdateClusterInitializationObject(
+        cm_cluster.cluster().info(), params, load_balancer_factory, add_or_update_cluster);
+  }
+
+  ThreadLocalUpdateCb update =
       [info = cm_cluster.cluster().info(), params = std::move(params), add_or_update_cluster,
-       load_balancer_factory](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+       load_balancer_factory, cluster_initialization_object](
+          OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+        if (cluster_initialization_object != nullptr) {
+          cluster_manager->deferred_clusters_[info->name()] = cluster_initialization_object;
+          // Clusters that have not been used on this thread are created from the latest
+          // initialization object on first use.
+          if (cluster_manager->thread_local_clusters_.count(info->name()) == 0) {
+            return;
+          }
+        }
+
         ThreadLocalClusterManagerImpl::ClusterEntry* new_cluster = nullptr;
         if (add_or_update_cluster) {
           if (cluster_manager->thread_local_clusters_.count(info->name()) > 0) {
@@ -981,15 +1023,85 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
         }
 
         if (new_cluster != nullptr) {
+          cluster_manager->pending_created_clusters_.erase(info->name());
           for (auto& cb : cluster_manager->update_callbacks_) {
             cb->onClusterAddOrUpdate(*new_cluster);
           }
         }
-      });
+      };
+
+  // Added or updated clusters are made available right away, only membership updates are batched.
+  if (add_or_update_cluster) {
+    flushThreadLocalUpdates();
+    tls_.runOnAllThreads(update);
+  } else {
+    postThreadLocalUpdate(std::move(update));
+  }
+}
+
+void ClusterManagerImpl::postThreadLocalUpdate(ThreadLocalUpdateCb update) {
+  if (!cluster_update_batch_window_.has_value()) {
+    tls_.runOnAllThreads(update);
+    return;
+  }
+
+  if (batched_updates_.empty()) {
+    batch_started_ = time_source_.monotonicTime();
+    update_batch_timer_->enableTimer(cluster_update_batch_window_.value());
+  }
+  batched_updates_.push_back(std::move(update));
+}
+
+void ClusterManagerImpl::flushThreadLocalUpdates() {
+  if (batched_updates_.empty()) {
+    return;
+  }
+  update_batch_timer_->disableTimer();
+  cm_stats_.update_batch_size_.recordValue(batched_updates_.size());
+
+  // The batch is shared by all threads rather than copied into each posted callback.
+  auto updates =
+      std::make_shared<const std::vector<ThreadLocalUpdateCb>>(std::move(batched_updates_));
+  batched_updates_.clear();
+  tls_.runOnAllThreads([updates, batch_started = batch_started_](
+                           OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+    for (const auto& update : *updates) {
+      update(cluster_manager);
+    }
+    const auto propagation_time =
+        cluster_manager->thread_local_dispatcher_.timeSource().monotonicTime() - batch_started;
+    cluster_manager->parent_.cm_stats_.update_batch_propagation_ms_.recordValue(
+        std::chrono::duration_cast<std::chrono::milliseconds>(propagation_time).count());
+  });
+}
+
+ClusterManagerImpl::ClusterInitializationObjectConstSharedPtr
+ClusterManagerImpl::addOrUpdateClusterInitializationObject(
+    const ClusterInfoConstSharedPtr& cluster_info, const ThreadLocalClusterUpdateParams& params,
+    LoadBalancerFactorySharedPtr load_balancer_factory, bool add_or_update_cluster) {
+  auto object = std::make_shared<ClusterInitializationObject>();
+  const auto entry = cluster_initialization_map_.find(cluster_info->name());
+  // A membership update only carries the priorities that changed, so start from the previous
+  // state. An added or updated cluster carries all of its hosts.
+  if (!add_or_update_cluster && entry != cluster_initialization_map_.end()) {
+    object->per_priority_state_ = entry->second->per_priority_state_;
+    load_balancer_factory = entry->second->load_balancer_factory_;
+  }
+  object->cluster_info_ = cluster_info;
+  object->load_balancer_factory_ = std::move(load_balancer_factory);
+  for (const auto& per_priority : params.per_priority_update_params_) {
+    object->per_priority_state_[per_priority.priority_] = {per_priority.update_hosts_params_,
+                                                           per_priority.locality_weights_,
+                                                           per_priority.overprovisioning_factor_};
+  }
+  cluster_initialization_map_[cluster_info->name()] = object;
+  return object;
 }
 
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
-  tls_.runOnAllThreads([host](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+  // Batched like membership updates, so that the connection pools of a host are not drained ahead
+  // of a pending update that adds it.
+  postThreadLocalUpdate([host](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
     cluster_manager->onHostHealthFailure(host);
   });
 }
@@ -1061,7 +1173,10 @@ ProtobufTypes::MessagePtr ClusterManagerImpl::dumpClusterConfigs() {
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl(
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
     const absl::optional<LocalClusterParams>& local_cluster_params)
-    : parent_(parent), thread_local_dispatcher_(dispatcher) {
+    : parent_(parent), thread_local_dispatcher_(dispatcher),
+      worker_index_(&dispatcher == &parent.dispatcher_
+                        ? absl::nullopt
+                        : absl::make_optional(parent.next_worker_index_++)) {
   // If local cluster is defined then we need to initialize it first.
   if (local_cluster_params.has_value()) {
     const auto& local_cluster_name = local_cluster_params->info_->name();
@@ -1070,6 +1185,13 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
         *this, local_cluster_params->info_, local_cluster_params->load_balancer_factory_);
     local_priority_set_ = &thread_local_clusters_[local_cluster_name]->priority_set_;
   }
+
+  if (parent_.deferred_cluster_creation_) {
+    announce_created_clusters_cb_ =
+        thread_local_dispatcher_.createSchedulableCallback([this]() -> void {
+          announceCreatedClusters();
+        });
+  }
 }
 
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImpl() {
@@ -1090,6 +1212,47 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImp
   thread_local_clusters_.clear();
 }
 
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::initializeClusterInline(absl::string_view name) {
+  const auto deferred_cluster = deferred_clusters_.find(name);
+  if (deferred_cluster == deferred_clusters_.end()) {
+    return nullptr;
+  }
+  const ClusterInitializationObjectConstSharedPtr object = deferred_cluster->second;
+  const std::string& cluster_name = object->cluster_info_->name();
+  ENVOY_LOG(debug, "creating deferred TLS cluster {}", cluster_name);
+  auto new_cluster =
+      std::make_unique<ClusterEntry>(*this, object->cluster_info_, object->load_balancer_factory_);
+  ClusterEntry* cluster_entry = new_cluster.get();
+  thread_local_clusters_[cluster_name] = std::move(new_cluster);
+  for (const auto& [priority, per_priority] : object->per_priority_state_) {
+    updateClusterMembership(cluster_name, priority, per_priority.update_hosts_params_,
+                            per_priority.locality_weights_,
+                            *per_priority.update_hosts_params_.hosts, HostVector{},
+                            per_priority.overprovisioning_factor_);
+  }
+  parent_.cm_stats_.deferred_cluster_created_.inc();
+
+  // The cluster is created from within getThreadLocalCluster(), whose caller may not expect the
+  // update callbacks to run, so they are told about the cluster from the event loop instead.
+  pending_created_clusters_.insert(cluster_name);
+  announce_created_clusters_cb_->scheduleCallbackCurrentIteration();
+  return cluster_entry;
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::announceCreatedClusters() {
+  // Callbacks may look up further deferred clusters, which are announced in a later pass.
+  const absl::flat_hash_set<std::string> created_clusters = std::move(pending_created_clusters_);
+  pending_created_clusters_.clear();
+  for (const std::string& name : created_clusters) {
+    const auto entry = thread_local_clusters_.find(name);
+    ASSERT(entry != thread_local_clusters_.end());
+    for (auto& cb : update_callbacks_) {
+      cb->onClusterAddOrUpdate(*entry->second);
+    }
+  }
+}
+
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::drainConnPools(const HostVector& hosts) {
   for (const HostSharedPtr& host : hosts) {
     {
@@ -1202,8 +1365,13 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeTcpConn(
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeHosts(
     const std::string& name, const HostVector& hosts_removed) {
-  ASSERT(thread_local_clusters_.find(name) != thread_local_clusters_.end());
-  const auto& cluster_entry = thread_local_clusters_[name];
+  const auto entry = thread_local_clusters_.find(name);
+  if (entry == thread_local_clusters_.end()) {
+    // There are no connection pools of a deferred cluster that has not been created.
+    ASSERT(parent_.deferred_cluster_creation_);
+    return;
+  }
+  const auto& cluster_entry = entry->second;
   ENVOY_LOG(debug, "removing hosts for TLS cluster {} removed {}", name, hosts_removed.size());
 
   // We need to go through and purge any connection pools for hosts that got deleted.
@@ -1220,9 +1388,8 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
   const auto& cluster_entry = thread_local_clusters_[name];
   ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
             hosts_added.size(), hosts_removed.size());
-  cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
-                                           std::move(locality_weights), hosts_added, hosts_removed,
-                                           overprovisioning_factor);
+  cluster_entry->updateHosts(priority, std::move(update_hosts_params), std::move(locality_weights),
+                             hosts_added, hosts_removed, overprovisioning_factor);
 
   // If an LB is thread aware, create a new worker local LB on membership changes.
   if (cluster_entry->lb_factory_ != nullptr) {
@@ -1360,6 +1527,84 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
   }
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::updateHosts(
+    uint32_t priority, PrioritySet::UpdateHostsParams&& update_hosts_params,
+    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
+    const HostVector& hosts_removed, uint64_t overprovisioning_factor) {
+  const uint32_t partitions = cluster_info_->lbConfig().worker_host_partitions();
+  // Thread aware load balancers are built from the main thread's hosts, so partitioning the worker
+  // local hosts would have no effect on them.
+  if (partitions <= 1 || !parent_.worker_index_.has_value() || lb_factory_ != nullptr) {
+    priority_set_.updateHosts(priority, std::move(update_hosts_params),
+                              std::move(locality_weights), hosts_added, hosts_removed,
+                              overprovisioning_factor);
+    return;
+  }
+
+  const uint64_t partition = parent_.worker_index_.value() % partitions;
+  const auto in_partition = [partitions, partition](const Host& host) {
+    return HashUtil::xxHash64(host.address()->asStringView()) % partitions == partition;
+  };
+  HostVectorConstSharedPtr hosts = update_hosts_params.hosts;
+  HostsPerLocalityConstSharedPtr hosts_per_locality = update_hosts_params.hosts_per_locality;
+  auto partition_hosts = std::make_shared<HostVector>();
+  bool partition_available = false;
+  for (const HostSharedPtr& host : *hosts) {
+    if (in_partition(*host)) {
+      partition_hosts->push_back(host);
+      partition_available |= host->health() != Host::Health::Unhealthy;
+    }
+  }
+  // Rather than failing all streams of this worker, use all hosts if none of the hosts in its
+  // partition are healthy or degraded. Health changes are posted as membership updates, so the
+  // worker switches back to its partition once one of its hosts recovers.
+  if (partition_available) {
+    hosts = std::move(partition_hosts);
+    hosts_per_locality = hosts_per_locality->filter({in_partition})[0];
+  }
+
+  // Hosts enter and leave the partition as they are added to or removed from the cluster, but also
+  // when the worker starts or stops using all hosts, so compute the changes against the current
+  // hosts rather than filtering the cluster's changes.
+  const HostVector& current_hosts = priority_set_.getOrCreateHostSet(priority).hosts();
+  absl::flat_hash_set<const Host*> current_set;
+  current_set.reserve(current_hosts.size());
+  for (const HostSharedPtr& host : current_hosts) {
+    current_set.insert(host.get());
+  }
+  absl::flat_hash_set<const Host*> next_set;
+  next_set.reserve(hosts->size());
+  HostVector added;
+  for (const HostSharedPtr& host : *hosts) {
+    next_set.insert(host.get());
+    if (!current_set.contains(host.get())) {
+      added.push_back(host);
+    }
+  }
+  HostVector removed;
+  HostVector left_partition;
+  absl::flat_hash_set<const Host*> removed_from_cluster;
+  for (const HostSharedPtr& host : hosts_removed) {
+    removed_from_cluster.insert(host.get());
+  }
+  for (const HostSharedPtr& host : current_hosts) {
+    if (!next_set.contains(host.get())) {
+      removed.push_back(host);
+      if (!removed_from_cluster.contains(host.get())) {
+        left_partition.push_back(host);
+      }
+    }
+  }
+
+  priority_set_.updateHosts(priority, HostSetImpl::partitionHosts(hosts, hosts_per_locality),
+                            std::move(locality_weights), added, removed, overprovisioning_factor);
+  // Connections to removed hosts are drained by removeHosts(), but the ones to hosts that are
+  // still in the cluster and no longer used by this worker are drained here.
+  if (!left_partition.empty()) {
+    parent_.drainConnPools(left_partition);
+  }
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::~ClusterEntry() {
   // We need to drain all connection pools for the cluster being removed. Then we can remove the
   // cluster.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -34,6 +35,8 @@
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -198,22 +201,26 @@ private:
 /**
  * All cluster manager stats. @see stats_macros.h
  */
-#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE)                                                  \
+#define ALL_CLUSTER_MANAGER_STATS(COUNTER, GAUGE, HISTOGRAM)                                       \
   COUNTER(cluster_added)                                                                           \
   COUNTER(cluster_modified)                                                                        \
   COUNTER(cluster_removed)                                                                         \
   COUNTER(cluster_updated)                                                                         \
   COUNTER(cluster_updated_via_merge)                                                               \
+  COUNTER(deferred_cluster_created)                                                                \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
   GAUGE(active_clusters, NeverImport)                                                              \
-  GAUGE(warming_clusters, NeverImport)
+  GAUGE(warming_clusters, NeverImport)                                                             \
+  HISTOGRAM(update_batch_propagation_ms, Milliseconds)                                             \
+  HISTOGRAM(update_batch_size, Unspecified)
 
 /**
  * Struct definition for all cluster manager stats. @see stats_macros.h
  */
 struct ClusterManagerStats {
-  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  ALL_CLUSTER_MANAGER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                            GENERATE_HISTOGRAM_STRUCT)
 };
 
 /**
@@ -271,6 +278,12 @@ public:
     active_clusters_.clear();
     warming_clusters_.clear();
     updateClusterCounts();
+    // The workers are shutting down as well, so the pending batch of updates is dropped rather
+    // than posted.
+    if (update_batch_timer_ != nullptr) {
+      update_batch_timer_->disableTimer();
+    }
+    batched_updates_.clear();
   }
 
   const envoy::config::core::v3::BindConfig& bindConfig() const override { return bind_config_; }
@@ -336,6 +349,25 @@ protected:
                                             ThreadLocalClusterUpdateParams&& params);
 
 private:
+  /**
+   * The state needed to create a thread local cluster on first use if cluster creation is
+   * deferred. A single object is shared by all workers, and replaced on every cluster update.
+   */
+  struct ClusterInitializationObject {
+    struct PerPriority {
+      PrioritySet::UpdateHostsParams update_hosts_params_;
+      LocalityWeightsConstSharedPtr locality_weights_;
+      uint32_t overprovisioning_factor_;
+    };
+
+    ClusterInfoConstSharedPtr cluster_info_;
+    LoadBalancerFactorySharedPtr load_balancer_factory_;
+    // Ordered by priority, as host sets are created in that order.
+    std::map<uint32_t, PerPriority> per_priority_state_;
+  };
+  using ClusterInitializationObjectConstSharedPtr =
+      std::shared_ptr<const ClusterInitializationObject>;
+
   /**
    * Thread local cached cluster data. Each thread local cluster gets updates from the parent
    * central dynamic cluster (if applicable). It maintains load balancer state and any created
@@ -412,6 +444,13 @@ private:
       Host::CreateConnectionData tcpConn(LoadBalancerContext* context) override;
       Http::AsyncClient& httpAsyncClient() override;
 
+      // Applies a membership update to the worker local priority set. If the cluster partitions
+      // its hosts across workers, only the hosts of this worker's partition are kept.
+      void updateHosts(uint32_t priority, PrioritySet::UpdateHostsParams&& update_hosts_params,
+                       LocalityWeightsConstSharedPtr locality_weights,
+                       const HostVector& hosts_added, const HostVector& hosts_removed,
+                       uint64_t overprovisioning_factor);
+
       ThreadLocalClusterManagerImpl& parent_;
       PrioritySetImpl priority_set_;
       // LB factory if applicable. Not all load balancer types have a factory. LB types that have
@@ -446,13 +485,29 @@ private:
                                  const HostVector& hosts_added, const HostVector& hosts_removed,
                                  uint64_t overprovisioning_factor);
     void onHostHealthFailure(const HostSharedPtr& host);
+    // Creates a deferred cluster on its first use on this thread. Returns nullptr if there is no
+    // such cluster. A created cluster is kept until it is removed. It is not evicted when idle:
+    // its connection pools are only released when its hosts or the cluster are removed, and the
+    // update callbacks have no way to tell an eviction from a removal, so extensions holding on to
+    // the cluster, such as the aggregate cluster and Redis proxy, would lose it.
+    ClusterEntry* initializeClusterInline(absl::string_view name);
+    // Runs the update callbacks for the deferred clusters created since the last call.
+    void announceCreatedClusters();
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
 
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
+    // The index of this worker, used to partition hosts across workers. Unset on the main thread.
+    const absl::optional<uint32_t> worker_index_;
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
+    // If cluster creation is deferred, all clusters known to the cluster manager, whether or not
+    // they have been created on this thread.
+    absl::flat_hash_map<std::string, ClusterInitializationObjectConstSharedPtr> deferred_clusters_;
+    // Deferred clusters that have been created, but not yet passed to the update callbacks.
+    absl::flat_hash_set<std::string> pending_created_clusters_;
+    Event::SchedulableCallbackPtr announce_created_clusters_cb_;
 
     ClusterConnectivityState cluster_manager_state_;
 
@@ -567,7 +622,19 @@ private:
                              const uint64_t cluster_hash, const std::string& version_info,
                              bool added_via_api, ClusterMap& cluster_map);
   void onClusterInit(ClusterManagerCluster& cluster);
+  ClusterInitializationObjectConstSharedPtr
+  addOrUpdateClusterInitializationObject(const ClusterInfoConstSharedPtr& cluster_info,
+                                         const ThreadLocalClusterUpdateParams& params,
+                                         LoadBalancerFactorySharedPtr load_balancer_factory,
+                                         bool add_or_update_cluster);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
+  using ThreadLocalUpdateCb = ThreadLocal::TypedSlot<ThreadLocalClusterManagerImpl>::UpdateCb;
+  // Runs an update on all threads. If updates are batched, the update is added to the pending
+  // batch instead, and runs in order with the other updates of the batch once it is flushed.
+  void postThreadLocalUpdate(ThreadLocalUpdateCb update);
+  // Runs the pending batch of updates, if any, on all threads. Updates that cannot be batched, e.g.
+  // adding or removing a cluster, flush the batch before they are posted to preserve their order.
+  void flushThreadLocalUpdates();
   void updateClusterCounts();
   void clusterWarmingToActive(const std::string& cluster_name);
   static void maybePreconnect(ThreadLocalClusterManagerImpl::ClusterEntry& cluster_entry,
@@ -578,6 +645,8 @@ private:
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
   ThreadLocal::TypedSlot<ThreadLocalClusterManagerImpl> tls_;
+  // Worker indexes are handed out as the thread local cluster managers are created on the workers.
+  std::atomic<uint32_t> next_worker_index_{0};
   Random::RandomGenerator& random_;
 
 protected:
@@ -588,6 +657,12 @@ private:
   envoy::config::core::v3::BindConfig bind_config_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
+  // See enable_deferred_cluster_creation in the bootstrap's cluster manager config.
+  const bool deferred_cluster_creation_;
+  // See cluster_update_batch_window in the bootstrap's cluster manager config.
+  const absl::optional<std::chrono::milliseconds> cluster_update_batch_window_;
+  absl::flat_hash_map<std::string, ClusterInitializationObjectConstSharedPtr>
+      cluster_initialization_map_;
   CdsApiPtr cds_api_;
   ClusterManagerStats cm_stats_;
   ClusterManagerInitHelper init_helper_;
@@ -602,6 +677,10 @@ private:
   TimeSource& time_source_;
   ClusterUpdatesMap updates_map_;
   Event::Dispatcher& dispatcher_;
+  Event::TimerPtr update_batch_timer_;
+  std::vector<ThreadLocalUpdateCb> batched_updates_;
+  // When the first update of the pending batch was posted.
+  MonotonicTime batch_started_;
   Http::Context& http_context_;
   Router::Context& router_context_;
   ClusterStatNames cluster_stat_names_;
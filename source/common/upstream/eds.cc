@@ -206,6 +206,16 @@ void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
   for (size_t priority = 0; priority < host_sets.size(); ++priority) {
     const auto& host_set = host_sets[priority];
 
+    // Unless a host is excluded from this priority, its hosts are unchanged and can be shared.
+    if (host_to_exclude == nullptr ||
+        std::find(host_set->hosts().begin(), host_set->hosts().end(), host_to_exclude) ==
+            host_set->hosts().end()) {
+      prioritySet().updateHosts(priority,
+                                HostSetImpl::updateHostsParamsForHealthChange(*host_set, host),
+                                host_set->localityWeights(), {}, {}, absl::nullopt);
+      continue;
+    }
+
     // Filter current hosts in case we need to exclude a host.
     HostVectorSharedPtr hosts_copy(new HostVector());
     std::copy_if(host_set->hosts().begin(), host_set->hosts().end(),
@@ -222,6 +222,26 @@ bool updateHealthFlag(const Host& updated_host, Host& existing_host, Host::Healt
   return false;
 }
 
+bool excludeBasedOnHealthFlag(const Host& host) {
+  return host.healthFlagGet(Host::HealthFlag::PENDING_ACTIVE_HC) ||
+         (host.healthFlagGet(Host::HealthFlag::EXCLUDED_VIA_IMMEDIATE_HC_FAIL) &&
+          Runtime::runtimeFeatureEnabled(
+              "envoy.reloadable_features.health_check.immediate_failure_exclude_from_cluster"));
+}
+
+// Returns the hosts matching the predicate, in their original order.
+template <class HostVectorType>
+std::shared_ptr<const HostVectorType>
+filterHostVector(const HostVector& hosts, const std::function<bool(const Host&)>& pred) {
+  auto filtered = std::make_shared<HostVectorType>();
+  for (const auto& host : hosts) {
+    if (pred(*host)) {
+      filtered->get().emplace_back(host);
+    }
+  }
+  return filtered;
+}
+
 // Converts a set of hosts into a HostVector, excluding certain hosts.
 // @param hosts hosts to convert
 // @param excluded_hosts hosts to exclude from the resulting vector.
@@ -522,6 +542,50 @@ HostSetImpl::partitionHosts(HostVectorConstSharedPtr hosts,
                            std::move(std::get<2>(healthy_degraded_excluded_hosts_per_locality)));
 }
 
+PrioritySet::UpdateHostsParams
+HostSetImpl::updateHostsParamsForHealthChange(const HostSet& host_set,
+                                              const HostSharedPtr& changed_host) {
+  // The hosts themselves are unchanged, so the host vectors are shared with the current host set.
+  // When the host isn't known, all subsets are recomputed.
+  if (changed_host == nullptr) {
+    return partitionHosts(host_set.hostsPtr(), host_set.hostsPerLocalityPtr());
+  }
+
+  PrioritySet::UpdateHostsParams params = updateHostsParams(host_set);
+  const auto& hosts = host_set.hosts();
+  if (std::find(hosts.begin(), hosts.end(), changed_host) == hosts.end()) {
+    return params;
+  }
+
+  // Only the subsets the host entered or left are recomputed, the others are shared. Finding the
+  // host in a subset only compares pointers, which is much cheaper than copying the subset.
+  const auto membership_changed = [&changed_host](const HostVector& subset, bool member) {
+    return member != (std::find(subset.begin(), subset.end(), changed_host) != subset.end());
+  };
+  const std::function<bool(const Host&)> is_healthy = [](const Host& host) {
+    return host.health() == Host::Health::Healthy;
+  };
+  if (membership_changed(host_set.healthyHosts(), is_healthy(*changed_host))) {
+    params.healthy_hosts = filterHostVector<HealthyHostVector>(hosts, is_healthy);
+    params.healthy_hosts_per_locality = host_set.hostsPerLocality().filter({is_healthy})[0];
+  }
+  const std::function<bool(const Host&)> is_degraded = [](const Host& host) {
+    return host.health() == Host::Health::Degraded;
+  };
+  if (membership_changed(host_set.degradedHosts(), is_degraded(*changed_host))) {
+    params.degraded_hosts = filterHostVector<DegradedHostVector>(hosts, is_degraded);
+    params.degraded_hosts_per_locality = host_set.hostsPerLocality().filter({is_degraded})[0];
+  }
+  const std::function<bool(const Host&)> is_excluded = [](const Host& host) {
+    return excludeBasedOnHealthFlag(host);
+  };
+  if (membership_changed(host_set.excludedHosts(), is_excluded(*changed_host))) {
+    params.excluded_hosts = filterHostVector<ExcludedHostVector>(hosts, is_excluded);
+    params.excluded_hosts_per_locality = host_set.hostsPerLocality().filter({is_excluded})[0];
+  }
+  return params;
+}
+
 double HostSetImpl::effectiveLocalityWeight(uint32_t index,
                                             const HostsPerLocality& eligible_hosts_per_locality,
                                             const HostsPerLocality& excluded_hosts_per_locality,
@@ -747,6 +811,10 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      min_ready_connections_(config.preconnect_policy().min_ready_connections()),
+      arrival_rate_lookahead_(std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(config.preconnect_policy(), arrival_rate_lookahead, 0))),
+      connection_selection_policy_(config.connection_selection_policy()),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
@@ -1010,17 +1078,6 @@ ClusterImplBase::ClusterImplBase(
       });
 }
 
-namespace {
-
-bool excludeBasedOnHealthFlag(const Host& host) {
-  return host.healthFlagGet(Host::HealthFlag::PENDING_ACTIVE_HC) ||
-         (host.healthFlagGet(Host::HealthFlag::EXCLUDED_VIA_IMMEDIATE_HC_FAIL) &&
-          Runtime::runtimeFeatureEnabled(
-              "envoy.reloadable_features.health_check.immediate_failure_exclude_from_cluster"));
-}
-
-} // namespace
-
 std::tuple<HealthyHostVectorConstSharedPtr, DegradedHostVectorConstSharedPtr,
            ExcludedHostVectorConstSharedPtr>
 ClusterImplBase::partitionHostList(const HostVector& hosts) {
@@ -1158,16 +1215,12 @@ void ClusterImplBase::reloadHealthyHosts(const HostSharedPtr& host) {
   reloadHealthyHostsHelper(host);
 }
 
-void ClusterImplBase::reloadHealthyHostsHelper(const HostSharedPtr&) {
+void ClusterImplBase::reloadHealthyHostsHelper(const HostSharedPtr& host) {
   const auto& host_sets = prioritySet().hostSetsPerPriority();
   for (size_t priority = 0; priority < host_sets.size(); ++priority) {
     const auto& host_set = host_sets[priority];
-    // TODO(htuch): Can we skip these copies by exporting out const shared_ptr from HostSet?
-    HostVectorConstSharedPtr hosts_copy = std::make_shared<HostVector>(host_set->hosts());
-
-    HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().clone();
     prioritySet().updateHosts(priority,
-                              HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy),
+                              HostSetImpl::updateHostsParamsForHealthChange(*host_set, host),
                               host_set->localityWeights(), {}, {}, absl::nullopt);
   }
 }
@@ -354,6 +354,16 @@ public:
   static PrioritySet::UpdateHostsParams updateHostsParams(const HostSet& host_set);
   static PrioritySet::UpdateHostsParams
   partitionHosts(HostVectorConstSharedPtr hosts, HostsPerLocalityConstSharedPtr hosts_per_locality);
+  /**
+   * Builds the parameters to update a host set whose hosts are unchanged, but where the health of
+   * changed_host may have changed. The host vectors, and the subsets that changed_host neither
+   * entered nor left, are shared with the current host set rather than copied.
+   * @param host_set supplies the current host set.
+   * @param changed_host supplies the host whose health changed, or nullptr if unknown, in which
+   *        case all subsets are recomputed.
+   */
+  static PrioritySet::UpdateHostsParams
+  updateHostsParamsForHealthChange(const HostSet& host_set, const HostSharedPtr& changed_host);
 
   void updateHosts(PrioritySet::UpdateHostsParams&& update_hosts_params,
                    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
@@ -552,6 +562,14 @@ public:
   }
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  uint32_t minReadyConnections() const override { return min_ready_connections_; }
+  std::chrono::milliseconds arrivalRateLookahead() const override {
+    return arrival_rate_lookahead_;
+  }
+  envoy::config::cluster::v3::Cluster::ConnectionSelectionPolicy
+  connectionSelectionPolicy() const override {
+    return connection_selection_policy_;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -699,6 +717,9 @@ private:
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  const uint32_t min_ready_connections_;
+  const std::chrono::milliseconds arrival_rate_lookahead_;
+  const envoy::config::cluster::v3::Cluster::ConnectionSelectionPolicy connection_selection_policy_;
   const uint32_t per_connection_buffer_limit_bytes_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopePtr stats_scope_;
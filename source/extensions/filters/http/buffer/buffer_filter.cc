@@ -4,6 +4,7 @@
 #include "envoy/extensions/filters/http/buffer/v3/buffer.pb.h"
 #include "envoy/http/codes.h"
 
+#include "common/buffer/watermark_buffer.h"
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
 #include "common/http/codes.h"
@@ -33,11 +34,20 @@ BufferFilterSettings::BufferFilterSettings(
               : 0) {}
 
 BufferFilterConfig::BufferFilterConfig(
-    const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config)
-    : settings_(proto_config) {}
+    const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config,
+    Server::OverloadManager& overload_manager)
+    : settings_(proto_config), overload_manager_(overload_manager) {}
+
+const Server::OverloadActionState& BufferFilterConfig::bufferLimitReduction() const {
+  // The overload state is thread local, so it must be looked up on the worker creating the filter.
+  return overload_manager_.getThreadLocalOverloadState().getState(
+      Server::OverloadActionNames::get().ReduceBufferLimits);
+}
 
-BufferFilter::BufferFilter(BufferFilterConfigSharedPtr config)
-    : config_(config), settings_(config->settings()) {}
+BufferFilter::BufferFilter(BufferFilterConfigSharedPtr config,
+                           const Server::OverloadActionState& buffer_limit_reduction)
+    : config_(config), settings_(config->settings()),
+      buffer_limit_reduction_(buffer_limit_reduction) {}
 
 void BufferFilter::initConfig() {
   ASSERT(!config_initialized_);
@@ -69,7 +79,8 @@ Http::FilterHeadersStatus BufferFilter::decodeHeaders(Http::RequestHeaderMap& he
     return Http::FilterHeadersStatus::Continue;
   }
 
-  callbacks_->setDecoderBufferLimit(settings_->maxRequestBytes());
+  callbacks_->setDecoderBufferLimit(Buffer::scaleBufferLimit(
+      static_cast<uint32_t>(settings_->maxRequestBytes()), buffer_limit_reduction_.value()));
   request_headers_ = &headers;
 
   return Http::FilterHeadersStatus::StopIteration;
@@ -7,6 +7,7 @@
 
 #include "envoy/extensions/filters/http/buffer/v3/buffer.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/server/overload/overload_manager.h"
 
 #include "common/buffer/buffer_impl.h"
 
@@ -33,12 +34,19 @@ private:
  */
 class BufferFilterConfig {
 public:
-  BufferFilterConfig(const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config);
+  BufferFilterConfig(const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config,
+                     Server::OverloadManager& overload_manager);
 
   const BufferFilterSettings* settings() const { return &settings_; }
 
+  /**
+   * @return the calling worker's state of the reduce buffer limits overload action.
+   */
+  const Server::OverloadActionState& bufferLimitReduction() const;
+
 private:
   const BufferFilterSettings settings_;
+  Server::OverloadManager& overload_manager_;
 };
 
 using BufferFilterConfigSharedPtr = std::shared_ptr<BufferFilterConfig>;
@@ -48,7 +56,12 @@ using BufferFilterConfigSharedPtr = std::shared_ptr<BufferFilterConfig>;
  */
 class BufferFilter : public Http::StreamDecoderFilter {
 public:
-  BufferFilter(BufferFilterConfigSharedPtr config);
+  /**
+   * @param buffer_limit_reduction the thread local state of the reduce buffer limits overload
+   *        action, which scales down max_request_bytes under resource pressure.
+   */
+  BufferFilter(BufferFilterConfigSharedPtr config,
+               const Server::OverloadActionState& buffer_limit_reduction);
 
   // Http::StreamFilterBase
   void onDestroy() override {}
@@ -66,6 +79,7 @@ private:
 
   BufferFilterConfigSharedPtr config_;
   const BufferFilterSettings* settings_;
+  const Server::OverloadActionState& buffer_limit_reduction_;
   Http::StreamDecoderFilterCallbacks* callbacks_{};
   Http::RequestHeaderMap* request_headers_{};
   uint64_t content_length_{};
@@ -17,12 +17,14 @@ namespace BufferFilter {
 
 Http::FilterFactoryCb BufferFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::buffer::v3::Buffer& proto_config, const std::string&,
-    Server::Configuration::FactoryContext&) {
+    Server::Configuration::FactoryContext& context) {
   ASSERT(proto_config.has_max_request_bytes());
 
-  BufferFilterConfigSharedPtr filter_config(new BufferFilterConfig(proto_config));
+  BufferFilterConfigSharedPtr filter_config(
+      new BufferFilterConfig(proto_config, context.overloadManager()));
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamDecoderFilter(std::make_shared<BufferFilter>(filter_config));
+    callbacks.addStreamDecoderFilter(
+        std::make_shared<BufferFilter>(filter_config, filter_config->bufferLimitReduction()));
   };
 }
 
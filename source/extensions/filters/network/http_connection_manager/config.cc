@@ -23,6 +23,7 @@
 #include "common/http/conn_manager_config.h"
 #include "common/http/conn_manager_utility.h"
 #include "common/http/default_server_string.h"
+#include "common/http/filter_latency.h"
 #include "common/http/http1/codec_impl.h"
 #include "common/http/http1/settings.h"
 #include "common/http/http2/codec_impl.h"
@@ -42,6 +43,8 @@
 
 #include "extensions/filters/http/common/pass_through_filter.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -233,6 +236,7 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
       request_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, request_timeout, RequestTimeoutMs)),
       request_headers_timeout_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, request_headers_timeout, RequestHeaderTimeoutMs)),
+      stream_timer_granularity_(PROTOBUF_GET_MS_OR_DEFAULT(config, stream_timer_granularity, 0)),
       drain_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, drain_timeout, 5000)),
       generate_request_id_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, generate_request_id, true)),
       preserve_external_request_id_(config.preserve_external_request_id()),
@@ -260,7 +264,12 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
       merge_slashes_(config.merge_slashes()),
       headers_with_underscores_action_(
           config.common_http_protocol_options().headers_with_underscores_action()),
-      local_reply_(LocalReply::Factory::create(config.local_reply_config(), context)) {
+      local_reply_(LocalReply::Factory::create(config.local_reply_config(), context)),
+      filter_latency_enabled_(config.has_filter_latency()),
+      filter_latency_sample_rate_(
+          PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(config.filter_latency(), sample_rate, 100.0) /
+          100.0),
+      record_filter_cpu_time_(config.filter_latency().record_cpu_time()) {
   // If idle_timeout_ was not configured in common_http_protocol_options, use value in deprecated
   // idle_timeout field.
   // TODO(asraa): Remove when idle_timeout is removed.
@@ -537,6 +546,7 @@ void HttpConnectionManagerConfig::processFilter(
                     : static_cast<const Protobuf::Message&>(
                           proto_config.hidden_envoy_deprecated_config()),
                 true));
+  addFilterLatencyRecorder(filter_config_provider->name());
   filter_factories.push_back(std::move(filter_config_provider));
 }
 
@@ -565,6 +575,7 @@ void HttpConnectionManagerConfig::processDynamicFilterConfig(
 
   auto filter_config_provider = filter_config_provider_manager_.createDynamicFilterConfigProvider(
       config_discovery, name, context_, stats_prefix_);
+  addFilterLatencyRecorder(filter_config_provider->name());
   filter_factories.push_back(std::move(filter_config_provider));
 }
 
@@ -605,15 +616,36 @@ HttpConnectionManagerConfig::createCodec(Network::Connection& connection,
   NOT_REACHED_GCOVR_EXCL_LINE;
 }
 
+void HttpConnectionManagerConfig::addFilterLatencyRecorder(const std::string& name) {
+  if (!filter_latency_enabled_ || filter_latency_recorders_.contains(name)) {
+    return;
+  }
+  filter_latency_recorders_.emplace(
+      name, std::make_unique<Http::FilterLatencyRecorderImpl>(
+                absl::StrCat(stats_prefix_, "filter_latency.", name, "."), context_.scope(),
+                record_filter_cpu_time_));
+}
+
 void HttpConnectionManagerConfig::createFilterChainForFactories(
     Http::FilterChainFactoryCallbacks& callbacks, const FilterFactoriesList& filter_factories) {
+  // Sampling is decided once per stream, so the filters of a stream are all timed or not at all.
+  const bool record_filter_latency =
+      filter_latency_enabled_ &&
+      context_.api().randomGenerator().bernoulli(filter_latency_sample_rate_);
   bool added_missing_config_filter = false;
   for (const auto& filter_config_provider : filter_factories) {
     auto config = filter_config_provider->config();
     if (config.has_value()) {
+      if (record_filter_latency) {
+        callbacks.setFilterLatencyRecorder(
+            filter_latency_recorders_.at(filter_config_provider->name()).get());
+      }
       config.value()(callbacks);
       continue;
     }
+    if (record_filter_latency) {
+      callbacks.setFilterLatencyRecorder(nullptr);
+    }
 
     // If a filter config is missing after warming, inject a local reply with status 500.
     if (!added_missing_config_filter) {
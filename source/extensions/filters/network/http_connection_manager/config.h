@@ -17,6 +17,7 @@
 #include "envoy/router/route_config_provider_manager.h"
 #include "envoy/tracing/http_tracer_manager.h"
 
+#include "common/common/interval_value.h"
 #include "common/common/logger.h"
 #include "common/http/conn_manager_config.h"
 #include "common/http/conn_manager_impl.h"
@@ -33,6 +34,8 @@
 #include "extensions/filters/network/common/factory_base.h"
 #include "extensions/filters/network/well_known_names.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -135,6 +138,9 @@ public:
   absl::optional<std::chrono::milliseconds> maxStreamDuration() const override {
     return max_stream_duration_;
   }
+  std::chrono::milliseconds streamTimerGranularity() const override {
+    return stream_timer_granularity_;
+  }
   Router::RouteConfigProvider* routeConfigProvider() override {
     return route_config_provider_.get();
   }
@@ -193,6 +199,8 @@ private:
                              const envoy::config::core::v3::ExtensionConfigSource& config_discovery,
                              FilterFactoriesList& filter_factories, const char* filter_chain_type,
                              bool last_filter_in_current_config);
+  // Creates the latency stats of the filter with the given name, if filter latency is recorded.
+  void addFilterLatencyRecorder(const std::string& name);
   void createFilterChainForFactories(Http::FilterChainFactoryCallbacks& callbacks,
                                      const FilterFactoriesList& filter_factories);
 
@@ -243,6 +251,7 @@ private:
   std::chrono::milliseconds stream_idle_timeout_;
   std::chrono::milliseconds request_timeout_;
   std::chrono::milliseconds request_headers_timeout_;
+  std::chrono::milliseconds stream_timer_granularity_;
   Router::RouteConfigProviderSharedPtr route_config_provider_;
   Config::ConfigProviderPtr scoped_routes_config_provider_;
   std::chrono::milliseconds drain_timeout_;
@@ -260,6 +269,11 @@ private:
   const envoy::config::core::v3::HttpProtocolOptions::HeadersWithUnderscoresAction
       headers_with_underscores_action_;
   const LocalReply::LocalReplyPtr local_reply_;
+  const bool filter_latency_enabled_;
+  const UnitFloat filter_latency_sample_rate_;
+  const bool record_filter_cpu_time_;
+  // The latency recorders of the filters, by name, which filters of the same name share.
+  absl::flat_hash_map<std::string, Http::FilterLatencyRecorderPtr> filter_latency_recorders_;
 
   // Default idle timeout is 5 minutes if nothing is specified in the HCM config.
   static const uint64_t StreamIdleTimeoutMs = 5 * 60 * 1000;
@@ -0,0 +1,55 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+    std::unique_ptr<CgroupMemoryStatsReader> stats)
+    : max_memory_(config.max_memory_bytes()),
+      exclude_inactive_file_(config.exclude_inactive_file()),
+      stall_percentage_saturation_(config.stall_percentage_saturation()),
+      stats_(std::move(stats)) {}
+
+double CgroupMemoryMonitor::computePressure() {
+  // The limit is re-read on every update since it may be changed while Envoy is running.
+  const uint64_t limit = stats_->memoryMax().value_or(max_memory_);
+  if (limit == 0) {
+    throw EnvoyException("cgroup has no memory limit and max_memory_bytes is not configured");
+  }
+
+  uint64_t used = stats_->memoryCurrent();
+  if (exclude_inactive_file_) {
+    used -= std::min(used, stats_->inactiveFile());
+  }
+  double pressure = used / static_cast<double>(limit);
+
+  if (stall_percentage_saturation_ > 0) {
+    pressure = std::max(pressure, stats_->someStallAvg10() / stall_percentage_saturation_);
+  }
+  return pressure;
+}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  TRY_ASSERT_MAIN_THREAD { usage.resource_pressure_ = computePressure(); }
+  END_TRY
+  catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+    return;
+  }
+  callbacks.onSuccess(usage);
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
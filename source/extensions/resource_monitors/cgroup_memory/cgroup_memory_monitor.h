@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_stats_reader.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Memory monitor for the cgroup v2 Envoy runs in. The resource pressure is the memory charged to
+ * the cgroup divided by its limit, optionally raised to the scaled memory stall percentage.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+      std::unique_ptr<CgroupMemoryStatsReader> stats);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  double computePressure();
+
+  const uint64_t max_memory_;
+  const bool exclude_inactive_file_;
+  const double stall_percentage_saturation_;
+  std::unique_ptr<CgroupMemoryStatsReader> stats_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,75 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_stats_reader.h"
+
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+CgroupMemoryStatsReader::CgroupMemoryStatsReader(Filesystem::Instance& file_system,
+                                                 absl::string_view cgroup_root)
+    : file_system_(file_system), memory_current_path_(absl::StrCat(cgroup_root, "/memory.current")),
+      memory_max_path_(absl::StrCat(cgroup_root, "/memory.max")),
+      memory_stat_path_(absl::StrCat(cgroup_root, "/memory.stat")),
+      memory_pressure_path_(absl::StrCat(cgroup_root, "/memory.pressure")) {}
+
+uint64_t CgroupMemoryStatsReader::readCounter(const std::string& path) {
+  const std::string contents = file_system_.fileReadToEnd(path);
+  uint64_t value;
+  if (!absl::SimpleAtoi(absl::StripAsciiWhitespace(contents), &value)) {
+    throw EnvoyException(absl::StrCat("failed to parse '", contents, "' in ", path));
+  }
+  return value;
+}
+
+uint64_t CgroupMemoryStatsReader::memoryCurrent() { return readCounter(memory_current_path_); }
+
+absl::optional<uint64_t> CgroupMemoryStatsReader::memoryMax() {
+  if (absl::StripAsciiWhitespace(file_system_.fileReadToEnd(memory_max_path_)) == "max") {
+    return absl::nullopt;
+  }
+  return readCounter(memory_max_path_);
+}
+
+uint64_t CgroupMemoryStatsReader::inactiveFile() {
+  const std::string memory_stat = file_system_.fileReadToEnd(memory_stat_path_);
+  for (absl::string_view line : absl::StrSplit(memory_stat, '\n', absl::SkipEmpty())) {
+    const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ', absl::SkipEmpty());
+    uint64_t value;
+    if (fields.size() == 2 && fields[0] == "inactive_file" && absl::SimpleAtoi(fields[1], &value)) {
+      return value;
+    }
+  }
+  throw EnvoyException(absl::StrCat("no inactive_file in ", memory_stat_path_));
+}
+
+double CgroupMemoryStatsReader::someStallAvg10() {
+  // memory.pressure contains lines like "some avg10=0.12 avg60=0.03 avg300=0.00 total=1234".
+  const std::string memory_pressure = file_system_.fileReadToEnd(memory_pressure_path_);
+  for (absl::string_view line : absl::StrSplit(memory_pressure, '\n', absl::SkipEmpty())) {
+    const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ', absl::SkipEmpty());
+    if (fields.size() < 2 || fields[0] != "some") {
+      continue;
+    }
+    absl::string_view avg10 = fields[1];
+    double value;
+    if (absl::ConsumePrefix(&avg10, "avg10=") && absl::SimpleAtod(avg10, &value)) {
+      return value;
+    }
+  }
+  throw EnvoyException(absl::StrCat("no 'some avg10' in ", memory_pressure_path_));
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/filesystem/filesystem.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Helper class for reading the memory interface files of a cgroup v2. All methods throw
+ * EnvoyException if the underlying file cannot be read or parsed.
+ */
+class CgroupMemoryStatsReader {
+public:
+  static constexpr absl::string_view DefaultCgroupRoot = "/sys/fs/cgroup";
+
+  CgroupMemoryStatsReader(Filesystem::Instance& file_system,
+                          absl::string_view cgroup_root = DefaultCgroupRoot);
+  virtual ~CgroupMemoryStatsReader() = default;
+
+  // Total memory charged to the cgroup, from memory.current.
+  virtual uint64_t memoryCurrent();
+  // The cgroup's hard limit from memory.max, or nullopt if the cgroup is unlimited.
+  virtual absl::optional<uint64_t> memoryMax();
+  // Reclaimable page cache on the inactive LRU list, from the inactive_file entry of memory.stat.
+  virtual uint64_t inactiveFile();
+  // Percentage of the last 10 seconds in which at least one task in the cgroup was stalled on
+  // memory, from the "some" line of memory.pressure.
+  virtual double someStallAvg10();
+
+private:
+  uint64_t readCounter(const std::string& path);
+
+  Filesystem::Instance& file_system_;
+  const std::string memory_current_path_;
+  const std::string memory_max_path_;
+  const std::string memory_stat_path_;
+  const std::string memory_pressure_path_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
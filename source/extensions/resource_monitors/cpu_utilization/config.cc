@@ -0,0 +1,47 @@
+#include "extensions/resource_monitors/cpu_utilization/config.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "envoy/extensions/resource_monitors/cpu_utilization/v3/cpu_utilization.pb.h"
+#include "envoy/extensions/resource_monitors/cpu_utilization/v3/cpu_utilization.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/resource_monitors/cpu_utilization/cpu_stats_reader.h"
+#include "extensions/resource_monitors/cpu_utilization/cpu_utilization_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+Server::ResourceMonitorPtr CpuUtilizationMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  CpuStatsReaderPtr stats;
+  switch (config.source()) {
+  case envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig::CGROUP:
+    stats = std::make_unique<CgroupCpuStatsReader>(
+        context.api().fileSystem(), context.api().timeSource(),
+        std::max(1U, std::thread::hardware_concurrency()),
+        config.cgroup_root().empty() ? CgroupCpuStatsReader::DefaultCgroupRoot
+                                     : config.cgroup_root());
+    break;
+  default:
+    stats = std::make_unique<ProcessCpuStatsReader>(context.api().fileSystem());
+    break;
+  }
+  return std::make_unique<CpuUtilizationMonitor>(std::move(stats));
+}
+
+/**
+ * Static registration for the CPU utilization resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(CpuUtilizationMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
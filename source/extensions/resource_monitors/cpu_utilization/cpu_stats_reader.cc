@@ -0,0 +1,128 @@
+#include "extensions/resource_monitors/cpu_utilization/cpu_stats_reader.h"
+
+#include <chrono>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+namespace {
+
+// Index of the utime field in /proc/<pid>/stat, counted from the state field that follows the
+// parenthesized command name. See proc(5); utime is field 14 and state is field 3.
+constexpr size_t ProcStatUtimeIndex = 14 - 3;
+constexpr size_t ProcStatStimeIndex = 15 - 3;
+// The user, nice, system, idle, iowait, irq, softirq and steal columns of the aggregate "cpu" line
+// of /proc/stat. The guest columns are already accounted for in user and nice.
+constexpr size_t HostStatTimeFields = 8;
+
+uint64_t parseCounter(absl::string_view value, absl::string_view path) {
+  uint64_t result;
+  if (!absl::SimpleAtoi(value, &result)) {
+    throw EnvoyException(absl::StrCat("failed to parse '", value, "' in ", path));
+  }
+  return result;
+}
+
+} // namespace
+
+ProcessCpuStatsReader::ProcessCpuStatsReader(Filesystem::Instance& file_system,
+                                             const std::string& process_stat_path,
+                                             const std::string& host_stat_path)
+    : file_system_(file_system), process_stat_path_(process_stat_path),
+      host_stat_path_(host_stat_path) {}
+
+CpuTimes ProcessCpuStatsReader::getCpuTimes() {
+  // The command name may contain spaces and parentheses, so only split after the last ')'.
+  const std::string process_stat = file_system_.fileReadToEnd(process_stat_path_);
+  const size_t comm_end = process_stat.rfind(')');
+  if (comm_end == std::string::npos) {
+    throw EnvoyException(absl::StrCat("unexpected format of ", process_stat_path_));
+  }
+  const std::vector<absl::string_view> process_fields =
+      absl::StrSplit(absl::string_view(process_stat).substr(comm_end + 1), ' ', absl::SkipEmpty());
+  if (process_fields.size() <= ProcStatStimeIndex) {
+    throw EnvoyException(absl::StrCat("unexpected format of ", process_stat_path_));
+  }
+  const uint64_t work_time = parseCounter(process_fields[ProcStatUtimeIndex], process_stat_path_) +
+                             parseCounter(process_fields[ProcStatStimeIndex], process_stat_path_);
+
+  const std::string host_stat = file_system_.fileReadToEnd(host_stat_path_);
+  const absl::string_view cpu_line = absl::string_view(host_stat).substr(0, host_stat.find('\n'));
+  const std::vector<absl::string_view> host_fields =
+      absl::StrSplit(cpu_line, ' ', absl::SkipEmpty());
+  if (host_fields.size() <= HostStatTimeFields || host_fields[0] != "cpu") {
+    throw EnvoyException(absl::StrCat("unexpected format of ", host_stat_path_));
+  }
+  uint64_t total_time = 0;
+  for (size_t i = 1; i <= HostStatTimeFields; ++i) {
+    total_time += parseCounter(host_fields[i], host_stat_path_);
+  }
+
+  return {static_cast<double>(work_time), static_cast<double>(total_time)};
+}
+
+CgroupCpuStatsReader::CgroupCpuStatsReader(Filesystem::Instance& file_system,
+                                           TimeSource& time_source, uint32_t host_cpus,
+                                           absl::string_view cgroup_root)
+    : file_system_(file_system), time_source_(time_source), host_cpus_(host_cpus),
+      cpu_stat_path_(absl::StrCat(cgroup_root, "/cpu.stat")),
+      cpu_max_path_(absl::StrCat(cgroup_root, "/cpu.max")),
+      last_sample_time_(time_source.monotonicTime()) {}
+
+double CgroupCpuStatsReader::allowedCpus() {
+  // cpu.max contains "<quota> <period>" where quota is either a number of microseconds or "max".
+  const std::string cpu_max = file_system_.fileReadToEnd(cpu_max_path_);
+  const std::vector<absl::string_view> fields =
+      absl::StrSplit(absl::StripAsciiWhitespace(cpu_max), ' ', absl::SkipEmpty());
+  if (fields.size() != 2) {
+    throw EnvoyException(absl::StrCat("unexpected format of ", cpu_max_path_));
+  }
+  if (fields[0] == "max") {
+    return host_cpus_;
+  }
+  const uint64_t quota = parseCounter(fields[0], cpu_max_path_);
+  const uint64_t period = parseCounter(fields[1], cpu_max_path_);
+  if (period == 0) {
+    throw EnvoyException(absl::StrCat("invalid period in ", cpu_max_path_));
+  }
+  return static_cast<double>(quota) / period;
+}
+
+CpuTimes CgroupCpuStatsReader::getCpuTimes() {
+  const std::string cpu_stat = file_system_.fileReadToEnd(cpu_stat_path_);
+  absl::optional<uint64_t> usage_usec;
+  for (absl::string_view line : absl::StrSplit(cpu_stat, '\n', absl::SkipEmpty())) {
+    const std::vector<absl::string_view> fields = absl::StrSplit(line, ' ', absl::SkipEmpty());
+    if (fields.size() == 2 && fields[0] == "usage_usec") {
+      usage_usec = parseCounter(fields[1], cpu_stat_path_);
+      break;
+    }
+  }
+  if (!usage_usec.has_value()) {
+    throw EnvoyException(absl::StrCat("no usage_usec in ", cpu_stat_path_));
+  }
+
+  const double cpus = allowedCpus();
+  const MonotonicTime now = time_source_.monotonicTime();
+  total_time_ +=
+      cpus * std::chrono::duration_cast<std::chrono::microseconds>(now - last_sample_time_).count();
+  last_sample_time_ = now;
+
+  return {static_cast<double>(*usage_usec), total_time_};
+}
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
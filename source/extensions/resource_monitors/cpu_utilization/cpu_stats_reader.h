@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+#include "envoy/filesystem/filesystem.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+/**
+ * Cumulative CPU time counters. Both values use the same reader specific unit, so the utilization
+ * between two samples is (work_time_ delta) / (total_time_ delta).
+ */
+struct CpuTimes {
+  // CPU time consumed by the monitored entity.
+  double work_time_;
+  // CPU time available to the monitored entity.
+  double total_time_;
+};
+
+/**
+ * Helper class for reading cumulative CPU times.
+ */
+class CpuStatsReader {
+public:
+  virtual ~CpuStatsReader() = default;
+
+  /**
+   * @return CpuTimes the current cumulative CPU times.
+   * @throw EnvoyException if the underlying counters cannot be read or parsed.
+   */
+  virtual CpuTimes getCpuTimes() PURE;
+};
+
+using CpuStatsReaderPtr = std::unique_ptr<CpuStatsReader>;
+
+/**
+ * Reads the Envoy process CPU time (utime + stime) from /proc/self/stat and the CPU time of all
+ * host CPUs from the aggregate "cpu" line of /proc/stat. Both are in clock ticks.
+ */
+class ProcessCpuStatsReader : public CpuStatsReader {
+public:
+  ProcessCpuStatsReader(Filesystem::Instance& file_system,
+                        const std::string& process_stat_path = "/proc/self/stat",
+                        const std::string& host_stat_path = "/proc/stat");
+
+  // CpuStatsReader
+  CpuTimes getCpuTimes() override;
+
+private:
+  Filesystem::Instance& file_system_;
+  const std::string process_stat_path_;
+  const std::string host_stat_path_;
+};
+
+/**
+ * Reads the CPU time used by a cgroup v2 from the usage_usec entry of <cgroup_root>/cpu.stat. The
+ * available CPU time is the monotonic time elapsed since the reader was created multiplied by the
+ * number of CPUs granted by <cgroup_root>/cpu.max, or by host_cpus if the cgroup has no quota.
+ * Both are in microseconds.
+ */
+class CgroupCpuStatsReader : public CpuStatsReader {
+public:
+  static constexpr absl::string_view DefaultCgroupRoot = "/sys/fs/cgroup";
+
+  CgroupCpuStatsReader(Filesystem::Instance& file_system, TimeSource& time_source,
+                       uint32_t host_cpus, absl::string_view cgroup_root = DefaultCgroupRoot);
+
+  // CpuStatsReader
+  CpuTimes getCpuTimes() override;
+
+private:
+  double allowedCpus();
+
+  Filesystem::Instance& file_system_;
+  TimeSource& time_source_;
+  const uint32_t host_cpus_;
+  const std::string cpu_stat_path_;
+  const std::string cpu_max_path_;
+  // Available CPU time accumulated up to last_sample_time_. This is integrated sample by sample so
+  // that a change of the cgroup quota only applies to time elapsed after the change.
+  double total_time_{};
+  MonotonicTime last_sample_time_;
+};
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#include "extensions/resource_monitors/cpu_utilization/cpu_utilization_monitor.h"
+
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+CpuUtilizationMonitor::CpuUtilizationMonitor(CpuStatsReaderPtr stats) : stats_(std::move(stats)) {
+  // Take the initial sample now so that the first update already reports a utilization. If this
+  // fails the error is reported by the first update instead.
+  TRY_ASSERT_MAIN_THREAD { previous_times_ = stats_->getCpuTimes(); }
+  END_TRY
+  catch (const EnvoyException&) {
+  }
+}
+
+void CpuUtilizationMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  CpuTimes times{};
+  TRY_ASSERT_MAIN_THREAD { times = stats_->getCpuTimes(); }
+  END_TRY
+  catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+    return;
+  }
+
+  if (previous_times_.has_value()) {
+    const double work_delta = times.work_time_ - previous_times_->work_time_;
+    const double total_delta = times.total_time_ - previous_times_->total_time_;
+    // Counters that did not advance (or went backwards, e.g. after a cgroup change) carry no
+    // information; keep reporting the last known utilization.
+    if (total_delta > 0 && work_delta >= 0) {
+      utilization_ = work_delta / total_delta;
+    }
+  }
+  previous_times_ = times;
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = utilization_;
+  callbacks.onSuccess(usage);
+}
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "envoy/server/resource_monitor.h"
+
+#include "extensions/resource_monitors/cpu_utilization/cpu_stats_reader.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+/**
+ * CPU utilization monitor. The resource pressure is the fraction of the available CPU time that
+ * was consumed between two consecutive updates.
+ */
+class CpuUtilizationMonitor : public Server::ResourceMonitor {
+public:
+  CpuUtilizationMonitor(CpuStatsReaderPtr stats);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  CpuStatsReaderPtr stats_;
+  absl::optional<CpuTimes> previous_times_;
+  double utilization_{};
+};
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
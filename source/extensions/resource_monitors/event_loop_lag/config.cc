@@ -0,0 +1,30 @@
+#include "extensions/resource_monitors/event_loop_lag/config.h"
+
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+Server::ResourceMonitorPtr EventLoopLagMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<EventLoopLagMonitor>(config, context);
+}
+
+/**
+ * Static registration for the event loop lag resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(EventLoopLagMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
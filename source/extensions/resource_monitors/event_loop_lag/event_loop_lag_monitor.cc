@@ -0,0 +1,76 @@
+#include "extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+EventLoopLagMonitor::EventLoopLagMonitor(
+    const envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context)
+    : max_lag_(std::chrono::milliseconds(DurationUtil::durationToMilliseconds(config.max_lag()))),
+      time_source_(context.api().timeSource()), tls_(context.threadLocal()) {}
+
+void EventLoopLagMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  // Workers register for thread local storage after the overload manager creates its monitors,
+  // so the slot can only be populated once updates start.
+  if (!tls_initialized_) {
+    tls_.set([](Event::Dispatcher& dispatcher) {
+      return std::make_shared<ThreadLocalProbe>(dispatcher.timeSource());
+    });
+    tls_initialized_ = true;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  // A probe that hasn't run yet has already waited this long, and the overload manager doesn't
+  // request another update until this one is reported, so a stuck worker must be reported while
+  // its probe is still queued rather than once it finally runs.
+  if (!round_pending_) {
+    startRound(now);
+  }
+  const std::chrono::microseconds outstanding_lag =
+      round_pending_ ? std::chrono::duration_cast<std::chrono::microseconds>(now - round_posted_)
+                     : std::chrono::microseconds(0);
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ =
+      static_cast<double>(std::max(last_lag_, outstanding_lag).count()) / max_lag_.count();
+  callbacks.onSuccess(usage);
+}
+
+void EventLoopLagMonitor::startRound(MonotonicTime posted) {
+  round_pending_ = true;
+  round_posted_ = posted;
+  auto max_lag = std::make_shared<MaxLag>(0);
+  tls_.runOnAllThreads(
+      [max_lag, posted](OptRef<ThreadLocalProbe> probe) {
+        if (!probe.has_value()) {
+          return;
+        }
+        const auto lag = std::chrono::duration_cast<std::chrono::microseconds>(
+                             probe->time_source_.monotonicTime() - posted)
+                             .count();
+        auto current = max_lag->load();
+        while (lag > current && !max_lag->compare_exchange_weak(current, lag)) {
+        }
+      },
+      [this, max_lag, guard = std::weak_ptr<bool>(alive_guard_)]() {
+        if (guard.expired()) {
+          return;
+        }
+        // The completion callback runs on the main thread, like updateResourceUsage().
+        last_lag_ = std::chrono::microseconds(max_lag->load());
+        round_pending_ = false;
+      });
+}
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/server/resource_monitor_config.h"
+#include "envoy/thread_local/thread_local.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+
+/**
+ * A monitor for the responsiveness of the worker event loops. Every update posts a probe to all
+ * threads registered for thread local storage and records how long each probe waited in its
+ * dispatcher's queue. The resource pressure is the largest delay divided by the configured
+ * maximum lag. Updates are reported immediately: with the delay of the last round of probes that
+ * all ran, or while a round is still running, with the time since it was posted if that is longer.
+ * A new round is only posted once the previous one has completed.
+ */
+class EventLoopLagMonitor : public Server::ResourceMonitor {
+public:
+  EventLoopLagMonitor(
+      const envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  // Per-thread state used to time probes with the time source of the thread's dispatcher.
+  struct ThreadLocalProbe : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalProbe(TimeSource& time_source) : time_source_(time_source) {}
+
+    TimeSource& time_source_;
+  };
+
+  // The maximum lag observed by the probes of a single update.
+  using MaxLag = std::atomic<std::chrono::microseconds::rep>;
+
+  void startRound(MonotonicTime posted);
+
+  const std::chrono::microseconds max_lag_;
+  TimeSource& time_source_;
+  ThreadLocal::TypedSlot<ThreadLocalProbe> tls_;
+  bool tls_initialized_{false};
+  // Whether some probes of the round posted at round_posted_ haven't run yet.
+  bool round_pending_{false};
+  MonotonicTime round_posted_;
+  // The largest delay of the last round whose probes all ran.
+  std::chrono::microseconds last_lag_{0};
+  // Guards against completion callbacks running after the monitor has been destroyed.
+  std::shared_ptr<bool> alive_guard_{std::make_shared<bool>(true)};
+};
+
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
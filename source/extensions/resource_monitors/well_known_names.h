@@ -18,6 +18,15 @@ public:
 
   // File-based injected resource monitor.
   const std::string InjectedResource = "envoy.resource_monitors.injected_resource";
+
+  // Process or cgroup CPU utilization monitor.
+  const std::string CpuUtilization = "envoy.resource_monitors.cpu_utilization";
+
+  // Worker event loop lag monitor.
+  const std::string EventLoopLag = "envoy.resource_monitors.event_loop_lag";
+
+  // Cgroup v2 memory usage and pressure stall monitor.
+  const std::string CgroupMemory = "envoy.resource_monitors.cgroup_memory";
 };
 
 using ResourceMonitorNames = ConstSingleton<ResourceMonitorNameValues>;
@@ -32,7 +32,9 @@ void HttpConnPool::newStream(GenericConnectionPoolCallbacks* callbacks) {
   // might get deleted inline as well. Only write the returned handle out if it is not nullptr to
   // deal with this case.
   Envoy::Http::ConnectionPool::Cancellable* handle =
-      conn_pool_->newStream(callbacks->upstreamToDownstream(), *this);
+      can_send_early_data_
+          ? conn_pool_->newEarlyDataStream(callbacks->upstreamToDownstream(), *this)
+          : conn_pool_->newStream(callbacks->upstreamToDownstream(), *this);
   if (handle) {
     conn_pool_stream_handle_ = handle;
   }
@@ -10,6 +10,7 @@
 #include "common/common/assert.h"
 #include "common/common/logger.h"
 #include "common/config/well_known_names.h"
+#include "common/http/utility.h"
 #include "common/router/upstream_request.h"
 
 namespace Envoy {
@@ -28,6 +29,10 @@ public:
     ASSERT(!is_connect);
     conn_pool_ =
         thread_local_cluster.httpConnPool(route_entry.priority(), downstream_protocol, ctx);
+    const Envoy::Http::RequestHeaderMap* headers =
+        ctx != nullptr ? ctx->downstreamHeaders() : nullptr;
+    can_send_early_data_ =
+        headers != nullptr && Envoy::Http::Utility::isIdempotentRequest(*headers);
   }
   ~HttpConnPool() override {
     ASSERT(conn_pool_stream_handle_ == nullptr, "conn_pool_stream_handle not null");
@@ -51,6 +56,8 @@ protected:
   Envoy::Http::ConnectionPool::Instance* conn_pool_{};
   Envoy::Http::ConnectionPool::Cancellable* conn_pool_stream_handle_{};
   Router::GenericConnectionPoolCallbacks* callbacks_{};
+  // True if the request is safe to replay, so may be sent as early data.
+  bool can_send_early_data_{};
 };
 
 class HttpUpstream : public Router::GenericUpstream, public Envoy::Http::StreamCallbacks {
@@ -58,6 +65,11 @@ public:
   HttpUpstream(Router::UpstreamToDownstream& upstream_request, Envoy::Http::RequestEncoder* encoder)
       : upstream_request_(upstream_request), request_encoder_(encoder) {
     request_encoder_->getStream().addCallbacks(*this);
+    // Charge the upstream stream's buffers to the downstream request it proxies.
+    Buffer::BufferMemoryAccountSharedPtr account = upstream_request_.account();
+    if (account != nullptr) {
+      request_encoder_->getStream().setAccount(std::move(account));
+    }
   }
 
   // GenericUpstream
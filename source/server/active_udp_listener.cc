@@ -59,6 +59,7 @@ void ActiveUdpListenerBase::onData(Network::UdpRecvData&& data) {
   if (dest == worker_index_) {
     onDataWorker(std::move(data));
   } else {
+    udp_stats_.downstream_rx_datagram_misrouted_.inc();
     config_->udpListenerConfig()->listenerWorkerRouter().deliver(dest, std::move(data));
   }
 }
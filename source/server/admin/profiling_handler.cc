@@ -1,12 +1,36 @@
 #include "server/admin/profiling_handler.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 
 #include "server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
 
+namespace {
+
+constexpr uint64_t DefaultCollapsedProfileSeconds = 10;
+constexpr uint64_t MaxCollapsedProfileSeconds = 60;
+constexpr uint64_t DefaultCollapsedProfileHz = 99;
+constexpr uint64_t MaxCollapsedProfileHz = 1000;
+
+// Parses the query parameter `name` as an integer in [1, max], defaulting to default_value.
+bool boundedParam(const Http::Utility::QueryParams& params, const std::string& name,
+                  uint64_t default_value, uint64_t max, uint64_t& value) {
+  const absl::optional<std::string> param = Utility::queryParam(params, name);
+  if (!param.has_value()) {
+    value = default_value;
+    return true;
+  }
+  return absl::SimpleAtoi(param.value(), &value) && value >= 1 && value <= max;
+}
+
+} // namespace
+
 ProfilingHandler::ProfilingHandler(const std::string& profile_path) : profile_path_(profile_path) {}
 
 Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::ResponseHeaderMap&,
@@ -19,6 +43,10 @@ Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::Res
   }
 
   bool enable = query_params.begin()->second == "y";
+  if (enable && Profiler::SamplingProfiler::running()) {
+    response.add("A /cpuprofiler/collapsed profile is being taken\n");
+    return Http::Code::BadRequest;
+  }
   if (enable && !Profiler::Cpu::profilerEnabled()) {
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
@@ -80,5 +108,62 @@ Http::Code ProfilingHandler::handlerHeapProfiler(absl::string_view url, Http::Re
   return res;
 }
 
+Http::Code ProfilingHandler::handlerCpuProfilerCollapsed(absl::string_view url,
+                                                         Http::ResponseHeaderMap&,
+                                                         Buffer::Instance& response,
+                                                         AdminStream& admin_stream) {
+  const Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  uint64_t seconds;
+  uint64_t hz;
+  if (!boundedParam(query_params, "seconds", DefaultCollapsedProfileSeconds,
+                    MaxCollapsedProfileSeconds, seconds) ||
+      !boundedParam(query_params, "hz", DefaultCollapsedProfileHz, MaxCollapsedProfileHz, hz)) {
+    response.add(fmt::format("?seconds=<1-{}>&hz=<1-{}>\n", MaxCollapsedProfileSeconds,
+                             MaxCollapsedProfileHz));
+    return Http::Code::BadRequest;
+  }
+
+  // Both profilers sample with SIGPROF.
+  if (Profiler::Cpu::profilerEnabled()) {
+    response.add("The CPU profiler is running\n");
+    return Http::Code::BadRequest;
+  }
+  if (!Profiler::SamplingProfiler::start(std::chrono::microseconds(1000000 / hz),
+                                         std::chrono::seconds(seconds))) {
+    if (Profiler::SamplingProfiler::running()) {
+      response.add("A profile is already being taken\n");
+      return Http::Code::BadRequest;
+    }
+    response.add("Failure to start the sampling profiler\n");
+    return Http::Code::InternalServerError;
+  }
+
+  admin_stream.setEndStreamOnComplete(false);
+  // Abandons the profile if the request goes away before it completes.
+  admin_stream.addOnDestroyCallback([this, &admin_stream] {
+    if (collapsed_profile_stream_ == &admin_stream) {
+      stopCollapsedProfile();
+    }
+  });
+  collapsed_profile_stream_ = &admin_stream;
+  collapsed_profile_timer_ =
+      admin_stream.getDecoderFilterCallbacks().dispatcher().createTimer([this] {
+        // The timer isn't reset here as it is running, but is replaced by the next profile.
+        AdminStream& stream = *collapsed_profile_stream_;
+        collapsed_profile_stream_ = nullptr;
+        // Dropped samples are counted in the output.
+        Buffer::OwnedImpl output(Profiler::SamplingProfiler::stop().collapsed());
+        stream.getDecoderFilterCallbacks().encodeData(output, true);
+      });
+  collapsed_profile_timer_->enableTimer(std::chrono::seconds(seconds));
+  return Http::Code::OK;
+}
+
+void ProfilingHandler::stopCollapsedProfile() {
+  collapsed_profile_stream_ = nullptr;
+  collapsed_profile_timer_.reset();
+  Profiler::SamplingProfiler::stop();
+}
+
 } // namespace Server
 } // namespace Envoy
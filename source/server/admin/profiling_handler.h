@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/event/timer.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
 #include "envoy/server/admin.h"
@@ -23,8 +24,22 @@ public:
                                  Http::ResponseHeaderMap& response_headers,
                                  Buffer::Instance& response, AdminStream&);
 
+  /**
+   * Runs the sampling CPU profiler for ?seconds=<n> (10 by default) at ?hz=<n> samples per second
+   * (99 by default), then responds with the sampled stacks in the collapsed format. The response
+   * is streamed when the profile completes, so the main thread isn't blocked meanwhile.
+   */
+  Http::Code handlerCpuProfilerCollapsed(absl::string_view path_and_query,
+                                         Http::ResponseHeaderMap& response_headers,
+                                         Buffer::Instance& response, AdminStream& admin_stream);
+
 private:
+  void stopCollapsedProfile();
+
   const std::string profile_path_;
+  // The request a sampling profile is being taken for, if any, and the timer ending it.
+  AdminStream* collapsed_profile_stream_{};
+  Event::TimerPtr collapsed_profile_timer_;
 };
 
 } // namespace Server
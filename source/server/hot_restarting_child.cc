@@ -1,6 +1,15 @@
 #include "server/hot_restarting_child.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/api/os_sys_calls_impl_hot_restart.h"
+#include "common/common/fmt.h"
 #include "common/common/utility.h"
+#include "common/stats/stat_snapshot.h"
 
 namespace Envoy {
 namespace Server {
@@ -9,7 +18,8 @@ using HotRestartMessage = envoy::HotRestartMessage;
 
 HotRestartingChild::HotRestartingChild(int base_id, int restart_epoch,
                                        const std::string& socket_path, mode_t socket_mode)
-    : HotRestartingBase(base_id), restart_epoch_(restart_epoch) {
+    : HotRestartingBase(base_id), restart_epoch_(restart_epoch),
+      stats_snapshot_name_(fmt::format("/envoy_hot_restart_stats_{}_{}", base_id, restart_epoch)) {
   initDomainSocketAddress(&parent_address_);
   if (restart_epoch_ != 0) {
     parent_address_ =
@@ -40,7 +50,12 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  if (use_stats_snapshot_) {
+    wrapped_request.mutable_request()->mutable_stats()->set_shared_memory_name(
+        stats_snapshot_name_);
+  } else {
+    wrapped_request.mutable_request()->mutable_stats();
+  }
   sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
@@ -103,6 +118,18 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
     hot_restart_generation_stat_name_ = hotRestartGeneration(stats_store).statName();
   }
 
+  if (stats_proto.shared_memory_size() > 0) {
+    if (!mergeParentStatsSnapshot(stats_proto.shared_memory_size())) {
+      // The parent has already latched the counters in the snapshot, so their deltas are lost, but
+      // later transfers can still use the protobuf maps.
+      ENVOY_LOG(warn, "skipping the hot restart stats snapshot {}; requesting the stats without "
+                      "shared memory from now on",
+                stats_snapshot_name_);
+      use_stats_snapshot_ = false;
+    }
+    return;
+  }
+
   // Convert the protobuf for serialized dynamic spans into the structure
   // required by StatMerger.
   Stats::StatMerger::DynamicsMap dynamics;
@@ -116,5 +143,51 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+bool HotRestartingChild::mergeParentStatsSnapshot(uint64_t size) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+  const Api::SysCallIntResult open_result =
+      hot_restart_os_sys_calls.shmOpen(stats_snapshot_name_.c_str(), O_RDONLY, 0);
+  if (open_result.rc_ == -1) {
+    ENVOY_LOG(warn, "cannot open the hot restart stats snapshot {}: {}", stats_snapshot_name_,
+              errorDetails(open_result.errno_));
+    return false;
+  }
+  // The snapshot is only needed for this merge; the parent writes a new one for the next.
+  hot_restart_os_sys_calls.shmUnlink(stats_snapshot_name_.c_str());
+
+  // Mapping more than the size of the object would raise SIGBUS when reading past its end.
+  struct stat stat_result;
+  const Api::SysCallIntResult fstat_result = os_sys_calls.fstat(open_result.rc_, &stat_result);
+  if (fstat_result.rc_ == -1 || static_cast<uint64_t>(stat_result.st_size) < size) {
+    ENVOY_LOG(warn, "hot restart stats snapshot {} is smaller than the {} bytes announced",
+              stats_snapshot_name_, size);
+    os_sys_calls.close(open_result.rc_);
+    return false;
+  }
+  const Api::SysCallPtrResult mmap_result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_SHARED, open_result.rc_, 0);
+  os_sys_calls.close(open_result.rc_);
+  if (mmap_result.rc_ == MAP_FAILED) {
+    ENVOY_LOG(warn, "cannot map the hot restart stats snapshot {}: {}", stats_snapshot_name_,
+              errorDetails(mmap_result.errno_));
+    return false;
+  }
+
+  // Copy the snapshot before validating it, so that what is merged is what was validated even if
+  // the shared memory changes in the meantime.
+  const auto* mapped = static_cast<const uint8_t*>(mmap_result.rc_);
+  const std::vector<uint8_t> data(mapped, mapped + size);
+  os_sys_calls.munmap(mmap_result.rc_, size);
+
+  Stats::StatSnapshotReader snapshot;
+  if (!snapshot.parse(data.data(), data.size())) {
+    ENVOY_LOG(warn, "hot restart parent sent a malformed stats snapshot");
+    return false;
+  }
+  stat_merger_->mergeStats(snapshot);
+  return true;
+}
+
 } // namespace Server
 } // namespace Envoy
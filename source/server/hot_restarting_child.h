@@ -24,7 +24,15 @@ public:
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
 
 private:
+  // Merges the snapshot of stats_snapshot_name_ that the parent wrote in reply to getParentStats().
+  // Returns false, without merging anything, if the snapshot can't be read or is malformed.
+  bool mergeParentStatsSnapshot(uint64_t size);
+
   const int restart_epoch_;
+  // The shared memory object the parent writes the stats snapshot into.
+  const std::string stats_snapshot_name_;
+  // Cleared once a snapshot could not be merged, after which the stats are requested in the maps.
+  bool use_stats_snapshot_{true};
   bool parent_terminated_{};
   sockaddr_un parent_address_;
   std::unique_ptr<Stats::StatMerger> stat_merger_{};
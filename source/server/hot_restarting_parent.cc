@@ -1,10 +1,16 @@
 #include "server/hot_restarting_parent.h"
 
+#include <sys/mman.h>
+
 #include "envoy/server/instance.h"
 
+#include "common/api/os_sys_calls_impl.h"
+#include "common/api/os_sys_calls_impl_hot_restart.h"
+#include "common/common/utility.h"
 #include "common/memory/stats.h"
 #include "common/network/utility.h"
 #include "common/stats/stat_merger.h"
+#include "common/stats/stat_snapshot.h"
 #include "common/stats/symbol_table_impl.h"
 #include "common/stats/utility.h"
 
@@ -15,6 +21,63 @@ namespace Server {
 
 using HotRestartMessage = envoy::HotRestartMessage;
 
+namespace {
+
+void addDynamicSpans(HotRestartMessage::Reply::Stats* stats, const std::string& name,
+                     const Stats::DynamicSpans& spans) {
+  if (!spans.empty()) {
+    HotRestartMessage::Reply::RepeatedSpan spans_proto;
+    for (const Stats::DynamicSpan& span : spans) {
+      HotRestartMessage::Reply::Span* span_proto = spans_proto.add_spans();
+      span_proto->set_first(span.first);
+      span_proto->set_last(span.second);
+    }
+    (*stats->mutable_dynamics())[name] = spans_proto;
+  }
+}
+
+// Writes the snapshot into a new shared memory object, returning false if that fails.
+bool writeStatsSnapshot(const std::string& shared_memory_name,
+                        const Stats::StatSnapshotWriter& writer) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+  // The name is predictable, so rather than reusing an object that is already there, e.g. left
+  // behind by a child that crashed before merging it, remove it and create a new one.
+  hot_restart_os_sys_calls.shmUnlink(shared_memory_name.c_str());
+  const Api::SysCallIntResult open_result = hot_restart_os_sys_calls.shmOpen(
+      shared_memory_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (open_result.rc_ == -1) {
+    ENVOY_LOG_MISC(warn, "cannot open shared memory {} for the hot restart stats snapshot: {}",
+                   shared_memory_name, errorDetails(open_result.errno_));
+    return false;
+  }
+
+  // Allocate the whole object up front, so that running out of shared memory fails here rather
+  // than raising SIGBUS while writing the snapshot.
+  const uint64_t size = writer.size();
+  int rc = posix_fallocate(open_result.rc_, 0, size);
+  if (rc == 0) {
+    const Api::SysCallPtrResult mmap_result = os_sys_calls.mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, open_result.rc_, 0);
+    if (mmap_result.rc_ != MAP_FAILED) {
+      writer.write(static_cast<uint8_t*>(mmap_result.rc_));
+      os_sys_calls.munmap(mmap_result.rc_, size);
+    } else {
+      rc = mmap_result.errno_;
+    }
+  }
+  os_sys_calls.close(open_result.rc_);
+  if (rc != 0) {
+    ENVOY_LOG_MISC(warn, "cannot write the hot restart stats snapshot to shared memory {}: {}",
+                   shared_memory_name, errorDetails(rc));
+    hot_restart_os_sys_calls.shmUnlink(shared_memory_name.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
 HotRestartingParent::HotRestartingParent(int base_id, int restart_epoch,
                                          const std::string& socket_path, mode_t socket_mode)
     : HotRestartingBase(base_id), restart_epoch_(restart_epoch) {
@@ -57,7 +120,14 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      const std::string& shared_memory_name =
+          wrapped_request->request().stats().shared_memory_name();
+      if (shared_memory_name.empty()) {
+        internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      } else {
+        internal_->exportStatsSnapshotToChild(shared_memory_name,
+                                              wrapped_reply.mutable_reply()->mutable_stats());
+      }
       sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -161,14 +231,51 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
 
   // Convert that C++ structure (controlled by stat_merger.cc) into a protobuf
   // for serialization.
-  if (!spans.empty()) {
-    HotRestartMessage::Reply::RepeatedSpan spans_proto;
-    for (const Stats::DynamicSpan& span : spans) {
-      HotRestartMessage::Reply::Span* span_proto = spans_proto.add_spans();
-      span_proto->set_first(span.first);
-      span_proto->set_last(span.second);
+  addDynamicSpans(stats, name, spans);
+}
+
+void HotRestartingParent::Internal::exportStatsSnapshotToChild(
+    const std::string& shared_memory_name, HotRestartMessage::Reply::Stats* stats) {
+  const Stats::SymbolTable& symbol_table = server_->stats().symbolTable();
+  Stats::StatSnapshotWriter writer;
+  for (const auto& gauge : server_->stats().gauges()) {
+    if (gauge->used()) {
+      writer.addGauge(gauge->name(), gauge->value(),
+                      symbol_table.getDynamicSpans(gauge->statName()));
     }
-    (*stats->mutable_dynamics())[name] = spans_proto;
+  }
+  for (const auto& counter : server_->stats().counters()) {
+    if (counter->used()) {
+      // See exportStatsToChild about latching.
+      uint64_t latched_value = counter->latch();
+      if (latched_value > 0) {
+        writer.addCounter(counter->name(), latched_value,
+                          symbol_table.getDynamicSpans(counter->statName()));
+      }
+    }
+  }
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+
+  if (writeStatsSnapshot(shared_memory_name, writer)) {
+    stats->set_shared_memory_size(writer.size());
+    return;
+  }
+
+  // The counters are latched already, so their deltas must still reach the child via the maps.
+  std::vector<uint64_t> buffer(writer.size() / sizeof(uint64_t));
+  writer.write(reinterpret_cast<uint8_t*>(buffer.data()));
+  Stats::StatSnapshotReader snapshot;
+  RELEASE_ASSERT(snapshot.parse(reinterpret_cast<const uint8_t*>(buffer.data()), writer.size()),
+                 "failed to parse our own stats snapshot.");
+  for (uint32_t i = 0; i < snapshot.numStats(); ++i) {
+    const std::string name(snapshot.name(i));
+    if (i < snapshot.numCounters()) {
+      (*stats->mutable_counter_deltas())[name] = snapshot.value(i);
+    } else {
+      (*stats->mutable_gauges())[name] = snapshot.value(i);
+    }
+    addDynamicSpans(stats, name, snapshot.dynamicSpans(i));
   }
 }
 
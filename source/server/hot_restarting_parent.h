@@ -31,6 +31,11 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Like exportStatsToChild, but writes the stats as a snapshot into the shared memory object
+    // named by the child, which can merge it in place. Falls back to the maps of 'stats' if the
+    // snapshot can't be written.
+    void exportStatsSnapshotToChild(const std::string& shared_memory_name,
+                                    envoy::HotRestartMessage::Reply::Stats* stats);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
@@ -136,13 +136,9 @@ Event::ScaledTimerType parseTimerType(
   }
 }
 
-Event::ScaledTimerTypeMap
-parseTimerMinimums(const ProtobufWkt::Any& typed_config,
-                   ProtobufMessage::ValidationVisitor& validation_visitor) {
+Event::ScaledTimerTypeMap parseTimerMinimums(
+    const envoy::config::overload::v3::ScaleTimersOverloadActionConfig& action_config) {
   using Config = envoy::config::overload::v3::ScaleTimersOverloadActionConfig;
-  const Config action_config =
-      MessageUtil::anyConvertAndValidate<Config>(typed_config, validation_visitor);
-
   Event::ScaledTimerTypeMap timer_map;
 
   for (const auto& scale_timer : action_config.timer_scale_factors()) {
@@ -268,7 +264,7 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
       refresh_interval_(
           std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))) {
   Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, options, api,
-                                                           validation_visitor);
+                                                           validation_visitor, slot_allocator);
   for (const auto& resource : config.resource_monitors()) {
     const auto& name = resource.name();
     ENVOY_LOG(debug, "Adding resource monitor for {}", name);
@@ -298,8 +294,13 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
     }
 
     if (name == OverloadActionNames::get().ReduceTimeouts) {
-      timer_minimums_ = std::make_shared<const Event::ScaledTimerTypeMap>(
-          parseTimerMinimums(action.typed_config(), validation_visitor));
+      using Config = envoy::config::overload::v3::ScaleTimersOverloadActionConfig;
+      const Config action_config =
+          MessageUtil::anyConvertAndValidate<Config>(action.typed_config(), validation_visitor);
+      timer_minimums_ =
+          std::make_shared<const Event::ScaledTimerTypeMap>(parseTimerMinimums(action_config));
+      min_timer_granularity_ = std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(action_config, min_timer_granularity, 0));
     } else if (action.has_typed_config()) {
       throw EnvoyException(fmt::format(
           "Overload action \"{}\" has an unexpected value for the typed_config field", name));
@@ -393,7 +394,8 @@ Event::ScaledRangeTimerManagerFactory OverloadManagerImpl::scaledTimerFactory()
 Event::ScaledRangeTimerManagerPtr OverloadManagerImpl::createScaledRangeTimerManager(
     Event::Dispatcher& dispatcher,
     const Event::ScaledTimerTypeMapConstSharedPtr& timer_minimums) const {
-  return std::make_unique<Event::ScaledRangeTimerManagerImpl>(dispatcher, timer_minimums);
+  return std::make_unique<Event::ScaledRangeTimerManagerImpl>(dispatcher, timer_minimums,
+                                                              min_timer_granularity_);
 }
 
 void OverloadManagerImpl::updateResourcePressure(const std::string& resource, double pressure,
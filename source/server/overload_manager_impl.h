@@ -176,6 +176,8 @@ private:
   absl::node_hash_map<NamedOverloadActionSymbolTable::Symbol, OverloadAction> actions_;
 
   Event::ScaledTimerTypeMapConstSharedPtr timer_minimums_;
+  // Granularity of the min duration timers of scaled timers, or zero for precise timers.
+  std::chrono::milliseconds min_timer_granularity_{};
 
   absl::flat_hash_map<NamedOverloadActionSymbolTable::Symbol, OverloadActionState>
       state_updates_to_flush_;
@@ -10,9 +10,10 @@ class ResourceMonitorFactoryContextImpl : public ResourceMonitorFactoryContext {
 public:
   ResourceMonitorFactoryContextImpl(Event::Dispatcher& dispatcher, const Server::Options& options,
                                     Api::Api& api,
-                                    ProtobufMessage::ValidationVisitor& validation_visitor)
+                                    ProtobufMessage::ValidationVisitor& validation_visitor,
+                                    ThreadLocal::SlotAllocator& slot_allocator)
       : dispatcher_(dispatcher), options_(options), api_(api),
-        validation_visitor_(validation_visitor) {}
+        validation_visitor_(validation_visitor), slot_allocator_(slot_allocator) {}
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
@@ -24,11 +25,14 @@ public:
     return validation_visitor_;
   }
 
+  ThreadLocal::SlotAllocator& threadLocal() override { return slot_allocator_; }
+
 private:
   Event::Dispatcher& dispatcher_;
   const Server::Options& options_;
   Api::Api& api_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
+  ThreadLocal::SlotAllocator& slot_allocator_;
 };
 
 } // namespace Configuration
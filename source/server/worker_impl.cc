@@ -35,6 +35,12 @@ WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
   overload_manager.registerForAction(
       OverloadActionNames::get().RejectIncomingConnections, *dispatcher_,
       [this](OverloadActionState state) { rejectIncomingConnectionsCb(state); });
+  if (overload_manager.registerForAction(
+          OverloadActionNames::get().ResetStreamsUsingExcessiveMemory, *dispatcher_,
+          [this](OverloadActionState state) { resetStreamsUsingExcessiveMemory(state); })) {
+    // Streams are only charged to memory accounts if the action is configured to reset them.
+    dispatcher_->getWatermarkFactory().enableAccountTracking(api.rootScope());
+  }
 }
 
 void WorkerImpl::addListener(absl::optional<uint64_t> overridden_listener,
@@ -160,5 +166,11 @@ void WorkerImpl::rejectIncomingConnectionsCb(OverloadActionState state) {
   handler_->setListenerRejectFraction(state.value());
 }
 
+void WorkerImpl::resetStreamsUsingExcessiveMemory(OverloadActionState state) {
+  const uint64_t streams_reset =
+      dispatcher_->getWatermarkFactory().resetAccountsGivenPressure(state.value().value());
+  ENVOY_LOG(debug, "reset {} streams due to buffer memory pressure", streams_reset);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -4,9 +4,11 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/buffer/watermark_buffer.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "test/common/buffer/utility.h"
 #include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
@@ -570,6 +572,174 @@ TEST_F(WatermarkBufferTest, MoveWatermarksOverflow) {
   EXPECT_EQ(1, overflow_watermark_buffer1);
 }
 
+class BufferMemoryAccountTest : public testing::Test {
+public:
+  BufferMemoryAccountTest() {
+    factory_.enableAccountTracking(store_);
+    account_ = factory_.createAccount([this]() -> void { ++times_reset_called_; });
+  }
+
+  uint64_t bucketBytes(uint32_t bucket) {
+    return TestUtility::findGauge(store_, absl::StrCat("buffer_memory_account.bucket_", bucket,
+                                                       "_bytes"))
+        ->value();
+  }
+
+  WatermarkBuffer createBuffer() {
+    return WatermarkBuffer([]() -> void {}, []() -> void {}, []() -> void {});
+  }
+
+  static constexpr uint64_t MinimumTrackedBalance = 1 << MinimumTrackedAccountBalanceLog2;
+
+  Stats::IsolatedStoreImpl store_;
+  WatermarkBufferFactory factory_;
+  uint32_t times_reset_called_{0};
+  BufferMemoryAccountSharedPtr account_;
+};
+
+TEST(BufferMemoryAccountDisabledTest, NoAccountsUntilTrackingIsEnabled) {
+  Stats::IsolatedStoreImpl store;
+  WatermarkBufferFactory factory;
+  EXPECT_EQ(nullptr, factory.createAccount([]() -> void {}));
+  EXPECT_EQ(0, factory.resetAccountsGivenPressure(1.0));
+  EXPECT_FALSE(TestUtility::findCounter(store, "buffer_memory_account.streams_reset"));
+
+  factory.enableAccountTracking(store);
+  EXPECT_NE(nullptr, factory.createAccount([]() -> void {}));
+  EXPECT_TRUE(TestUtility::findCounter(store, "buffer_memory_account.streams_reset"));
+}
+
+TEST_F(BufferMemoryAccountTest, ChargesAndCreditsLength) {
+  WatermarkBuffer buffer = createBuffer();
+  buffer.add(TEN_BYTES, 10);
+  // Bytes held before binding are charged on bind.
+  buffer.bindAccount(account_);
+  EXPECT_EQ(10, account_->balance());
+
+  buffer.add(TEN_BYTES, 5);
+  EXPECT_EQ(15, account_->balance());
+  buffer.drain(12);
+  EXPECT_EQ(3, account_->balance());
+
+  // Rebinding moves the charge to the new account.
+  BufferMemoryAccountSharedPtr other_account = factory_.createAccount([]() -> void {});
+  buffer.bindAccount(other_account);
+  EXPECT_EQ(0, account_->balance());
+  EXPECT_EQ(3, other_account->balance());
+
+  buffer.bindAccount(nullptr);
+  EXPECT_EQ(0, other_account->balance());
+}
+
+TEST_F(BufferMemoryAccountTest, MoveTransfersCharge) {
+  WatermarkBuffer source = createBuffer();
+  WatermarkBuffer destination = createBuffer();
+  source.bindAccount(account_);
+  BufferMemoryAccountSharedPtr other_account = factory_.createAccount([]() -> void {});
+  destination.bindAccount(other_account);
+
+  source.add(TEN_BYTES, 10);
+  destination.move(source, 4);
+  EXPECT_EQ(6, account_->balance());
+  EXPECT_EQ(4, other_account->balance());
+
+  destination.move(source);
+  EXPECT_EQ(0, account_->balance());
+  EXPECT_EQ(10, other_account->balance());
+}
+
+TEST_F(BufferMemoryAccountTest, DestroyedBufferCreditsAccount) {
+  {
+    WatermarkBuffer buffer = createBuffer();
+    buffer.bindAccount(account_);
+    buffer.add(TEN_BYTES, 10);
+    EXPECT_EQ(10, account_->balance());
+  }
+  EXPECT_EQ(0, account_->balance());
+}
+
+TEST_F(BufferMemoryAccountTest, TracksLargeAccountsInBuckets) {
+  WatermarkBuffer buffer = createBuffer();
+  buffer.bindAccount(account_);
+
+  buffer.add(std::string(MinimumTrackedBalance - 1, 'a'));
+  EXPECT_TRUE(factory_.accountsInBucketForTest(0).empty());
+  EXPECT_EQ(0, bucketBytes(0));
+
+  buffer.add("a");
+  EXPECT_EQ(1, factory_.accountsInBucketForTest(0).size());
+  EXPECT_EQ(MinimumTrackedBalance, bucketBytes(0));
+
+  // Doubling the balance moves the account to the next bucket.
+  buffer.add(std::string(MinimumTrackedBalance, 'a'));
+  EXPECT_TRUE(factory_.accountsInBucketForTest(0).empty());
+  EXPECT_EQ(1, factory_.accountsInBucketForTest(1).size());
+  EXPECT_EQ(0, bucketBytes(0));
+  EXPECT_EQ(2 * MinimumTrackedBalance, bucketBytes(1));
+
+  buffer.drain(buffer.length());
+  EXPECT_TRUE(factory_.accountsInBucketForTest(1).empty());
+  EXPECT_EQ(0, bucketBytes(1));
+}
+
+TEST_F(BufferMemoryAccountTest, ResetsLargestAccountsGivenPressure) {
+  WatermarkBuffer large_buffer = createBuffer();
+  large_buffer.bindAccount(account_);
+  // 2^7 times the minimum lands in the last bucket.
+  large_buffer.add(std::string(MinimumTrackedBalance << (NumAccountBuckets - 1), 'a'));
+
+  uint32_t times_small_reset_called = 0;
+  BufferMemoryAccountSharedPtr small_account =
+      factory_.createAccount([&]() -> void { ++times_small_reset_called; });
+  WatermarkBuffer small_buffer = createBuffer();
+  small_buffer.bindAccount(small_account);
+  small_buffer.add(std::string(MinimumTrackedBalance, 'a'));
+
+  // Nothing is reset when the action is inactive.
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(0));
+
+  // Low pressure only resets the last bucket.
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(0.1));
+  EXPECT_EQ(1, times_reset_called_);
+  EXPECT_EQ(0, times_small_reset_called);
+
+  // Accounts are only reset once, even while their buffers are still held.
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(1.0));
+  EXPECT_EQ(1, times_reset_called_);
+  EXPECT_EQ(1, times_small_reset_called);
+  EXPECT_EQ(2, TestUtility::findCounter(store_, "buffer_memory_account.streams_reset")->value());
+}
+
+TEST_F(BufferMemoryAccountTest, ClearedDownstreamIsNotReset) {
+  WatermarkBuffer buffer = createBuffer();
+  buffer.bindAccount(account_);
+  buffer.add(std::string(MinimumTrackedBalance, 'a'));
+
+  account_->clearDownstream();
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(1.0));
+  EXPECT_EQ(0, times_reset_called_);
+}
+
+TEST(ScaleBufferLimitTest, Unlimited) {
+  EXPECT_EQ(0U, scaleBufferLimit(0, UnitFloat::max()));
+}
+
+TEST(ScaleBufferLimitTest, Inactive) {
+  EXPECT_EQ(1024U * 1024, scaleBufferLimit(1024 * 1024, UnitFloat::min()));
+}
+
+TEST(ScaleBufferLimitTest, ScalesProportionally) {
+  EXPECT_EQ(768U * 1024, scaleBufferLimit(1024 * 1024, UnitFloat(0.25)));
+  EXPECT_EQ(256U * 1024, scaleBufferLimit(1024 * 1024, UnitFloat(0.75)));
+}
+
+TEST(ScaleBufferLimitTest, NeverBelowMinimum) {
+  EXPECT_EQ(MinimumScaledBufferLimit, scaleBufferLimit(1024 * 1024, UnitFloat::max()));
+  EXPECT_EQ(MinimumScaledBufferLimit, scaleBufferLimit(64 * 1024, UnitFloat(0.9)));
+  // Limits already below the minimum are not changed.
+  EXPECT_EQ(1000U, scaleBufferLimit(1000, UnitFloat::max()));
+}
+
 } // namespace
 } // namespace Buffer
 } // namespace Envoy
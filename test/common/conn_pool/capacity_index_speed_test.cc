@@ -0,0 +1,91 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the cost of assigning streams to the least loaded of many multiplexed connections, as a
+// connection pool spreading streams does, between a linear scan of the connections and a capacity
+// index.
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include "common/common/utility.h"
+#include "common/conn_pool/capacity_index.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+
+struct TestClient {
+  int64_t capacity_;
+  CapacityIndex<TestClient>::Entry entry_;
+};
+
+constexpr int64_t ConcurrentStreams = 100;
+
+// Attaches and completes streams in turn, keeping each connection about half loaded.
+template <class Select, class Update>
+void churn(std::vector<TestClient>& clients, Select select, Update update) {
+  std::vector<TestClient*> attached;
+  attached.reserve(clients.size() * ConcurrentStreams / 2);
+  for (size_t i = 0; i < attached.capacity(); ++i) {
+    TestClient* client = select();
+    update(*client, client->capacity_ - 1);
+    attached.push_back(client);
+  }
+  for (TestClient* client : attached) {
+    update(*client, client->capacity_ + 1);
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LinearScanSelection(benchmark::State& state) {
+  std::vector<TestClient> clients(state.range(0));
+  std::list<TestClient*> ready_clients;
+  for (TestClient& client : clients) {
+    client.capacity_ = ConcurrentStreams;
+    ready_clients.push_back(&client);
+  }
+  const auto select = [&ready_clients]() {
+    TestClient* best = ready_clients.front();
+    for (TestClient* client : ready_clients) {
+      if (client->capacity_ > best->capacity_) {
+        best = client;
+      }
+    }
+    return best;
+  };
+  const auto update = [](TestClient& client, int64_t capacity) { client.capacity_ = capacity; };
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    churn(clients, select, update);
+  }
+}
+BENCHMARK(BM_LinearScanSelection)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CapacityIndexSelection(benchmark::State& state) {
+  std::vector<TestClient> clients(state.range(0));
+  CapacityIndex<TestClient> index;
+  for (TestClient& client : clients) {
+    client.capacity_ = ConcurrentStreams;
+    index.insert(client, client.entry_, client.capacity_);
+  }
+  const auto select = [&index]() { return index.mostCapacity(); };
+  const auto update = [&index](TestClient& client, int64_t capacity) {
+    client.capacity_ = capacity;
+    index.update(client.entry_, capacity);
+  };
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    churn(clients, select, update);
+  }
+  for (TestClient& client : clients) {
+    index.remove(client.entry_);
+  }
+}
+BENCHMARK(BM_CapacityIndexSelection)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+} // namespace ConnectionPool
+} // namespace Envoy
@@ -0,0 +1,127 @@
+#include <vector>
+
+#include "common/conn_pool/capacity_index.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+struct TestElement {
+  CapacityIndex<TestElement>::Entry entry_;
+};
+
+class CapacityIndexTest : public testing::Test {
+public:
+  CapacityIndexTest() : elements_(4) {}
+
+  ~CapacityIndexTest() override {
+    for (TestElement& element : elements_) {
+      if (element.entry_.indexed()) {
+        index_.remove(element.entry_);
+      }
+    }
+  }
+
+  void insert(size_t element, int64_t capacity) {
+    index_.insert(elements_[element], elements_[element].entry_, capacity);
+  }
+  void update(size_t element, int64_t capacity) {
+    index_.update(elements_[element].entry_, capacity);
+  }
+  void remove(size_t element) { index_.remove(elements_[element].entry_); }
+
+  std::vector<TestElement> elements_;
+  CapacityIndex<TestElement> index_;
+};
+
+TEST_F(CapacityIndexTest, Empty) {
+  EXPECT_TRUE(index_.empty());
+  EXPECT_EQ(nullptr, index_.leastCapacity(0));
+  EXPECT_EQ(nullptr, index_.mostCapacity());
+}
+
+TEST_F(CapacityIndexTest, InsertAndRemove) {
+  insert(0, 5);
+  insert(1, 1);
+  insert(2, 10);
+  insert(3, 3);
+  EXPECT_EQ(4U, index_.size());
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[3], index_.leastCapacity(2));
+  EXPECT_EQ(&elements_[2], index_.leastCapacity(10));
+  EXPECT_EQ(nullptr, index_.leastCapacity(11));
+  EXPECT_EQ(&elements_[2], index_.mostCapacity());
+
+  remove(2);
+  EXPECT_FALSE(elements_[2].entry_.indexed());
+  EXPECT_EQ(&elements_[0], index_.mostCapacity());
+  remove(1);
+  EXPECT_EQ(&elements_[3], index_.leastCapacity(0));
+  EXPECT_EQ(2U, index_.size());
+}
+
+TEST_F(CapacityIndexTest, EqualCapacity) {
+  insert(0, 2);
+  insert(1, 2);
+  // The most recently inserted element is returned first.
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[1], index_.mostCapacity());
+
+  remove(1);
+  EXPECT_EQ(&elements_[0], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[0], index_.mostCapacity());
+}
+
+TEST_F(CapacityIndexTest, UpdateByOne) {
+  insert(0, 3);
+  insert(1, 3);
+  update(1, 2);
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[0], index_.mostCapacity());
+
+  update(0, 2);
+  update(0, 1);
+  EXPECT_EQ(&elements_[0], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[1], index_.mostCapacity());
+
+  update(0, 2);
+  update(0, 3);
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[0], index_.mostCapacity());
+
+  // Updating to the same capacity is a no-op.
+  update(0, 3);
+  EXPECT_EQ(&elements_[0], index_.mostCapacity());
+}
+
+TEST_F(CapacityIndexTest, UpdateAcrossBuckets) {
+  insert(0, 1);
+  insert(1, 5);
+  insert(2, 10);
+  insert(3, 20);
+
+  update(0, 15);
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(0));
+  EXPECT_EQ(&elements_[0], index_.leastCapacity(11));
+  EXPECT_EQ(&elements_[3], index_.mostCapacity());
+
+  update(3, -1);
+  EXPECT_EQ(&elements_[3], index_.leastCapacity(-5));
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(1));
+  EXPECT_EQ(&elements_[0], index_.mostCapacity());
+
+  // Moving onto an existing bucket.
+  update(2, 5);
+  update(1, 4);
+  update(1, 5);
+  EXPECT_EQ(&elements_[1], index_.leastCapacity(1));
+  update(1, 15);
+  EXPECT_EQ(&elements_[1], index_.mostCapacity());
+  EXPECT_EQ(4U, index_.size());
+}
+
+} // namespace
+} // namespace ConnectionPool
+} // namespace Envoy
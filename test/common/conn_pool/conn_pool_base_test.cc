@@ -16,6 +16,7 @@ using testing::HasSubstr;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::Return;
+using testing::ReturnPointee;
 
 class TestActiveClient : public ActiveClient {
 public:
@@ -31,8 +32,8 @@ public:
 
 class TestPendingStream : public PendingStream {
 public:
-  TestPendingStream(ConnPoolImplBase& parent, AttachContext& context)
-      : PendingStream(parent), context_(context) {}
+  TestPendingStream(ConnPoolImplBase& parent, bool can_send_early_data, AttachContext& context)
+      : PendingStream(parent, can_send_early_data), context_(context) {}
   AttachContext& context() override { return context_; }
   AttachContext& context_;
 };
@@ -40,8 +41,9 @@ public:
 class TestConnPoolImplBase : public ConnPoolImplBase {
 public:
   using ConnPoolImplBase::ConnPoolImplBase;
-  ConnectionPool::Cancellable* newPendingStream(AttachContext& context) override {
-    auto entry = std::make_unique<TestPendingStream>(*this, context);
+  ConnectionPool::Cancellable* newPendingStream(AttachContext& context,
+                                                bool can_send_early_data) override {
+    auto entry = std::make_unique<TestPendingStream>(*this, can_send_early_data, context);
     return addPendingStream(std::move(entry));
   }
   MOCK_METHOD(ActiveClientPtr, instantiateActiveClient, ());
@@ -201,5 +203,213 @@ TEST_F(ConnPoolImplBaseTest, ExplicitPreconnectNotHealthy) {
   EXPECT_FALSE(pool_.maybePreconnect(1));
 }
 
+TEST_F(ConnPoolImplBaseTest, PrewarmMinReadyConnections) {
+  ON_CALL(*cluster_, minReadyConnections).WillByDefault(Return(2));
+
+  // On new stream, create enough connections to have 2 ready ones.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prewarm_miss_.value());
+
+  // Once the first connection is used for the pending stream, another one is established to
+  // replace it.
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 2 /*connecting capacity*/);
+
+  // Once the stream completes, there are more ready connections than needed, which are kept.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(0);
+  static_cast<TestActiveClient*>(clients_[0])->active_streams_ = 0;
+  pool_.onStreamClosed(*clients_[0], false);
+  CHECK_STATE(0 /*active*/, 0 /*pending*/, 3 /*connecting capacity*/);
+
+  // A new stream uses the ready connection, and the prewarmed connections suffice.
+  pool_.newStream(context_);
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 2 /*connecting capacity*/);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_prewarm_hit_.value());
+
+  static_cast<TestActiveClient*>(clients_[0])->active_streams_ = 0;
+  pool_.onStreamClosed(*clients_[0], false);
+  pool_.destructAllConnections();
+}
+
+TEST_F(ConnPoolImplBaseTest, PrewarmPausedAfterConnectFailure) {
+  ON_CALL(*cluster_, minReadyConnections).WillByDefault(Return(2));
+
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(context_);
+
+  // A failed connection is not replaced while there are no streams needing it.
+  EXPECT_CALL(pool_, onPoolFailure);
+  clients_[0]->close();
+  CHECK_STATE(0 /*active*/, 0 /*pending*/, 1 /*connecting capacity*/);
+
+  // Once a connection succeeds, prewarming resumes.
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(0 /*active*/, 0 /*pending*/, 2 /*connecting capacity*/);
+
+  pool_.destructAllConnections();
+}
+
+TEST_F(ConnPoolImplBaseTest, EarlyData) {
+  concurrent_streams_ = 2;
+
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
+  pool_.newStream(context_, true);
+  CHECK_STATE(0 /*active*/, 2 /*pending*/, 2 /*connecting capacity*/);
+
+  // Only the stream which may be sent as early data is attached before the handshake completes.
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+  CHECK_STATE(1 /*active*/, 1 /*pending*/, 1 /*connecting capacity*/);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_0rtt_.value());
+
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  CHECK_STATE(2 /*active*/, 0 /*pending*/, 0 /*connecting capacity*/);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_rq_0rtt_.value());
+
+  pool_.destructAllConnections();
+}
+
+TEST_F(ConnPoolImplBaseTest, EarlyDataConnectFailure) {
+  EXPECT_CALL(pool_, instantiateActiveClient);
+  pool_.newStream(context_, true);
+
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::ConnectedZeroRtt);
+  CHECK_STATE(1 /*active*/, 0 /*pending*/, 0 /*connecting capacity*/);
+
+  // The handshake never completed, so this is still a connect failure.
+  clients_[0]->close();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_connect_fail_.value());
+}
+
+TEST_F(ConnPoolImplBaseTest, PrewarmForArrivalRate) {
+  ON_CALL(*cluster_, arrivalRateLookahead).WillByDefault(Return(std::chrono::milliseconds(1000)));
+  MonotonicTime now;
+  ON_CALL(dispatcher_, approximateMonotonicTime()).WillByDefault(ReturnPointee(&now));
+
+  // Each stream arriving in a burst anticipates another one, so connections are established for
+  // twice as many streams as are pending.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(4);
+  pool_.newStream(context_);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 2 /*pending*/, 4 /*connecting capacity*/);
+
+  // Once the burst is long past, a new stream only anticipates itself.
+  now += std::chrono::seconds(10);
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(0);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 3 /*pending*/, 4 /*connecting capacity*/);
+  EXPECT_EQ(3U, cluster_->stats_.upstream_rq_prewarm_miss_.value());
+
+  EXPECT_CALL(pool_, onPoolFailure).Times(3);
+  pool_.destructAllConnections();
+}
+
+class ConnPoolImplBaseSelectionTest : public ConnPoolImplBaseTest {
+public:
+  // Creates a pool with the given connection selection policy and two ready clients, each of
+  // which can serve 4 concurrent streams.
+  void initialize(envoy::config::cluster::v3::Cluster::ConnectionSelectionPolicy policy) {
+    ON_CALL(*cluster_, connectionSelectionPolicy).WillByDefault(Return(policy));
+    // Owned by the pool.
+    new NiceMock<Event::MockSchedulableCallback>(&dispatcher_);
+    selection_pool_ = std::make_unique<TestConnPoolImplBase>(
+        host_, Upstream::ResourcePriority::Default, dispatcher_, nullptr, nullptr, state_);
+    ON_CALL(*selection_pool_, instantiateActiveClient)
+        .WillByDefault(Invoke([&]() -> ActiveClientPtr {
+          auto ret = std::make_unique<TestActiveClient>(*selection_pool_, 100, 4);
+          clients_.push_back(ret.get());
+          ret->real_host_description_ = descr_;
+          return ret;
+        }));
+    ON_CALL(*selection_pool_, onPoolReady(_, _))
+        .WillByDefault(Invoke([](ActiveClient& client, AttachContext&) -> void {
+          ++(static_cast<TestActiveClient*>(&client)->active_streams_);
+        }));
+
+    EXPECT_CALL(*selection_pool_, instantiateActiveClient).Times(2);
+    EXPECT_TRUE(selection_pool_->maybePreconnect(5));
+    EXPECT_TRUE(selection_pool_->maybePreconnect(5));
+    clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+    clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  }
+
+  uint32_t activeStreams(size_t client) {
+    return static_cast<TestActiveClient*>(clients_[client])->active_streams_;
+  }
+
+  void closeStream(size_t client) {
+    --static_cast<TestActiveClient*>(clients_[client])->active_streams_;
+    selection_pool_->onStreamClosed(*clients_[client], false);
+  }
+
+  void TearDown() override {
+    for (size_t client = 0; client < clients_.size(); ++client) {
+      while (activeStreams(client) > 0) {
+        closeStream(client);
+      }
+    }
+    selection_pool_->destructAllConnections();
+  }
+
+  std::unique_ptr<TestConnPoolImplBase> selection_pool_;
+};
+
+TEST_F(ConnPoolImplBaseSelectionTest, MostRecentlyReady) {
+  initialize(envoy::config::cluster::v3::Cluster::MOST_RECENTLY_READY);
+  selection_pool_->newStream(context_);
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(0U, activeStreams(0));
+  EXPECT_EQ(2U, activeStreams(1));
+}
+
+TEST_F(ConnPoolImplBaseSelectionTest, Pack) {
+  initialize(envoy::config::cluster::v3::Cluster::PACK);
+  selection_pool_->newStream(context_);
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(0U, activeStreams(0));
+  EXPECT_EQ(2U, activeStreams(1));
+
+  // Once the most loaded client is busy, streams go to the other client.
+  selection_pool_->newStream(context_);
+  selection_pool_->newStream(context_);
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(1U, activeStreams(0));
+  EXPECT_EQ(4U, activeStreams(1));
+
+  // A client with more streams remains preferred when streams complete.
+  closeStream(1);
+  closeStream(1);
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(1U, activeStreams(0));
+  EXPECT_EQ(3U, activeStreams(1));
+}
+
+TEST_F(ConnPoolImplBaseSelectionTest, Spread) {
+  initialize(envoy::config::cluster::v3::Cluster::SPREAD);
+  selection_pool_->newStream(context_);
+  selection_pool_->newStream(context_);
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(2U, activeStreams(0));
+  EXPECT_EQ(1U, activeStreams(1));
+
+  // The least loaded client is preferred as streams complete.
+  closeStream(0);
+  closeStream(0);
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(1U, activeStreams(0));
+  EXPECT_EQ(1U, activeStreams(1));
+  selection_pool_->newStream(context_);
+  EXPECT_EQ(2U, activeStreams(0));
+  EXPECT_EQ(1U, activeStreams(1));
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
@@ -16,6 +16,7 @@
 #include "test/mocks/common.h"
 #include "test/mocks/server/watch_dog.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/logging.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
@@ -24,10 +25,12 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::AnyNumber;
 using testing::ByMove;
 using testing::InSequence;
 using testing::MockFunction;
 using testing::NiceMock;
+using testing::Property;
 using testing::Return;
 
 namespace Envoy {
@@ -382,10 +385,21 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, counter("test.dispatcher.slow_callbacks"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.deferred_delete_us",
+                                Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.file_event_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.poll_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_callback_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.schedulable_callback_us",
+                                Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.timer_us", Stats::Histogram::Unit::Microseconds));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
@@ -1587,6 +1601,154 @@ TEST_F(DispatcherWithWatchdogTest, TouchBeforeFdEvent) {
   dispatcher_->run(Dispatcher::RunType::NonBlock);
 }
 
+class DispatcherCallbackStatsTest : public testing::Test {
+protected:
+  DispatcherCallbackStatsTest()
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")) {
+    // The loop's own stats, and the durations of callbacks a test doesn't check, are ignored.
+    EXPECT_CALL(store_, deliverHistogramToSinks(_, _)).Times(AnyNumber());
+  }
+
+  void initializeStats() {
+    dispatcher_->initializeStats(store_, "test.");
+    dispatcher_->run(Dispatcher::RunType::NonBlock);
+  }
+
+  // Advances time without waiting for simulated timers, so it can be called from callbacks.
+  void advanceTime(std::chrono::milliseconds duration) {
+    time_system_.setMonotonicTime(time_system_.monotonicTime() + duration);
+  }
+
+  void expectDuration(const std::string& name, uint64_t duration_us) {
+    EXPECT_CALL(store_,
+                deliverHistogramToSinks(Property(&Stats::Metric::name, name), duration_us));
+  }
+
+  NiceMock<Stats::MockStore> store_; // Must outlive dispatcher_.
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+TEST_F(DispatcherCallbackStatsTest, RecordsCallbackDurationsByType) {
+  initializeStats();
+
+  expectDuration("test.dispatcher.post_callback_us", 5000);
+  dispatcher_->post([this]() { advanceTime(std::chrono::milliseconds(5)); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  expectDuration("test.dispatcher.deferred_delete_us", 3000);
+  dispatcher_->deferredDelete(std::make_unique<TestDeferredDeletable>(
+      [this]() { advanceTime(std::chrono::milliseconds(3)); }));
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  os_fd_t fd = Api::OsSysCallsSingleton::get().socket(AF_INET6, SOCK_DGRAM, 0).rc_;
+  ASSERT_TRUE(SOCKET_VALID(fd));
+  expectDuration("test.dispatcher.file_event_us", 2000);
+  FileEventPtr file_event = dispatcher_->createFileEvent(
+      fd, [this](uint32_t) { advanceTime(std::chrono::milliseconds(2)); },
+      PlatformDefaultTriggerType, FileReadyType::Read);
+  file_event->activate(FileReadyType::Read);
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  expectDuration("test.dispatcher.schedulable_callback_us", 0);
+  SchedulableCallbackPtr schedulable_callback = dispatcher_->createSchedulableCallback([]() {});
+  schedulable_callback->scheduleCallbackCurrentIteration();
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  // Time can't be advanced from the callback of a simulated timer.
+  expectDuration("test.dispatcher.timer_us", 0);
+  TimerPtr timer = dispatcher_->createTimer([]() {});
+  timer->enableTimer(std::chrono::milliseconds(0));
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  // Slow callbacks aren't counted unless a threshold is configured.
+  EXPECT_CALL(store_.counter_, inc()).Times(0);
+  dispatcher_->post([this]() { advanceTime(std::chrono::seconds(1)); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
+TEST_F(DispatcherCallbackStatsTest, LogsSlowCallbackWithTrackedObjects) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.dispatcher.slow_callback_threshold_ms", "10"}});
+  initializeStats();
+
+  // A callback below the threshold isn't logged.
+  EXPECT_CALL(store_.counter_, inc()).Times(0);
+  dispatcher_->post([this]() { advanceTime(std::chrono::milliseconds(5)); });
+  EXPECT_LOG_NOT_CONTAINS("warn", "slow post callback", {
+    dispatcher_->run(Dispatcher::RunType::NonBlock);
+  });
+
+  // The tracked objects are dumped when they are popped after the threshold is reached.
+  EXPECT_CALL(store_.counter_, inc());
+  dispatcher_->post([this]() {
+    MessageTrackedObject first{"first"};
+    ScopeTrackerScopeState first_state{&first, *dispatcher_};
+    {
+      MessageTrackedObject second{"second"};
+      ScopeTrackerScopeState second_state{&second, *dispatcher_};
+      advanceTime(std::chrono::milliseconds(20));
+    }
+  });
+  EXPECT_LOG_CONTAINS(
+      "warn", "test.dispatcher: slow post callback took 20000us, while processing:\nsecondfirst",
+      { dispatcher_->run(Dispatcher::RunType::NonBlock); });
+}
+
+// Callbacks run from within another callback are only timed as part of the outermost one.
+TEST_F(DispatcherCallbackStatsTest, NestedCallbacksTimedAsPartOfOutermost) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.dispatcher.slow_callback_threshold_ms", "10"}});
+  initializeStats();
+
+  EXPECT_CALL(store_, deliverHistogramToSinks(
+                          Property(&Stats::Metric::name, "test.dispatcher.deferred_delete_us"), _))
+      .Times(0);
+  expectDuration("test.dispatcher.post_callback_us", 25000);
+  EXPECT_CALL(store_.counter_, inc());
+  dispatcher_->post([this]() {
+    MessageTrackedObject outer{"outer"};
+    ScopeTrackerScopeState outer_state{&outer, *dispatcher_};
+    // Deleting an object can clear the deferred delete list, e.g. from the destructor of a
+    // connection pool, which runs the deferred deletes inside this callback.
+    dispatcher_->deferredDelete(std::make_unique<TestDeferredDeletable>(
+        [this]() { advanceTime(std::chrono::milliseconds(20)); }));
+    dispatcher_->clearDeferredDeleteList();
+    advanceTime(std::chrono::milliseconds(5));
+  });
+  EXPECT_LOG_CONTAINS("warn",
+                      "test.dispatcher: slow post callback took 25000us, while processing:
+outer",
+                      { dispatcher_->run(Dispatcher::RunType::NonBlock); });
+}
+
+// The slow callback threshold follows runtime changes after the stats are initialized.
+TEST_F(DispatcherCallbackStatsTest, SlowCallbackThresholdReadFromRuntime) {
+  TestScopedRuntime scoped_runtime;
+  initializeStats();
+
+  EXPECT_CALL(store_.counter_, inc()).Times(0);
+  dispatcher_->post([this]() { advanceTime(std::chrono::milliseconds(20)); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.dispatcher.slow_callback_threshold_ms", "10"}});
+  EXPECT_CALL(store_.counter_, inc());
+  dispatcher_->post([this]() { advanceTime(std::chrono::milliseconds(20)); });
+  EXPECT_LOG_CONTAINS("warn", "test.dispatcher: slow post callback took 20000us",
+                      { dispatcher_->run(Dispatcher::RunType::NonBlock); });
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.dispatcher.slow_callback_threshold_ms", "0"}});
+  EXPECT_CALL(store_.counter_, inc()).Times(0);
+  dispatcher_->post([this]() { advanceTime(std::chrono::milliseconds(20)); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+}
+
 } // namespace
 } // namespace Event
 } // namespace Envoy
@@ -93,6 +93,24 @@ TEST_F(ScaledRangeTimerManagerTest, CreateSingleScaledTimer) {
   EXPECT_FALSE(timer->enabled());
 }
 
+TEST_F(ScaledRangeTimerManagerTest, CoarseMinDurationTimer) {
+  ScaledRangeTimerManagerImpl manager(dispatcher_, nullptr, std::chrono::milliseconds(100));
+
+  MockFunction<TimerCb> callback;
+  auto timer = manager.createTimer(ScaledMinimum(UnitFloat(1.0)), callback.AsStdFunction());
+
+  // The min duration is rounded up to the granularity of the coarse timer.
+  timer->enableTimer(std::chrono::milliseconds(150));
+  simTime().advanceTimeAndRun(std::chrono::milliseconds(150), dispatcher_,
+                              Dispatcher::RunType::Block);
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  simTime().advanceTimeAndRun(std::chrono::milliseconds(50), dispatcher_,
+                              Dispatcher::RunType::Block);
+  EXPECT_FALSE(timer->enabled());
+}
+
 TEST_F(ScaledRangeTimerManagerTest, EnableAndDisableTimer) {
   ScaledRangeTimerManagerImpl manager(dispatcher_);
 
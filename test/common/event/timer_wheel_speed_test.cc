@@ -0,0 +1,81 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares the cost of re-arming and cancelling many concurrent timers, which is what the
+// per-stream timeouts of a busy HTTP connection manager do, between libevent timers and coarse
+// timers backed by a timing wheel.
+
+#include <chrono>
+#include <vector>
+
+#include "common/event/dispatcher_impl.h"
+#include "common/event/real_time_system.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerChurnPerf {
+public:
+  TimerChurnPerf(bool coarse, uint64_t num_timers)
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")) {
+    timers_.reserve(num_timers);
+    for (uint64_t i = 0; i < num_timers; ++i) {
+      if (coarse) {
+        timers_.push_back(dispatcher_->createCoarseTimer(std::chrono::milliseconds(100), []() {}));
+      } else {
+        timers_.push_back(dispatcher_->createTimer([]() {}));
+      }
+    }
+  }
+
+  // Arms every timer with a slightly different timeout, as streams created over time would, then
+  // re-arms them, and finally cancels them as if the streams had completed.
+  void churn() {
+    for (uint64_t i = 0; i < timers_.size(); ++i) {
+      timers_[i]->enableTimer(std::chrono::milliseconds(15000 + i % 1000));
+    }
+    for (uint64_t i = 0; i < timers_.size(); ++i) {
+      timers_[i]->enableTimer(std::chrono::milliseconds(30000 + i % 1000));
+    }
+    for (auto& timer : timers_) {
+      timer->disableTimer();
+    }
+  }
+
+private:
+  RealTimeSystem time_system_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+  std::vector<TimerPtr> timers_;
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_LibeventTimerChurn(benchmark::State& state) {
+  TimerChurnPerf perf(false, state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    perf.churn();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LibeventTimerChurn)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CoarseTimerChurn(benchmark::State& state) {
+  TimerChurnPerf perf(true, state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    perf.churn();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CoarseTimerChurn)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+} // namespace Event
+} // namespace Envoy
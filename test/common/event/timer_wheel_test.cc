@@ -0,0 +1,318 @@
+#include <chrono>
+#include <vector>
+
+#include "envoy/event/timer.h"
+
+#include "common/event/dispatcher_impl.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/mocks/common.h"
+#include "test/mocks/event/wrapped_dispatcher.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using testing::InSequence;
+using testing::MockFunction;
+
+class ScopeTrackingDispatcher : public WrappedDispatcher {
+public:
+  ScopeTrackingDispatcher(Dispatcher& impl) : WrappedDispatcher(impl) {}
+
+  void pushTrackedObject(const ScopeTrackedObject* object) override {
+    scope_ = object;
+    return impl_.pushTrackedObject(object);
+  }
+
+  void popTrackedObject(const ScopeTrackedObject* expected_object) override {
+    scope_ = nullptr;
+    return impl_.popTrackedObject(expected_object);
+  }
+
+  const ScopeTrackedObject* scope_{nullptr};
+};
+
+class TimerWheelTest : public testing::Test, public TestUsingSimulatedTime {
+public:
+  TimerWheelTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        wheel_(*dispatcher_, std::chrono::milliseconds(10)) {}
+
+  void advance(std::chrono::milliseconds duration) {
+    simTime().advanceTimeAndRun(duration, *dispatcher_, Dispatcher::RunType::NonBlock);
+  }
+
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+  TimerWheel wheel_;
+};
+
+TEST_F(TimerWheelTest, CreateAndDestroy) {
+  auto timer = wheel_.createTimer([]() {});
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+}
+
+TEST_F(TimerWheelTest, FiresAfterTimeout) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(50));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(1U, wheel_.enabledTimers());
+
+  advance(std::chrono::milliseconds(49));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+}
+
+TEST_F(TimerWheelTest, RoundsUpToGranularity) {
+  // Move away from a tick boundary so that the expiration is rounded up.
+  advance(std::chrono::milliseconds(3));
+
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(20));
+
+  // The requested expiration is at 23ms, which is rounded up to the tick at 30ms.
+  advance(std::chrono::milliseconds(20));
+  EXPECT_TRUE(timer->enabled());
+  advance(std::chrono::milliseconds(6));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+}
+
+TEST_F(TimerWheelTest, ZeroTimeoutFiresOnNextTick) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(0));
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(10));
+}
+
+TEST_F(TimerWheelTest, HighResolutionTimer) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableHRTimer(std::chrono::microseconds(10001));
+
+  advance(std::chrono::milliseconds(19));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+}
+
+TEST_F(TimerWheelTest, DisableTimer) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(50));
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+
+  // Disabling twice is a no-op.
+  timer->disableTimer();
+
+  advance(std::chrono::milliseconds(100));
+}
+
+TEST_F(TimerWheelTest, ReenableMovesTimer) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(50));
+  advance(std::chrono::milliseconds(40));
+
+  timer->enableTimer(std::chrono::milliseconds(50));
+  EXPECT_EQ(1U, wheel_.enabledTimers());
+  advance(std::chrono::milliseconds(40));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(10));
+}
+
+TEST_F(TimerWheelTest, DestroyEnabledTimer) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(50));
+  timer.reset();
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+
+  advance(std::chrono::milliseconds(100));
+}
+
+TEST_F(TimerWheelTest, EarlierTimerEnabledAfterLaterTimer) {
+  InSequence s;
+  MockFunction<void()> early_callback;
+  MockFunction<void()> late_callback;
+  auto late_timer = wheel_.createTimer(late_callback.AsStdFunction());
+  auto early_timer = wheel_.createTimer(early_callback.AsStdFunction());
+  late_timer->enableTimer(std::chrono::seconds(10));
+  early_timer->enableTimer(std::chrono::milliseconds(10));
+
+  EXPECT_CALL(early_callback, Call());
+  advance(std::chrono::milliseconds(10));
+  EXPECT_CALL(late_callback, Call());
+  advance(std::chrono::milliseconds(9990));
+}
+
+// Timers far enough in the future to be placed in every level of the wheel fire at their
+// expiration time after being cascaded down.
+TEST_F(TimerWheelTest, CascadesThroughLevels) {
+  const std::vector<std::chrono::milliseconds> timeouts = {
+      std::chrono::milliseconds(30),     std::chrono::milliseconds(640),
+      std::chrono::milliseconds(1230),   std::chrono::milliseconds(40970),
+      std::chrono::milliseconds(123450), std::chrono::milliseconds(2621470),
+      std::chrono::milliseconds(9999990)};
+  std::vector<bool> fired(timeouts.size());
+  std::vector<TimerPtr> timers;
+  for (size_t i = 0; i < timeouts.size(); ++i) {
+    timers.push_back(wheel_.createTimer([&fired, i]() { fired[i] = true; }));
+    timers.back()->enableTimer(timeouts[i]);
+  }
+
+  std::chrono::milliseconds elapsed(0);
+  for (size_t i = 0; i < timeouts.size(); ++i) {
+    // Stop one tick before the expiration, then advance to it.
+    advance(timeouts[i] - std::chrono::milliseconds(10) - elapsed);
+    EXPECT_FALSE(fired[i]) << "timer " << i;
+    advance(std::chrono::milliseconds(10));
+    EXPECT_TRUE(fired[i]) << "timer " << i;
+    elapsed = timeouts[i];
+  }
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+}
+
+// Timers beyond the range of the wheel are parked and still fire on time.
+TEST_F(TimerWheelTest, TimerBeyondWheelRange) {
+  TimerWheel wheel(*dispatcher_, std::chrono::milliseconds(1));
+  MockFunction<void()> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+  // The wheel covers 2^24 ticks.
+  const std::chrono::milliseconds timeout((1 << 24) + 12345);
+  timer->enableTimer(timeout);
+
+  advance(timeout - std::chrono::milliseconds(1));
+  EXPECT_TRUE(timer->enabled());
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+}
+
+TEST_F(TimerWheelTest, CatchesUpAfterLongIdlePeriod) {
+  MockFunction<void()> callback;
+  auto timer = wheel_.createTimer(callback.AsStdFunction());
+  advance(std::chrono::hours(1));
+
+  timer->enableTimer(std::chrono::milliseconds(50));
+  advance(std::chrono::milliseconds(40));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(10));
+}
+
+TEST_F(TimerWheelTest, CallbackDisablesTimerExpiringOnSameTick) {
+  TimerPtr timer1;
+  TimerPtr timer2;
+  int fired = 0;
+  timer1 = wheel_.createTimer([&]() {
+    ++fired;
+    timer2->disableTimer();
+  });
+  timer2 = wheel_.createTimer([&]() {
+    ++fired;
+    timer1->disableTimer();
+  });
+  timer1->enableTimer(std::chrono::milliseconds(10));
+  timer2->enableTimer(std::chrono::milliseconds(10));
+
+  advance(std::chrono::milliseconds(10));
+  EXPECT_EQ(1, fired);
+  EXPECT_FALSE(timer1->enabled());
+  EXPECT_FALSE(timer2->enabled());
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+}
+
+TEST_F(TimerWheelTest, CallbackDestroysTimers) {
+  TimerPtr timer1;
+  TimerPtr timer2;
+  timer1 = wheel_.createTimer([&]() {
+    timer1.reset();
+    timer2.reset();
+  });
+  timer2 = wheel_.createTimer([&]() {
+    timer1.reset();
+    timer2.reset();
+  });
+  timer1->enableTimer(std::chrono::milliseconds(10));
+  timer2->enableTimer(std::chrono::milliseconds(10));
+
+  advance(std::chrono::milliseconds(10));
+  EXPECT_EQ(nullptr, timer1);
+  EXPECT_EQ(nullptr, timer2);
+  EXPECT_EQ(0U, wheel_.enabledTimers());
+}
+
+TEST_F(TimerWheelTest, CallbackReenablesTimer) {
+  int fired = 0;
+  TimerPtr timer;
+  timer = wheel_.createTimer([&]() {
+    if (++fired < 3) {
+      timer->enableTimer(std::chrono::milliseconds(10));
+    }
+  });
+  timer->enableTimer(std::chrono::milliseconds(10));
+
+  for (int i = 1; i <= 3; ++i) {
+    advance(std::chrono::milliseconds(10));
+    EXPECT_EQ(i, fired);
+  }
+  EXPECT_FALSE(timer->enabled());
+}
+
+TEST_F(TimerWheelTest, ScopeTracking) {
+  ScopeTrackingDispatcher dispatcher(*dispatcher_);
+  TimerWheel wheel(dispatcher, std::chrono::milliseconds(10));
+  MockScopedTrackedObject scope;
+  MockFunction<void()> callback;
+  auto timer = wheel.createTimer(callback.AsStdFunction());
+  timer->enableTimer(std::chrono::milliseconds(10), &scope);
+
+  EXPECT_CALL(callback, Call()).WillOnce([&]() { EXPECT_EQ(&scope, dispatcher.scope_); });
+  advance(std::chrono::milliseconds(10));
+  EXPECT_EQ(nullptr, dispatcher.scope_);
+}
+
+TEST_F(TimerWheelTest, DispatcherSharesWheelPerGranularity) {
+  MockFunction<void()> callback1;
+  MockFunction<void()> callback2;
+  auto timer1 = dispatcher_->createCoarseTimer(std::chrono::milliseconds(100),
+                                               callback1.AsStdFunction());
+  auto timer2 = dispatcher_->createCoarseTimer(std::chrono::milliseconds(100),
+                                               callback2.AsStdFunction());
+  timer1->enableTimer(std::chrono::milliseconds(150));
+  timer2->enableTimer(std::chrono::milliseconds(200));
+
+  advance(std::chrono::milliseconds(150));
+  EXPECT_CALL(callback1, Call());
+  EXPECT_CALL(callback2, Call());
+  advance(std::chrono::milliseconds(50));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
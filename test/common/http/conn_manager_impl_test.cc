@@ -2584,6 +2584,32 @@ TEST_F(HttpConnectionManagerImplTest, RequestTimeoutValidlyConfigured) {
   filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+TEST_F(HttpConnectionManagerImplTest, RequestTimeoutUsesCoarseTimerWithGranularity) {
+  request_timeout_ = std::chrono::milliseconds(10);
+  stream_timer_granularity_ = std::chrono::milliseconds(100);
+  setup(false, "");
+
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance&) -> Http::Status {
+    // Ownership of the timer is transferred to the caller of createCoarseTimer_().
+    Event::MockTimer* request_timer = new Event::MockTimer();
+    EXPECT_CALL(filter_callbacks_.connection_.dispatcher_,
+                createCoarseTimer_(std::chrono::milliseconds(100), _))
+        .WillOnce(Return(request_timer));
+    EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createTimer_(_)).Times(0);
+    EXPECT_CALL(*request_timer, enableTimer(request_timeout_, _));
+    EXPECT_CALL(*request_timer, disableTimer());
+
+    conn_manager_->newStream(response_encoder_);
+    return Http::okStatus();
+  }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  expectOnDestroy();
+  filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+}
+
 TEST_F(HttpConnectionManagerImplTest, RequestTimeoutCallbackDisarmsAndReturns408) {
   request_timeout_ = std::chrono::milliseconds(10);
   setup(false, "");
@@ -3219,9 +3245,17 @@ TEST_F(HttpConnectionManagerImplTest, DrainClose) {
   filter->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
   EXPECT_EQ(ssl_connection_.get(), filter->callbacks_->connection()->ssl().get());
 
-  EXPECT_CALL(*codec_, goAway());
-  EXPECT_CALL(filter_callbacks_.connection_,
-              close(Network::ConnectionCloseType::FlushWriteAndDelay));
+  {
+    // Frames the codec holds back are sent before checking whether it still wants to write, and
+    // before the connection is closed.
+    InSequence s;
+    EXPECT_CALL(*codec_, goAway());
+    EXPECT_CALL(*codec_, flushPendingWrites());
+    EXPECT_CALL(*codec_, wantsToWrite()).WillOnce(Return(false));
+    EXPECT_CALL(*codec_, flushPendingWrites());
+    EXPECT_CALL(filter_callbacks_.connection_,
+                close(Network::ConnectionCloseType::FlushWriteAndDelay));
+  }
   EXPECT_CALL(*drain_timer, disableTimer());
   drain_timer->invokeCallback();
 
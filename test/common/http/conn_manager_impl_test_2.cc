@@ -1,3 +1,5 @@
+#include "common/buffer/watermark_buffer.h"
+
 #include "test/common/http/conn_manager_impl_test_base.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/test_runtime.h"
@@ -2136,6 +2138,51 @@ TEST_F(HttpConnectionManagerImplTest, DisableHttp1KeepAliveWhenOverloaded) {
   EXPECT_EQ(1U, stats_.named_.downstream_cx_overload_disable_keepalive_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, ReduceBufferLimitsWhenOverloaded) {
+  Server::OverloadActionState reduce_buffer_limits(UnitFloat(0.5));
+  ON_CALL(overload_manager_.overload_state_,
+          getState(Server::OverloadActionNames::get().ReduceBufferLimits))
+      .WillByDefault(ReturnRef(reduce_buffer_limits));
+
+  initial_buffer_limit_ = 1024 * 1024;
+  setup(false, "");
+  setUpEncoderAndDecoder(false, false);
+  sendRequestHeadersAndData();
+
+  // New streams start with half of the connection buffer limit.
+  EXPECT_EQ(512U * 1024, decoder_filters_[0]->callbacks_->decoderBufferLimit());
+  EXPECT_EQ(512U * 1024, encoder_filters_[0]->callbacks_->encoderBufferLimit());
+
+  doRemoteClose();
+}
+
+TEST_F(HttpConnectionManagerImplTest, ResetStreamWhenMemoryAccountIsReset) {
+  setup(false, "");
+  setupFilterChain(1, 0);
+
+  auto account = std::make_shared<NiceMock<MockBufferMemoryAccount>>();
+  Buffer::BufferMemoryAccountSharedPtr account_ptr = account;
+  std::function<void()> reset_stream;
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_.buffer_factory_, createAccount(_))
+      .WillOnce(Invoke([&](std::function<void()> cb) -> Buffer::BufferMemoryAccountSharedPtr {
+        reset_stream = cb;
+        return account_ptr;
+      }));
+  // The codec stream's buffers are charged to the same account as the filter buffers.
+  EXPECT_CALL(response_encoder_.stream_, setAccount(account_ptr));
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  startRequest(false);
+  EXPECT_EQ(account_ptr, decoder_filters_[0]->callbacks_->account());
+
+  EXPECT_CALL(response_encoder_.stream_, resetStream(_));
+  EXPECT_CALL(*account, clearDownstream());
+  expectOnDestroy();
+  reset_stream();
+
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_tx_reset_.value());
+}
+
 class DrainH2HttpConnectionManagerImplTest : public HttpConnectionManagerImplTest,
                                              public testing::WithParamInterface<bool> {
 public:
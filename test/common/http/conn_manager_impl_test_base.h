@@ -90,6 +90,9 @@ public:
   absl::optional<std::chrono::milliseconds> maxStreamDuration() const override {
     return max_stream_duration_;
   }
+  std::chrono::milliseconds streamTimerGranularity() const override {
+    return stream_timer_granularity_;
+  }
   bool use_srds_{};
   Router::RouteConfigProvider* routeConfigProvider() override {
     if (use_srds_) {
@@ -174,6 +177,7 @@ public:
   std::chrono::milliseconds stream_idle_timeout_{};
   std::chrono::milliseconds request_timeout_{};
   std::chrono::milliseconds request_headers_timeout_{};
+  std::chrono::milliseconds stream_timer_granularity_{};
   std::chrono::milliseconds delayed_close_timeout_{};
   absl::optional<std::chrono::milliseconds> max_stream_duration_{};
   NiceMock<Random::MockRandomGenerator> random_;
@@ -0,0 +1,72 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures what timing a filter callback costs the filter manager: with no latency recorder, which
+// is the case unless filter latency is configured and the stream is sampled, with a recorder, and
+// with a recorder that also measures the thread CPU time.
+
+#include <chrono>
+
+#include "common/common/macros.h"
+#include "common/event/real_time_system.h"
+#include "common/http/filter_latency.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class SummingRecorder : public FilterLatencyRecorder {
+public:
+  explicit SummingRecorder(bool record_cpu_time) : record_cpu_time_(record_cpu_time) {}
+
+  // Http::FilterLatencyRecorder
+  bool recordsCpuTime() const override { return record_cpu_time_; }
+  void recordDecode(std::chrono::microseconds duration,
+                    std::chrono::microseconds cpu_time) override {
+    total_ += duration + cpu_time;
+  }
+  void recordEncode(std::chrono::microseconds duration,
+                    std::chrono::microseconds cpu_time) override {
+    total_ += duration + cpu_time;
+  }
+
+  std::chrono::microseconds total_{0};
+
+private:
+  const bool record_cpu_time_;
+};
+
+void timeCallbacks(benchmark::State& state, FilterLatencyRecorder* recorder) {
+  Event::RealTimeSystem time_system;
+  uint64_t calls = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    FilterLatencyTimer timer(recorder, time_system, /* encode = */ false);
+    benchmark::DoNotOptimize(++calls);
+  }
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmUntimedFilterCallback(benchmark::State& state) { timeCallbacks(state, nullptr); }
+BENCHMARK(bmUntimedFilterCallback);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmTimedFilterCallback(benchmark::State& state) {
+  SummingRecorder recorder(false);
+  timeCallbacks(state, &recorder);
+}
+BENCHMARK(bmTimedFilterCallback);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmTimedFilterCallbackWithCpuTime(benchmark::State& state) {
+  SummingRecorder recorder(true);
+  timeCallbacks(state, &recorder);
+}
+BENCHMARK(bmTimedFilterCallbackWithCpuTime);
+
+} // namespace Http
+} // namespace Envoy
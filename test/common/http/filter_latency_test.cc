@@ -0,0 +1,146 @@
+#include <chrono>
+
+#include "common/http/filter_latency.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::NiceMock;
+using testing::Property;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class FilterLatencyTimerTest : public testing::Test {
+protected:
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<MockFilterLatencyRecorder> recorder_;
+};
+
+TEST_F(FilterLatencyTimerTest, RecordsDecodeTime) {
+  EXPECT_CALL(recorder_, recordDecode(std::chrono::microseconds(5000),
+                                      std::chrono::microseconds(0)));
+  {
+    FilterLatencyTimer timer(&recorder_, time_system_, /* encode = */ false);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(5));
+  }
+}
+
+TEST_F(FilterLatencyTimerTest, RecordsEncodeTime) {
+  EXPECT_CALL(recorder_, recordEncode(std::chrono::microseconds(250),
+                                      std::chrono::microseconds(0)));
+  {
+    FilterLatencyTimer timer(&recorder_, time_system_, /* encode = */ true);
+    time_system_.advanceTimeWait(std::chrono::microseconds(250));
+  }
+}
+
+TEST_F(FilterLatencyTimerTest, RecordsCpuTime) {
+  ON_CALL(recorder_, recordsCpuTime()).WillByDefault(Return(true));
+  std::chrono::microseconds cpu_time{-1};
+  EXPECT_CALL(recorder_, recordDecode(_, _))
+      .WillOnce(testing::SaveArg<1>(&cpu_time));
+  {
+    FilterLatencyTimer timer(&recorder_, time_system_, /* encode = */ false);
+  }
+  EXPECT_GE(cpu_time.count(), 0);
+}
+
+// A callback run from within another callback pauses the outer callback's timer, so that each is
+// only charged for its own time.
+TEST_F(FilterLatencyTimerTest, NestedTimersPauseOuterTimer) {
+  NiceMock<MockFilterLatencyRecorder> inner_recorder;
+  EXPECT_CALL(recorder_, recordDecode(std::chrono::microseconds(6000),
+                                      std::chrono::microseconds(0)));
+  EXPECT_CALL(inner_recorder, recordEncode(std::chrono::microseconds(2000),
+                                           std::chrono::microseconds(0)));
+  {
+    FilterLatencyTimer timer(&recorder_, time_system_, /* encode = */ false);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(5));
+    {
+      FilterLatencyTimer inner_timer(&inner_recorder, time_system_, /* encode = */ true);
+      time_system_.advanceTimeWait(std::chrono::milliseconds(2));
+      // An untimed callback is charged to the callback running it.
+      FilterLatencyTimer untimed_timer(nullptr, time_system_, /* encode = */ true);
+    }
+    time_system_.advanceTimeWait(std::chrono::milliseconds(1));
+  }
+
+  // The timers are unwound, so the next callback is timed on its own.
+  EXPECT_CALL(recorder_, recordDecode(std::chrono::microseconds(3000),
+                                      std::chrono::microseconds(0)));
+  {
+    FilterLatencyTimer timer(&recorder_, time_system_, /* encode = */ false);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(3));
+  }
+}
+
+TEST(FilterLatencyTimer, ThreadCpuTimeAdvances) {
+  const std::chrono::nanoseconds start = FilterLatencyTimer::threadCpuTime();
+  volatile uint64_t sum = 0;
+  while (FilterLatencyTimer::threadCpuTime() == start) {
+    sum = sum + 1;
+  }
+  EXPECT_GT(FilterLatencyTimer::threadCpuTime(), start);
+}
+
+TEST(FilterLatencyRecorderImplTest, RecordsHistograms) {
+  NiceMock<Stats::MockStore> store;
+  FilterLatencyRecorderImpl recorder("http.test.filter_latency.envoy.filters.http.router.", store,
+                                     /* record_cpu_time = */ true);
+  EXPECT_TRUE(recorder.recordsCpuTime());
+
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name,
+                                  "http.test.filter_latency.envoy.filters.http.router.decode_time"),
+                         10));
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name,
+                           "http.test.filter_latency.envoy.filters.http.router.decode_cpu_time"),
+                  4));
+  recorder.recordDecode(std::chrono::microseconds(10), std::chrono::microseconds(4));
+
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name,
+                                  "http.test.filter_latency.envoy.filters.http.router.encode_time"),
+                         7));
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(
+                  Property(&Stats::Metric::name,
+                           "http.test.filter_latency.envoy.filters.http.router.encode_cpu_time"),
+                  3));
+  recorder.recordEncode(std::chrono::microseconds(7), std::chrono::microseconds(3));
+}
+
+TEST(FilterLatencyRecorderImplTest, SkipsCpuTimeUnlessEnabled) {
+  NiceMock<Stats::MockStore> store;
+  EXPECT_CALL(store, histogram(_, _)).Times(AnyNumber());
+  EXPECT_CALL(store, histogram("http.test.filter_latency.foo.decode_cpu_time", _)).Times(0);
+  EXPECT_CALL(store, histogram("http.test.filter_latency.foo.encode_cpu_time", _)).Times(0);
+  FilterLatencyRecorderImpl recorder("http.test.filter_latency.foo.", store,
+                                     /* record_cpu_time = */ false);
+  EXPECT_FALSE(recorder.recordsCpuTime());
+
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name, "http.test.filter_latency.foo.decode_time"),
+                         10));
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         Property(&Stats::Metric::name,
+                                  "http.test.filter_latency.foo.decode_cpu_time"),
+                         _))
+      .Times(0);
+  recorder.recordDecode(std::chrono::microseconds(10), std::chrono::microseconds(0));
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
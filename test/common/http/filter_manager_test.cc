@@ -30,7 +30,7 @@ public:
     filter_manager_ = std::make_unique<FilterManager>(
         filter_manager_callbacks_, dispatcher_, connection_, 0, true, 10000, filter_factory_,
         local_reply_, protocol_, time_source_, filter_state_,
-        StreamInfo::FilterState::LifeSpan::Connection);
+        StreamInfo::FilterState::LifeSpan::Connection, nullptr);
   }
 
   std::unique_ptr<FilterManager> filter_manager_;
@@ -545,6 +545,81 @@ TEST_F(FilterManagerTest, MultipleOnLocalReply) {
   filter_manager_->destroyFilters();
 }
 
+// Verifies that only the callbacks of the filters added with a latency recorder are timed.
+TEST_F(FilterManagerTest, RecordsFilterLatency) {
+  initialize();
+
+  std::shared_ptr<MockStreamDecoderFilter> timed_filter(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamDecoderFilter> untimed_filter(new NiceMock<MockStreamDecoderFilter>());
+  NiceMock<MockFilterLatencyRecorder> recorder;
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders()).WillByDefault(Return(makeOptRef(*headers)));
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.setFilterLatencyRecorder(&recorder);
+        callbacks.addStreamDecoderFilter(timed_filter);
+        callbacks.setFilterLatencyRecorder(nullptr);
+        callbacks.addStreamDecoderFilter(untimed_filter);
+      }));
+  filter_manager_->createFilterChain();
+  filter_manager_->requestHeadersInitialized();
+
+  EXPECT_CALL(*timed_filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*untimed_filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(recorder, recordDecode(_, std::chrono::microseconds(0)));
+  EXPECT_CALL(recorder, recordEncode(_, _)).Times(0);
+  filter_manager_->decodeHeaders(*headers, true);
+
+  filter_manager_->destroyFilters();
+}
+
+// Verifies that the encoder callbacks of a local reply sent from a decoder callback are timed
+// separately, and not charged to the decoder callback too.
+TEST_F(FilterManagerTest, RecordsFilterLatencyOfLocalReply) {
+  initialize();
+
+  std::shared_ptr<MockStreamFilter> filter(new NiceMock<MockStreamFilter>());
+  NiceMock<MockFilterLatencyRecorder> recorder;
+  MonotonicTime now;
+  ON_CALL(time_source_, monotonicTime()).WillByDefault(testing::ReturnPointee(&now));
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders()).WillByDefault(Return(makeOptRef(*headers)));
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.setFilterLatencyRecorder(&recorder);
+        callbacks.addStreamFilter(filter);
+      }));
+  filter_manager_->createFilterChain();
+  filter_manager_->requestHeadersInitialized();
+
+  EXPECT_CALL(*filter, decodeHeaders(_, true))
+      .WillOnce(Invoke([&](RequestHeaderMap&, bool) -> FilterHeadersStatus {
+        now += std::chrono::milliseconds(5);
+        filter->decoder_callbacks_->sendLocalReply(Code::InternalServerError, "", nullptr,
+                                                   absl::nullopt, "");
+        now += std::chrono::milliseconds(1);
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(*filter, encodeHeaders(_, true))
+      .WillOnce(Invoke([&](ResponseHeaderMap&, bool) -> FilterHeadersStatus {
+        now += std::chrono::milliseconds(2);
+        return FilterHeadersStatus::Continue;
+      }));
+  EXPECT_CALL(recorder, recordDecode(std::chrono::microseconds(6000), _));
+  EXPECT_CALL(recorder, recordEncode(std::chrono::microseconds(2000), _));
+  filter_manager_->decodeHeaders(*headers, true);
+
+  filter_manager_->destroyFilters();
+}
+
 } // namespace
 } // namespace Http
 } // namespace Envoy
@@ -0,0 +1,68 @@
+#include <chrono>
+
+#include "common/http/http2/bdp_estimator.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+class BdpEstimatorTest : public ::testing::Test {
+public:
+  // Measures a round trip during which the supplied bytes are received.
+  absl::optional<uint64_t> roundTrip(uint64_t bytes, std::chrono::milliseconds duration) {
+    EXPECT_TRUE(estimator_.onDataReceived(1));
+    estimator_.onPingSent(now_);
+    EXPECT_FALSE(estimator_.onDataReceived(bytes));
+    now_ += duration;
+    return estimator_.onPingAck(now_);
+  }
+
+  BdpEstimator estimator_{65535};
+  MonotonicTime now_;
+};
+
+TEST_F(BdpEstimatorTest, PingOutstanding) {
+  EXPECT_FALSE(estimator_.pingOutstanding());
+  EXPECT_TRUE(estimator_.onDataReceived(100));
+  estimator_.onPingSent(now_);
+  EXPECT_TRUE(estimator_.pingOutstanding());
+  EXPECT_FALSE(estimator_.onDataReceived(100));
+  estimator_.onPingAck(now_ + std::chrono::milliseconds(10));
+  EXPECT_FALSE(estimator_.pingOutstanding());
+}
+
+TEST_F(BdpEstimatorTest, GrowsWhenRoundTripFillsEstimate) {
+  EXPECT_EQ(131070U, roundTrip(60000, std::chrono::milliseconds(10)));
+  EXPECT_EQ(131070U, estimator_.estimate());
+  // More bytes than twice the estimate become the estimate.
+  EXPECT_EQ(1000000U, roundTrip(1000000, std::chrono::milliseconds(10)));
+}
+
+TEST_F(BdpEstimatorTest, NoGrowthBelowTwoThirdsOfEstimate) {
+  EXPECT_EQ(absl::nullopt, roundTrip(40000, std::chrono::milliseconds(10)));
+  EXPECT_EQ(65535U, estimator_.estimate());
+}
+
+TEST_F(BdpEstimatorTest, NoGrowthWithoutBandwidthIncrease) {
+  EXPECT_EQ(131070U, roundTrip(60000, std::chrono::milliseconds(10)));
+  // Filling the larger estimate over a much longer round trip means the bandwidth didn't grow.
+  EXPECT_EQ(absl::nullopt, roundTrip(120000, std::chrono::milliseconds(100)));
+  // A zero round trip measures no bandwidth.
+  EXPECT_EQ(absl::nullopt, roundTrip(120000, std::chrono::milliseconds(0)));
+  EXPECT_EQ(131070U, estimator_.estimate());
+}
+
+// Bytes received before the PING was sent don't count towards the round trip.
+TEST_F(BdpEstimatorTest, BytesBeforePingIgnored) {
+  EXPECT_TRUE(estimator_.onDataReceived(1000000));
+  estimator_.onPingSent(now_);
+  EXPECT_EQ(absl::nullopt, estimator_.onPingAck(now_ + std::chrono::milliseconds(10)));
+}
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
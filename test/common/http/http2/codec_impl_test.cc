@@ -23,6 +23,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -374,6 +375,32 @@ TEST_P(Http2CodecImplTest, ProtocolErrorForTest) {
 }
 
 // 100 response followed by 200 results in a [decode100ContinueHeaders, decodeHeaders] sequence.
+// Verify that header names and values decoded from the HPACK static table reference the table
+// instead of being copied.
+TEST_P(Http2CodecImplTest, StaticTableHeadersReferenced) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers{{"accept-language", "en"}, {"x-custom", "value"}};
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true))
+      .WillOnce(Invoke([](RequestHeaderMapPtr& headers, bool) -> void {
+        EXPECT_TRUE(headers->Method()->value().isReference());
+        EXPECT_TRUE(headers->Path()->value().isReference());
+        EXPECT_FALSE(headers->Host()->value().isReference());
+
+        const auto accept_language = headers->get(LowerCaseString("accept-language"));
+        ASSERT_EQ(1, accept_language.size());
+        EXPECT_TRUE(accept_language[0]->key().isReference());
+        EXPECT_FALSE(accept_language[0]->value().isReference());
+
+        const auto custom = headers->get(LowerCaseString("x-custom"));
+        ASSERT_EQ(1, custom.size());
+        EXPECT_FALSE(custom[0]->key().isReference());
+        EXPECT_EQ("value", custom[0]->value().getStringView());
+      }));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+}
+
 TEST_P(Http2CodecImplTest, ContinueHeaders) {
   initialize();
 
@@ -2955,6 +2982,228 @@ TEST_F(Http2CodecMetadataTest, UnknownStreamId) {
   EXPECT_TRUE(client_->submitMetadata(metadata_vector, 1000));
 }
 
+class Http2CodecCoalesceFrameWritesTest : public Http2CodecImplTestFixture,
+                                          public ::testing::Test {
+protected:
+  void initialize() override {
+    server_http2_options_.set_coalesce_frame_writes(true);
+    deferred_send_ = new NiceMock<Event::MockSchedulableCallback>(&server_connection_.dispatcher_);
+    Http2CodecImplTestFixture::initialize();
+    ON_CALL(server_connection_, write(_, _))
+        .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void {
+          ++server_writes_;
+          ASSERT_TRUE(client_wrapper_.dispatch(data, *client_).ok());
+        }));
+  }
+
+  NiceMock<Event::MockSchedulableCallback>* deferred_send_{};
+  uint32_t server_writes_{};
+};
+
+// Verify that the frames of several responses encoded in the same event loop iteration are sent in
+// a single write at the end of the iteration.
+TEST_F(Http2CodecCoalesceFrameWritesTest, ResponsesWrittenOncePerIteration) {
+  initialize();
+
+  std::vector<ResponseEncoder*> response_encoders;
+  EXPECT_CALL(server_callbacks_, newStream(_, _))
+      .WillRepeatedly(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoders.push_back(&encoder);
+        return request_decoder_;
+      }));
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true)).Times(3);
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  MockResponseDecoder response_decoder2;
+  MockResponseDecoder response_decoder3;
+  EXPECT_TRUE(client_->newStream(response_decoder2).encodeHeaders(request_headers, true).ok());
+  EXPECT_TRUE(client_->newStream(response_decoder3).encodeHeaders(request_headers, true).ok());
+  ASSERT_EQ(3U, response_encoders.size());
+
+  // Frames sent in response to dispatched data are not deferred.
+  EXPECT_FALSE(deferred_send_->enabled_);
+  server_writes_ = 0;
+
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  for (ResponseEncoder* response_encoder : response_encoders) {
+    response_encoder->encodeHeaders(response_headers, false);
+    Buffer::OwnedImpl data("hello");
+    response_encoder->encodeData(data, true);
+  }
+  EXPECT_TRUE(deferred_send_->enabled_);
+  EXPECT_EQ(0U, server_writes_);
+
+  for (MockResponseDecoder* response_decoder :
+       {&response_decoder_, &response_decoder2, &response_decoder3}) {
+    EXPECT_CALL(*response_decoder, decodeHeaders_(_, false));
+    EXPECT_CALL(*response_decoder, decodeData(_, true));
+  }
+  deferred_send_->invokeCallback();
+  EXPECT_EQ(1U, server_writes_);
+}
+
+// Verify that flushPendingWrites() sends the frames queued in the current event loop iteration,
+// including those ending or resetting a stream, so that they are written before the connection is
+// closed.
+TEST_F(Http2CodecCoalesceFrameWritesTest, FlushPendingWritesBeforeClose) {
+  initialize();
+
+  std::vector<ResponseEncoder*> response_encoders;
+  EXPECT_CALL(server_callbacks_, newStream(_, _))
+      .WillRepeatedly(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoders.push_back(&encoder);
+        return request_decoder_;
+      }));
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true)).Times(2);
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  MockResponseDecoder response_decoder2;
+  RequestEncoder& request_encoder2 = client_->newStream(response_decoder2);
+  EXPECT_TRUE(request_encoder2.encodeHeaders(request_headers, true).ok());
+  ASSERT_EQ(2U, response_encoders.size());
+  server_writes_ = 0;
+
+  // Neither ending nor resetting a stream sends its frames right away.
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  response_encoders[0]->encodeHeaders(response_headers, true);
+  response_encoders[1]->encodeHeaders(response_headers, false);
+  response_encoders[1]->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_TRUE(deferred_send_->enabled_);
+  EXPECT_EQ(0U, server_writes_);
+
+  MockStreamCallbacks client_stream_callbacks;
+  request_encoder2.getStream().addCallbacks(client_stream_callbacks);
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, true));
+  EXPECT_CALL(response_decoder2, decodeHeaders_(_, false));
+  EXPECT_CALL(client_stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  server_->flushPendingWrites();
+  EXPECT_FALSE(deferred_send_->enabled_);
+  EXPECT_EQ(1U, server_writes_);
+
+  // Nothing is left to send.
+  server_->flushPendingWrites();
+  EXPECT_EQ(1U, server_writes_);
+}
+
+// Verify that GOAWAY is not deferred, and flushes frames queued earlier in the iteration.
+TEST_F(Http2CodecCoalesceFrameWritesTest, GoAwaySentImmediately) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  server_writes_ = 0;
+
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  response_encoder_->encodeHeaders(response_headers, true);
+  EXPECT_TRUE(deferred_send_->enabled_);
+
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, true));
+  EXPECT_CALL(client_callbacks_, onGoAway(_));
+  server_->goAway();
+  EXPECT_FALSE(deferred_send_->enabled_);
+  EXPECT_EQ(1U, server_writes_);
+}
+
+class Http2CodecWindowAutoTuningTest : public Event::TestUsingSimulatedTime,
+                                       public Http2CodecImplTestFixture,
+                                       public ::testing::Test {
+public:
+  Http2CodecWindowAutoTuningTest()
+      : Http2CodecImplTestFixture(SmallWindowSettings, SmallWindowSettings) {}
+
+protected:
+  void initialize() override {
+    auto* window_auto_tuning = server_http2_options_.mutable_window_auto_tuning();
+    window_auto_tuning->mutable_max_connection_window_size()->set_value(1024 * 1024);
+    window_auto_tuning->mutable_max_stream_window_size()->set_value(1024 * 1024);
+    Http2CodecImplTestFixture::initialize();
+  }
+
+  // Holds the frames sent by the client until deliverToServer(), so that the round trip of a PING
+  // sent by the server takes time.
+  void holdClientFrames() {
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(
+            Invoke([&](Buffer::Instance& data, bool) -> void { client_frames_.move(data); }));
+  }
+
+  void deliverToServer() {
+    Buffer::OwnedImpl data;
+    data.move(client_frames_);
+    ASSERT_TRUE(server_wrapper_.dispatch(data, *server_).ok());
+  }
+
+  static constexpr Http2SettingsTuple SmallWindowSettings{
+      CommonUtility::OptionsLimits::DEFAULT_HPACK_TABLE_SIZE,
+      CommonUtility::OptionsLimits::DEFAULT_MAX_CONCURRENT_STREAMS,
+      CommonUtility::OptionsLimits::MIN_INITIAL_STREAM_WINDOW_SIZE,
+      CommonUtility::OptionsLimits::MIN_INITIAL_CONNECTION_WINDOW_SIZE};
+
+  Buffer::OwnedImpl client_frames_;
+};
+
+// Verify that the windows grow when a full window of data arrives within the round trip of a PING.
+TEST_F(Http2CodecWindowAutoTuningTest, WindowsGrowWithBandwidthDelayProduct) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers, "POST");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  holdClientFrames();
+
+  // The server sends a PING upon the first DATA frame, and the client acknowledges it after the
+  // rest of the window.
+  EXPECT_CALL(request_decoder_, decodeData(_, false)).Times(AnyNumber());
+  Buffer::OwnedImpl data(std::string(65535, 'a'));
+  request_encoder_->encodeData(data, false);
+  deliverToServer();
+  EXPECT_EQ(0, server_stats_store_.counter("http2.window_auto_tuning_increases").value());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(50));
+  deliverToServer();
+  EXPECT_EQ(1, server_stats_store_.counter("http2.window_auto_tuning_increases").value());
+  // Twice the estimate, which is twice the initial window.
+  EXPECT_EQ(4 * 65535, nghttp2_session_get_effective_local_window_size(server_->session()));
+  EXPECT_EQ(3 * 65535, server_stats_store_
+                           .gauge("http2.window_auto_tuning_bytes",
+                                  Stats::Gauge::ImportMode::Accumulate)
+                           .value());
+  EXPECT_EQ(4U * 65535, server_->getStream(1)->bufferLimit());
+
+  // The stream window grows once the client acknowledges the new initial window size.
+  deliverToServer();
+  EXPECT_EQ(4 * 65535,
+            nghttp2_session_get_stream_effective_local_window_size(server_->session(), 1));
+}
+
+// Verify that the windows don't grow when less than a window of data arrives per round trip.
+TEST_F(Http2CodecWindowAutoTuningTest, SlowPeerDoesNotGrowWindows) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers, "POST");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  holdClientFrames();
+
+  EXPECT_CALL(request_decoder_, decodeData(_, false)).Times(AnyNumber());
+  for (int i = 0; i < 3; ++i) {
+    Buffer::OwnedImpl data(std::string(1024, 'a'));
+    request_encoder_->encodeData(data, false);
+    deliverToServer();
+    simTime().advanceTimeWait(std::chrono::milliseconds(50));
+  }
+  deliverToServer();
+  EXPECT_EQ(0, server_stats_store_.counter("http2.window_auto_tuning_increases").value());
+  EXPECT_EQ(65535, nghttp2_session_get_effective_local_window_size(server_->session()));
+  EXPECT_EQ(65535U, server_->getStream(1)->bufferLimit());
+}
+
 } // namespace Http2
 } // namespace Http
 } // namespace Envoy
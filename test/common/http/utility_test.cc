@@ -115,6 +115,20 @@ TEST(HttpUtility, isWebSocketUpgradeRequest) {
       TestRequestHeaderMapImpl{{"connection", "Upgrade"}, {"upgrade", "WebSocket"}}));
 }
 
+TEST(HttpUtility, isIdempotentRequest) {
+  EXPECT_FALSE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{}));
+  EXPECT_FALSE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "POST"}}));
+  EXPECT_FALSE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "PATCH"}}));
+  EXPECT_FALSE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "CONNECT"}}));
+
+  EXPECT_TRUE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "GET"}}));
+  EXPECT_TRUE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "HEAD"}}));
+  EXPECT_TRUE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "OPTIONS"}}));
+  EXPECT_TRUE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "TRACE"}}));
+  EXPECT_TRUE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "PUT"}}));
+  EXPECT_TRUE(Utility::isIdempotentRequest(TestRequestHeaderMapImpl{{":method", "DELETE"}}));
+}
+
 TEST(HttpUtility, isUpgrade) {
   EXPECT_FALSE(Utility::isUpgrade(TestRequestHeaderMapImpl{}));
   EXPECT_FALSE(Utility::isUpgrade(TestRequestHeaderMapImpl{{"connection", "upgrade"}}));
@@ -357,6 +371,30 @@ initial_connection_window_size: 65535
   }
 }
 
+TEST(HttpUtility, ValidateHttp2WindowAutoTuning) {
+  // The default initial windows exceed the default maximums of auto-tuning.
+  EXPECT_THROW_WITH_MESSAGE(
+      parseHttp2OptionsFromV3Yaml("window_auto_tuning: {}"), EnvoyException,
+      "window_auto_tuning requires initial_stream_window_size (268435456) and "
+      "initial_connection_window_size (268435456) to not exceed max_stream_window_size "
+      "(16777216) and max_connection_window_size (16777216)");
+
+  EXPECT_THROW_WITH_REGEX(parseHttp2OptionsFromV3Yaml(R"EOF(
+initial_stream_window_size: 65535
+initial_connection_window_size: 1048576
+window_auto_tuning:
+  max_connection_window_size: 65535
+    )EOF"),
+                          EnvoyException, "window_auto_tuning requires");
+
+  const std::string yaml = R"EOF(
+initial_stream_window_size: 65535
+initial_connection_window_size: 65535
+window_auto_tuning: {}
+  )EOF";
+  EXPECT_TRUE(parseHttp2OptionsFromV3Yaml(yaml).has_window_auto_tuning());
+}
+
 TEST(HttpUtility, ValidateStreamErrors) {
   // Both false, the result should be false.
   envoy::config::core::v3::Http2ProtocolOptions http2_options;
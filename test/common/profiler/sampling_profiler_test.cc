@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/profiler/sampling_profiler.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+// Burns CPU for the given time, so the profiler has something to sample.
+void __attribute__((noinline)) spinForProfiler(std::chrono::milliseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  volatile uint64_t sum = 0;
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < 1000; ++i) {
+      sum = sum + i;
+    }
+  }
+}
+
+TEST(SampledStacksTest, Collapsed) {
+  SampledStacks stacks;
+  EXPECT_EQ("", stacks.collapsed());
+
+  std::vector<void*> frames{reinterpret_cast<void*>(&spinForProfiler)};
+  stacks.add(frames);
+  stacks.add(frames);
+  EXPECT_EQ(2, stacks.numSamples());
+  EXPECT_EQ(0, stacks.numDropped());
+
+  const std::string collapsed = stacks.collapsed();
+  const std::vector<std::string> lines = absl::StrSplit(collapsed, '\n', absl::SkipEmpty());
+  ASSERT_EQ(1, lines.size());
+  EXPECT_TRUE(absl::EndsWith(lines[0], " 2")) << lines[0];
+
+  stacks.setNumDropped(3);
+  EXPECT_EQ(collapsed + "[dropped] 3\n", stacks.collapsed());
+}
+
+TEST(SamplingProfilerTest, MaxSamples) {
+  const uint32_t cpus = std::max(1U, std::thread::hardware_concurrency());
+  EXPECT_EQ(11 * cpus, SamplingProfiler::maxSamples(std::chrono::milliseconds(1),
+                                                     std::chrono::milliseconds(10)));
+  EXPECT_EQ(SamplingProfiler::MaxSamples,
+            SamplingProfiler::maxSamples(std::chrono::milliseconds(1), std::chrono::hours(1)));
+}
+
+#ifndef WIN32
+
+TEST(SamplingProfilerTest, SamplesBusyThread) {
+  EXPECT_FALSE(SamplingProfiler::running());
+  ASSERT_TRUE(
+      SamplingProfiler::start(std::chrono::milliseconds(1), std::chrono::milliseconds(200)));
+  EXPECT_TRUE(SamplingProfiler::running());
+  EXPECT_FALSE(
+      SamplingProfiler::start(std::chrono::milliseconds(1), std::chrono::milliseconds(200)));
+
+  spinForProfiler(std::chrono::milliseconds(200));
+  const SampledStacks stacks = SamplingProfiler::stop();
+  EXPECT_FALSE(SamplingProfiler::running());
+  EXPECT_GT(stacks.numSamples(), 0);
+  EXPECT_EQ(0, stacks.numDropped());
+
+  uint64_t total = 0;
+  for (absl::string_view line : absl::StrSplit(stacks.collapsed(), '\n', absl::SkipEmpty())) {
+    const size_t space = line.rfind(' ');
+    ASSERT_NE(absl::string_view::npos, space) << line;
+    uint64_t count;
+    ASSERT_TRUE(absl::SimpleAtoi(line.substr(space + 1), &count)) << line;
+    total += count;
+  }
+  EXPECT_EQ(stacks.numSamples(), total);
+
+  // The profiler can be restarted once stopped.
+  ASSERT_TRUE(
+      SamplingProfiler::start(std::chrono::milliseconds(1), std::chrono::milliseconds(200)));
+  SamplingProfiler::stop();
+}
+
+// Samples beyond the expected duration of the profile are dropped, and counted.
+TEST(SamplingProfilerTest, DropsSamplesPastBuffer) {
+  ASSERT_TRUE(SamplingProfiler::start(std::chrono::milliseconds(1), std::chrono::milliseconds(0)));
+  const uint32_t max_samples =
+      SamplingProfiler::maxSamples(std::chrono::milliseconds(1), std::chrono::milliseconds(0));
+  spinForProfiler(std::chrono::milliseconds(100 * max_samples));
+  const SampledStacks stacks = SamplingProfiler::stop();
+  EXPECT_EQ(max_samples, stacks.numSamples());
+  EXPECT_GT(stacks.numDropped(), 0);
+  EXPECT_TRUE(absl::StrContains(stacks.collapsed(), "[dropped] ")) << stacks.collapsed();
+}
+
+#endif
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
@@ -24,6 +24,7 @@
 #include "common/common/logger.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/socket_option_factory.h"
+#include "common/network/udp_listener_impl.h"
 #include "common/network/udp_packet_writer_handler_impl.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/quic/active_quic_listener.h"
@@ -313,12 +314,53 @@ TEST_P(ActiveQuicListenerTest, FailSocketOptionUponCreation) {
   EXPECT_THROW_WITH_REGEX(
       (void)std::make_unique<ActiveQuicListener>(
           0, 1, *dispatcher_, connection_handler_, listen_socket_, listener_config_, quic_config_,
-          options, false,
+          options,
           ActiveQuicListenerFactoryPeer::runtimeEnabled(
               static_cast<ActiveQuicListenerFactory*>(listener_factory_.get()))),
       Network::CreateListenerException, "Failed to apply socket options.");
 }
 
+// Packets are routed to the worker encoded in the connection ID of their header, and the ones that
+// a worker doesn't own are forwarded.
+TEST_P(ActiveQuicListenerTest, RouteByConnectionId) {
+  quic_listener_.reset();
+  udp_listener_config_.udp_listener_worker_router_ =
+      std::make_unique<Network::UdpListenerWorkerRouterImpl>(4);
+  EXPECT_CALL(listener_config_, filterChainManager()).WillOnce(ReturnRef(filter_chain_manager_));
+  quic_listener_ = std::make_unique<ActiveQuicListener>(
+      1, 4, *dispatcher_, connection_handler_, listen_socket_, listener_config_, quic_config_,
+      nullptr,
+      ActiveQuicListenerFactoryPeer::runtimeEnabled(
+          static_cast<ActiveQuicListenerFactory*>(listener_factory_.get())));
+
+  quic::QuicConnectionId connection_id = quic::test::TestConnectionId(1);
+  encodeWorkerIndexInConnectionId(connection_id, 3, 4);
+
+  Network::UdpRecvData short_header_packet;
+  short_header_packet.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+  short_header_packet.buffer_->writeByte(0x40);
+  short_header_packet.buffer_->add(connection_id.data(), connection_id.length());
+  EXPECT_EQ(3u, quic_listener_->destination(short_header_packet));
+
+  Network::UdpRecvData long_header_packet;
+  long_header_packet.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+  long_header_packet.buffer_->writeByte(0xc0);
+  long_header_packet.buffer_->writeBEInt<uint32_t>(1);
+  long_header_packet.buffer_->writeByte(connection_id.length());
+  long_header_packet.buffer_->add(connection_id.data(), connection_id.length());
+  EXPECT_EQ(3u, quic_listener_->destination(long_header_packet));
+
+  // Packets too short to carry a connection ID stay on the current worker.
+  Network::UdpRecvData short_packet;
+  short_packet.buffer_ = std::make_unique<Buffer::OwnedImpl>("\x40\x01");
+  EXPECT_EQ(1u, quic_listener_->destination(short_packet));
+
+  quic_listener_->onData(std::move(short_header_packet));
+  EXPECT_EQ(1u, listener_config_.listenerScope()
+                    .counterFromString("udp.downstream_rx_datagram_misrouted")
+                    .value());
+}
+
 TEST_P(ActiveQuicListenerTest, ReceiveCHLO) {
   quic::QuicBufferedPacketStore* const buffered_packets =
       quic::test::QuicDispatcherPeer::GetBufferedPackets(quic_dispatcher_);
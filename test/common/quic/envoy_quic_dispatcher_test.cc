@@ -83,7 +83,8 @@ public:
             std::make_unique<EnvoyQuicConnectionHelper>(*dispatcher_),
             std::make_unique<EnvoyQuicAlarmFactory>(*dispatcher_, *connection_helper_.GetClock()),
             quic::kQuicDefaultConnectionIdLength, connection_handler_, listener_config_,
-            listener_stats_, per_worker_stats_, *dispatcher_, *listen_socket_),
+            listener_stats_, per_worker_stats_, *dispatcher_, *listen_socket_,
+            /*worker_index=*/1, /*concurrency=*/3),
         connection_id_(quic::test::TestConnectionId(1)) {
     auto writer = new testing::NiceMock<quic::test::MockPacketWriter>();
     envoy_quic_dispatcher_.InitializeWithWriter(writer);
@@ -257,5 +258,19 @@ TEST_P(EnvoyQuicDispatcherTest, CreateNewConnectionUponBufferedCHLO) {
   processValidChloPacketAndInitializeFilters(true);
 }
 
+// Client chosen connection IDs of an unexpected length are replaced by IDs which route the
+// packets of the connection to the worker that received its first packet.
+TEST_P(EnvoyQuicDispatcherTest, ReplacedConnectionIdEncodesWorkerIndex) {
+  const std::string id_bytes(20, '\xff');
+  const quic::QuicConnectionId long_connection_id(id_bytes.data(), id_bytes.size());
+  const quic::QuicConnectionId new_connection_id =
+      envoy_quic_dispatcher_.GenerateNewServerConnectionId(quic_version_, long_connection_id);
+  EXPECT_EQ(quic::kQuicDefaultConnectionIdLength, new_connection_id.length());
+  EXPECT_EQ(1u, connectionIdWorkerIndex(new_connection_id, 3));
+  // The replacement is deterministic, so that retransmitted packets are handled consistently.
+  EXPECT_EQ(new_connection_id,
+            envoy_quic_dispatcher_.GenerateNewServerConnectionId(quic_version_, long_connection_id));
+}
+
 } // namespace Quic
 } // namespace Envoy
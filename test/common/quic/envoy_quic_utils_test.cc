@@ -109,5 +109,21 @@ TEST(EnvoyQuicUtilsTest, HeadersConversion) {
             quicHeadersToEnvoyHeaders<Http::RequestHeaderMapImpl>(quic_headers2, validator));
 }
 
+TEST(EnvoyQuicUtilsTest, WorkerIndexInConnectionId) {
+  for (uint64_t id : std::vector<uint64_t>{0, 1, 0x1234567890abcdef, 0xffffffff00000000,
+                                           0xffffffffffffffff}) {
+    for (uint32_t concurrency : {1u, 2u, 3u, 7u, 8u}) {
+      for (uint32_t worker_index = 0; worker_index < concurrency; ++worker_index) {
+        quic::QuicConnectionId connection_id = quic::test::TestConnectionId(id);
+        encodeWorkerIndexInConnectionId(connection_id, worker_index, concurrency);
+        EXPECT_EQ(worker_index, connectionIdWorkerIndex(connection_id, concurrency));
+        // Only the bytes routed on are rewritten.
+        EXPECT_EQ(0, memcmp(connection_id.data() + 4,
+                            quic::test::TestConnectionId(id).data() + 4, 4));
+      }
+    }
+  }
+}
+
 } // namespace Quic
 } // namespace Envoy
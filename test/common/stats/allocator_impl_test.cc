@@ -1,10 +1,12 @@
 #include <string>
+#include <vector>
 
 #include "common/stats/allocator_impl.h"
 
 #include "test/test_common/logging.h"
 #include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "gtest/gtest.h"
 
@@ -72,6 +74,100 @@ TEST_F(AllocatorImplTest, GaugesWithSameName) {
   EXPECT_EQ(0, g2->value());
 }
 
+// Stats are carved out of slabs, so allocate enough of each kind to span several slabs, and check
+// that each stat keeps its own name and value, and that freed slots are reused safely.
+TEST_F(AllocatorImplTest, ManyStats) {
+  const uint32_t num_stats = 1000;
+  std::vector<CounterSharedPtr> counters;
+  std::vector<GaugeSharedPtr> gauges;
+  std::vector<TextReadoutSharedPtr> text_readouts;
+  for (uint32_t i = 0; i < num_stats; ++i) {
+    const std::string suffix = absl::StrCat(i);
+    counters.push_back(alloc_.makeCounter(makeStat("counter." + suffix), StatName(), {}));
+    counters.back()->add(i);
+    gauges.push_back(alloc_.makeGauge(makeStat("gauge." + suffix), StatName(), {},
+                                      Gauge::ImportMode::Accumulate));
+    gauges.back()->set(i);
+    text_readouts.push_back(alloc_.makeTextReadout(makeStat("text." + suffix), StatName(), {}));
+    text_readouts.back()->set(suffix);
+  }
+  for (uint32_t i = 0; i < num_stats; ++i) {
+    const std::string suffix = absl::StrCat(i);
+    EXPECT_EQ("counter." + suffix, counters[i]->name());
+    EXPECT_EQ(i, counters[i]->value());
+    EXPECT_EQ("gauge." + suffix, gauges[i]->name());
+    EXPECT_EQ(i, gauges[i]->value());
+    EXPECT_EQ("text." + suffix, text_readouts[i]->name());
+    EXPECT_EQ(suffix, text_readouts[i]->value());
+    EXPECT_EQ(&symbol_table_, &counters[i]->symbolTable());
+  }
+
+  // Free every other counter, and re-create them from scratch in the freed slots.
+  for (uint32_t i = 0; i < num_stats; i += 2) {
+    counters[i].reset();
+  }
+  for (uint32_t i = 0; i < num_stats; i += 2) {
+    counters[i] = alloc_.makeCounter(makeStat(absl::StrCat("counter.", i)), StatName(), {});
+    EXPECT_EQ(0, counters[i]->value());
+    EXPECT_EQ(i + 1, counters[i + 1]->value());
+  }
+}
+
+// Increments from many threads land in different shards, and are all counted.
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  StatName counter_name = makeStat("counter.name");
+  CounterSharedPtr counter = alloc_.makeShardedCounter(counter_name, StatName(), {});
+  EXPECT_EQ(counter.get(), alloc_.makeCounter(counter_name, StatName(), {}).get());
+  EXPECT_EQ(counter.get(), alloc_.makeShardedCounter(counter_name, StatName(), {}).get());
+  EXPECT_FALSE(counter->used());
+
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  const uint32_t num_threads = 12;
+  const uint32_t iters = 10000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        counter->inc();
+      }
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+  EXPECT_TRUE(counter->used());
+  EXPECT_EQ(num_threads * iters, counter->value());
+  EXPECT_EQ(num_threads * iters, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+}
+
+// Resetting a sharded counter rebases both its value and its latch.
+TEST_F(AllocatorImplTest, ShardedCounterLatchAfterReset) {
+  CounterSharedPtr counter = alloc_.makeShardedCounter(makeStat("counter.name"), StatName(), {});
+  counter->add(7);
+  EXPECT_EQ(7, counter->latch());
+
+  counter->add(10);
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+  EXPECT_EQ(0, counter->latch());
+
+  counter->add(5);
+  EXPECT_EQ(5, counter->value());
+  EXPECT_EQ(5, counter->latch());
+  EXPECT_EQ(0, counter->latch());
+
+  // Resetting right after a latch leaves nothing pending either.
+  counter->add(3);
+  EXPECT_EQ(3, counter->latch());
+  counter->reset();
+  EXPECT_EQ(0, counter->value());
+  EXPECT_EQ(0, counter->latch());
+}
+
 // Test for a race-condition where we may decrement the ref-count of a stat to
 // zero at the same time as we are allocating another instance of that
 // stat. This test reproduces that race organically by having a 12 threads each
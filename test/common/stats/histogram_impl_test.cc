@@ -95,5 +95,37 @@ TEST_F(HistogramSettingsImplTest, Priority) {
   EXPECT_EQ(settings_->buckets("abcd"), ConstSupportedBuckets({1, 2}));
 }
 
+TEST_F(HistogramSettingsImplTest, RelativeError) {
+  initialize();
+  EXPECT_EQ(absl::nullopt, settings_->relativeError());
+
+  envoy::config::metrics::v3::StatsConfig config;
+  config.mutable_histogram_relative_error()->set_value(0.01);
+  settings_ = std::make_unique<HistogramSettingsImpl>(config);
+  EXPECT_EQ(0.01, settings_->relativeError());
+}
+
+// Test that the statistics of a log-linear histogram are computed from its buckets.
+TEST(HistogramStatisticsImplTest, LogLinearHistogram) {
+  LogLinearHistogram histogram(7);
+  for (uint64_t value = 1; value <= 100; ++value) {
+    histogram.recordValue(value);
+  }
+  const ConstSupportedBuckets buckets{10, 50, 1000};
+  HistogramStatisticsImpl statistics(histogram, buckets);
+  EXPECT_EQ(100, statistics.sampleCount());
+  EXPECT_EQ(5050, statistics.sampleSum());
+  // Each value v is counted in the bucket [v, v + 1), within which quantiles are interpolated.
+  EXPECT_EQ("P0: 1, P25: 26, P50: 51, P75: 76, P90: 91, P95: 96, P99: 100, P99.5: 100.5, "
+            "P99.9: 100.9, P100: 101",
+            statistics.quantileSummary());
+  EXPECT_EQ("B10: 9, B50: 49, B1000: 100", statistics.bucketSummary());
+
+  histogram.clear();
+  statistics.refresh(histogram);
+  EXPECT_EQ(0, statistics.sampleCount());
+  EXPECT_EQ("B10: 0, B50: 0, B1000: 0", statistics.bucketSummary());
+}
+
 } // namespace Stats
 } // namespace Envoy
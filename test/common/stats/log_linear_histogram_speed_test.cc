@@ -0,0 +1,123 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+//
+// Compares the costs of recording values in circllhist and log-linear histograms, and of merging
+// the histograms of several threads as the stats flush does.
+
+#include <vector>
+
+#include "common/common/macros.h"
+#include "common/common/random_generator.h"
+#include "common/stats/log_linear_histogram.h"
+
+#include "benchmark/benchmark.h"
+#include "circllhist.h"
+
+namespace {
+
+// Values spread over four orders of magnitude, like the latencies of upstream requests in ms.
+std::vector<uint64_t> makeValues(size_t count) {
+  Envoy::Random::RandomGeneratorImpl random;
+  std::vector<uint64_t> values;
+  values.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    values.push_back(1 + random.random() % 10 * (1 + random.random() % 1000));
+  }
+  return values;
+}
+
+constexpr uint32_t PrecisionBits = 7; // 1% relative error.
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmCircllhistRecord(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeValues(1000);
+  histogram_t* histogram = hist_alloc();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint64_t value : values) {
+      hist_insert_intscale(histogram, value, 0, 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  hist_free(histogram);
+}
+BENCHMARK(bmCircllhistRecord);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmLogLinearRecord(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeValues(1000);
+  Envoy::Stats::LogLinearHistogram histogram(PrecisionBits);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (uint64_t value : values) {
+      histogram.recordValue(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(bmLogLinearRecord);
+
+// Merges the histograms of state.range(0) threads into an interval histogram, and the interval
+// histogram into a cumulative one, clearing the thread histograms as ParentHistogramImpl does.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmCircllhistMerge(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeValues(1000);
+  std::vector<histogram_t*> thread_histograms;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    thread_histograms.push_back(hist_alloc());
+  }
+  histogram_t* interval = hist_alloc();
+  histogram_t* cumulative = hist_alloc();
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    for (histogram_t* histogram : thread_histograms) {
+      for (uint64_t value : values) {
+        hist_insert_intscale(histogram, value, 0, 1);
+      }
+    }
+    state.ResumeTiming();
+    hist_clear(interval);
+    for (histogram_t*& histogram : thread_histograms) {
+      hist_accumulate(interval, &histogram, 1);
+      hist_clear(histogram);
+    }
+    hist_accumulate(cumulative, &interval, 1);
+  }
+  for (histogram_t* histogram : thread_histograms) {
+    hist_free(histogram);
+  }
+  hist_free(interval);
+  hist_free(cumulative);
+}
+BENCHMARK(bmCircllhistMerge)->Arg(1)->Arg(8)->Arg(32);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmLogLinearMerge(benchmark::State& state) {
+  const std::vector<uint64_t> values = makeValues(1000);
+  std::vector<Envoy::Stats::LogLinearHistogram> thread_histograms(
+      state.range(0), Envoy::Stats::LogLinearHistogram(PrecisionBits));
+  Envoy::Stats::LogLinearHistogram interval(PrecisionBits);
+  Envoy::Stats::LogLinearHistogram cumulative(PrecisionBits);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    for (Envoy::Stats::LogLinearHistogram& histogram : thread_histograms) {
+      for (uint64_t value : values) {
+        histogram.recordValue(value);
+      }
+    }
+    state.ResumeTiming();
+    interval.clear();
+    for (Envoy::Stats::LogLinearHistogram& histogram : thread_histograms) {
+      interval.merge(histogram);
+      histogram.clear();
+    }
+    cumulative.merge(interval);
+  }
+}
+BENCHMARK(bmLogLinearMerge)->Arg(1)->Arg(8)->Arg(32);
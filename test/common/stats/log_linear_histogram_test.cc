@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <limits>
+
+#include "common/stats/log_linear_histogram.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+TEST(LogLinearHistogramTest, PrecisionBits) {
+  EXPECT_EQ(1, LogLinearHistogram::precisionBits(0.5));
+  EXPECT_EQ(1, LogLinearHistogram::precisionBits(0.9));
+  EXPECT_EQ(7, LogLinearHistogram::precisionBits(0.01));
+  EXPECT_EQ(10, LogLinearHistogram::precisionBits(0.001));
+}
+
+TEST(LogLinearHistogramTest, Empty) {
+  LogLinearHistogram histogram(7);
+  EXPECT_EQ(0, histogram.sampleCount());
+  EXPECT_EQ(0, histogram.sampleSum());
+  EXPECT_EQ(0, histogram.quantile(0.5));
+  EXPECT_EQ(0, histogram.countBelow(100));
+}
+
+// Values below 2^precision_bits are counted exactly.
+TEST(LogLinearHistogramTest, SmallValuesExact) {
+  LogLinearHistogram histogram(4);
+  for (uint64_t value = 0; value < 16; ++value) {
+    histogram.recordValue(value);
+  }
+  EXPECT_EQ(16, histogram.sampleCount());
+  EXPECT_EQ(120, histogram.sampleSum());
+  EXPECT_EQ(0, histogram.quantile(0));
+  EXPECT_EQ(8, histogram.quantile(0.5));
+  EXPECT_EQ(16, histogram.quantile(1));
+  EXPECT_EQ(0, histogram.countBelow(0.5));
+  EXPECT_EQ(5, histogram.countBelow(5));
+}
+
+// Each value falls in a bucket starting at most at the value, and at most a fraction
+// 2^-precision_bits of its lower bound wide.
+TEST(LogLinearHistogramTest, RelativeError) {
+  for (uint32_t precision_bits : {1, 4, 7}) {
+    for (uint64_t value : std::vector<uint64_t>{1, 100, 1000, 65535, 65536, 1000000007,
+                                                std::numeric_limits<uint64_t>::max()}) {
+      LogLinearHistogram histogram(precision_bits);
+      histogram.recordValue(value);
+      const double lower = histogram.quantile(0);
+      const double upper = histogram.quantile(1);
+      EXPECT_LE(lower, value);
+      EXPECT_GT(upper, static_cast<double>(value) * (1 - 1e-15));
+      EXPECT_LE(upper - lower, std::max(1.0, lower / (uint64_t(1) << precision_bits)));
+    }
+  }
+}
+
+TEST(LogLinearHistogramTest, Quantiles) {
+  LogLinearHistogram histogram(7);
+  for (uint64_t value = 1; value <= 10000; ++value) {
+    histogram.recordValue(value);
+  }
+  EXPECT_NEAR(5000, histogram.quantile(0.5), 5000 * 0.01);
+  EXPECT_NEAR(9900, histogram.quantile(0.99), 9900 * 0.01);
+  EXPECT_EQ(99, histogram.countBelow(100));
+  EXPECT_EQ(10000, histogram.countBelow(1e9));
+}
+
+TEST(LogLinearHistogramTest, Merge) {
+  LogLinearHistogram low(7);
+  LogLinearHistogram high(7);
+  LogLinearHistogram all(7);
+  for (uint64_t value = 1; value <= 100; ++value) {
+    low.recordValue(value);
+    all.recordValue(value);
+  }
+  for (uint64_t value = 1000; value <= 1100; ++value) {
+    high.recordValue(value);
+    all.recordValue(value);
+  }
+
+  // Merging extends the buckets of the target on either side.
+  LogLinearHistogram merged(7);
+  merged.merge(high);
+  merged.merge(low);
+  EXPECT_EQ(all.sampleCount(), merged.sampleCount());
+  EXPECT_EQ(all.sampleSum(), merged.sampleSum());
+  for (double q : {0.0, 0.25, 0.5, 0.75, 0.99, 1.0}) {
+    EXPECT_EQ(all.quantile(q), merged.quantile(q));
+  }
+
+  merged.merge(LogLinearHistogram(7));
+  EXPECT_EQ(all.sampleCount(), merged.sampleCount());
+}
+
+TEST(LogLinearHistogramTest, Clear) {
+  LogLinearHistogram histogram(7);
+  histogram.recordValue(1000);
+  histogram.clear();
+  EXPECT_EQ(0, histogram.sampleCount());
+  EXPECT_EQ(0, histogram.sampleSum());
+  EXPECT_EQ(0, histogram.countBelow(1e9));
+
+  histogram.recordValue(10);
+  EXPECT_EQ(1, histogram.sampleCount());
+  EXPECT_EQ(10, histogram.quantile(0));
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
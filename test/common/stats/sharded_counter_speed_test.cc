@@ -0,0 +1,71 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+//
+// Compares the costs of incrementing a counter from a growing number of threads, as workers do for
+// counters such as downstream_rq_total, with regular and sharded counters.
+
+#include "common/common/macros.h"
+#include "common/stats/allocator_impl.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Shared by all the threads of a benchmark, and never destroyed as benchmark threads may still
+// be running when the process exits.
+class Counters {
+public:
+  Counters() : alloc_(symbol_table_), pool_(symbol_table_) {
+    counter_ = alloc_.makeCounter(pool_.add("counter"), Envoy::Stats::StatName(), {});
+    sharded_counter_ =
+        alloc_.makeShardedCounter(pool_.add("sharded_counter"), Envoy::Stats::StatName(), {});
+  }
+
+  static Counters& get() {
+    static Counters* counters = new Counters;
+    return *counters;
+  }
+
+  Envoy::Stats::SymbolTableImpl symbol_table_;
+  Envoy::Stats::AllocatorImpl alloc_;
+  Envoy::Stats::StatNamePool pool_;
+  Envoy::Stats::CounterSharedPtr counter_;
+  Envoy::Stats::CounterSharedPtr sharded_counter_;
+};
+
+void incrementCounter(benchmark::State& state, Envoy::Stats::Counter& counter) {
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    counter.inc();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmCounterInc(benchmark::State& state) {
+  incrementCounter(state, *Counters::get().counter_);
+}
+BENCHMARK(bmCounterInc)->ThreadRange(1, 64)->UseRealTime();
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmShardedCounterInc(benchmark::State& state) {
+  incrementCounter(state, *Counters::get().sharded_counter_);
+}
+BENCHMARK(bmShardedCounterInc)->ThreadRange(1, 64)->UseRealTime();
+
+// Reading a sharded counter sums its shards, which is done by the main thread on each flush.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmShardedCounterLatch(benchmark::State& state) {
+  Envoy::Stats::Counter& counter = *Counters::get().sharded_counter_;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    counter.inc();
+    benchmark::DoNotOptimize(counter.latch());
+  }
+}
+BENCHMARK(bmShardedCounterLatch);
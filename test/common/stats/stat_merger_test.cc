@@ -103,6 +103,28 @@ TEST_F(StatMergerTest, BasicDefaultAccumulationImport) {
   EXPECT_EQ(789, whywassixafraidofseven_.value());
 }
 
+// A snapshot merges like the equivalent protobuf maps, dynamic segments included.
+TEST_F(StatMergerTest, SnapshotMerge) {
+  StatSnapshotWriter writer;
+  writer.addGauge("whywassixafraidofseven", 111, {});
+  writer.addCounter("draculaer", 3, {});
+  writer.addCounter("symbolic.dynamic", 2, {{1, 1}});
+  std::vector<uint64_t> buffer(writer.size() / sizeof(uint64_t));
+  writer.write(reinterpret_cast<uint8_t*>(buffer.data()));
+  StatSnapshotReader snapshot;
+  ASSERT_TRUE(snapshot.parse(reinterpret_cast<const uint8_t*>(buffer.data()), writer.size()));
+
+  stat_merger_.mergeStats(snapshot);
+  EXPECT_EQ(789, whywassixafraidofseven_.value());
+  EXPECT_EQ(3, store_.counterFromString("draculaer").value());
+
+  StatNamePool symbolic_pool(store_.symbolTable());
+  StatNameDynamicPool dynamic_pool(store_.symbolTable());
+  SymbolTable::StoragePtr joined =
+      store_.symbolTable().join({symbolic_pool.add("symbolic"), dynamic_pool.add("dynamic")});
+  EXPECT_EQ(2, store_.counterFromStatName(StatName(joined.get())).value());
+}
+
 TEST_F(StatMergerTest, MultipleImportsWithAccumulationLogic) {
   {
     Protobuf::Map<std::string, uint64_t> gauges;
@@ -0,0 +1,78 @@
+#include <cstdint>
+#include <vector>
+
+#include "common/stats/stat_slab_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class StatSlabPoolTest : public testing::Test {
+protected:
+  StatSlabPoolTest() : pool_(&owner_, 40) {}
+
+  // Allocates a slab's worth of objects, filling each with its index.
+  std::vector<void*> allocateSlab() {
+    std::vector<void*> objects;
+    for (uint32_t i = 0; i < pool_.objectsPerSlab(); ++i) {
+      objects.push_back(pool_.allocate());
+      *static_cast<uint64_t*>(objects.back()) = i;
+    }
+    return objects;
+  }
+
+  int owner_;
+  StatSlabPool pool_;
+};
+
+TEST_F(StatSlabPoolTest, ObjectsFindTheirOwner) {
+  EXPECT_EQ(0, pool_.numSlabs());
+  void* object = pool_.allocate();
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(object) % 8);
+  EXPECT_EQ(&owner_, StatSlabPool::owner(object));
+  EXPECT_EQ(1, pool_.numSlabs());
+  StatSlabPool::free(object);
+  EXPECT_EQ(0, pool_.numSlabs());
+}
+
+// A slab holds as many objects as fit after its header, and another is allocated when it fills.
+TEST_F(StatSlabPoolTest, SlabsFillAndEmpty) {
+  EXPECT_EQ((StatSlabPool::SlabSize - 32) / 40, pool_.objectsPerSlab());
+  std::vector<void*> first = allocateSlab();
+  EXPECT_EQ(1, pool_.numSlabs());
+  void* extra = pool_.allocate();
+  EXPECT_EQ(2, pool_.numSlabs());
+  EXPECT_EQ(&owner_, StatSlabPool::owner(extra));
+
+  for (uint32_t i = 0; i < first.size(); ++i) {
+    EXPECT_EQ(i, *static_cast<uint64_t*>(first[i]));
+    StatSlabPool::free(first[i]);
+  }
+  EXPECT_EQ(1, pool_.numSlabs());
+  StatSlabPool::free(extra);
+  EXPECT_EQ(0, pool_.numSlabs());
+}
+
+// Freed objects are reused before a new slab is allocated.
+TEST_F(StatSlabPoolTest, FreedObjectsReused) {
+  std::vector<void*> objects = allocateSlab();
+  StatSlabPool::free(objects[3]);
+  StatSlabPool::free(objects[7]);
+  void* a = pool_.allocate();
+  void* b = pool_.allocate();
+  EXPECT_EQ(objects[7], a);
+  EXPECT_EQ(objects[3], b);
+  EXPECT_EQ(1, pool_.numSlabs());
+  objects[3] = b;
+  objects[7] = a;
+  for (void* object : objects) {
+    StatSlabPool::free(object);
+  }
+  EXPECT_EQ(0, pool_.numSlabs());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#include <cstring>
+#include <vector>
+
+#include "common/stats/stat_snapshot.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class StatSnapshotTest : public testing::Test {
+public:
+  // Writes the snapshot into buffer_, returning whether it reads back.
+  bool writeAndParse() {
+    buffer_.assign(writer_.size() / sizeof(uint64_t), 0);
+    writer_.write(data());
+    return reader_.parse(data(), writer_.size());
+  }
+
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(buffer_.data()); }
+
+  StatSnapshotWriter writer_;
+  StatSnapshotReader reader_;
+  std::vector<uint64_t> buffer_;
+};
+
+TEST_F(StatSnapshotTest, Empty) {
+  ASSERT_TRUE(writeAndParse());
+  EXPECT_EQ(0, reader_.numCounters());
+  EXPECT_EQ(0, reader_.numGauges());
+  EXPECT_EQ(0, reader_.numStats());
+}
+
+// Counters come first whatever order the stats were added in, and the names and spans of the
+// gauges are found after the counters'.
+TEST_F(StatSnapshotTest, RoundTrip) {
+  writer_.addGauge("g1", 10, {{0, 0}});
+  writer_.addCounter("c1", 1, {});
+  writer_.addGauge("", 20, {});
+  writer_.addCounter("c2.dynamic.segments", 2, {{1, 2}, {3, 3}});
+  ASSERT_TRUE(writeAndParse());
+  EXPECT_EQ(0, writer_.size() % sizeof(uint64_t));
+
+  ASSERT_EQ(2, reader_.numCounters());
+  ASSERT_EQ(2, reader_.numGauges());
+  EXPECT_EQ("c1", reader_.name(0));
+  EXPECT_EQ(1, reader_.value(0));
+  EXPECT_EQ(DynamicSpans{}, reader_.dynamicSpans(0));
+  EXPECT_EQ("c2.dynamic.segments", reader_.name(1));
+  EXPECT_EQ(2, reader_.value(1));
+  EXPECT_EQ((DynamicSpans{{1, 2}, {3, 3}}), reader_.dynamicSpans(1));
+  EXPECT_EQ("g1", reader_.name(2));
+  EXPECT_EQ(10, reader_.value(2));
+  EXPECT_EQ((DynamicSpans{{0, 0}}), reader_.dynamicSpans(2));
+  EXPECT_EQ("", reader_.name(3));
+  EXPECT_EQ(20, reader_.value(3));
+  EXPECT_EQ(DynamicSpans{}, reader_.dynamicSpans(3));
+}
+
+TEST_F(StatSnapshotTest, Truncated) {
+  writer_.addCounter("c1", 1, {});
+  ASSERT_TRUE(writeAndParse());
+  EXPECT_FALSE(reader_.parse(data(), writer_.size() - sizeof(uint64_t)));
+  EXPECT_FALSE(reader_.parse(data(), sizeof(StatSnapshot::Header) - 1));
+}
+
+TEST_F(StatSnapshotTest, BadMagic) {
+  writer_.addCounter("c1", 1, {});
+  ASSERT_TRUE(writeAndParse());
+  reinterpret_cast<StatSnapshot::Header*>(data())->magic_ = 0;
+  EXPECT_FALSE(reader_.parse(data(), writer_.size()));
+}
+
+// Name ends that decrease or run past the names are rejected.
+TEST_F(StatSnapshotTest, BadNameEnds) {
+  writer_.addCounter("c1", 1, {});
+  writer_.addCounter("c2", 2, {});
+  ASSERT_TRUE(writeAndParse());
+  // The name ends follow the header and the two values.
+  auto* name_ends = reinterpret_cast<uint32_t*>(buffer_.data() + 3 + 2);
+  ASSERT_EQ(2, name_ends[0]);
+  ASSERT_EQ(4, name_ends[1]);
+
+  name_ends[0] = 5;
+  EXPECT_FALSE(reader_.parse(data(), writer_.size()));
+  name_ends[0] = 2;
+  name_ends[1] = 5;
+  EXPECT_FALSE(reader_.parse(data(), writer_.size()));
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
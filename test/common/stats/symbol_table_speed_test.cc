@@ -12,6 +12,7 @@
 #include "test/common/stats/make_elements_helper.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -61,6 +62,57 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Measures the throughput of encoding names whose symbols all exist already, as workers do
+// when they look up stats with dynamic names, from a varying number of threads. Each thread
+// encodes its own names, which share their leading and trailing tokens with those of the other
+// threads.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeExistingContended(benchmark::State& state) {
+  const int num_threads = state.range(0);
+  constexpr int encodes_per_thread = 10000;
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  Envoy::Stats::SymbolTableImpl table;
+  std::vector<std::string> names;
+  std::vector<Envoy::Stats::StatNameStorage> initial;
+  for (int i = 0; i < num_threads; ++i) {
+    names.push_back(absl::StrCat("cluster.service_", i, ".upstream_rq_200"));
+    initial.emplace_back(names.back(), table);
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    Envoy::ConditionalInitializer access;
+    absl::BlockingCounter accesses(num_threads);
+
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(
+          thread_factory.createThread([&access, &accesses, &table, &name = names[i]]() {
+            access.wait();
+            for (int count = 0; count < encodes_per_thread; ++count) {
+              Envoy::Stats::StatNameStorage storage(name, table);
+              storage.free(table);
+            }
+            accesses.DecrementCount();
+          }));
+    }
+
+    access.setReady();
+    accesses.Wait();
+
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * encodes_per_thread);
+
+  for (Envoy::Stats::StatNameStorage& storage : initial) {
+    storage.free(table);
+  }
+}
+BENCHMARK(bmEncodeExistingContended)->Arg(1)->Arg(4)->Arg(16)->Unit(::benchmark::kMillisecond);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
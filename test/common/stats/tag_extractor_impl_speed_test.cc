@@ -43,6 +43,7 @@
 #include "envoy/config/metrics/v3/stats.pb.h"
 
 #include "common/common/assert.h"
+#include "common/common/fmt.h"
 #include "common/config/well_known_names.h"
 #include "common/stats/tag_producer_impl.h"
 
@@ -106,6 +107,46 @@ void BM_ExtractTags(benchmark::State& state) {
 }
 BENCHMARK(BM_ExtractTags)->DenseRange(0, 26, 1);
 
+// Names of the stats created at startup for state.range(0) clusters, listeners and HTTP
+// connection managers, of which only a few are matched by each regex.
+std::vector<std::string> startupStatNames(int64_t num_stats) {
+  const std::vector<std::string> formats = {
+      "cluster.cluster_{}.upstream_rq_200",
+      "cluster.cluster_{}.upstream_rq_5xx",
+      "cluster.cluster_{}.upstream_cx_total",
+      "cluster.cluster_{}.ssl.ciphers.ECDHE-RSA-AES128-GCM-SHA256",
+      "cluster.cluster_{}.grpc.service.method.success",
+      "listener.127.0.0.1_{}.downstream_cx_total",
+      "listener.127.0.0.1_{}.http.ingress_http.downstream_rq_2xx",
+      "http.ingress_{}.downstream_rq_total",
+      "http.ingress_{}.rds.route_config.update_success",
+      "vhost.vhost_{}.vcluster.other.upstream_rq_retry",
+  };
+  std::vector<std::string> names;
+  names.reserve(num_stats);
+  for (int64_t i = 0; i < num_stats; ++i) {
+    names.push_back(fmt::format(formats[i % formats.size()], i / formats.size()));
+  }
+  return names;
+}
+
+// Extracts the tags of all the stats created at startup.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ExtractTagsStartup(benchmark::State& state) {
+  TagProducerImpl tag_extractors{envoy::config::metrics::v3::StatsConfig()};
+  const std::vector<std::string> names = startupStatNames(state.range(0));
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (const std::string& name : names) {
+      TagVector tags;
+      benchmark::DoNotOptimize(tag_extractors.produceTags(name, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_ExtractTagsStartup)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
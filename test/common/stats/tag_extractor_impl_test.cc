@@ -12,6 +12,7 @@
 #include "gtest/gtest.h"
 
 using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
 
 namespace Envoy {
 namespace Stats {
@@ -150,6 +151,15 @@ public:
     return StringUtil::removeCharacters(metric_name, remove_characters);
   }
 
+  // Returns the names of the extractors forEachExtractorMatching tries on metric_name.
+  std::vector<std::string> matchingExtractorNames(absl::string_view metric_name) const {
+    std::vector<std::string> names;
+    tag_extractors_.forEachExtractorMatching(
+        metric_name,
+        [&names](const TagExtractorPtr& tag_extractor) { names.push_back(tag_extractor->name()); });
+    return names;
+  }
+
   SymbolTableImpl symbol_table_;
   TagProducerImpl tag_extractors_;
 };
@@ -381,6 +391,40 @@ TEST(TagExtractorTest, DefaultTagExtractors) {
                          "listener_manager.dispatcher.loop_duration_us", {worker_id});
 }
 
+// The RE2 extractors whose regexes don't match a stat name are not tried on it, whether or not
+// they have a prefix.
+TEST(TagExtractorTest, RegexSetSkipsNonMatchingExtractors) {
+  const auto& tag_names = Config::TagNames::get();
+  DefaultTagRegexTester regex_tester;
+
+  EXPECT_THAT(regex_tester.matchingExtractorNames("cluster.ratelimit.upstream_rq_timeout"),
+              UnorderedElementsAre(tag_names.GRPC_BRIDGE_METHOD, tag_names.GRPC_BRIDGE_SERVICE,
+                                   tag_names.CLUSTER_NAME));
+  EXPECT_THAT(regex_tester.matchingExtractorNames("cluster.ratelimit.upstream_rq_200"),
+              UnorderedElementsAre(tag_names.RESPONSE_CODE, tag_names.GRPC_BRIDGE_METHOD,
+                                   tag_names.GRPC_BRIDGE_SERVICE, tag_names.CLUSTER_NAME));
+  EXPECT_THAT(regex_tester.matchingExtractorNames("cluster.ratelimit.ssl.ciphers.AES256-SHA"),
+              UnorderedElementsAre(tag_names.SSL_CIPHER_SUITE, tag_names.GRPC_BRIDGE_METHOD,
+                                   tag_names.GRPC_BRIDGE_SERVICE, tag_names.CLUSTER_NAME));
+  EXPECT_THAT(regex_tester.matchingExtractorNames("server.uptime"), ElementsAre());
+}
+
+// Extractors configured with a std::regex are not part of the RE2 set, and are always tried.
+TEST(TagExtractorTest, StdRegexExtractorsAlwaysTried) {
+  envoy::config::metrics::v3::StatsConfig stats_config;
+  stats_config.mutable_use_all_default_tags()->set_value(false);
+  auto* tag_specifier = stats_config.add_stats_tags();
+  tag_specifier->set_tag_name("custom");
+  tag_specifier->set_regex("\\.(custom_(\\d+))$");
+  TagProducerImpl tag_producer(stats_config);
+
+  TagVector tags;
+  EXPECT_EQ("server.uptime", tag_producer.produceTags("server.uptime.custom_1", tags));
+  ASSERT_EQ(1, tags.size());
+  EXPECT_EQ("custom", tags[0].name_);
+  EXPECT_EQ("1", tags[0].value_);
+}
+
 TEST(TagExtractorTest, ExtractRegexPrefix) {
   TagExtractorPtr tag_extractor; // Keep tag_extractor in this scope to prolong prefix lifetime.
   auto extractRegexPrefix = [&tag_extractor](const std::string& regex) -> absl::string_view {
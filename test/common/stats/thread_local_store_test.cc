@@ -4,8 +4,10 @@
 
 #include "envoy/config/metrics/v3/stats.pb.h"
 #include "envoy/stats/histogram.h"
+#include "envoy/type/matcher/v3/string.pb.h"
 
 #include "common/common/c_smart_ptr.h"
+#include "common/common/matchers.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/memory/stats.h"
 #include "common/stats/stats_matcher_impl.h"
@@ -332,6 +334,50 @@ TEST_F(StatsThreadLocalStoreTest, Tls) {
   EXPECT_EQ(2L, store_->textReadouts().front().use_count());
 }
 
+// An allocator recording the names of the counters created sharded.
+class ShardRecordingAllocator : public AllocatorImpl {
+public:
+  using AllocatorImpl::AllocatorImpl;
+
+  CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                      const StatNameTagVector& stat_name_tags) override {
+    sharded_counters_.push_back(symbolTable().toString(name));
+    return AllocatorImpl::makeShardedCounter(name, tag_extracted_name, stat_name_tags);
+  }
+
+  std::vector<std::string> sharded_counters_;
+};
+
+TEST_F(StatsThreadLocalStoreTest, ShardedCounters) {
+  ShardRecordingAllocator alloc(symbol_table_);
+  resetStoreWithAlloc(alloc);
+  envoy::type::matcher::v3::StringMatcher matcher;
+  matcher.set_suffix("rq_total");
+  std::vector<Matchers::StringMatcherPtr> matchers;
+  matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
+  store_->setShardedCounterMatchers(std::move(matchers));
+
+  ScopePtr scope = store_->createScope("http.");
+  Counter& rq_total = scope->counterFromString("downstream_rq_total");
+  Counter& rq_2xx = scope->counterFromString("downstream_rq_2xx");
+  EXPECT_EQ(std::vector<std::string>{"http.downstream_rq_total"}, alloc.sharded_counters_);
+  EXPECT_EQ(&rq_total, &scope->counterFromString("downstream_rq_total"));
+  EXPECT_EQ(1, alloc.sharded_counters_.size());
+
+  EXPECT_FALSE(rq_total.used());
+  rq_total.add(5);
+  rq_2xx.inc();
+  EXPECT_TRUE(rq_total.used());
+  EXPECT_EQ(5, rq_total.value());
+  EXPECT_EQ(5, rq_total.latch());
+  EXPECT_EQ(0, rq_total.latch());
+  EXPECT_EQ(1, rq_2xx.value());
+
+  scope.reset();
+  store_->shutdownThreading();
+  store_.reset();
+}
+
 TEST_F(StatsThreadLocalStoreTest, BasicScope) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -1434,6 +1480,40 @@ TEST_F(HistogramTest, ParentHistogramBucketSummary) {
             parent_histogram->bucketSummary());
 }
 
+// Histograms record their values in log-linear histograms when a relative error is configured.
+TEST_F(HistogramTest, LogLinearHistogramMerge) {
+  envoy::config::metrics::v3::StatsConfig config;
+  config.mutable_histogram_relative_error()->set_value(0.01);
+  store_->setHistogramSettings(std::make_unique<HistogramSettingsImpl>(config));
+
+  Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
+  LogLinearHistogram expected(7);
+  for (uint64_t value : {0, 13, 41, 43, 125, 415, 2201, 3201}) {
+    EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), value));
+    h1.recordValue(value);
+    expected.recordValue(value);
+  }
+  store_->mergeHistograms([]() -> void {});
+  ASSERT_EQ(1, store_->histograms().size());
+  ParentHistogramSharedPtr parent_histogram = store_->histograms()[0];
+  HistogramStatisticsImpl expected_statistics(expected);
+  EXPECT_EQ(expected_statistics.quantileSummary(),
+            parent_histogram->intervalStatistics().quantileSummary());
+  EXPECT_EQ(expected_statistics.bucketSummary(),
+            parent_histogram->cumulativeStatistics().bucketSummary());
+
+  // The next interval starts from scratch, while the cumulative histogram keeps all values.
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 10));
+  h1.recordValue(10);
+  expected.recordValue(10);
+  store_->mergeHistograms([]() -> void {});
+  EXPECT_EQ(1, parent_histogram->intervalStatistics().sampleCount());
+  EXPECT_EQ(9, parent_histogram->cumulativeStatistics().sampleCount());
+  expected_statistics.refresh(expected);
+  EXPECT_EQ(expected_statistics.quantileSummary(),
+            parent_histogram->cumulativeStatistics().quantileSummary());
+}
+
 class ThreadLocalRealThreadsTestBase : public ThreadLocalStoreNoMocksTestBase {
 protected:
   static constexpr uint32_t NumScopes = 1000;
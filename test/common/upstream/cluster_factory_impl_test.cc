@@ -273,6 +273,49 @@ TEST_F(TestStaticClusterImplTest, HostnameWithoutDNS) {
       "'envoy.clusters.test_static'");
 }
 
+TEST_F(TestStaticClusterImplTest, WorkerHostPartitionsExceedConcurrency) {
+  const std::string yaml = R"EOF(
+      name: staticcluster
+      connect_timeout: 0.25s
+      lb_policy: ROUND_ROBIN
+      common_lb_config:
+        worker_host_partitions: 3
+      load_assignment:
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 443
+      cluster_type:
+        name: envoy.clusters.test_static
+    )EOF";
+
+  options_.concurrency_ = 2;
+  EXPECT_THROW_WITH_MESSAGE(
+      {
+        const envoy::config::cluster::v3::Cluster cluster_config = parseClusterFromV3Yaml(yaml);
+        ClusterFactoryImplBase::create(
+            cluster_config, cm_, stats_, tls_, dns_resolver_, ssl_context_manager_, runtime_,
+            dispatcher_, log_manager_, local_info_, admin_, singleton_manager_,
+            std::move(outlier_event_logger_), false, validation_visitor_, *api_, options_);
+      },
+      EnvoyException,
+      "cluster: worker_host_partitions (3) of cluster 'staticcluster' must not exceed the "
+      "concurrency (2)");
+
+  // A partition per worker is allowed.
+  TestStaticClusterFactory factory;
+  Registry::InjectFactory<ClusterFactory> registered_factory(factory);
+  options_.concurrency_ = 3;
+  const envoy::config::cluster::v3::Cluster cluster_config = parseClusterFromV3Yaml(yaml);
+  EXPECT_NO_THROW(ClusterFactoryImplBase::create(
+      cluster_config, cm_, stats_, tls_, dns_resolver_, ssl_context_manager_, runtime_,
+      dispatcher_, log_manager_, local_info_, admin_, singleton_manager_,
+      std::move(outlier_event_logger_), false, validation_visitor_, *api_, options_));
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
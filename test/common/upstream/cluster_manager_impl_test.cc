@@ -4,6 +4,7 @@
 #include "envoy/config/cluster/v3/cluster.pb.validate.h"
 #include "envoy/config/core/v3/base.pb.h"
 
+#include "common/common/hash.h"
 #include "common/network/raw_buffer_socket.h"
 #include "common/router/context_impl.h"
 
@@ -1727,6 +1728,260 @@ TEST_F(ClusterManagerImplTest, HostsPostedToTlsCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+TEST_F(ClusterManagerImplTest, DeferredClusterCreation) {
+  auto bootstrap = defaultConfig();
+  bootstrap.mutable_cluster_manager()->set_enable_deferred_cluster_creation(true);
+  auto* announce_cb = new Event::MockSchedulableCallback(&factory_.tls_.dispatcher_);
+  create(bootstrap);
+
+  std::unique_ptr<MockClusterUpdateCallbacks> callbacks(new NiceMock<MockClusterUpdateCallbacks>());
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(*callbacks);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster1->info_, "tcp://127.0.0.1:80", time_system_)};
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  // The cluster is only created on the worker once it is used.
+  EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_)).Times(0);
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), ""));
+
+  // Membership updates are applied once the cluster is created.
+  HostSharedPtr host2 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:81", time_system_);
+  cluster1->prioritySet().getMockHostSet(0)->hosts_.push_back(host2);
+  cluster1->prioritySet().runUpdateCallbacks(0, {host2}, {});
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
+  EXPECT_EQ(0U, factory_.stats_.counter("cluster_manager.deferred_cluster_created").value());
+
+  // The update callbacks are not run from within the lookup that creates the cluster.
+  EXPECT_CALL(*announce_cb, scheduleCallbackCurrentIteration());
+  ThreadLocalCluster* cluster = cluster_manager_->getThreadLocalCluster("fake_cluster");
+  ASSERT_NE(nullptr, cluster);
+  EXPECT_EQ(cluster1->info_, cluster->info());
+  EXPECT_EQ(2U, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(cluster, cluster_manager_->getThreadLocalCluster("fake_cluster"));
+  EXPECT_EQ(1U, factory_.stats_.counter("cluster_manager.deferred_cluster_created").value());
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("unknown_cluster"));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
+
+  EXPECT_CALL(*callbacks, onClusterAddOrUpdate(Ref(*cluster)));
+  announce_cb->invokeCallback();
+
+  // Updates of a created cluster are applied right away.
+  cluster1->prioritySet().getMockHostSet(0)->hosts_.pop_back();
+  cluster1->prioritySet().runUpdateCallbacks(0, {}, {host2});
+  EXPECT_EQ(1U, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  EXPECT_CALL(*callbacks, onClusterRemoval("fake_cluster"));
+  EXPECT_TRUE(cluster_manager_->removeCluster("fake_cluster"));
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("fake_cluster"));
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
+// Verifies that the update callbacks are not told about the removal of a deferred cluster whose
+// creation they were not told about yet.
+TEST_F(ClusterManagerImplTest, DeferredClusterRemovedBeforeAnnounced) {
+  auto bootstrap = defaultConfig();
+  bootstrap.mutable_cluster_manager()->set_enable_deferred_cluster_creation(true);
+  auto* announce_cb = new Event::MockSchedulableCallback(&factory_.tls_.dispatcher_);
+  create(bootstrap);
+
+  std::unique_ptr<MockClusterUpdateCallbacks> callbacks(new NiceMock<MockClusterUpdateCallbacks>());
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(*callbacks);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), ""));
+  EXPECT_CALL(*announce_cb, scheduleCallbackCurrentIteration());
+  EXPECT_NE(nullptr, cluster_manager_->getThreadLocalCluster("fake_cluster"));
+
+  EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_)).Times(0);
+  EXPECT_CALL(*callbacks, onClusterRemoval(_)).Times(0);
+  EXPECT_TRUE(cluster_manager_->removeCluster("fake_cluster"));
+  announce_cb->invokeCallback();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
+// Verifies that membership updates of all clusters are delivered to the workers in a single batch
+// once the batch window ends, while added and removed clusters are posted right away.
+TEST_F(ClusterManagerImplTest, ClusterUpdatesBatched) {
+  auto bootstrap = defaultConfig();
+  bootstrap.mutable_cluster_manager()->mutable_cluster_update_batch_window()->set_nanos(100000000);
+  auto* batch_timer = new Event::MockTimer(&factory_.dispatcher_);
+  create(bootstrap);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "cluster_1";
+  cluster1->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster1->info_, "tcp://127.0.0.1:80", time_system_)};
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2(new NiceMock<MockClusterMockPrioritySet>());
+  cluster2->info_->name_ = "cluster_2";
+  cluster2->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster2->info_, "tcp://127.0.0.2:80", time_system_)};
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)))
+      .WillOnce(Return(std::make_pair(cluster2, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_CALL(*cluster2, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_1"), ""));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_2"), ""));
+
+  // Added clusters are available right away.
+  ThreadLocalCluster* tls_cluster1 = cluster_manager_->getThreadLocalCluster("cluster_1");
+  ThreadLocalCluster* tls_cluster2 = cluster_manager_->getThreadLocalCluster("cluster_2");
+  ASSERT_NE(nullptr, tls_cluster1);
+  ASSERT_NE(nullptr, tls_cluster2);
+
+  // Membership updates are held back until the batch window ends.
+  EXPECT_CALL(*batch_timer, enableTimer(std::chrono::milliseconds(100), _));
+  HostSharedPtr host2 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:81", time_system_);
+  cluster1->prioritySet().getMockHostSet(0)->hosts_.push_back(host2);
+  cluster1->prioritySet().runUpdateCallbacks(0, {host2}, {});
+  HostSharedPtr host3 = makeTestHost(cluster2->info_, "tcp://127.0.0.2:81", time_system_);
+  cluster2->prioritySet().getMockHostSet(0)->hosts_.push_back(host3);
+  cluster2->prioritySet().runUpdateCallbacks(0, {host3}, {});
+  EXPECT_EQ(1U, tls_cluster1->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(1U, tls_cluster2->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  batch_timer->invokeCallback();
+  EXPECT_EQ(2U, tls_cluster1->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(2U, tls_cluster2->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  // Removing a cluster delivers the pending batch first.
+  EXPECT_CALL(*batch_timer, enableTimer(std::chrono::milliseconds(100), _));
+  cluster1->prioritySet().getMockHostSet(0)->hosts_.pop_back();
+  cluster1->prioritySet().runUpdateCallbacks(0, {}, {host2});
+  EXPECT_EQ(2U, tls_cluster1->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  EXPECT_CALL(*batch_timer, disableTimer());
+  EXPECT_TRUE(cluster_manager_->removeCluster("cluster_2"));
+  EXPECT_EQ(1U, tls_cluster1->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_2"));
+
+  // A batch still pending at shutdown is dropped.
+  EXPECT_CALL(*batch_timer, enableTimer(std::chrono::milliseconds(100), _));
+  cluster1->prioritySet().getMockHostSet(0)->hosts_.push_back(host2);
+  cluster1->prioritySet().runUpdateCallbacks(0, {host2}, {});
+  EXPECT_CALL(*batch_timer, disableTimer());
+  cluster_manager_->shutdown();
+  EXPECT_EQ(1U, tls_cluster1->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster2.get()));
+}
+
+// Verifies that connection pools of a host that failed health checks are drained along with the
+// pending batch of updates.
+TEST_F(ClusterManagerImplTest, HealthFailureBatched) {
+  auto bootstrap = parseBootstrapFromV3Json(fmt::sprintf(
+      "{\"static_resources\":{%s}}", clustersJson({defaultStaticClusterJson("some_cluster")})));
+  bootstrap.mutable_cluster_manager()->mutable_cluster_update_batch_window()->set_nanos(100000000);
+  auto* batch_timer = new Event::MockTimer(&factory_.dispatcher_);
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "some_cluster";
+  HostSharedPtr test_host = makeTestHost(cluster1->info_, "tcp://127.0.0.1:80", time_system_);
+  cluster1->prioritySet().getMockHostSet(0)->hosts_ = {test_host};
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+
+  NiceMock<MockHealthChecker> health_checker;
+  ON_CALL(*cluster1, healthChecker()).WillByDefault(Return(&health_checker));
+
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  create(bootstrap);
+
+  Http::ConnectionPool::MockInstance* cp = new Http::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _)).WillOnce(Return(cp));
+  cluster_manager_->getThreadLocalCluster("some_cluster")
+      ->httpConnPool(ResourcePriority::Default, Http::Protocol::Http11, nullptr);
+
+  EXPECT_CALL(*batch_timer, enableTimer(std::chrono::milliseconds(100), _));
+  EXPECT_CALL(*cp, drainConnections()).Times(0);
+  test_host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  health_checker.runCallbacks(test_host, HealthTransition::Changed);
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cp));
+
+  EXPECT_CALL(*cp, drainConnections());
+  batch_timer->invokeCallback();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
+// Verifies that only the hosts of the worker's partition are posted to the TLS cluster if the
+// cluster partitions its hosts across workers.
+TEST_F(ClusterManagerImplTest, HostsPartitionedAcrossWorkers) {
+  const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                        clustersJson({defaultStaticClusterJson("fake_cluster")}));
+  std::shared_ptr<MockClusterRealPrioritySet> cluster1(new NiceMock<MockClusterRealPrioritySet>());
+  cluster1->info_->lb_config_.set_worker_host_partitions(2);
+  InSequence s;
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*cluster1, initialize(_));
+
+  create(parseBootstrapFromV3Json(json));
+
+  ReadyWatcher initialized;
+  cluster_manager_->setInitializedCb([&]() -> void { initialized.ready(); });
+
+  EXPECT_CALL(initialized, ready());
+  cluster1->initialize_callback_();
+
+  // The thread local cluster manager of the mock thread local instance belongs to the first
+  // worker, which uses the first partition.
+  HostVector hosts;
+  HostVector partition_hosts;
+  HostVector other_hosts;
+  for (int i = 1; i <= 16; ++i) {
+    hosts.push_back(
+        makeTestHost(cluster1->info_, fmt::format("tcp://127.0.0.{}:80", i), time_system_));
+    if (HashUtil::xxHash64(hosts.back()->address()->asStringView()) % 2 == 0) {
+      partition_hosts.push_back(hosts.back());
+    } else {
+      other_hosts.push_back(hosts.back());
+    }
+  }
+  ASSERT_FALSE(partition_hosts.empty());
+  ASSERT_FALSE(other_hosts.empty());
+
+  cluster1->priority_set_.updateHosts(
+      0,
+      HostSetImpl::partitionHosts(std::make_shared<HostVector>(hosts),
+                                  HostsPerLocalityImpl::empty()),
+      nullptr, hosts, {}, 100);
+
+  auto* tls_cluster = cluster_manager_->getThreadLocalCluster(cluster1->info_->name());
+  EXPECT_EQ(partition_hosts, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts());
+  EXPECT_EQ(partition_hosts.size(),
+            tls_cluster->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+
+  // Once no host is in the worker's partition, it uses all of them.
+  cluster1->priority_set_.updateHosts(
+      0,
+      HostSetImpl::partitionHosts(std::make_shared<HostVector>(other_hosts),
+                                  HostsPerLocalityImpl::empty()),
+      nullptr, {}, partition_hosts, 100);
+  EXPECT_EQ(other_hosts, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts());
+
+  factory_.tls_.shutdownThread();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
 // Test that we close all HTTP connection pool connections when there is a host health failure.
 TEST_F(ClusterManagerImplTest, CloseHttpConnectionsOnHealthFailure) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
@@ -0,0 +1,118 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the startup time and thread local memory of a cluster manager with many static clusters,
+// with and without deferred creation of thread local clusters. Only a small fraction of the
+// clusters is used, as is typical of very large CDS configurations.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "common/memory/stats.h"
+#include "common/router/context_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+
+class DeferredClusterSpeedTest {
+public:
+  DeferredClusterSpeedTest(uint64_t num_clusters, bool deferred)
+      : http_context_(factory_.stats_.symbolTable()), grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()) {
+    auto* cm_config = bootstrap_.mutable_cluster_manager();
+    cm_config->set_enable_deferred_cluster_creation(deferred);
+    if (deferred) {
+      // Announces the clusters created on first use to the update callbacks.
+      new NiceMock<Event::MockSchedulableCallback>(&factory_.tls_.dispatcher_);
+    }
+    for (uint64_t i = 0; i < num_clusters; ++i) {
+      auto* cluster = bootstrap_.mutable_static_resources()->add_clusters();
+      cluster->set_name(absl::StrCat("cluster_", i));
+      cluster->set_type(envoy::config::cluster::v3::Cluster::STATIC);
+      cluster->mutable_connect_timeout()->set_nanos(250000000);
+      auto* load_assignment = cluster->mutable_load_assignment();
+      load_assignment->set_cluster_name(cluster->name());
+      auto* socket_address = load_assignment->add_endpoints()
+                                 ->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address("127.0.0.1");
+      socket_address->set_port_value(10000 + i % 50000);
+    }
+  }
+
+  void create() {
+    cluster_manager_ = std::make_unique<TestClusterManagerImpl>(
+        bootstrap_, factory_, factory_.stats_, factory_.tls_, factory_.runtime_,
+        factory_.local_info_, log_manager_, factory_.dispatcher_, admin_, validation_context_,
+        *factory_.api_, http_context_, grpc_context_, router_context_);
+  }
+
+  // Looks up one in every hundred clusters, as if only those received traffic.
+  void useSomeClusters() {
+    const auto& clusters = bootstrap_.static_resources().clusters();
+    for (int i = 0; i < clusters.size(); i += 100) {
+      ::benchmark::DoNotOptimize(cluster_manager_->getThreadLocalCluster(clusters[i].name()));
+    }
+  }
+
+private:
+  envoy::config::bootstrap::v3::Bootstrap bootstrap_;
+  NiceMock<TestClusterManagerFactory> factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+};
+
+void benchmarkClusterManagerStartup(::benchmark::State& state, bool deferred) {
+  const uint64_t num_clusters = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_clusters > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    DeferredClusterSpeedTest speed_test(num_clusters, deferred);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+
+    state.ResumeTiming();
+    speed_test.create();
+    speed_test.useSomeClusters();
+    state.PauseTiming();
+
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_cluster"] = (end_mem - start_mem) / num_clusters;
+    state.ResumeTiming();
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_EagerClusterStartup(::benchmark::State& state) {
+  benchmarkClusterManagerStartup(state, false);
+}
+BENCHMARK(BM_EagerClusterStartup)->Arg(100)->Arg(1000)->Arg(10000)->Unit(::benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_DeferredClusterStartup(::benchmark::State& state) {
+  benchmarkClusterManagerStartup(state, true);
+}
+BENCHMARK(BM_DeferredClusterStartup)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1,6 +1,7 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
@@ -12,12 +13,14 @@
 #include "common/config/grpc_subscription_impl.h"
 #include "common/config/protobuf_link_hacks.h"
 #include "common/config/utility.h"
+#include "common/router/context_impl.h"
 #include "common/singleton/manager_impl.h"
 #include "common/upstream/eds.h"
 
 #include "server/transport_socket_config_impl.h"
 
 #include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
 #include "test/common/upstream/utility.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/protobuf/mocks.h"
@@ -142,6 +145,32 @@ public:
            num_hosts);
   }
 
+  // Flips the health of one host of a cluster with num_hosts hosts back and forth. Each flip either
+  // rebuilds the host set from copies of all hosts, or only recomputes the subsets the host entered
+  // or left, sharing everything else with the current host set.
+  void healthFlapHelper(size_t num_hosts, bool incremental) {
+    priorityAndLocalityWeightedHelper(true, num_hosts, true);
+    state_.PauseTiming();
+    PrioritySet& priority_set = cluster_->prioritySet();
+    const HostSet& host_set = *priority_set.hostSetsPerPriority()[1];
+    const HostSharedPtr host = host_set.hosts()[0];
+    state_.ResumeTiming();
+
+    for (uint32_t i = 0; i < 100; ++i) {
+      if (i % 2 == 0) {
+        host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+      } else {
+        host->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+      }
+      PrioritySet::UpdateHostsParams params =
+          incremental ? HostSetImpl::updateHostsParamsForHealthChange(host_set, host)
+                      : HostSetImpl::partitionHosts(std::make_shared<HostVector>(host_set.hosts()),
+                                                    host_set.hostsPerLocality().clone());
+      priority_set.updateHosts(1, std::move(params), host_set.localityWeights(), {}, {},
+                               absl::nullopt);
+    }
+  }
+
   TestDeprecatedV2Api _deprecated_v2_api_;
   State& state_;
   const bool v2_config_;
@@ -173,6 +202,71 @@ public:
   Config::GrpcSubscriptionImplPtr subscription_;
 };
 
+// Delivers an EDS push that adds a host to each of many clusters to the workers, with and without
+// batching cluster updates in the cluster manager.
+class ClusterManagerEdsSpeedTest {
+public:
+  ClusterManagerEdsSpeedTest(uint64_t num_clusters, bool batched)
+      : http_context_(factory_.stats_.symbolTable()), grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()) {
+    envoy::config::bootstrap::v3::Bootstrap bootstrap;
+    if (batched) {
+      bootstrap.mutable_cluster_manager()->mutable_cluster_update_batch_window()->set_seconds(1);
+      batch_timer_ = new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+    }
+    for (uint64_t i = 0; i < num_clusters; ++i) {
+      *bootstrap.mutable_static_resources()->add_clusters() =
+          defaultStaticCluster(absl::StrCat("cluster_", i));
+    }
+    // Count the updates posted to the workers.
+    ON_CALL(factory_.tls_, runOnAllThreads(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      ++posts_;
+      cb();
+    }));
+    cluster_manager_ = std::make_unique<TestClusterManagerImpl>(
+        bootstrap, factory_, factory_.stats_, factory_.tls_, factory_.runtime_,
+        factory_.local_info_, log_manager_, factory_.dispatcher_, admin_, validation_context_,
+        *factory_.api_, http_context_, grpc_context_, router_context_);
+    posts_ = 0;
+  }
+
+  // Adds a host to every cluster, as an EDS push would, and delivers the updates to the workers.
+  void push() {
+    for (auto& cluster : cluster_manager_->activeClusters()) {
+      PrioritySet& priority_set = cluster.second.get().prioritySet();
+      HostVectorSharedPtr hosts(new HostVector(priority_set.hostSetsPerPriority()[0]->hosts()));
+      const HostVector hosts_added{
+          makeTestHost(cluster.second.get().info(), fmt::format("tcp://10.0.0.1:{}", ++port_),
+                       factory_.dispatcher_.timeSource())};
+      hosts->push_back(hosts_added[0]);
+      HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+      priority_set.updateHosts(
+          0,
+          updateHostsParams(hosts, hosts_per_locality,
+                            std::make_shared<const HealthyHostVector>(*hosts), hosts_per_locality),
+          {}, hosts_added, {}, absl::nullopt);
+    }
+    if (batch_timer_ != nullptr) {
+      batch_timer_->invokeCallback();
+    }
+  }
+
+  uint64_t posts() const { return posts_; }
+
+private:
+  NiceMock<TestClusterManagerFactory> factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  Event::MockTimer* batch_timer_{};
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+  uint64_t posts_{};
+  uint32_t port_{1000};
+};
+
 } // namespace Upstream
 } // namespace Envoy
 
@@ -223,3 +317,35 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+
+static void healthFlap(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) {
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(1);
+
+    speed_test.healthFlapHelper(endpoints, state.range(0));
+  }
+}
+
+BENCHMARK(healthFlap)->Ranges({{false, true}, {1, 100000}})->Unit(benchmark::kMillisecond);
+
+static void clusterManagerUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) {
+    state.PauseTiming();
+    // if we've been instructed to skip tests, only run once no matter the argument:
+    uint32_t clusters = skipExpensiveBenchmarks() ? 1 : state.range(1);
+    Envoy::Upstream::ClusterManagerEdsSpeedTest speed_test(clusters, state.range(0));
+    state.ResumeTiming();
+
+    speed_test.push();
+    state.counters["posts"] = speed_test.posts();
+  }
+}
+
+BENCHMARK(clusterManagerUpdate)->Ranges({{false, true}, {1, 10000}})->Unit(benchmark::kMillisecond);
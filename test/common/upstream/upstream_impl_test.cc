@@ -3677,6 +3677,61 @@ TEST(HostPartitionTest, PartitionHostsImmediateFailureExcludeDisabled) {
   EXPECT_EQ(hosts[2], update_hosts_params.excluded_hosts_per_locality->get()[1][0]);
 }
 
+// Verifies that a health change of a single host only recomputes the subsets the host entered or
+// left, and shares everything else with the current host set.
+TEST(HostPartitionTest, UpdateHostsParamsForHealthChange) {
+  std::shared_ptr<MockClusterInfo> info{new NiceMock<MockClusterInfo>()};
+  auto time_source = std::make_unique<NiceMock<MockTimeSystem>>();
+  HostVector hosts{makeTestHost(info, "tcp://127.0.0.1:80", *time_source),
+                   makeTestHost(info, "tcp://127.0.0.1:81", *time_source),
+                   makeTestHost(info, "tcp://127.0.0.1:82", *time_source)};
+  hosts[1]->healthFlagSet(Host::HealthFlag::DEGRADED_ACTIVE_HC);
+
+  HostSetImpl host_set(0, kDefaultOverProvisioningFactor);
+  host_set.updateHosts(
+      HostSetImpl::partitionHosts(std::make_shared<const HostVector>(hosts),
+                                  makeHostsPerLocality({{hosts[0], hosts[1]}, {hosts[2]}})),
+      nullptr, hosts, {});
+
+  // The host becomes unhealthy, so only the healthy subsets are recomputed.
+  hosts[2]->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  auto params = HostSetImpl::updateHostsParamsForHealthChange(host_set, hosts[2]);
+  EXPECT_EQ(host_set.hostsPtr(), params.hosts);
+  EXPECT_EQ(host_set.hostsPerLocalityPtr(), params.hosts_per_locality);
+  EXPECT_NE(host_set.healthyHostsPtr(), params.healthy_hosts);
+  EXPECT_EQ(HostVector({hosts[0]}), params.healthy_hosts->get());
+  EXPECT_NE(host_set.healthyHostsPerLocalityPtr(), params.healthy_hosts_per_locality);
+  EXPECT_EQ(1, params.healthy_hosts_per_locality->get()[0].size());
+  EXPECT_EQ(0, params.healthy_hosts_per_locality->get()[1].size());
+  EXPECT_EQ(host_set.degradedHostsPtr(), params.degraded_hosts);
+  EXPECT_EQ(host_set.degradedHostsPerLocalityPtr(), params.degraded_hosts_per_locality);
+  EXPECT_EQ(host_set.excludedHostsPtr(), params.excluded_hosts);
+  EXPECT_EQ(host_set.excludedHostsPerLocalityPtr(), params.excluded_hosts_per_locality);
+  host_set.updateHosts(std::move(params), nullptr, {}, {});
+
+  // The host is excluded as well, so the excluded subsets are recomputed.
+  hosts[2]->healthFlagSet(Host::HealthFlag::PENDING_ACTIVE_HC);
+  params = HostSetImpl::updateHostsParamsForHealthChange(host_set, hosts[2]);
+  EXPECT_EQ(host_set.healthyHostsPtr(), params.healthy_hosts);
+  EXPECT_EQ(host_set.degradedHostsPtr(), params.degraded_hosts);
+  EXPECT_EQ(HostVector({hosts[2]}), params.excluded_hosts->get());
+  EXPECT_EQ(1, params.excluded_hosts_per_locality->get()[1].size());
+  host_set.updateHosts(std::move(params), nullptr, {}, {});
+
+  // A host of another host set doesn't change anything.
+  HostSharedPtr other_host = makeTestHost(info, "tcp://127.0.0.1:83", *time_source);
+  params = HostSetImpl::updateHostsParamsForHealthChange(host_set, other_host);
+  EXPECT_EQ(host_set.healthyHostsPtr(), params.healthy_hosts);
+  EXPECT_EQ(host_set.excludedHostsPtr(), params.excluded_hosts);
+
+  // Without a host, all subsets are recomputed.
+  params = HostSetImpl::updateHostsParamsForHealthChange(host_set, nullptr);
+  EXPECT_EQ(host_set.hostsPtr(), params.hosts);
+  EXPECT_NE(host_set.healthyHostsPtr(), params.healthy_hosts);
+  EXPECT_EQ(HostVector({hosts[0]}), params.healthy_hosts->get());
+  EXPECT_EQ(HostVector({hosts[1]}), params.degraded_hosts->get());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -4,6 +4,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/extensions/filters/http/buffer/v3/buffer.pb.h"
 
+#include "common/buffer/watermark_buffer.h"
 #include "common/http/header_map_impl.h"
 #include "common/runtime/runtime_impl.h"
 
@@ -12,6 +13,7 @@
 
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/http/mocks.h"
+#include "test/mocks/server/overload_manager.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/test_runtime.h"
 
@@ -32,10 +34,10 @@ public:
   BufferFilterConfigSharedPtr setupConfig() {
     envoy::extensions::filters::http::buffer::v3::Buffer proto_config;
     proto_config.mutable_max_request_bytes()->set_value(1024 * 1024);
-    return std::make_shared<BufferFilterConfig>(proto_config);
+    return std::make_shared<BufferFilterConfig>(proto_config, overload_manager_);
   }
 
-  BufferFilterTest() : config_(setupConfig()), filter_(config_) {
+  BufferFilterTest() : config_(setupConfig()), filter_(config_, buffer_limit_reduction_) {
     filter_.setDecoderFilterCallbacks(callbacks_);
   }
 
@@ -49,7 +51,9 @@ public:
   }
 
   NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
+  NiceMock<Server::MockOverloadManager> overload_manager_;
   BufferFilterConfigSharedPtr config_;
+  Server::OverloadActionState buffer_limit_reduction_{Server::OverloadActionState::inactive()};
   BufferFilter filter_;
   // Create a runtime loader, so that tests can manually manipulate runtime guarded features.
   TestScopedRuntime scoped_runtime;
@@ -167,6 +171,40 @@ TEST_F(BufferFilterTest, VHostConfigOverride) {
   filter_.onDestroy();
 }
 
+TEST_F(BufferFilterTest, OverloadReducesBufferLimit) {
+  // Halve the configured 1MiB limit.
+  buffer_limit_reduction_ = Server::OverloadActionState(UnitFloat(0.5));
+  EXPECT_CALL(callbacks_, setDecoderBufferLimit(512U * 1024));
+
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_.decodeHeaders(headers, false));
+  filter_.onDestroy();
+}
+
+TEST_F(BufferFilterTest, OverloadSaturatedKeepsMinimumBufferLimit) {
+  buffer_limit_reduction_ = Server::OverloadActionState::saturated();
+  EXPECT_CALL(callbacks_, setDecoderBufferLimit(Buffer::MinimumScaledBufferLimit));
+
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_.decodeHeaders(headers, false));
+  filter_.onDestroy();
+}
+
+TEST_F(BufferFilterTest, OverloadKeepsSmallRouteBufferLimit) {
+  envoy::extensions::filters::http::buffer::v3::BufferPerRoute route_cfg;
+  route_cfg.mutable_buffer()->mutable_max_request_bytes()->set_value(123);
+  BufferFilterSettings route_settings(route_cfg);
+  routeLocalConfig(&route_settings, nullptr);
+  buffer_limit_reduction_ = Server::OverloadActionState::saturated();
+
+  // Limits that are already below the minimum scaled limit are left alone.
+  EXPECT_CALL(callbacks_, setDecoderBufferLimit(123ULL));
+
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_.decodeHeaders(headers, false));
+  filter_.onDestroy();
+}
+
 TEST_F(BufferFilterTest, RouteDisabledConfigOverride) {
   envoy::extensions::filters::http::buffer::v3::BufferPerRoute vhost_cfg;
   vhost_cfg.set_disabled(true);
@@ -46,6 +46,24 @@ TEST(BufferFilterFactoryTest, BufferFilterCorrectProto) {
   cb(filter_callback);
 }
 
+// The overload state is looked up in the thread local overload state of the worker creating the
+// filter.
+TEST(BufferFilterFactoryTest, OverloadStateLookedUpPerFilter) {
+  envoy::extensions::filters::http::buffer::v3::Buffer config;
+  config.mutable_max_request_bytes()->set_value(1028);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  BufferFilterFactory factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(config, "stats", context);
+  EXPECT_CALL(context.overload_manager_.overload_state_,
+              getState(Server::OverloadActionNames::get().ReduceBufferLimits))
+      .Times(2);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamDecoderFilter(_)).Times(2);
+  cb(filter_callback);
+  cb(filter_callback);
+}
+
 TEST(BufferFilterFactoryTest, BufferFilterEmptyProto) {
   BufferFilterFactory factory;
   auto empty_proto = factory.createEmptyConfigProto();
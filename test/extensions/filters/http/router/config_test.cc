@@ -4,6 +4,9 @@
 #include "envoy/extensions/filters/http/router/v3/router.pb.validate.h"
 #include "envoy/registry/registry.h"
 
+#include "common/router/router.h"
+#include "common/router/shadow_writer_impl.h"
+
 #include "extensions/filters/http/router/config.h"
 
 #include "test/mocks/server/factory_context.h"
@@ -13,6 +16,7 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::ReturnRef;
 
 namespace Envoy {
 namespace Extensions {
@@ -86,6 +90,21 @@ TEST(RouterFilterConfigTest, RouterFilterWithEmptyProtoConfig) {
   cb(filter_callback);
 }
 
+// The router reads the reduce buffer limits action from the worker's thread local overload state.
+TEST(RouterFilterConfigTest, BufferLimitReductionFromOverloadState) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  const Server::OverloadActionState saturated = Server::OverloadActionState::saturated();
+  EXPECT_CALL(context.overload_manager_.overload_state_,
+              getState(Server::OverloadActionNames::get().ReduceBufferLimits))
+      .WillOnce(ReturnRef(saturated));
+
+  Stats::StatNameManagedStorage prefix("stats.", context.scope().symbolTable());
+  Router::FilterConfig config(prefix.statName(), context,
+                              std::make_unique<Router::ShadowWriterImpl>(context.clusterManager()),
+                              envoy::extensions::filters::http::router::v3::Router());
+  EXPECT_TRUE(config.bufferLimitReduction().isSaturated());
+}
+
 // Test that the deprecated extension name still functions.
 TEST(RouterFilterConfigTest, DEPRECATED_FEATURE_TEST(DeprecatedExtensionFilterName)) {
   const std::string deprecated_name = "envoy.router";
@@ -54,6 +54,55 @@ TEST_F(FilterChainTest, CreateFilterChain) {
   config.createFilterChain(callbacks);
 }
 
+TEST_F(FilterChainTest, CreateFilterChainWithFilterLatency) {
+  auto hcm_config = parseHttpConnectionManagerFromYaml(basic_config_);
+  hcm_config.mutable_filter_latency()->set_record_cpu_time(true);
+  HttpConnectionManagerConfig config(hcm_config, context_, date_provider_,
+                                     route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  // Each filter is added after its own recorder is set.
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  Http::FilterLatencyRecorder* buffer_recorder = nullptr;
+  Http::FilterLatencyRecorder* router_recorder = nullptr;
+  {
+    testing::InSequence s;
+    EXPECT_CALL(callbacks, setFilterLatencyRecorder(testing::NotNull()))
+        .WillOnce(testing::SaveArg<0>(&buffer_recorder));
+    EXPECT_CALL(callbacks, addStreamFilter(_)); // Buffer
+    EXPECT_CALL(callbacks, setFilterLatencyRecorder(testing::NotNull()))
+        .WillOnce(testing::SaveArg<0>(&router_recorder));
+    EXPECT_CALL(callbacks, addStreamDecoderFilter(_)); // Router
+  }
+  config.createFilterChain(callbacks);
+  EXPECT_NE(buffer_recorder, router_recorder);
+  EXPECT_TRUE(router_recorder->recordsCpuTime());
+
+  // The recorders are reused by later streams.
+  Http::MockFilterChainFactoryCallbacks more_callbacks;
+  EXPECT_CALL(more_callbacks, setFilterLatencyRecorder(buffer_recorder));
+  EXPECT_CALL(more_callbacks, setFilterLatencyRecorder(router_recorder));
+  EXPECT_CALL(more_callbacks, addStreamFilter(_));
+  EXPECT_CALL(more_callbacks, addStreamDecoderFilter(_));
+  config.createFilterChain(more_callbacks);
+}
+
+TEST_F(FilterChainTest, CreateFilterChainWithFilterLatencyNotSampled) {
+  auto hcm_config = parseHttpConnectionManagerFromYaml(basic_config_);
+  hcm_config.mutable_filter_latency()->mutable_sample_rate()->set_value(0);
+  HttpConnectionManagerConfig config(hcm_config, context_, date_provider_,
+                                     route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  EXPECT_CALL(callbacks, setFilterLatencyRecorder(_)).Times(0);
+  EXPECT_CALL(callbacks, addStreamFilter(_));        // Buffer
+  EXPECT_CALL(callbacks, addStreamDecoderFilter(_)); // Router
+  config.createFilterChain(callbacks);
+}
+
 TEST_F(FilterChainTest, CreateDynamicFilterChain) {
   const std::string yaml_string = R"EOF(
 codec_type: http1
@@ -719,6 +719,24 @@ TEST_F(HttpConnectionManagerConfigTest, DisabledStreamIdleTimeout) {
   EXPECT_EQ(0, config.streamIdleTimeout().count());
 }
 
+// Validate that stream timers default to precise timers and that a granularity is ingested.
+TEST_F(HttpConnectionManagerConfigTest, StreamTimerGranularity) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  stream_timer_granularity: 0.1s
+  route_config:
+    name: local_route
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+  EXPECT_EQ(100, config.streamTimerGranularity().count());
+}
+
 // Validate that deprecated idle_timeout is still ingested.
 TEST_F(HttpConnectionManagerConfigTest, DEPRECATED_FEATURE_TEST(IdleTimeout)) {
   TestDeprecatedV2Api _deprecated_v2_api;
@@ -0,0 +1,158 @@
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+using testing::Return;
+using testing::Throw;
+
+class MockCgroupMemoryStatsReader : public CgroupMemoryStatsReader {
+public:
+  MockCgroupMemoryStatsReader(Filesystem::Instance& file_system)
+      : CgroupMemoryStatsReader(file_system) {}
+
+  MOCK_METHOD(uint64_t, memoryCurrent, ());
+  MOCK_METHOD(absl::optional<uint64_t>, memoryMax, ());
+  MOCK_METHOD(uint64_t, inactiveFile, ());
+  MOCK_METHOD(double, someStallAvg10, ());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class CgroupMemoryMonitorTest : public testing::Test {
+protected:
+  CgroupMemoryMonitorTest()
+      : api_(Api::createApiForTest()),
+        stats_reader_(new MockCgroupMemoryStatsReader(api_->fileSystem())) {}
+
+  std::unique_ptr<CgroupMemoryMonitor> createMonitor() {
+    return std::make_unique<CgroupMemoryMonitor>(
+        config_, std::unique_ptr<CgroupMemoryStatsReader>(stats_reader_));
+  }
+
+  Api::ApiPtr api_;
+  envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config_;
+  // Owned by the monitor.
+  MockCgroupMemoryStatsReader* stats_reader_;
+};
+
+TEST_F(CgroupMemoryMonitorTest, ComputesUsageAgainstCgroupLimit) {
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillOnce(Return(1000));
+  EXPECT_CALL(*stats_reader_, memoryCurrent()).WillOnce(Return(700));
+  EXPECT_CALL(*stats_reader_, inactiveFile()).Times(0);
+  EXPECT_CALL(*stats_reader_, someStallAvg10()).Times(0);
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_FALSE(resource.hasError());
+  EXPECT_DOUBLE_EQ(0.7, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, FollowsLimitChanges) {
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryCurrent()).WillRepeatedly(Return(500));
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillOnce(Return(1000)).WillOnce(Return(625));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.8, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedCgroupUsesConfiguredMax) {
+  config_.set_max_memory_bytes(2000);
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillOnce(Return(absl::nullopt));
+  EXPECT_CALL(*stats_reader_, memoryCurrent()).WillOnce(Return(500));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.25, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedCgroupWithoutConfiguredMax) {
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillOnce(Return(absl::nullopt));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CgroupMemoryMonitorTest, ExcludesInactiveFile) {
+  config_.set_exclude_inactive_file(true);
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillRepeatedly(Return(1000));
+  EXPECT_CALL(*stats_reader_, memoryCurrent()).WillRepeatedly(Return(900));
+  EXPECT_CALL(*stats_reader_, inactiveFile()).WillOnce(Return(300)).WillOnce(Return(1200));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.6, resource.pressure());
+
+  // The inactive file count is sampled separately and may exceed the current usage.
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, UsesStallInformation) {
+  config_.set_stall_percentage_saturation(20);
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillRepeatedly(Return(1000));
+  EXPECT_CALL(*stats_reader_, memoryCurrent()).WillRepeatedly(Return(500));
+  EXPECT_CALL(*stats_reader_, someStallAvg10()).WillOnce(Return(2.0)).WillOnce(Return(15.0));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.75, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, ReportsReadErrors) {
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, memoryMax()).WillOnce(Throw(EnvoyException("no memory.max")));
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
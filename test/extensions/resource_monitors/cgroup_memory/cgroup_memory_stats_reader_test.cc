@@ -0,0 +1,71 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_stats_reader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class CgroupMemoryStatsReaderTest : public testing::Test {
+protected:
+  CgroupMemoryStatsReaderTest()
+      : api_(Api::createApiForTest()), cgroup_root_(TestEnvironment::temporaryPath("cgroup")),
+        reader_(api_->fileSystem(), cgroup_root_) {
+    TestEnvironment::createPath(cgroup_root_);
+  }
+
+  void writeCgroupFile(const std::string& name, const std::string& contents) {
+    TestEnvironment::writeStringToFileForTest(absl::StrCat(cgroup_root_, "/", name), contents,
+                                              true);
+  }
+
+  Api::ApiPtr api_;
+  const std::string cgroup_root_;
+  CgroupMemoryStatsReader reader_;
+};
+
+TEST_F(CgroupMemoryStatsReaderTest, ReadsCurrentAndMax) {
+  writeCgroupFile("memory.current", "104857600\n");
+  writeCgroupFile("memory.max", "209715200\n");
+  EXPECT_EQ(104857600UL, reader_.memoryCurrent());
+  EXPECT_EQ(209715200UL, reader_.memoryMax());
+
+  writeCgroupFile("memory.max", "max\n");
+  EXPECT_EQ(absl::nullopt, reader_.memoryMax());
+}
+
+TEST_F(CgroupMemoryStatsReaderTest, ReadsInactiveFile) {
+  writeCgroupFile("memory.stat", "anon 1000\nfile 5000\nactive_file 3000\ninactive_file 2000\n");
+  EXPECT_EQ(2000UL, reader_.inactiveFile());
+
+  writeCgroupFile("memory.stat", "anon 1000\nfile 5000\n");
+  EXPECT_THROW_WITH_REGEX(reader_.inactiveFile(), EnvoyException, "no inactive_file");
+}
+
+TEST_F(CgroupMemoryStatsReaderTest, ReadsStallAverage) {
+  writeCgroupFile("memory.pressure", "some avg10=12.50 avg60=3.00 avg300=0.50 total=123456\n"
+                                     "full avg10=6.00 avg60=1.00 avg300=0.10 total=65432\n");
+  EXPECT_DOUBLE_EQ(12.5, reader_.someStallAvg10());
+
+  writeCgroupFile("memory.pressure", "full avg10=6.00 avg60=1.00 avg300=0.10 total=65432\n");
+  EXPECT_THROW_WITH_REGEX(reader_.someStallAvg10(), EnvoyException, "no 'some avg10'");
+}
+
+TEST_F(CgroupMemoryStatsReaderTest, Errors) {
+  EXPECT_THROW(reader_.memoryCurrent(), EnvoyException);
+
+  writeCgroupFile("memory.current", "lots\n");
+  EXPECT_THROW_WITH_REGEX(reader_.memoryCurrent(), EnvoyException, "failed to parse");
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,139 @@
+#include "extensions/resource_monitors/cpu_utilization/cpu_stats_reader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+namespace {
+
+// A /proc/self/stat line with utime=1500 and stime=500. The command name contains spaces and a
+// parenthesis to make sure it is skipped correctly.
+const std::string ProcessStat =
+    "1234 (envoy (main) x) S 1 1234 1234 0 -1 4194560 61035 0 0 0 1500 500 0 0 20 0 9 0 "
+    "11235 154537984 5834 18446744073709551615 1 1 0 0 0 0 0 4096 17642 0 0 0 17 0 0 0 0 0 0\n";
+
+// A /proc/stat file whose aggregate cpu line sums up to 10000 ticks (guest columns excluded).
+const std::string HostStat = "cpu  4000 0 1000 4500 200 0 100 200 300 0\n"
+                             "cpu0 2000 0 500 2250 100 0 50 100 150 0\n"
+                             "cpu1 2000 0 500 2250 100 0 50 100 150 0\n"
+                             "intr 12345 0 0\n";
+
+class ProcessCpuStatsReaderTest : public testing::Test {
+protected:
+  ProcessCpuStatsReaderTest()
+      : api_(Api::createApiForTest()),
+        process_stat_path_(TestEnvironment::writeStringToFileForTest("self_stat", ProcessStat)),
+        host_stat_path_(TestEnvironment::writeStringToFileForTest("host_stat", HostStat)) {}
+
+  Api::ApiPtr api_;
+  const std::string process_stat_path_;
+  const std::string host_stat_path_;
+};
+
+TEST_F(ProcessCpuStatsReaderTest, ReadsProcessAndHostTimes) {
+  ProcessCpuStatsReader reader(api_->fileSystem(), process_stat_path_, host_stat_path_);
+  const CpuTimes times = reader.getCpuTimes();
+  EXPECT_EQ(2000, times.work_time_);
+  EXPECT_EQ(10000, times.total_time_);
+}
+
+TEST_F(ProcessCpuStatsReaderTest, MissingFile) {
+  ProcessCpuStatsReader reader(api_->fileSystem(), TestEnvironment::temporaryPath("missing"),
+                               host_stat_path_);
+  EXPECT_THROW(reader.getCpuTimes(), EnvoyException);
+}
+
+TEST_F(ProcessCpuStatsReaderTest, TruncatedProcessStat) {
+  const std::string path =
+      TestEnvironment::writeStringToFileForTest("truncated_self_stat", "1234 (envoy) S 1 2 3\n");
+  ProcessCpuStatsReader reader(api_->fileSystem(), path, host_stat_path_);
+  EXPECT_THROW_WITH_REGEX(reader.getCpuTimes(), EnvoyException, "unexpected format");
+}
+
+TEST_F(ProcessCpuStatsReaderTest, MalformedHostStat) {
+  const std::string path =
+      TestEnvironment::writeStringToFileForTest("bad_host_stat", "cpu  1 2 3 four 5 6 7 8\n");
+  ProcessCpuStatsReader reader(api_->fileSystem(), process_stat_path_, path);
+  EXPECT_THROW_WITH_REGEX(reader.getCpuTimes(), EnvoyException, "failed to parse 'four'");
+}
+
+class CgroupCpuStatsReaderTest : public testing::Test {
+protected:
+  CgroupCpuStatsReaderTest()
+      : api_(Api::createApiForTest()), cgroup_root_(TestEnvironment::temporaryPath("cgroup")) {
+    TestEnvironment::createPath(cgroup_root_);
+  }
+
+  void writeCgroupFile(const std::string& name, const std::string& contents) {
+    TestEnvironment::writeStringToFileForTest(absl::StrCat(cgroup_root_, "/", name), contents,
+                                              true);
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  const std::string cgroup_root_;
+};
+
+TEST_F(CgroupCpuStatsReaderTest, UsesQuota) {
+  writeCgroupFile("cpu.stat", "usage_usec 1000000\nuser_usec 800000\nsystem_usec 200000\n");
+  writeCgroupFile("cpu.max", "200000 100000\n");
+  CgroupCpuStatsReader reader(api_->fileSystem(), time_system_, 8, cgroup_root_);
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  const CpuTimes times = reader.getCpuTimes();
+  EXPECT_EQ(1000000, times.work_time_);
+  // Two CPUs for one second.
+  EXPECT_EQ(2000000, times.total_time_);
+}
+
+TEST_F(CgroupCpuStatsReaderTest, UsesHostCpusWithoutQuota) {
+  writeCgroupFile("cpu.stat", "usage_usec 1000000\n");
+  writeCgroupFile("cpu.max", "max 100000\n");
+  CgroupCpuStatsReader reader(api_->fileSystem(), time_system_, 4, cgroup_root_);
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(4000000, reader.getCpuTimes().total_time_);
+}
+
+TEST_F(CgroupCpuStatsReaderTest, QuotaChangeOnlyAffectsLaterSamples) {
+  writeCgroupFile("cpu.stat", "usage_usec 0\n");
+  writeCgroupFile("cpu.max", "100000 100000\n");
+  CgroupCpuStatsReader reader(api_->fileSystem(), time_system_, 4, cgroup_root_);
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(1000000, reader.getCpuTimes().total_time_);
+
+  writeCgroupFile("cpu.max", "300000 100000\n");
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(4000000, reader.getCpuTimes().total_time_);
+}
+
+TEST_F(CgroupCpuStatsReaderTest, MissingUsage) {
+  writeCgroupFile("cpu.stat", "user_usec 800000\n");
+  writeCgroupFile("cpu.max", "max 100000\n");
+  CgroupCpuStatsReader reader(api_->fileSystem(), time_system_, 4, cgroup_root_);
+  EXPECT_THROW_WITH_REGEX(reader.getCpuTimes(), EnvoyException, "no usage_usec");
+}
+
+TEST_F(CgroupCpuStatsReaderTest, MalformedCpuMax) {
+  writeCgroupFile("cpu.stat", "usage_usec 1000000\n");
+  writeCgroupFile("cpu.max", "max\n");
+  CgroupCpuStatsReader reader(api_->fileSystem(), time_system_, 4, cgroup_root_);
+  EXPECT_THROW_WITH_REGEX(reader.getCpuTimes(), EnvoyException, "unexpected format");
+
+  writeCgroupFile("cpu.max", "100000 0\n");
+  EXPECT_THROW_WITH_REGEX(reader.getCpuTimes(), EnvoyException, "invalid period");
+}
+
+} // namespace
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
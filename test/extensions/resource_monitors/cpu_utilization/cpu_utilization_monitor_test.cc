@@ -0,0 +1,109 @@
+#include "extensions/resource_monitors/cpu_utilization/cpu_utilization_monitor.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+namespace {
+
+using testing::Return;
+using testing::Throw;
+
+class MockCpuStatsReader : public CpuStatsReader {
+public:
+  MockCpuStatsReader() = default;
+
+  MOCK_METHOD(CpuTimes, getCpuTimes, ());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+    error_.reset();
+  }
+
+  void onFailure(const EnvoyException& error) override {
+    error_ = error;
+    pressure_.reset();
+  }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+TEST(CpuUtilizationMonitorTest, ComputesUtilizationBetweenUpdates) {
+  auto stats_reader = std::make_unique<MockCpuStatsReader>();
+  EXPECT_CALL(*stats_reader, getCpuTimes())
+      .WillOnce(Return(CpuTimes{100, 1000}))
+      .WillOnce(Return(CpuTimes{150, 1100}))
+      .WillOnce(Return(CpuTimes{350, 1500}));
+  CpuUtilizationMonitor monitor(std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+}
+
+TEST(CpuUtilizationMonitorTest, KeepsLastUtilizationWhenCountersDoNotAdvance) {
+  auto stats_reader = std::make_unique<MockCpuStatsReader>();
+  EXPECT_CALL(*stats_reader, getCpuTimes())
+      .WillOnce(Return(CpuTimes{0, 0}))
+      .WillOnce(Return(CpuTimes{25, 100}))
+      .WillOnce(Return(CpuTimes{25, 100}))
+      .WillOnce(Return(CpuTimes{10, 200}));
+  CpuUtilizationMonitor monitor(std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.25, resource.pressure());
+
+  // No time elapsed.
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.25, resource.pressure());
+
+  // Work counter went backwards.
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.25, resource.pressure());
+}
+
+TEST(CpuUtilizationMonitorTest, ReportsReadErrors) {
+  auto stats_reader = std::make_unique<MockCpuStatsReader>();
+  EXPECT_CALL(*stats_reader, getCpuTimes())
+      .WillOnce(Throw(EnvoyException("no such file")))
+      .WillOnce(Throw(EnvoyException("no such file")))
+      .WillOnce(Return(CpuTimes{10, 100}))
+      .WillOnce(Return(CpuTimes{30, 200}));
+  CpuUtilizationMonitor monitor(std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasError());
+
+  // The first successful sample after a failed initial sample has no baseline.
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0, resource.pressure());
+
+  monitor.updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(0.2, resource.pressure());
+}
+
+} // namespace
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
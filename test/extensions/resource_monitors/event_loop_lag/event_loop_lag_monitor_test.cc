@@ -0,0 +1,137 @@
+#include "envoy/extensions/resource_monitors/event_loop_lag/v3/event_loop_lag.pb.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/event_loop_lag/event_loop_lag_monitor.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopLagMonitor {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+class MockedCallbacks : public Server::ResourceMonitor::Callbacks {
+public:
+  MOCK_METHOD(void, onSuccess, (const Server::ResourceUsage&));
+  MOCK_METHOD(void, onFailure, (const EnvoyException&));
+};
+
+class EventLoopLagMonitorTest : public testing::Test {
+protected:
+  EventLoopLagMonitorTest() : api_(Api::createApiForTest(time_system_)) {}
+
+  std::unique_ptr<EventLoopLagMonitor> createMonitor(std::chrono::milliseconds max_lag) {
+    envoy::extensions::resource_monitors::event_loop_lag::v3::EventLoopLagConfig config;
+    config.mutable_max_lag()->set_nanos(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(max_lag).count());
+    Server::Configuration::ResourceMonitorFactoryContextImpl context(
+        dispatcher_, options_, *api_, ProtobufMessage::getStrictValidationVisitor(), tls_);
+    return std::make_unique<EventLoopLagMonitor>(config, context);
+  }
+
+  // Runs one probe per entry in lags, each after the given delay since the probes were posted. The
+  // mock dispatchers use the global time system, which follows time_system_.
+  void expectProbesWithLag(std::vector<std::chrono::milliseconds> lags) {
+    EXPECT_CALL(tls_, runOnAllThreads(_, _))
+        .WillOnce(Invoke([this, lags](Event::PostCb cb, Event::PostCb complete_cb) {
+          std::chrono::milliseconds elapsed(0);
+          for (const auto lag : lags) {
+            time_system_.advanceTimeWait(lag - elapsed);
+            elapsed = lag;
+            cb();
+          }
+          complete_cb();
+        }));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Server::MockOptions options_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  MockedCallbacks callbacks_;
+};
+
+TEST_F(EventLoopLagMonitorTest, ReportsMaxLagAcrossThreads) {
+  auto monitor = createMonitor(std::chrono::milliseconds(100));
+
+  expectProbesWithLag({std::chrono::milliseconds(0), std::chrono::milliseconds(50),
+                       std::chrono::milliseconds(20)});
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{0.5}));
+  monitor->updateResourceUsage(callbacks_);
+
+  expectProbesWithLag({std::chrono::milliseconds(0), std::chrono::milliseconds(200)});
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{2.0}));
+  monitor->updateResourceUsage(callbacks_);
+}
+
+TEST_F(EventLoopLagMonitorTest, NoLag) {
+  auto monitor = createMonitor(std::chrono::milliseconds(10));
+
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(callbacks_);
+}
+
+// A worker that doesn't run its probe is reported with the time since the probe was posted, and
+// no further probes are posted until it runs.
+TEST_F(EventLoopLagMonitorTest, ReportsOutstandingProbe) {
+  auto monitor = createMonitor(std::chrono::milliseconds(100));
+
+  Event::PostCb deferred_cb;
+  Event::PostCb deferred_complete_cb;
+  EXPECT_CALL(tls_, runOnAllThreads(_, _))
+      .WillOnce(Invoke([&](Event::PostCb cb, Event::PostCb complete_cb) {
+        deferred_cb = cb;
+        deferred_complete_cb = complete_cb;
+      }));
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(callbacks_);
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(30));
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{0.3}));
+  monitor->updateResourceUsage(callbacks_);
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(20));
+  deferred_cb();
+  deferred_complete_cb();
+
+  // The completed round's lag is reported until the next round completes.
+  EXPECT_CALL(tls_, runOnAllThreads(_, _)).WillOnce(Invoke([](Event::PostCb, Event::PostCb) {}));
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{0.5}));
+  monitor->updateResourceUsage(callbacks_);
+}
+
+TEST_F(EventLoopLagMonitorTest, NoUpdateAfterDestruction) {
+  auto monitor = createMonitor(std::chrono::milliseconds(10));
+
+  Event::PostCb deferred_complete_cb;
+  EXPECT_CALL(tls_, runOnAllThreads(_, _))
+      .WillOnce(Invoke([&](Event::PostCb cb, Event::PostCb complete_cb) {
+        cb();
+        deferred_complete_cb = complete_cb;
+      }));
+  EXPECT_CALL(callbacks_, onSuccess(Server::ResourceUsage{0}));
+  monitor->updateResourceUsage(callbacks_);
+  monitor.reset();
+
+  deferred_complete_cb();
+}
+
+} // namespace
+} // namespace EventLoopLagMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
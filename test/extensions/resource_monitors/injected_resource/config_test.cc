@@ -9,6 +9,7 @@
 #include "extensions/resource_monitors/injected_resource/config.h"
 
 #include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
@@ -31,8 +32,9 @@ TEST(InjectedResourceMonitorFactoryTest, CreateMonitor) {
   Api::ApiPtr api = Api::createApiForTest();
   Event::DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
   Server::MockOptions options;
+  ThreadLocal::MockInstance tls;
   Server::Configuration::ResourceMonitorFactoryContextImpl context(
-      *dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+      *dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor(), tls);
   Server::ResourceMonitorPtr monitor = factory->createResourceMonitor(config, context);
   EXPECT_NE(monitor, nullptr);
 }
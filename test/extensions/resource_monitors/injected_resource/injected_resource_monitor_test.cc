@@ -8,6 +8,7 @@
 #include "extensions/resource_monitors/injected_resource/injected_resource_monitor.h"
 
 #include "test/mocks/server/options.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
@@ -65,13 +66,14 @@ protected:
     envoy::extensions::resource_monitors::injected_resource::v3::InjectedResourceConfig config;
     config.set_filename(resource_filename_);
     Server::Configuration::ResourceMonitorFactoryContextImpl context(
-        *dispatcher_, options_, *api_, ProtobufMessage::getStrictValidationVisitor());
+        *dispatcher_, options_, *api_, ProtobufMessage::getStrictValidationVisitor(), tls_);
     return std::make_unique<TestableInjectedResourceMonitor>(config, context);
   }
 
   Api::ApiPtr api_;
   Event::DispatcherPtr dispatcher_;
   Server::MockOptions options_;
+  ThreadLocal::MockInstance tls_;
   const std::string resource_filename_;
   AtomicFileUpdater file_updater_;
   MockedCallbacks cb_;
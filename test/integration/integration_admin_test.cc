@@ -487,6 +487,21 @@ TEST_P(IntegrationAdminTest, AdminCpuProfilerStart) {
   EXPECT_EQ("200", request("admin", "POST", "/cpuprofiler?enable=n", response));
 }
 
+TEST_P(IntegrationAdminTest, AdminCpuProfilerCollapsed) {
+  initialize();
+  BufferingStreamDecoderPtr response;
+  EXPECT_EQ("400", request("admin", "POST", "/cpuprofiler/collapsed?seconds=0", response));
+  EXPECT_EQ("400", request("admin", "POST", "/cpuprofiler/collapsed?hz=5000", response));
+
+  // The response only completes once the profile has been taken.
+#ifndef WIN32
+  EXPECT_EQ("200", request("admin", "POST", "/cpuprofiler/collapsed?seconds=1", response));
+  EXPECT_EQ("text/plain; charset=UTF-8", ContentType(response));
+#else
+  EXPECT_EQ("500", request("admin", "POST", "/cpuprofiler/collapsed?seconds=1", response));
+#endif
+}
+
 class IntegrationAdminIpv4Ipv6Test : public testing::Test, public HttpIntegrationTest {
 public:
   IntegrationAdminIpv4Ipv6Test()
@@ -592,4 +592,46 @@ TEST_P(Http2UpstreamIntegrationTest, MultipleRequestsLowStreamLimit) {
   response2->waitForEndStream();
 }
 
+// Idempotent requests are sent as early (0-RTT) data on new upstream HTTP/3 connections which
+// resume the TLS session of a previous connection to the same host.
+TEST_P(Http2UpstreamIntegrationTest, UpstreamZeroRtt) {
+  if (upstreamProtocol() != FakeHttpConnection::Type::HTTP3) {
+    return;
+  }
+  autonomous_upstream_ = true;
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    // Send each request on a new upstream connection.
+    auto* cluster = bootstrap.mutable_static_resources()->mutable_clusters(0);
+    cluster->mutable_max_requests_per_connection()->set_value(1);
+  });
+  initialize();
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+
+  auto response = codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+  response->waitForEndStream();
+  EXPECT_EQ("200", response->headers().getStatusValue());
+  // The first connection has no session to resume.
+  EXPECT_EQ(0, test_server_->counter("cluster.cluster_0.upstream_rq_0rtt")->value());
+  EXPECT_EQ(0, test_server_->counter("cluster.cluster_0.http3.zero_rtt_accepted")->value());
+
+  auto response2 = codec_client_->makeHeaderOnlyRequest(default_request_headers_);
+  response2->waitForEndStream();
+  EXPECT_EQ("200", response2->headers().getStatusValue());
+  EXPECT_EQ(1, test_server_->counter("cluster.cluster_0.upstream_rq_0rtt")->value());
+  test_server_->waitForCounterEq("cluster.cluster_0.http3.zero_rtt_accepted", 1);
+  EXPECT_EQ(0, test_server_->counter("cluster.cluster_0.http3.zero_rtt_rejected")->value());
+
+  // Requests which are not safe to replay wait for the handshake to complete.
+  auto response3 = codec_client_->makeRequestWithBody(
+      Http::TestRequestHeaderMapImpl{{":method", "POST"},
+                                     {":path", "/test/long/url"},
+                                     {":scheme", "http"},
+                                     {":authority", "host"}},
+      10);
+  response3->waitForEndStream();
+  EXPECT_EQ("200", response3->headers().getStatusValue());
+  test_server_->waitForCounterEq("cluster.cluster_0.upstream_cx_total", 3);
+  EXPECT_EQ(1, test_server_->counter("cluster.cluster_0.upstream_rq_0rtt")->value());
+}
+
 } // namespace Envoy
@@ -244,6 +244,54 @@ TEST_P(OverloadIntegrationTest, StopAcceptingConnectionsWhenOverloaded) {
   codec_client_->close();
 }
 
+TEST_P(OverloadIntegrationTest, ResetLargestStreamsWhenOverloaded) {
+  // The buffer filter holds each request body in Envoy until the request is complete.
+  config_helper_.addFilter(ConfigHelper::defaultBufferFilter());
+  initializeOverloadManager(
+      TestUtility::parseYaml<envoy::config::overload::v3::OverloadAction>(R"EOF(
+      name: "envoy.overload_actions.reset_high_memory_stream"
+      triggers:
+        - name: "envoy.resource_monitors.testonly.fake_resource_monitor"
+          scaled:
+            scaling_threshold: 0.5
+            saturation_threshold: 0.9
+    )EOF"));
+
+  // Start a request with a small body, which is too small for its account to be tracked.
+  IntegrationCodecClientPtr small_client = makeHttpConnection(lookupPort("http"));
+  auto small_request = small_client->startRequest(default_request_headers_);
+  IntegrationStreamDecoderPtr small_response = std::move(small_request.second);
+  small_client->sendData(small_request.first, 1024, false);
+
+  // Start a request with a 1MiB body on another connection.
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+  auto large_request = codec_client_->startRequest(default_request_headers_);
+  IntegrationStreamDecoderPtr large_response = std::move(large_request.second);
+  codec_client_->sendData(large_request.first, 1024 * 1024, false);
+  test_server_->waitForGaugeEq("buffer_memory_account.bucket_2_bytes", 1024 * 1024);
+
+  // Only the stream holding the most memory is reset under memory pressure.
+  updateResource(0.95);
+  test_server_->waitForCounterEq("buffer_memory_account.streams_reset", 1);
+  if (downstreamProtocol() == Http::CodecClient::Type::HTTP1) {
+    ASSERT_TRUE(codec_client_->waitForDisconnect());
+  } else {
+    large_response->waitForReset();
+  }
+  test_server_->waitForGaugeEq("buffer_memory_account.bucket_2_bytes", 0);
+
+  // The small request is unaffected.
+  updateResource(0);
+  small_client->sendData(small_request.first, 0, true);
+  waitForNextUpstreamRequest();
+  upstream_request_->encodeHeaders(default_response_headers_, true);
+  small_response->waitForEndStream();
+  EXPECT_TRUE(small_response->complete());
+  EXPECT_EQ("200", small_response->headers().getStatusValue());
+  EXPECT_EQ(1024U, upstream_request_->bodyLength());
+  small_client->close();
+}
+
 class OverloadScaledTimerIntegrationTest : public OverloadIntegrationTest {
 protected:
   void initializeOverloadManager(
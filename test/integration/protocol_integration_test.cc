@@ -2179,6 +2179,45 @@ TEST_P(DownstreamProtocolIntegrationTest, TestPreconnect) {
   }
 }
 
+TEST_P(DownstreamProtocolIntegrationTest, TestPrewarmMinReadyConnections) {
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    auto* cluster = bootstrap.mutable_static_resources()->mutable_clusters(0);
+    cluster->mutable_preconnect_policy()->set_min_ready_connections(2);
+  });
+  initialize();
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+  auto response =
+      sendRequestAndWaitForResponse(default_request_headers_, 0, default_response_headers_, 0);
+  // Regardless of the protocol, a second connection is established ahead of demand.
+  FakeHttpConnectionPtr fake_upstream_connection_two;
+  ASSERT_TRUE(
+      fake_upstreams_[0]->waitForHttpConnection(*dispatcher_, fake_upstream_connection_two));
+  EXPECT_EQ(1, test_server_->counter("cluster.cluster_0.upstream_rq_prewarm_miss")->value());
+  EXPECT_EQ(0, test_server_->counter("cluster.cluster_0.upstream_rq_prewarm_hit")->value());
+}
+
+TEST_P(DownstreamProtocolIntegrationTest, TestPrewarmForArrivalRate) {
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    auto* cluster = bootstrap.mutable_static_resources()->mutable_clusters(0);
+    cluster->mutable_preconnect_policy()->mutable_arrival_rate_lookahead()->set_seconds(10);
+  });
+  initialize();
+  codec_client_ = makeHttpConnection(lookupPort("http"));
+  auto response =
+      sendRequestAndWaitForResponse(default_request_headers_, 0, default_response_headers_, 0);
+  FakeHttpConnectionPtr fake_upstream_connection_two;
+  if (upstreamProtocol() == FakeHttpConnection::Type::HTTP1) {
+    // The first stream anticipates another one within the lookahead, which needs a second
+    // HTTP/1.1 connection.
+    ASSERT_TRUE(
+        fake_upstreams_[0]->waitForHttpConnection(*dispatcher_, fake_upstream_connection_two));
+  } else {
+    // For HTTP/2, the original connection can accommodate the anticipated stream.
+    ASSERT_FALSE(fake_upstreams_[0]->waitForHttpConnection(
+        *dispatcher_, fake_upstream_connection_two, std::chrono::milliseconds(5)));
+  }
+}
+
 TEST_P(DownstreamProtocolIntegrationTest, BasicMaxStreamTimeout) {
   config_helper_.setDownstreamMaxStreamDuration(std::chrono::milliseconds(500));
   initialize();
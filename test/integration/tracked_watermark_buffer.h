@@ -47,6 +47,12 @@ public:
   Buffer::InstancePtr create(std::function<void()> below_low_watermark,
                              std::function<void()> above_high_watermark,
                              std::function<void()> above_overflow_watermark) override;
+  // Memory accounts are not tracked by this factory.
+  void enableAccountTracking(Stats::Scope&) override {}
+  Buffer::BufferMemoryAccountSharedPtr createAccount(std::function<void()>) override {
+    return nullptr;
+  }
+  uint64_t resetAccountsGivenPressure(float) override { return 0; }
 
   // Number of buffers created.
   uint64_t numBuffersCreated() const;
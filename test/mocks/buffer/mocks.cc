@@ -27,4 +27,7 @@ template <> MockBufferBase<Buffer::OwnedImpl>::MockBufferBase() : Buffer::OwnedI
 MockBufferFactory::MockBufferFactory() = default;
 MockBufferFactory::~MockBufferFactory() = default;
 
+MockBufferMemoryAccount::MockBufferMemoryAccount() = default;
+MockBufferMemoryAccount::~MockBufferMemoryAccount() = default;
+
 } // namespace Envoy
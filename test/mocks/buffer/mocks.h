@@ -84,6 +84,22 @@ public:
   MOCK_METHOD(Buffer::Instance*, create_,
               (std::function<void()> below_low, std::function<void()> above_high,
                std::function<void()> above_overflow));
+  MOCK_METHOD(void, enableAccountTracking, (Stats::Scope & scope));
+  MOCK_METHOD(Buffer::BufferMemoryAccountSharedPtr, createAccount,
+              (std::function<void()> reset_stream));
+  MOCK_METHOD(uint64_t, resetAccountsGivenPressure, (float pressure));
+};
+
+class MockBufferMemoryAccount : public Buffer::BufferMemoryAccount {
+public:
+  MockBufferMemoryAccount();
+  ~MockBufferMemoryAccount() override;
+
+  MOCK_METHOD(uint64_t, balance, (), (const));
+  MOCK_METHOD(void, charge, (uint64_t amount));
+  MOCK_METHOD(void, credit, (uint64_t amount));
+  MOCK_METHOD(void, resetDownstream, ());
+  MOCK_METHOD(void, clearDownstream, ());
 };
 
 MATCHER_P(BufferEqual, rhs, testing::PrintToString(*rhs)) {
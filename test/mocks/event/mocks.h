@@ -99,6 +99,14 @@ public:
     return timer;
   }
 
+  Event::TimerPtr createCoarseTimer(std::chrono::milliseconds granularity,
+                                    Event::TimerCb cb) override {
+    auto timer = Event::TimerPtr{createCoarseTimer_(granularity, cb)};
+    // Assert that the timer is not null to avoid confusing test failures down the line.
+    ASSERT(timer != nullptr);
+    return timer;
+  }
+
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override {
     auto schedulable_cb = Event::SchedulableCallbackPtr{createSchedulableCallback_(cb)};
     if (!allow_null_callback_) {
@@ -145,6 +153,8 @@ public:
   MOCK_METHOD(Timer*, createTimer_, (Event::TimerCb cb));
   MOCK_METHOD(Timer*, createScaledTimer_, (ScaledTimerMinimum minimum, Event::TimerCb cb));
   MOCK_METHOD(Timer*, createScaledTypedTimer_, (ScaledTimerType timer_type, Event::TimerCb cb));
+  MOCK_METHOD(Timer*, createCoarseTimer_,
+              (std::chrono::milliseconds granularity, Event::TimerCb cb));
   MOCK_METHOD(SchedulableCallback*, createSchedulableCallback_, (std::function<void()> cb));
   MOCK_METHOD(void, deferredDelete_, (DeferredDeletable * to_delete));
   MOCK_METHOD(void, exit, ());
@@ -86,6 +86,10 @@ public:
     return impl_.createScaledTimer(timer_type, std::move(cb));
   }
 
+  TimerPtr createCoarseTimer(std::chrono::milliseconds granularity, TimerCb cb) override {
+    return impl_.createCoarseTimer(granularity, std::move(cb));
+  }
+
   Event::SchedulableCallbackPtr createSchedulableCallback(std::function<void()> cb) override {
     return impl_.createSchedulableCallback(std::move(cb));
   }
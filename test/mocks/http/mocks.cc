@@ -168,6 +168,9 @@ MockAsyncClientStream::~MockAsyncClientStream() = default;
 MockFilterChainFactoryCallbacks::MockFilterChainFactoryCallbacks() = default;
 MockFilterChainFactoryCallbacks::~MockFilterChainFactoryCallbacks() = default;
 
+MockFilterLatencyRecorder::MockFilterLatencyRecorder() = default;
+MockFilterLatencyRecorder::~MockFilterLatencyRecorder() = default;
+
 } // namespace Http
 
 namespace Http {
@@ -145,6 +145,7 @@ public:
   MOCK_METHOD(Protocol, protocol, ());
   MOCK_METHOD(void, shutdownNotice, ());
   MOCK_METHOD(bool, wantsToWrite, ());
+  MOCK_METHOD(void, flushPendingWrites, ());
   MOCK_METHOD(void, onUnderlyingConnectionAboveWriteBufferHighWatermark, ());
   MOCK_METHOD(void, onUnderlyingConnectionBelowWriteBufferLowWatermark, ());
 
@@ -162,6 +163,7 @@ public:
   MOCK_METHOD(Protocol, protocol, ());
   MOCK_METHOD(void, shutdownNotice, ());
   MOCK_METHOD(bool, wantsToWrite, ());
+  MOCK_METHOD(void, flushPendingWrites, ());
   MOCK_METHOD(void, onUnderlyingConnectionAboveWriteBufferHighWatermark, ());
   MOCK_METHOD(void, onUnderlyingConnectionBelowWriteBufferLowWatermark, ());
 
@@ -219,6 +221,7 @@ public:
   MOCK_METHOD(bool, recreateStream, (const ResponseHeaderMap* headers));
   MOCK_METHOD(void, addUpstreamSocketOptions, (const Network::Socket::OptionsSharedPtr& options));
   MOCK_METHOD(Network::Socket::OptionsSharedPtr, getUpstreamSocketOptions, (), (const));
+  MOCK_METHOD(Buffer::BufferMemoryAccountSharedPtr, account, (), (const));
 
   // Http::StreamDecoderFilterCallbacks
   void sendLocalReply_(Code code, absl::string_view body,
@@ -504,6 +507,19 @@ public:
               (Http::StreamFilterSharedPtr filter,
                Matcher::MatchTreeSharedPtr<HttpMatchingData> match_tree));
   MOCK_METHOD(void, addAccessLogHandler, (AccessLog::InstanceSharedPtr handler));
+  MOCK_METHOD(void, setFilterLatencyRecorder, (FilterLatencyRecorder* recorder));
+};
+
+class MockFilterLatencyRecorder : public FilterLatencyRecorder {
+public:
+  MockFilterLatencyRecorder();
+  ~MockFilterLatencyRecorder() override;
+
+  MOCK_METHOD(bool, recordsCpuTime, (), (const));
+  MOCK_METHOD(void, recordDecode,
+              (std::chrono::microseconds duration, std::chrono::microseconds cpu_time));
+  MOCK_METHOD(void, recordEncode,
+              (std::chrono::microseconds duration, std::chrono::microseconds cpu_time));
 };
 
 class MockDownstreamWatermarkCallbacks : public DownstreamWatermarkCallbacks {
@@ -546,6 +562,7 @@ public:
   MOCK_METHOD(std::chrono::milliseconds, streamIdleTimeout, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, requestTimeout, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, requestHeadersTimeout, (), (const));
+  MOCK_METHOD(std::chrono::milliseconds, streamTimerGranularity, (), (const));
   MOCK_METHOD(std::chrono::milliseconds, delayedCloseTimeout, (), (const));
   MOCK_METHOD(Router::RouteConfigProvider*, routeConfigProvider, ());
   MOCK_METHOD(Config::ConfigProvider*, scopedRouteConfigProvider, ());
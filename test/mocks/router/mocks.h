@@ -558,6 +558,7 @@ class MockUpstreamToDownstream : public UpstreamToDownstream {
 public:
   MOCK_METHOD(const RouteEntry&, routeEntry, (), (const));
   MOCK_METHOD(const Network::Connection&, connection, (), (const));
+  MOCK_METHOD(Buffer::BufferMemoryAccountSharedPtr, account, (), (const));
 
   MOCK_METHOD(void, decodeData, (Buffer::Instance&, bool));
   MOCK_METHOD(void, decodeMetadata, (Http::MetadataMapPtr &&));
@@ -96,6 +96,10 @@ public:
               (const));
   MOCK_METHOD(float, perUpstreamPreconnectRatio, (), (const));
   MOCK_METHOD(float, peekaheadRatio, (), (const));
+  MOCK_METHOD(uint32_t, minReadyConnections, (), (const));
+  MOCK_METHOD(std::chrono::milliseconds, arrivalRateLookahead, (), (const));
+  MOCK_METHOD(envoy::config::cluster::v3::Cluster::ConnectionSelectionPolicy,
+              connectionSelectionPolicy, (), (const));
   MOCK_METHOD(uint32_t, perConnectionBufferLimitBytes, (), (const));
   MOCK_METHOD(uint64_t, features, (), (const));
   MOCK_METHOD(const Http::Http1Settings&, http1Settings, (), (const));
@@ -0,0 +1,167 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+//
+// Compares the costs of transferring the stats of a hot restart parent to the child as the
+// protobuf maps of a HotRestartMessage, and as a flat snapshot the child reads in place. Both
+// cover exporting the parent's used stats, moving them between the processes, and merging them
+// into the child's store, which for the snapshot is modelled by a heap buffer rather than shared
+// memory.
+
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/stats/stat_merger.h"
+#include "common/stats/stat_snapshot.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "source/server/hot_restart.pb.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+using HotRestartMessage = envoy::HotRestartMessage;
+
+// Parent and child stores holding state.range(0) counters and a tenth as many gauges.
+class StatsTransferBenchmark {
+public:
+  explicit StatsTransferBenchmark(int64_t num_counters)
+      : parent_store_(parent_symbol_table_), child_store_(child_symbol_table_),
+        stat_merger_(child_store_) {
+    for (int64_t i = 0; i < num_counters; ++i) {
+      parent_store_.counterFromString(
+          fmt::format("cluster.cluster_{}.upstream_rq_{}", i / 10, 200 + i % 10));
+      if (i % 10 == 0) {
+        parent_store_.gaugeFromString(fmt::format("cluster.cluster_{}.upstream_cx_active", i / 10),
+                                      Envoy::Stats::Gauge::ImportMode::Accumulate);
+      }
+    }
+    counters_ = parent_store_.counters();
+    gauges_ = parent_store_.gauges();
+  }
+
+  // Gives every parent stat a value to export, as traffic would between two transfers.
+  void recordTraffic() {
+    for (const auto& counter : counters_) {
+      counter->inc();
+    }
+    for (const auto& gauge : gauges_) {
+      gauge->inc();
+    }
+  }
+
+  void transferProto() {
+    HotRestartMessage::Reply::Stats stats;
+    for (const auto& gauge : gauges_) {
+      if (gauge->used()) {
+        const std::string name = gauge->name();
+        (*stats.mutable_gauges())[name] = gauge->value();
+        addDynamics(stats, name, gauge->statName());
+      }
+    }
+    for (const auto& counter : counters_) {
+      if (counter->used()) {
+        const uint64_t latched_value = counter->latch();
+        if (latched_value > 0) {
+          const std::string name = counter->name();
+          (*stats.mutable_counter_deltas())[name] = latched_value;
+          addDynamics(stats, name, counter->statName());
+        }
+      }
+    }
+    const std::string serialized = stats.SerializeAsString();
+
+    HotRestartMessage::Reply::Stats received;
+    received.ParseFromString(serialized);
+    Envoy::Stats::StatMerger::DynamicsMap dynamics;
+    for (const auto& iter : received.dynamics()) {
+      Envoy::Stats::DynamicSpans& spans = dynamics[iter.first];
+      for (const auto& span : iter.second.spans()) {
+        spans.emplace_back(span.first(), span.last());
+      }
+    }
+    stat_merger_.mergeStats(received.counter_deltas(), received.gauges(), dynamics);
+  }
+
+  void transferSnapshot() {
+    Envoy::Stats::StatSnapshotWriter writer;
+    for (const auto& gauge : gauges_) {
+      if (gauge->used()) {
+        writer.addGauge(gauge->name(), gauge->value(),
+                        parent_symbol_table_.getDynamicSpans(gauge->statName()));
+      }
+    }
+    for (const auto& counter : counters_) {
+      if (counter->used()) {
+        const uint64_t latched_value = counter->latch();
+        if (latched_value > 0) {
+          writer.addCounter(counter->name(), latched_value,
+                            parent_symbol_table_.getDynamicSpans(counter->statName()));
+        }
+      }
+    }
+    std::vector<uint64_t> shared_memory(writer.size() / sizeof(uint64_t));
+    writer.write(reinterpret_cast<uint8_t*>(shared_memory.data()));
+
+    Envoy::Stats::StatSnapshotReader snapshot;
+    RELEASE_ASSERT(
+        snapshot.parse(reinterpret_cast<const uint8_t*>(shared_memory.data()), writer.size()), "");
+    stat_merger_.mergeStats(snapshot);
+  }
+
+private:
+  void addDynamics(HotRestartMessage::Reply::Stats& stats, const std::string& name,
+                   Envoy::Stats::StatName stat_name) {
+    const Envoy::Stats::DynamicSpans spans = parent_symbol_table_.getDynamicSpans(stat_name);
+    if (!spans.empty()) {
+      HotRestartMessage::Reply::RepeatedSpan& spans_proto = (*stats.mutable_dynamics())[name];
+      for (const Envoy::Stats::DynamicSpan& span : spans) {
+        HotRestartMessage::Reply::Span* span_proto = spans_proto.add_spans();
+        span_proto->set_first(span.first);
+        span_proto->set_last(span.second);
+      }
+    }
+  }
+
+  Envoy::Stats::SymbolTableImpl parent_symbol_table_;
+  Envoy::Stats::SymbolTableImpl child_symbol_table_;
+  Envoy::Stats::IsolatedStoreImpl parent_store_;
+  Envoy::Stats::IsolatedStoreImpl child_store_;
+  Envoy::Stats::StatMerger stat_merger_;
+  std::vector<Envoy::Stats::CounterSharedPtr> counters_;
+  std::vector<Envoy::Stats::GaugeSharedPtr> gauges_;
+};
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmTransferProto(benchmark::State& state) {
+  StatsTransferBenchmark context(state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    context.recordTraffic();
+    state.ResumeTiming();
+    context.transferProto();
+  }
+}
+BENCHMARK(bmTransferProto)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmTransferSnapshot(benchmark::State& state) {
+  StatsTransferBenchmark context(state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    state.PauseTiming();
+    context.recordTraffic();
+    state.ResumeTiming();
+    context.transferSnapshot();
+  }
+}
+BENCHMARK(bmTransferSnapshot)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -1,14 +1,19 @@
 #include <memory>
 
+#include "common/api/os_sys_calls_impl_hot_restart.h"
+
 #include "server/hot_restarting_child.h"
 #include "server/hot_restarting_parent.h"
 
+#include "test/mocks/api/hot_restart.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::InSequence;
 using testing::Return;
 using testing::ReturnRef;
@@ -152,6 +157,117 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+// The child merges the snapshot the parent wrote into shared memory, dynamic stat names included.
+TEST_F(HotRestartingParentTest, ExportStatsSnapshotToChild) {
+  MockListenerManager listener_manager;
+  Stats::SymbolTableImpl parent_symbol_table;
+  Stats::TestUtil::TestStore parent_store(parent_symbol_table);
+
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(parent_store));
+
+  Stats::SymbolTableImpl child_symbol_table;
+  Stats::TestUtil::TestStore child_store(child_symbol_table);
+  Stats::StatNameDynamicPool child_dynamic(child_store.symbolTable());
+  Stats::Counter& c1 = child_store.counter("c1");
+  Stats::Counter& c2 = child_store.counterFromStatName(child_dynamic.add("c2"));
+  Stats::Gauge& g1 = child_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate);
+  Stats::Gauge& g2 =
+      child_store.gaugeFromStatName(child_dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate);
+  // The child names its snapshot after its base id and restart epoch.
+  HotRestartingChild hot_restarting_child(0, 0, "@envoy_domain_socket", 0);
+  const std::string shared_memory_name = "/envoy_hot_restart_stats_0_0";
+
+  Stats::StatNameDynamicPool parent_dynamic(parent_store.symbolTable());
+  parent_store.counter("c1").inc();
+  parent_store.counterFromStatName(parent_dynamic.add("c2")).add(2);
+  parent_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  parent_store.gaugeFromStatName(parent_dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate)
+      .set(42);
+  {
+    HotRestartMessage::Reply::Stats stats_proto;
+    hot_restarting_parent_.exportStatsSnapshotToChild(shared_memory_name, &stats_proto);
+    EXPECT_GT(stats_proto.shared_memory_size(), 0);
+    EXPECT_TRUE(stats_proto.counter_deltas().empty());
+    EXPECT_TRUE(stats_proto.gauges().empty());
+    EXPECT_EQ(3, stats_proto.num_connections());
+
+    hot_restarting_child.mergeParentStats(child_store, stats_proto);
+    EXPECT_EQ(1, c1.value());
+    EXPECT_EQ(2, c2.value());
+    EXPECT_EQ(123, g1.value());
+    EXPECT_EQ(42, g2.value());
+  }
+
+  // Only the counter deltas since the last export are sent.
+  parent_store.counter("c1").add(5);
+  parent_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(100);
+  {
+    HotRestartMessage::Reply::Stats stats_proto;
+    hot_restarting_parent_.exportStatsSnapshotToChild(shared_memory_name, &stats_proto);
+    hot_restarting_child.mergeParentStats(child_store, stats_proto);
+    EXPECT_EQ(6, c1.value());
+    EXPECT_EQ(2, c2.value());
+    EXPECT_EQ(100, g1.value());
+  }
+}
+
+// A snapshot that can't be read in full is skipped rather than merged.
+TEST_F(HotRestartingParentTest, ChildSkipsTruncatedStatsSnapshot) {
+  MockListenerManager listener_manager;
+  Stats::TestUtil::TestStore parent_store;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(0));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(parent_store));
+
+  Stats::TestUtil::TestStore child_store;
+  Stats::Counter& c1 = child_store.counter("c1");
+  HotRestartingChild hot_restarting_child(0, 0, "@envoy_domain_socket", 0);
+
+  parent_store.counter("c1").inc();
+  HotRestartMessage::Reply::Stats stats_proto;
+  hot_restarting_parent_.exportStatsSnapshotToChild("/envoy_hot_restart_stats_0_0", &stats_proto);
+  ASSERT_GT(stats_proto.shared_memory_size(), 0);
+  stats_proto.set_shared_memory_size(stats_proto.shared_memory_size() + 4096);
+  hot_restarting_child.mergeParentStats(child_store, stats_proto);
+  EXPECT_EQ(0, c1.value());
+
+  // The snapshot was removed along the way, so the next one can't be opened either.
+  hot_restarting_child.mergeParentStats(child_store, stats_proto);
+  EXPECT_EQ(0, c1.value());
+}
+
+// If the snapshot can't be written to shared memory, the latched stats are sent in the maps.
+TEST_F(HotRestartingParentTest, ExportStatsSnapshotFallback) {
+  Api::MockHotRestartOsSysCalls hot_restart_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::HotRestartOsSysCallsImpl> hot_restart_os_calls(
+      &hot_restart_os_sys_calls);
+  EXPECT_CALL(hot_restart_os_sys_calls, shmUnlink(_));
+  EXPECT_CALL(hot_restart_os_sys_calls, shmOpen(_, O_RDWR | O_CREAT | O_EXCL, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EACCES}));
+
+  Stats::TestUtil::TestStore store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(0));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+
+  Stats::StatNameDynamicPool dynamic(store.symbolTable());
+  store.counter("c1").inc();
+  store.counterFromStatName(dynamic.add("c2")).add(2);
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  HotRestartMessage::Reply::Stats stats;
+  hot_restarting_parent_.exportStatsSnapshotToChild("/envoy_hot_restart_stats_test", &stats);
+  EXPECT_EQ(0, stats.shared_memory_size());
+  EXPECT_EQ(1, stats.counter_deltas().at("c1"));
+  EXPECT_EQ(2, stats.counter_deltas().at("c2"));
+  EXPECT_EQ(123, stats.gauges().at("g1"));
+  ASSERT_EQ(1, stats.dynamics().at("c2").spans_size());
+  EXPECT_EQ(0, stats.dynamics().at("c2").spans(0).first());
+  EXPECT_EQ(0, stats.dynamics().at("c2").spans(0).last());
+}
+
 TEST_F(HotRestartingParentTest, DrainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();